@@ -0,0 +1,70 @@
+/**
+ * @file backtrace_capture.h
+ * @brief Raw call stack capture for ERROR/CRITICAL entries
+ * @details Symbolizing on the target is far too slow for control loops, so
+ *          entries only carry raw return addresses. Each log file starts with
+ *          one "# Module:" line per loaded object giving its address range,
+ *          load bias and GNU build-id; tools/symbolize maps the addresses back
+ *          to functions and lines on a host with matching binaries. The
+ *          records describe the writing process only, so stacks on entries
+ *          received from other processes ("[pid N]") resolve only when that
+ *          process maps the same modules at the same addresses (fork children).
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ *
+ * @copyright Copyright (c) 2025 Unmanned Systems UK. All rights reserved.
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace embedded_logger
+{
+
+    /**
+     * @brief Return address capture and module map
+     * @note Linux only; elsewhere capture() returns 0 and no modules are listed.
+     */
+    class BacktraceCapture
+    {
+    public:
+        /// Deepest stack kept per entry
+        static constexpr size_t kMaxDepth = 32;
+
+        /**
+         * @brief Record the caller's return addresses
+         * @details Uses the platform unwinder (no frame pointers required).
+         *          Costs a few microseconds after warmUp().
+         * @param frames Receives addresses, innermost first
+         * @param maxDepth Capacity of frames (clamped to kMaxDepth)
+         * @param skipFrames Frames above the caller to leave out (e.g. logging wrappers)
+         * @return Number of addresses stored
+         */
+        static size_t capture(uintptr_t *frames, size_t maxDepth, size_t skipFrames);
+
+        /**
+         * @brief Load the unwinder ahead of time
+         * @details The first unwind loads libgcc_s, which allocates and takes
+         *          locks; doing it at startup keeps that out of the first ERROR.
+         */
+        static void warmUp();
+
+        /**
+         * @brief Append one header line per loaded object
+         * @details Format:
+         * @code
+         * # Module: start=0x55d0c1a00000 end=0x55d0c1a4f000 bias=0x55d0c1a00000 build-id=3f2a... path=/usr/bin/app
+         * @endcode
+         *          An address in [start, end) belongs to the module; the file
+         *          address handed to addr2line is address - bias.
+         * @param out Destination string (appended)
+         */
+        static void appendModuleRecords(std::string &out);
+    };
+
+} // namespace embedded_logger
@@ -0,0 +1,567 @@
+/**
+ * @file basic_logger.h
+ * @brief Policy-based synchronous logger with compile-time platform binding
+ * @details On firmware the platform is fixed at build time, so the time source,
+ *          file system and locking are template policies resolved and inlined
+ *          by the compiler instead of virtual calls through ITimeProvider and
+ *          IFileSystem. BasicLogger covers the synchronous write path (level
+ *          check, timestamp, format, write, rotate) with no heap allocation
+ *          per entry. Queueing, fork handling, streaming and component levels
+ *          remain in Logger.
+ *
+ *          Logger is not an instantiation of this template: its writer thread,
+ *          component table, fork handlers and rings are runtime state that
+ *          every instantiation would carry, and leaving them out is where the
+ *          size and speed difference comes from (tools/basic_logger_bench
+ *          measures both). Options BasicLogger does not implement are
+ *          reported by its constructor rather than silently ignored.
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ *
+ * @copyright Copyright (c) 2025 Unmanned Systems UK. All rights reserved.
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+
+#include "embedded_logger/logger.h"
+#include "embedded_logger/log_printf.h"
+#include "embedded_logger/rotating_file_writer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <string>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace embedded_logger
+{
+
+    // ------------------------------------------------------------------------
+    // Time policies: uint64_t nowMs(); void formatDateTime(uint64_t ms, char *out, size_t size);
+    // ------------------------------------------------------------------------
+
+    /**
+     * @brief Time policy using the C++ system clock and local time
+     */
+    struct SystemTimePolicy
+    {
+        uint64_t nowMs() const
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                             std::chrono::system_clock::now().time_since_epoch())
+                                             .count());
+        }
+
+        void formatDateTime(uint64_t ms, char *out, size_t size) const
+        {
+            std::time_t seconds = static_cast<std::time_t>(ms / 1000);
+            std::tm tm{};
+#ifdef _WIN32
+            localtime_s(&tm, &seconds);
+#else
+            localtime_r(&seconds, &tm);
+#endif
+            std::strftime(out, size, "%Y-%m-%d %H:%M:%S", &tm);
+        }
+    };
+
+    /**
+     * @brief Time policy forwarding to a runtime ITimeProvider
+     */
+    class RuntimeTimePolicy
+    {
+    public:
+        explicit RuntimeTimePolicy(ITimeProvider &provider) : provider_(&provider) {}
+
+        uint64_t nowMs() const { return provider_->getUnixTimestampMs(); }
+
+        void formatDateTime(uint64_t, char *out, size_t size) const
+        {
+            std::string text = provider_->getCurrentDateTime();
+            size_t length = std::min(text.size(), size - 1);
+            std::memcpy(out, text.data(), length);
+            out[length] = '\0';
+        }
+
+    private:
+        ITimeProvider *provider_;
+    };
+
+    // ------------------------------------------------------------------------
+    // File system policies: the IFileSystem queries (fileExists, createDirectory,
+    // deleteFile, renameFile) plus openFile/writeFile/flushFile/closeFile.
+    // ------------------------------------------------------------------------
+
+    /**
+     * @brief File system policy using C stdio
+     */
+    class StdioFileSystemPolicy
+    {
+    public:
+        StdioFileSystemPolicy() : file_(nullptr) {}
+        StdioFileSystemPolicy(StdioFileSystemPolicy &&other) noexcept : file_(other.file_) { other.file_ = nullptr; }
+        ~StdioFileSystemPolicy() { closeFile(); }
+
+        bool fileExists(const std::string &path)
+        {
+            FILE *file = fopen(path.c_str(), "rb");
+            if (!file)
+                return false;
+            fclose(file);
+            return true;
+        }
+
+        bool createDirectory(const std::string &path)
+        {
+#ifdef _WIN32
+            return _mkdir(path.c_str()) == 0 || errno == EEXIST;
+#else
+            return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+        }
+
+        bool deleteFile(const std::string &path) { return remove(path.c_str()) == 0; }
+
+        bool renameFile(const std::string &oldPath, const std::string &newPath)
+        {
+            return rename(oldPath.c_str(), newPath.c_str()) == 0;
+        }
+
+        bool openFile(const std::string &path)
+        {
+            closeFile();
+            file_ = fopen(path.c_str(), "ab");
+            return file_ != nullptr;
+        }
+
+        bool writeFile(const char *data, size_t size) { return file_ && fwrite(data, 1, size, file_) == size; }
+
+        void flushFile()
+        {
+            if (file_)
+                fflush(file_);
+        }
+
+        void closeFile()
+        {
+            if (file_)
+            {
+                fclose(file_);
+                file_ = nullptr;
+            }
+        }
+
+    private:
+        FILE *file_;
+    };
+
+    /**
+     * @brief File system policy forwarding to a runtime IFileSystem
+     */
+    class RuntimeFileSystemPolicy
+    {
+    public:
+        explicit RuntimeFileSystemPolicy(IFileSystem &fileSystem)
+            : fileSystem_(&fileSystem), handle_(kInvalidFileHandle) {}
+        RuntimeFileSystemPolicy(RuntimeFileSystemPolicy &&other) noexcept
+            : fileSystem_(other.fileSystem_), handle_(other.handle_) { other.handle_ = kInvalidFileHandle; }
+        ~RuntimeFileSystemPolicy() { closeFile(); }
+
+        bool fileExists(const std::string &path) { return fileSystem_->fileExists(path); }
+        bool createDirectory(const std::string &path) { return fileSystem_->createDirectory(path); }
+        bool deleteFile(const std::string &path) { return fileSystem_->deleteFile(path); }
+        bool renameFile(const std::string &oldPath, const std::string &newPath)
+        {
+            return fileSystem_->renameFile(oldPath, newPath);
+        }
+
+        bool openFile(const std::string &path)
+        {
+            closeFile();
+            handle_ = fileSystem_->openFile(path, FileOpenMode::APPEND);
+            return handle_ != kInvalidFileHandle;
+        }
+
+        bool writeFile(const char *data, size_t size) { return fileSystem_->appendFile(handle_, data, size); }
+
+        void flushFile() {}
+
+        void closeFile()
+        {
+            if (handle_ != kInvalidFileHandle)
+            {
+                fileSystem_->closeFile(handle_);
+                handle_ = kInvalidFileHandle;
+            }
+        }
+
+    private:
+        IFileSystem *fileSystem_;
+        FileHandle handle_;
+    };
+
+    // ------------------------------------------------------------------------
+    // Lock policies: BasicLockable (lock/unlock)
+    // ------------------------------------------------------------------------
+
+    /**
+     * @brief No locking, for single-threaded firmware or a logger owned by one task
+     */
+    struct NullLockPolicy
+    {
+        void lock() {}
+        void unlock() {}
+    };
+
+    /**
+     * @brief std::mutex locking for multi-threaded use
+     */
+    using MutexLockPolicy = std::mutex;
+
+    /**
+     * @brief Synchronous logger with compile-time platform policies
+     * @details Output matches Logger's line format, file naming, file header
+     *          and backup rotation. Messages longer than the line buffer are
+     *          truncated. The formatted date/time is cached per second, so
+     *          the time policy's formatting runs at most once a second. If a
+     *          new file cannot be opened (full or unmounted card), the failure
+     *          is printed once and the open retried at most once a second on
+     *          later file entries; entries in between go to the console only.
+     * @tparam TimePolicy Time source (SystemTimePolicy, RuntimeTimePolicy, ...)
+     * @tparam FsPolicy File system (StdioFileSystemPolicy, RuntimeFileSystemPolicy, ...)
+     * @tparam LockPolicy Locking (NullLockPolicy, MutexLockPolicy)
+     * @tparam LineSize Stack buffer per entry, including the newline
+     *
+     * @example Firmware binding
+     * @code
+     * using FirmwareLogger = BasicLogger<SystemTimePolicy, StdioFileSystemPolicy, NullLockPolicy>;
+     * FirmwareLogger logger(config);
+     * logger.initialize();
+     * logger.info("BMS", "Pack balanced");
+     * @endcode
+     */
+    template <typename TimePolicy, typename FsPolicy, typename LockPolicy, size_t LineSize = 256>
+    class BasicLogger
+    {
+        static_assert(LineSize >= 64, "BasicLogger line buffer too small for the entry prefix");
+
+    public:
+        /**
+         * @brief Constructor
+         * @param config Logger configuration (levels, destination, file settings)
+         * @param time Time policy instance
+         * @param fileSystem File system policy instance
+         */
+        explicit BasicLogger(const LoggerConfig &config = LoggerConfig{}, TimePolicy time = TimePolicy(),
+                             FsPolicy fileSystem = FsPolicy())
+            : config_(config), time_(std::move(time)), fileSystem_(std::move(fileSystem)),
+              consoleEnabled_(hasDestination(config.defaultDestination, LogDestination::CONSOLE_ONLY)),
+              fileEnabled_(hasDestination(config.defaultDestination, LogDestination::FILE_ONLY)),
+              minLevel_(LogLevel::CRITICAL), initialized_(false), fileOpen_(false), openFailureReported_(false),
+              currentFileSize_(0), cachedSecond_(UINT64_MAX), reopenAtMs_(0)
+        {
+            if (consoleEnabled_)
+                minLevel_ = std::min(minLevel_, config_.consoleLogLevel);
+            if (fileEnabled_)
+                minLevel_ = std::min(minLevel_, config_.fileLogLevel);
+            timestamp_[0] = '\0';
+            reportUnsupportedOptions();
+        }
+
+        /**
+         * @brief Destructor - flushes and closes the file
+         */
+        ~BasicLogger() { shutdown(); }
+
+        BasicLogger(const BasicLogger &) = delete;
+        BasicLogger &operator=(const BasicLogger &) = delete;
+
+        /**
+         * @brief Create the log directory and open the first file
+         * @return true if initialization successful
+         */
+        bool initialize()
+        {
+            std::lock_guard<LockPolicy> guard(lock_);
+            if (initialized_)
+            {
+                return true;
+            }
+
+            if (fileEnabled_)
+            {
+                if (!fileSystem_.fileExists(config_.logDirectory) && !fileSystem_.createDirectory(config_.logDirectory))
+                {
+                    printf("Logger: Failed to create log directory: %s\n", config_.logDirectory.c_str());
+                    return false;
+                }
+                if (!openNewFile())
+                {
+                    return false;
+                }
+            }
+
+            initialized_ = true;
+            return true;
+        }
+
+        /**
+         * @brief Flush and close the file
+         */
+        void shutdown()
+        {
+            std::lock_guard<LockPolicy> guard(lock_);
+            if (fileOpen_)
+            {
+                fileSystem_.flushFile();
+                fileSystem_.closeFile();
+                fileOpen_ = false;
+            }
+            initialized_ = false;
+        }
+
+        /**
+         * @brief Check whether an entry at this level would be written anywhere
+         * @param level Log level
+         * @return true if enabled
+         */
+        bool isEnabled(LogLevel level) const { return level >= minLevel_; }
+
+        /**
+         * @brief Log a message
+         * @param level Log level
+         * @param component Component name
+         * @param message Log message
+         */
+        void log(LogLevel level, const char *component, const char *message)
+        {
+            if (level < minLevel_ || !initialized_)
+            {
+                return;
+            }
+
+            uint64_t nowMs = time_.nowMs();
+            char line[LineSize];
+
+            std::lock_guard<LockPolicy> guard(lock_);
+            if (nowMs / 1000 != cachedSecond_)
+            {
+                time_.formatDateTime(nowMs, timestamp_, sizeof(timestamp_));
+                cachedSecond_ = nowMs / 1000;
+            }
+
+            int written = formatting::format(line, LineSize - 1, "[%s] [%8s] [%12s] %s", timestamp_, levelName(level),
+                                             component, message);
+            size_t length = written < 0 ? 0 : std::min(static_cast<size_t>(written), LineSize - 2);
+            line[length++] = '\n';
+
+            if (consoleEnabled_ && level >= config_.consoleLogLevel)
+            {
+                writeToConsole(level, line, length);
+            }
+
+            if (!fileOpen_ && fileEnabled_ && level >= config_.fileLogLevel && nowMs >= reopenAtMs_)
+            {
+                openNewFile();
+            }
+
+            if (fileOpen_ && level >= config_.fileLogLevel && fileSystem_.writeFile(line, length))
+            {
+                currentFileSize_ += length;
+                if (currentFileSize_ >= config_.maxFileSize)
+                {
+                    rotate();
+                }
+            }
+        }
+
+        /**
+         * @brief Log a message
+         * @param level Log level
+         * @param component Component name
+         * @param message Log message
+         */
+        void log(LogLevel level, const std::string &component, const std::string &message)
+        {
+            log(level, component.c_str(), message.c_str());
+        }
+
+        void debug(const char *component, const char *message) { log(LogLevel::DEBUG, component, message); }
+        void info(const char *component, const char *message) { log(LogLevel::INFO, component, message); }
+        void warning(const char *component, const char *message) { log(LogLevel::WARNING, component, message); }
+        void error(const char *component, const char *message) { log(LogLevel::ERROR, component, message); }
+        void critical(const char *component, const char *message) { log(LogLevel::CRITICAL, component, message); }
+
+        /**
+         * @brief Flush buffered output
+         */
+        void flush()
+        {
+            std::lock_guard<LockPolicy> guard(lock_);
+            fflush(stdout);
+            if (fileOpen_)
+            {
+                fileSystem_.flushFile();
+            }
+        }
+
+        /**
+         * @brief Get current log file path
+         * @return Current log file path
+         */
+        const std::string &getCurrentLogFile() const { return currentLogFile_; }
+
+    private:
+        static constexpr uint64_t kReopenIntervalMs = 1000; ///< Minimum time between attempts to open a file
+
+        static const char *levelName(LogLevel level)
+        {
+            static const char *const names[] = {"DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL"};
+            uint8_t index = static_cast<uint8_t>(level);
+            return index < 5 ? names[index] : "UNKNOWN";
+        }
+
+        /// Same colours and per-line flush as Logger's console output
+        void writeToConsole(LogLevel level, const char *line, size_t length)
+        {
+            if (config_.enableColors)
+            {
+                static const char *const colors[] = {"\033[36m", "\033[32m", "\033[33m", "\033[31m", "\033[35m"};
+                uint8_t index = static_cast<uint8_t>(level);
+                fputs(index < 5 ? colors[index] : "\033[0m", stdout);
+                fwrite(line, 1, length - 1, stdout);
+                fputs("\033[0m\n", stdout);
+            }
+            else
+            {
+                fwrite(line, 1, length, stdout);
+            }
+            fflush(stdout);
+        }
+
+        /// Logger options this class does not implement; entries are still written, without them
+        void reportUnsupportedOptions() const
+        {
+            const char *unsupported[12];
+            size_t count = 0;
+            if (config_.rotationPolicy != RotationPolicy::SIZE)
+                unsupported[count++] = "rotationPolicy (size rotation only)";
+            if (config_.recycleLogFiles)
+                unsupported[count++] = "recycleLogFiles";
+            if (config_.compressLogFiles)
+                unsupported[count++] = "compressLogFiles";
+            if (config_.directFileIo)
+                unsupported[count++] = "directFileIo";
+            if (!config_.componentLevels.empty())
+                unsupported[count++] = "componentLevels";
+            if (!config_.retentionTiers.empty() || config_.retentionMaxAgeHours != 0)
+                unsupported[count++] = "retention";
+            if (config_.adaptiveVerbosity)
+                unsupported[count++] = "adaptiveVerbosity";
+            if (config_.includeSourceLocation)
+                unsupported[count++] = "includeSourceLocation";
+            if (config_.captureBacktraces)
+                unsupported[count++] = "captureBacktraces";
+            if (config_.debugBurstMs != 0)
+                unsupported[count++] = "debugBurstMs";
+            if (config_.sharedRingRole != SharedRingRole::NONE)
+                unsupported[count++] = "sharedRingRole";
+            if (!config_.streamSocketPath.empty() || config_.streamTcpPort != 0)
+                unsupported[count++] = "streaming";
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                printf("Logger: BasicLogger ignores %s\n", unsupported[i]);
+            }
+        }
+
+        bool openNewFile()
+        {
+            uint64_t nowMs = time_.nowMs();
+            char timestamp[32];
+            time_.formatDateTime(nowMs, timestamp, sizeof(timestamp));
+            std::string name = timestamp;
+            // Replace colons and spaces with underscores for filename
+            std::replace(name.begin(), name.end(), ':', '_');
+            std::replace(name.begin(), name.end(), ' ', '_');
+
+            currentLogFile_ = config_.logDirectory + "/" + config_.logFilePrefix + "_" + name +
+                              config_.logFileExtension;
+            currentFileSize_ = 0;
+            fileOpen_ = fileSystem_.openFile(currentLogFile_);
+            if (!fileOpen_)
+            {
+                // Reported once; log() retries after kReopenIntervalMs
+                reopenAtMs_ = nowMs + kReopenIntervalMs;
+                if (!openFailureReported_)
+                {
+                    printf("Logger: Failed to create log file: %s\n", currentLogFile_.c_str());
+                    openFailureReported_ = true;
+                }
+                return false;
+            }
+            if (openFailureReported_)
+            {
+                printf("Logger: Log file reopened: %s\n", currentLogFile_.c_str());
+                openFailureReported_ = false;
+            }
+
+            // Same header as Logger
+            std::string header = "# Embedded Logger Library Log File\n# Created: ";
+            header += timestamp;
+            header += "\n# Format: [Timestamp] [Level] [Component] Message\n";
+            header += std::string(80, '=') + "\n";
+            fileSystem_.writeFile(header.data(), header.size());
+            return true;
+        }
+
+        void rotate()
+        {
+            fileSystem_.closeFile();
+            fileOpen_ = false;
+            shiftBackupFiles(fileSystem_, currentLogFile_, config_.maxBackupFiles);
+            openNewFile();
+        }
+
+        LoggerConfig config_;
+        TimePolicy time_;
+        FsPolicy fileSystem_;
+        LockPolicy lock_;
+
+        bool consoleEnabled_;
+        bool fileEnabled_;
+        LogLevel minLevel_;
+        std::atomic<bool> initialized_;
+        bool fileOpen_;
+        bool openFailureReported_;
+
+        std::string currentLogFile_;
+        size_t currentFileSize_;
+        uint64_t cachedSecond_;
+        uint64_t reopenAtMs_;
+        char timestamp_[32];
+    };
+
+    /**
+     * @brief Runtime-polymorphic instantiation, bound to ITimeProvider/IFileSystem
+     */
+    using RuntimeBasicLogger = BasicLogger<RuntimeTimePolicy, RuntimeFileSystemPolicy, MutexLockPolicy>;
+
+    /**
+     * @brief Fully static instantiation for hosted targets
+     */
+    using StaticBasicLogger = BasicLogger<SystemTimePolicy, StdioFileSystemPolicy, MutexLockPolicy>;
+
+} // namespace embedded_logger
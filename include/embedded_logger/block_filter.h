@@ -0,0 +1,129 @@
+/**
+ * @file block_filter.h
+ * @brief Per-block Bloom filters for searching compressed log files
+ * @details With LoggerConfig::blockFilterBitsPerToken set, every compressed
+ *          block (see log_compression.h) is preceded by a filter frame over
+ *          the words of its messages and the names of its components:
+ * @code
+ * 'F'                filter frame
+ * varint size        payload bytes
+ * uint8 hashCount    bits set per token
+ * bits               size - 1 bytes
+ * @endcode
+ *          tools/log_query tests the filter first and only decompresses
+ *          blocks that may contain every search term. Words are runs of
+ *          letters and digits, compared case-insensitively ("Cell 47
+ *          overvoltage" gives "cell", "47", "overvoltage"); a dotted
+ *          component name also matches its prefixes ("BMS.Cell" matches
+ *          "BMS"). The filter is written in the same write as its block, so
+ *          power loss never separates them.
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ *
+ * @copyright Copyright (c) 2025 Unmanned Systems UK. All rights reserved.
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace embedded_logger
+{
+
+    /**
+     * @brief Bloom filter over the tokens of one block
+     */
+    class BlockFilter
+    {
+    public:
+        /// First byte of a filter frame
+        static constexpr char kFrameTag = 'F';
+
+        BlockFilter() : hashCount_(0) {}
+
+        /**
+         * @brief Add the words of a message
+         * @param text Message text
+         * @param tokens Token hashes (appended)
+         */
+        static void addWords(const std::string &text, std::vector<uint64_t> &tokens);
+
+        /**
+         * @brief Add a component name and its dotted prefixes
+         * @param component Component name
+         * @param tokens Token hashes (appended)
+         */
+        static void addComponent(const std::string &component, std::vector<uint64_t> &tokens);
+
+        /**
+         * @brief Add the component and message words of a formatted log line
+         * @param line Line as written by Logger
+         * @param tokens Token hashes (appended)
+         */
+        static void addLine(const std::string &line, std::vector<uint64_t> &tokens);
+
+        /**
+         * @brief Hash of a search word, as stored by addWords()
+         * @param word Single word (letters and digits)
+         * @return Token hash
+         */
+        static uint64_t wordToken(const std::string &word);
+
+        /**
+         * @brief Hash of a component name, as stored by addComponent()
+         * @param component Component name or dotted prefix
+         * @return Token hash
+         */
+        static uint64_t componentToken(const std::string &component);
+
+        /**
+         * @brief Split a formatted log line into component and message
+         * @param line Line as written by Logger ("[ts] [LEVEL] [component] [pid N] message")
+         * @param component Receives the component name
+         * @param messageOffset Receives the offset of the message text
+         * @return false for headers and continuation lines
+         */
+        static bool parseLine(const std::string &line, std::string &component, size_t &messageOffset);
+
+        /**
+         * @brief Split text into lowercase words
+         * @param text Text to split
+         * @param words Receives the words (appended)
+         */
+        static void splitWords(const std::string &text, std::vector<std::string> &words);
+
+        /**
+         * @brief Build a filter over tokens and append it as a frame
+         * @param tokens Token hashes; sorted and deduplicated in place
+         * @param bitsPerToken Filter size per distinct token (8 gives about 2% false positives)
+         * @param out Destination (appended)
+         */
+        static void appendFrame(std::vector<uint64_t> &tokens, size_t bitsPerToken, std::string &out);
+
+        /**
+         * @brief Read a filter frame
+         * @param cursor Start of the frame; advanced past it on success
+         * @param end End of the available bytes
+         * @param filter Receives the filter
+         * @return false if no complete filter frame starts at cursor
+         */
+        static bool readFrame(const char *&cursor, const char *end, BlockFilter &filter);
+
+        /**
+         * @brief Test a token
+         * @param token Token hash
+         * @return false if the block certainly does not contain the token
+         */
+        bool mayContain(uint64_t token) const;
+
+    private:
+        std::string bits_;
+        uint8_t hashCount_;
+    };
+
+} // namespace embedded_logger
@@ -0,0 +1,144 @@
+/**
+ * @file direct_file_sink.h
+ * @brief Page-cache bypassing file sink for the log writer
+ * @details Writes log files with O_DIRECT so that logging does not evict the
+ *          page cache working set of other processes. Data is collected in two
+ *          aligned buffers: the logger's writer thread fills one while a
+ *          dedicated I/O thread writes the other, so the writer only waits on
+ *          the disk when both buffers are full.
+ *
+ *          Only whole, aligned blocks reach the disk. On flush() and close()
+ *          the final partial block is written zero-padded and the file is then
+ *          truncated to its logical length; the partial block stays buffered
+ *          and is rewritten in full once more data arrives.
+ *
+ *          Where O_DIRECT is unavailable (tmpfs, some network file systems,
+ *          macOS) the sink writes through the page cache and drops each
+ *          written range again with posix_fadvise(POSIX_FADV_DONTNEED)
+ *          (F_NOCACHE on macOS).
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ *
+ * @copyright Copyright (c) 2025 Unmanned Systems UK. All rights reserved.
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace embedded_logger
+{
+
+    /**
+     * @brief Double-buffered direct I/O file writer
+     * @details Used by Logger when LoggerConfig::directFileIo is set.
+     * @note POSIX only. Not thread-safe except for the internal I/O thread;
+     *       owned by a single writer.
+     */
+    class DirectFileSink
+    {
+    public:
+        /// Buffer alignment and write granularity (covers 512-byte and 4K sector devices)
+        static constexpr size_t kAlignment = 4096;
+
+        /**
+         * @brief Constructor
+         * @param bufferSize Size of each of the two buffers, rounded up to kAlignment
+         */
+        explicit DirectFileSink(size_t bufferSize);
+
+        /**
+         * @brief Destructor - writes buffered data and closes the file
+         */
+        ~DirectFileSink();
+
+        DirectFileSink(const DirectFileSink &) = delete;
+        DirectFileSink &operator=(const DirectFileSink &) = delete;
+
+        /**
+         * @brief Open (or append to) a file and start the I/O thread
+         * @param path File path
+         * @param useDirect false to start on the page-cache fallback instead of O_DIRECT
+         * @return true if the file is open
+         */
+        bool open(const std::string &path, bool useDirect = true);
+
+        /**
+         * @brief Append bytes; full buffers are handed to the I/O thread
+         * @param data Bytes to write
+         * @param size Number of bytes
+         * @return false if an earlier write failed
+         */
+        bool write(const void *data, size_t size);
+
+        /**
+         * @brief Write everything appended so far, including the partial tail block
+         * @return true if successful
+         */
+        bool flush();
+
+        /**
+         * @brief Flush, stop the I/O thread and close the file
+         */
+        void close();
+
+        /**
+         * @brief Check whether a file is open
+         * @return true if open
+         */
+        bool isOpen() const { return fd_ >= 0; }
+
+        /**
+         * @brief Check whether writes bypass the page cache
+         * @return true for O_DIRECT, false for the fadvise fallback
+         */
+        bool isDirect() const { return direct_.load(); }
+
+        /// Wait for the I/O thread to go idle and hold the sink lock across fork()
+        void prepareForFork();
+        /// Release the lock taken in prepareForFork() (parent)
+        void resumeAfterForkParent();
+        /// Child after fork(): drop the inherited file and I/O thread without writing
+        void abandonAfterForkChild();
+
+    private:
+        void ioThreadFunction();
+        void submitActive();
+        void waitIdle(std::unique_lock<std::mutex> &lock);
+        bool writeRange(const uint8_t *data, size_t size, uint64_t offset);
+        void fallBackToBuffered();
+        void dropCachedRange(uint64_t offset, size_t size);
+        void resetState();
+
+        size_t capacity_;
+        uint8_t *buffers_[2];
+        int fd_;
+        std::atomic<bool> direct_;
+        std::atomic<bool> failed_;
+
+        // Active buffer (filled by the caller)
+        int active_;
+        size_t activeUsed_;
+        size_t activeWritten_;  ///< Leading bytes already on disk as whole blocks
+        uint64_t activeOffset_; ///< File offset of the active buffer
+
+        // Buffer handed to the I/O thread; guarded by mutex_
+        std::mutex mutex_;
+        std::condition_variable condition_;
+        bool pending_;
+        int pendingIndex_;
+        size_t pendingFrom_;
+        uint64_t pendingOffset_;
+        bool stopping_;
+        std::thread ioThread_;
+    };
+
+} // namespace embedded_logger
@@ -0,0 +1,120 @@
+/**
+ * @file log_compactor.h
+ * @brief Level-tiered retention for rotated text log files
+ * @details Rotation keeps or deletes whole files. The compactor rewrites
+ *          rotated files once they reach the age of a retention tier,
+ *          keeping only entries at or above that tier's level, and merges
+ *          the (much smaller) results of a tier into files of up to
+ *          LoggerConfig::maxFileSize. Far more history then fits in the same
+ *          storage budget.
+ *
+ *          A compacted file starts with the usual title line followed by:
+ * @code
+ * # Compacted: WARNING
+ * # Last-Written: 1738281600000
+ * # Format: [Timestamp] [Level] [Component] Message
+ * ================================================================================
+ * # Source: embedded_log_2025-01-30_08_00_00.txt
+ * # Module: ...
+ * [2025-01-30 08:00:01] [ WARNING] [         BMS] Cell 3 low
+ * @endcode
+ *          Last-Written is the newest modification time of the merged
+ *          sources and gives the file its age. Each source keeps its
+ *          "# Module:" records, so tools/symbolize still resolves backtraces.
+ *          Sources are deleted only after their replacement is complete; a
+ *          power loss in between leaves entries duplicated, never lost. With
+ *          LoggerConfig::compressLogFiles the body is written as compressed
+ *          blocks under a "# Compression:" header line, like live files.
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ *
+ * @copyright Copyright (c) 2025 Unmanned Systems UK. All rights reserved.
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+
+#include "embedded_logger/log_compression.h"
+#include "embedded_logger/logger.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace embedded_logger
+{
+
+    /**
+     * @brief Background compaction of aged log files
+     * @details Logger runs one pass every LoggerConfig::compactionIntervalMs
+     *          on its own low-duty thread. Only files in logDirectory whose
+     *          names start with logFilePrefix are touched.
+     * @note Needs IFileSystem::listDirectory() and getFileModifiedTime().
+     */
+    class LogCompactor
+    {
+    public:
+        /**
+         * @brief Result of one pass
+         */
+        struct Report
+        {
+            size_t filesScanned = 0;   ///< Candidate files looked at
+            size_t filesCompacted = 0; ///< Sources filtered or merged (and removed)
+            size_t filesWritten = 0;   ///< Compacted files created
+            size_t filesExpired = 0;   ///< Files deleted past retentionMaxAgeHours
+            uint64_t bytesBefore = 0;  ///< Size of the compacted sources
+            uint64_t bytesAfter = 0;   ///< Size of the files written for them
+        };
+
+        /**
+         * @brief Constructor
+         * @param fileSystem File system holding the log directory
+         * @param config Directory, prefix, extension, tiers and merge size are taken from here
+         * @param dictionary Read with this dictionary and write compressed files (nullptr = plain text)
+         */
+        LogCompactor(IFileSystem &fileSystem, const LoggerConfig &config, const LogDictionary *dictionary = nullptr);
+
+        /**
+         * @brief Run one compaction pass
+         * @param nowMs Current Unix time in milliseconds
+         * @param liveFile Path of the file being written, never touched
+         * @param cancel Optional flag checked between files
+         * @return What was done
+         */
+        Report run(uint64_t nowMs, const std::string &liveFile, const std::atomic<bool> *cancel = nullptr);
+
+        /**
+         * @brief Parse the level field of a formatted log line
+         * @param line Line as written by Logger ("[ts] [   LEVEL] [comp] ...")
+         * @param level Receives the level
+         * @return false for headers and continuation lines
+         */
+        static bool parseLevel(const std::string &line, LogLevel &level);
+
+    private:
+        struct Candidate;
+        struct Output;
+
+        LogLevel tierLevel(uint64_t ageMs, bool &tiered) const;
+        bool appendFiltered(Output &output, const Candidate &candidate, LogLevel level);
+        void packBlocks(Output &output, bool all);
+        bool writeOutput(Output &output, LogLevel level, Report &report);
+
+        IFileSystem &fileSystem_;
+        std::string directory_;
+        std::string prefix_;
+        std::string extension_;
+        std::vector<RetentionTier> tiers_;
+        uint64_t maxAgeMs_;
+        size_t targetSize_;
+        bool compress_;
+        size_t filterBits_; ///< Block filters, as LoggerConfig::blockFilterBitsPerToken
+        LogBlockCodec codec_;
+        bool warned_; ///< Unsupported file system already reported
+    };
+
+} // namespace embedded_logger
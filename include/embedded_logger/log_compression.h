@@ -0,0 +1,177 @@
+/**
+ * @file log_compression.h
+ * @brief Dictionary-assisted block compression for log files
+ * @details Log files must survive power loss, so they are compressed in
+ *          small independent blocks (one per file write) rather than as one
+ *          stream. A generic compressor has little history to work with in a
+ *          few hundred bytes; a dictionary trained on earlier logs supplies
+ *          the timestamps, level tags, component names and message text that
+ *          recur in every block.
+ *
+ *          The codec is a byte-oriented LZ77 (LZ4-style sequences, 16-bit
+ *          offsets) whose window starts with the dictionary. Decoding needs
+ *          no tables and no allocation beyond the output, so it also suits
+ *          MCUs. Each block is framed as:
+ * @code
+ * 'Z' | 'S'          compressed or stored
+ * varint rawSize     LEB128
+ * varint payloadSize LEB128
+ * uint32 checksum    FNV-1a of the raw bytes, little-endian
+ * payload
+ * @endcode
+ *          A block torn by power loss fails its length or checksum check and
+ *          is dropped on reading; earlier blocks are unaffected.
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ *
+ * @copyright Copyright (c) 2025 Unmanned Systems UK. All rights reserved.
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace embedded_logger
+{
+
+    /**
+     * @brief Pre-trained compression dictionary
+     * @details Built by tools/log_dict from existing logs. Its ID (a hash of
+     *          the contents) is written into every compressed file header so
+     *          readers can check they hold the matching dictionary.
+     */
+    class LogDictionary
+    {
+    public:
+        /// Largest dictionary; keeps dictionary offsets within the 16-bit window
+        static constexpr size_t kMaxSize = 48 * 1024;
+
+        /**
+         * @brief Empty dictionary (ID 0)
+         */
+        LogDictionary();
+
+        /**
+         * @brief Dictionary with the given contents
+         * @param contents Raw dictionary bytes (truncated to kMaxSize, keeping the end)
+         */
+        explicit LogDictionary(const std::string &contents);
+
+        /**
+         * @brief Build a dictionary from sample blocks
+         * @details Picks the segments whose 8-byte substrings occur in the most
+         *          samples (one pick per slice of the corpus, as in zstd's
+         *          COVER trainer). The most valuable segments are placed last,
+         *          closest to the data, where offsets are shortest.
+         * @param samples Sample blocks, ideally cut like the blocks to compress
+         * @param size Target dictionary size in bytes
+         * @return Trained dictionary (empty if the samples are too small)
+         */
+        static LogDictionary train(const std::vector<std::string> &samples, size_t size);
+
+        /**
+         * @brief Load a dictionary file written by save()
+         * @param path File path
+         * @return true if the file is a valid dictionary
+         */
+        bool load(const std::string &path);
+
+        /**
+         * @brief Write the dictionary to a file
+         * @param path File path
+         * @return true if successful
+         */
+        bool save(const std::string &path) const;
+
+        /// Content hash identifying the dictionary (0 = empty)
+        uint32_t id() const { return id_; }
+        /// Dictionary bytes
+        const std::string &contents() const { return contents_; }
+        /// True if there is no dictionary
+        bool empty() const { return contents_.empty(); }
+
+    private:
+        std::string contents_;
+        uint32_t id_;
+    };
+
+    /**
+     * @brief Framed block encoder/decoder
+     * @note Not thread-safe (the encoder keeps its match table); use one per writer.
+     */
+    class LogBlockCodec
+    {
+    public:
+        /// Log file header line announcing compressed blocks, followed by the dictionary ID in hex
+        static constexpr char kHeaderLabel[] = "# Compression: lz dictionary=";
+
+        /**
+         * @brief Constructor
+         * @param dictionary Dictionary shared by all blocks (copied; may be empty)
+         */
+        explicit LogBlockCodec(const LogDictionary &dictionary = LogDictionary());
+
+        /**
+         * @brief Compress one block and append it, framed, to out
+         * @details Falls back to a stored block when compression does not help.
+         * @param data Raw bytes
+         * @param size Number of bytes
+         * @param out Destination (appended)
+         */
+        void appendBlock(const void *data, size_t size, std::string &out);
+
+        /**
+         * @brief Decode one framed block
+         * @details Filter frames in front of the block (block_filter.h) are skipped.
+         * @param cursor Start of the block; advanced past it on success
+         * @param end End of the available bytes
+         * @param out Destination for the raw bytes (appended)
+         * @return false for a torn, corrupt or foreign block (out unchanged)
+         */
+        bool readBlock(const char *&cursor, const char *end, std::string &out) const;
+
+        /**
+         * @brief Step over one framed block without decoding it
+         * @param cursor Start of the block; advanced past it on success
+         * @param end End of the available bytes
+         * @return false for a torn or foreign block
+         */
+        static bool skipBlock(const char *&cursor, const char *end);
+
+        /**
+         * @brief Compress without framing
+         * @param data Raw bytes
+         * @param size Number of bytes
+         * @param out Destination (appended)
+         */
+        void compress(const void *data, size_t size, std::string &out);
+
+        /**
+         * @brief Decompress output of compress()
+         * @param data Compressed bytes
+         * @param size Number of compressed bytes
+         * @param rawSize Expected raw size
+         * @param out Destination (appended)
+         * @return false if the input is malformed
+         */
+        bool decompress(const void *data, size_t size, size_t rawSize, std::string &out) const;
+
+        /// Dictionary in use
+        const LogDictionary &dictionary() const { return dictionary_; }
+
+    private:
+        static bool parseBlockHeader(const char *cursor, const char *end, const uint8_t *&payload, uint64_t &rawSize,
+                                     uint64_t &payloadSize, uint32_t &checksum, bool &stored);
+        size_t matchLength(uint32_t candidate, const uint8_t *source, size_t position, size_t size) const;
+
+        LogDictionary dictionary_;
+        std::vector<uint16_t> dictionaryTable_; ///< Last dictionary position per hash, +1 (0 = none)
+        std::vector<uint32_t> blockTable_;      ///< Last block position per hash, +1 (0 = none)
+    };
+
+} // namespace embedded_logger
@@ -0,0 +1,124 @@
+/**
+ * @file log_context.h
+ * @brief Thread-local diagnostic context (MDC) attached to log entries
+ * @details Context such as a flight id or battery string is pushed once per
+ *          scope instead of being concatenated into every message. Entries
+ *          that pass level filtering hold a reference to the context that was
+ *          active when they were logged; the formatter renders it as
+ *          "[flight=42 string=B] " in front of the message.
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ *
+ * @copyright Copyright (c) 2025 Unmanned Systems UK. All rights reserved.
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+namespace embedded_logger
+{
+
+    /**
+     * @brief One key/value in a thread's context stack
+     * @details Nodes are immutable and shared: an entry keeps its context
+     *          alive by holding a reference to the innermost node, so pushing
+     *          or popping context later never affects queued entries.
+     */
+    struct LogContextNode
+    {
+        std::string key;                              ///< Field name
+        std::string value;                            ///< Field value
+        std::shared_ptr<const LogContextNode> parent; ///< Enclosing context (null at the outermost scope)
+    };
+
+    /**
+     * @brief Access to the calling thread's context stack
+     */
+    class LogContext
+    {
+    public:
+        static constexpr size_t kMaxRenderedFields = 16; ///< Innermost fields rendered per entry
+
+        /**
+         * @brief Get the calling thread's innermost context
+         * @return Context handle (null when no context is active)
+         */
+        static const std::shared_ptr<const LogContextNode> &current();
+
+        /**
+         * @brief Render a context chain outermost first, e.g. "[flight=42 string=B] "
+         * @details Only the innermost kMaxRenderedFields fields are rendered;
+         *          deeper chains start with "... " in place of the outer ones,
+         *          e.g. "[... k5=v5 ... k20=v20] ".
+         * @param context Innermost node (may be null)
+         * @param out Destination string (appended; unchanged for a null context)
+         */
+        static void render(const LogContextNode *context, std::string &out);
+
+    private:
+        friend class LogContextScope;
+        static std::shared_ptr<const LogContextNode> &slot();
+    };
+
+    /**
+     * @brief RAII scope that pushes a context field for the calling thread
+     * @note Use through EL_CONTEXT; scopes must be destroyed in reverse order
+     *       of creation, which block scoping guarantees.
+     */
+    class LogContextScope
+    {
+    public:
+        /**
+         * @brief Push a field
+         * @param key Field name
+         * @param value Field value
+         */
+        LogContextScope(const char *key, std::string value);
+
+        /**
+         * @brief Push a numeric field
+         * @param key Field name
+         * @param value Field value, converted with std::to_string
+         */
+        template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+        LogContextScope(const char *key, T value) : LogContextScope(key, std::to_string(value))
+        {
+        }
+
+        /**
+         * @brief Pop the field
+         */
+        ~LogContextScope();
+
+        LogContextScope(const LogContextScope &) = delete;
+        LogContextScope &operator=(const LogContextScope &) = delete;
+
+    private:
+        std::shared_ptr<const LogContextNode> previous_;
+    };
+
+} // namespace embedded_logger
+
+#define EL_CONTEXT_CONCAT_INNER(a, b) a##b
+#define EL_CONTEXT_CONCAT(a, b) EL_CONTEXT_CONCAT_INNER(a, b)
+
+/**
+ * @brief Attach a context field to every entry logged by this thread until the end of the scope
+ * @param key Field name (string literal)
+ * @param value Field value (string or number)
+ * @code
+ * void runFlight(uint32_t flightId)
+ * {
+ *     EL_CONTEXT("flight", flightId);
+ *     EL_INFO("NAV", "Takeoff"); // [NAV] [flight=1234] Takeoff
+ * }
+ * @endcode
+ */
+#define EL_CONTEXT(key, value) \
+    embedded_logger::LogContextScope EL_CONTEXT_CONCAT(elContextScope_, __LINE__)(key, value)
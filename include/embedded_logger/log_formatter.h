@@ -0,0 +1,63 @@
+/**
+ * @file log_formatter.h
+ * @brief Formatting utilities shared by the logger, sinks and tools
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ *
+ * @copyright Copyright (c) 2025 Unmanned Systems UK. All rights reserved.
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace embedded_logger
+{
+    namespace formatting
+    {
+
+        /**
+         * @brief Append bytes as space-separated lowercase hex pairs
+         * @details Table-driven: one 16-bit table load per byte, no per-byte
+         *          branching or stream formatting.
+         * @param out Destination string (appended, reserved up front)
+         * @param data Bytes to encode
+         * @param size Number of bytes
+         * @code
+         * std::string text;
+         * formatting::appendHex(text, frame, 4); // "12 34 ab cd"
+         * @endcode
+         */
+        void appendHex(std::string &out, const void *data, size_t size);
+
+        /**
+         * @brief Append raw return addresses as " [bt 0x... 0x...]"
+         * @details Read back by tools/symbolize. Appends nothing for an empty stack.
+         * @param out Destination string (appended)
+         * @param frames Addresses, innermost first
+         * @param count Number of addresses
+         */
+        void appendBacktrace(std::string &out, const uintptr_t *frames, size_t count);
+
+        /**
+         * @brief Append an unsigned LEB128 varint
+         * @param out Destination string (appended)
+         * @param value Value to encode
+         */
+        void appendVarint(std::string &out, uint64_t value);
+
+        /**
+         * @brief Read an unsigned LEB128 varint
+         * @param cursor Start of the varint; advanced past it on success
+         * @param end End of the available bytes
+         * @param value Receives the value
+         * @return false if the varint is truncated or too long
+         */
+        bool readVarint(const uint8_t *&cursor, const uint8_t *end, uint64_t &value);
+
+    } // namespace formatting
+} // namespace embedded_logger
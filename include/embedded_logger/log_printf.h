@@ -0,0 +1,70 @@
+/**
+ * @file log_printf.h
+ * @brief Reentrant, allocation-free printf engine used by Logger::logf and BasicLogger
+ * @details Replaces vsnprintf on targets where the C library's version is
+ *          large, slow or allocates for floating point (newlib on Cortex-M).
+ *          Integers are converted two digits per division. Floating point is
+ *          formatted exactly, from the bits of the double, with base-10^9
+ *          big-number arithmetic on integers only (no FPU, no soft-float
+ *          calls), and rounded half-to-even like glibc. State lives on the
+ *          stack (about 600 bytes for floats), so any thread or interrupt
+ *          handler may call it.
+ *
+ *          Supported: flags "-+ #0", width and precision (including '*'),
+ *          length modifiers hh h l ll j z t L, conversions d i u o x X c s p
+ *          f F e E g G and %%. Other conversions (%a, %n, wide strings) are
+ *          copied to the output as written and consume no argument. Output
+ *          matches glibc except where tests/unit/test_log_printf.cpp lists
+ *          an exception (%#g after a rounding carry keeps the zeros C requires).
+ *
+ *          Define EMBEDDED_LOGGER_LIBC_PRINTF when building the library to
+ *          forward formatV() to the C library's vsnprintf instead.
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ *
+ * @copyright Copyright (c) 2025 Unmanned Systems UK. All rights reserved.
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace embedded_logger
+{
+    namespace formatting
+    {
+
+        /**
+         * @brief vsnprintf replacement
+         * @param buffer Destination (always NUL-terminated when size > 0)
+         * @param size Buffer size in bytes
+         * @param format Printf-style format string
+         * @param args Format arguments
+         * @return Length the complete output would have had, excluding the NUL
+         */
+        int formatV(char *buffer, size_t size, const char *format, va_list args);
+
+        /**
+         * @brief snprintf replacement
+         * @see formatV
+         */
+        int format(char *buffer, size_t size, const char *format, ...)
+#if defined(__GNUC__)
+            __attribute__((format(printf, 3, 4)))
+#endif
+            ;
+
+        /**
+         * @brief Append an unsigned integer in decimal
+         * @param out Destination string (appended)
+         * @param value Value to convert
+         */
+        void appendDecimal(std::string &out, uint64_t value);
+
+    } // namespace formatting
+} // namespace embedded_logger
@@ -0,0 +1,202 @@
+/**
+ * @file log_stream_server.h
+ * @brief Live log streaming to local subscribers
+ * @details Publishes entries over a UNIX domain socket and/or TCP loopback to
+ *          any number of viewers. Each subscriber has its own bounded buffer
+ *          that is filled by the logger and drained by a dedicated server
+ *          thread, so a slow viewer never slows the logger.
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ *
+ * @copyright Copyright (c) 2025 Unmanned Systems UK. All rights reserved.
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+
+#include "embedded_logger/logger.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace embedded_logger
+{
+
+    /**
+     * @brief Live log stream server
+     * @details Subscriber protocol: after connecting, a client may send a line
+     *          @code FILTER level=WARNING component=BMS.Cell format=binary @endcode
+     *          at any time; all keys are optional. Defaults are all levels, all
+     *          components, text format. Text records are formatted log lines
+     *          terminated by '\\n'. Binary records are little-endian:
+     *          @code
+     *          uint32_t length;          // bytes following this field
+     *          uint64_t timestampMs;
+     *          uint32_t processId;
+     *          uint8_t  level;
+     *          uint8_t  reserved;
+     *          uint16_t componentLength;
+     *          uint16_t payloadLength;   // logBinary() bytes, 0 for text entries
+     *          char     component[componentLength];
+     *          uint8_t  payload[payloadLength];
+     *          char     message[];       // remaining bytes, EL_CONTEXT fields rendered in front
+     *          @endcode
+     * @note POSIX only. publish() may be called from any thread: the logger's
+ *       writer thread with asynchronous logging, each logging thread
+ *       otherwise. Callers are serialised on the subscriber list lock.
+     */
+    class LogStreamServer
+    {
+    public:
+        /**
+         * @brief Behaviour when a subscriber's buffer is full
+         */
+        enum class SlowSubscriberPolicy : uint8_t
+        {
+            DISCONNECT = 0,   ///< Close the subscriber's connection
+            DROP_ENTRIES = 1  ///< Keep the connection, drop entries that do not fit
+        };
+
+        /**
+         * @brief Constructor
+         * @param bufferSize Per-subscriber buffer capacity in bytes
+         * @param maxSubscribers Maximum concurrent subscribers
+         * @param policy What to do with subscribers that cannot keep up
+         * @param onSubscribersChanged Called on the server thread, without any
+         *        server lock held, when the first subscriber connects or the
+         *        last one leaves (may be empty)
+         */
+        LogStreamServer(size_t bufferSize, size_t maxSubscribers, SlowSubscriberPolicy policy,
+                        std::function<void()> onSubscribersChanged = nullptr);
+
+        /**
+         * @brief Destructor - stops the server thread and closes all sockets
+         */
+        ~LogStreamServer();
+
+        LogStreamServer(const LogStreamServer &) = delete;
+        LogStreamServer &operator=(const LogStreamServer &) = delete;
+
+        /**
+         * @brief Start listening and launch the server thread
+         * @param socketPath UNIX socket path (empty to disable)
+         * @param tcpPort TCP port bound to 127.0.0.1 (0 to disable)
+         * @return true if at least one listener is active
+         */
+        bool start(const std::string &socketPath, uint16_t tcpPort);
+
+        /**
+         * @brief Stop the server thread and disconnect all subscribers
+         */
+        void stop();
+
+        /**
+         * @brief Check whether anyone is listening
+         * @return true if at least one subscriber is connected
+         * @note Single atomic load, lets the caller skip formatting entirely
+         */
+        bool hasSubscribers() const { return subscriberCount_.load(std::memory_order_relaxed) != 0; }
+
+        /**
+         * @brief Queue an entry for every subscriber whose filter matches
+         * @param entry Log entry
+         * @param formatted Entry formatted as a text line (without newline)
+         * @note Never blocks on a socket; only copies into subscriber buffers.
+         */
+        void publish(const LogEntry &entry, const std::string &formatted);
+
+        /**
+         * @brief Get number of entries dropped for slow subscribers
+         * @return Drop count
+         */
+        uint64_t getDroppedCount() const { return droppedCount_.load(); }
+
+        /**
+         * @brief Get number of subscribers disconnected for being too slow
+         * @return Disconnect count
+         */
+        uint64_t getDisconnectCount() const { return disconnectCount_.load(); }
+
+        /**
+         * @brief Lock internal state before fork()
+         */
+        void prepareForFork();
+
+        /**
+         * @brief Release internal state in the parent after fork()
+         */
+        void resumeAfterForkParent();
+
+        /**
+         * @brief Drop the inherited server in a child after fork()
+         * @note Closes this process' copies of the sockets without touching
+         *       the parent's server thread or its subscribers.
+         */
+        void abandonAfterForkChild();
+
+        /**
+         * @brief Encode an entry as a binary stream record
+         * @param entry Log entry
+         * @param out Receives the record (appended)
+         */
+        static void encodeBinaryRecord(const LogEntry &entry, std::string &out);
+
+        /**
+         * @brief Decode one binary stream record
+         * @param data Buffer starting at a record
+         * @param size Bytes available
+         * @param entry Receives the decoded entry
+         * @return Bytes consumed, or 0 if the buffer holds no complete record
+         */
+        static size_t decodeBinaryRecord(const char *data, size_t size, LogEntry &entry);
+
+    private:
+        struct Subscriber
+        {
+            int fd = -1;
+            std::string outbox;     ///< Pending bytes
+            size_t sentOffset = 0;  ///< Bytes of outbox already sent
+            std::string inbox;      ///< Partial command line
+            LogLevel minLevel = LogLevel::DEBUG;
+            std::string componentPrefix;
+            bool binary = false;
+            bool closing = false;
+        };
+
+        void serverThreadFunction();
+        void acceptSubscriber(int listenFd);
+        void readCommands(Subscriber &subscriber);
+        void applyFilter(Subscriber &subscriber, const std::string &line);
+        void sendPending(Subscriber &subscriber);
+        void wakeServer();
+        void closeAll();
+
+        size_t bufferSize_;
+        size_t maxSubscribers_;
+        SlowSubscriberPolicy policy_;
+        std::function<void()> onSubscribersChanged_;
+
+        std::string socketPath_;
+        int unixListenFd_;
+        int tcpListenFd_;
+        int wakePipe_[2];
+
+        std::vector<std::unique_ptr<Subscriber>> subscribers_;
+        std::mutex subscribersMutex_;
+        std::atomic<size_t> subscriberCount_;
+        std::atomic<bool> wakePending_;
+        std::atomic<bool> running_;
+        std::thread serverThread_;
+
+        std::atomic<uint64_t> droppedCount_;
+        std::atomic<uint64_t> disconnectCount_;
+    };
+
+} // namespace embedded_logger
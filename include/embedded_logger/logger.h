@@ -16,19 +16,44 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <fstream>
 #include <mutex>
 #include <atomic>
 #include <queue>
+#include <deque>
 #include <thread>
 #include <condition_variable>
 #include <functional>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <map>
+#include <unordered_map>
+
+#include "embedded_logger/log_context.h"
+
+/**
+ * @brief Capacity of the per-logger component level table
+ * @note Components registered beyond this share the default (unnamed) slot and
+ *       its levels; the first such name is reported on the console
+ */
+#ifndef EMBEDDED_LOGGER_MAX_COMPONENTS
+#define EMBEDDED_LOGGER_MAX_COMPONENTS 256
+#endif
 
 namespace embedded_logger
 {
 
+    class SharedLogRing;
+    class LogStreamServer;
+    class DirectFileSink;
+    class LogCompactor;
+    class LogDictionary;
+    class LogBlockCodec;
+
     /**
      * @brief Log levels for filtering and categorization
      */
@@ -51,6 +76,82 @@ namespace embedded_logger
         BOTH = 3          ///< Output to both console and file
     };
 
+    /**
+     * @brief Check whether a destination includes the given output
+     * @param destination Destination of an entry
+     * @param output CONSOLE_ONLY or FILE_ONLY
+     * @return true if destination writes to output
+     */
+    inline bool hasDestination(LogDestination destination, LogDestination output)
+    {
+        return (static_cast<uint8_t>(destination) & static_cast<uint8_t>(output)) != 0;
+    }
+
+    /**
+     * @brief When the logger starts a new log file
+     */
+    enum class RotationPolicy : uint8_t
+    {
+        SIZE = 0,        ///< When the file reaches maxFileSize
+        TIME = 1,        ///< At each rotationInterval boundary of local time
+        SIZE_OR_TIME = 2 ///< Whichever comes first
+    };
+
+    /**
+     * @brief Period of time-based rotation
+     */
+    enum class RotationInterval : uint8_t
+    {
+        HOURLY = 0, ///< On the hour
+        DAILY = 1   ///< At midnight
+    };
+
+    /**
+     * @brief Logging behaviour of a child process created with fork()
+     * @details The fork handler only releases the parent's locks; the child's
+     *          file and writer thread are set up on its first log call.
+     * @note Only meaningful on POSIX platforms with LoggerConfig::forkSafe enabled
+     */
+    enum class ForkChildMode : uint8_t
+    {
+        SEPARATE_FILE = 0, ///< Child opens its own log file (pid in the file name)
+        SHARED_FILE = 1,   ///< Child appends to the parent's current file, rotation disabled in child
+        PARENT_RING = 2,   ///< Child writes into a shared-memory ring drained by the parent's writer
+        DISABLED = 3       ///< Logging is turned off in the child
+    };
+
+    /**
+     * @brief Role of this logger in a named cross-process shared ring
+     * @note POSIX only, see SharedLogRing
+     */
+    enum class SharedRingRole : uint8_t
+    {
+        NONE = 0,     ///< No named ring, this process writes its own files
+        PRODUCER = 1, ///< Entries go into the named ring, no local files
+        COLLECTOR = 2 ///< Creates the named ring and writes all producers' entries
+    };
+
+    /**
+     * @brief Load-shedding state of the adaptive verbosity controller
+     */
+    enum class AdaptiveVerbosityState : uint8_t
+    {
+        NORMAL = 0,   ///< All levels pass
+        SAMPLING = 1, ///< DEBUG/INFO sampled 1-in-N per component
+        SHEDDING = 2  ///< DEBUG/INFO dropped, WARNING and above pass
+    };
+
+    /**
+     * @brief Handle for a registered component name
+     * @details Obtained once from Logger::registerComponent(); logging through a
+     *          handle resolves the component's effective level with a single
+     *          table load and no string work.
+     */
+    struct ComponentId
+    {
+        uint16_t value = 0; ///< Index into the component table (0 = default slot)
+    };
+
     /**
      * @brief Individual log entry structure
      */
@@ -63,6 +164,14 @@ namespace embedded_logger
         std::string filename;  ///< Source file name (optional)
         int lineNumber;        ///< Source line number (optional)
         uint64_t timestampMs;  ///< Unix timestamp in milliseconds
+        uint32_t processId = 0; ///< Producing process for entries received from another process (0 = local)
+        uint16_t componentId = 0;       ///< Registered component handle value
+        bool bypassSinkLevels = false;  ///< Component has an explicit level that overrides console/file levels
+        std::string payload;            ///< Raw bytes from logBinary(), hex-encoded when formatted
+        uint32_t payloadSize = 0;       ///< Payload size before truncation to maxBinaryPayloadSize
+        std::shared_ptr<const LogContextNode> context; ///< EL_CONTEXT fields active when logged
+        std::vector<uintptr_t> backtrace;              ///< Raw return addresses, innermost first (captureBacktraces)
+        std::function<std::string()> deferredMessage;  ///< Builds message on the writer thread (logDeferred)
 
         /**
          * @brief Default constructor
@@ -83,6 +192,37 @@ namespace embedded_logger
               lineNumber(line), timestampMs(0) {}
     };
 
+    /**
+     * @brief One step of level-tiered retention
+     * @details A rotated file last written at least afterHours ago keeps only
+     *          entries at minLevel and above (see LogCompactor).
+     */
+    struct RetentionTier
+    {
+        uint32_t afterHours; ///< File age at which the tier applies
+        LogLevel minLevel;   ///< Lowest level kept from then on
+    };
+
+    /**
+     * @brief How far Logger::emergencyFlush() got before its deadline
+     * @details Queued entries are written severest first: ERROR/CRITICAL,
+     *          then the formatted but unwritten tail of recent lines, then the
+     *          rest of the queue. Entries not written go back to the queue.
+     */
+    struct EmergencyFlushReport
+    {
+        bool completed = false;    ///< Everything pending was written and synced in time
+        bool lockTimedOut = false; ///< The writer held the file past the deadline; nothing was written
+        size_t severeWritten = 0;  ///< ERROR/CRITICAL queued entries written
+        size_t severePending = 0;  ///< ERROR/CRITICAL queued entries found
+        bool tailWritten = false;  ///< Formatted lines awaiting the next batch write were written
+        size_t otherWritten = 0;   ///< Other queued entries written
+        size_t otherPending = 0;   ///< Other queued entries bound for the file
+        size_t bytesWritten = 0;   ///< Bytes handed to the file system (compressed size if compressing)
+        bool synced = false;       ///< The file was synced to the medium
+        uint32_t elapsedUs = 0;    ///< Time taken
+    };
+
     /**
      * @brief Logger configuration structure
      */
@@ -94,7 +234,26 @@ namespace embedded_logger
 
         std::string logDirectory = "/logs"; ///< Log file directory
         size_t maxFileSize = 1024 * 1024;   ///< Max file size (1MB)
-        int maxBackupFiles = 5;             ///< Number of backup files
+        int maxBackupFiles = 5;             ///< Number of backup files (time rotation: older period files beyond this are deleted)
+        size_t fileWriteBatchSize = 8192;   ///< Async mode: bytes per file write (pending lines are also written when the queue empties)
+        bool recycleLogFiles = false;              ///< Reuse the oldest backup as the next live file (preallocated, overwritten in place); the live file is <prefix>_live<extension> across restarts
+        size_t validLengthUpdateBytes = 64 * 1024; ///< recycleLogFiles: rewrite the "# Valid-Length:" header after this many bytes (and on flush, rotation and shutdown)
+        bool directFileIo = false;                 ///< Linux: write log files with O_DIRECT, bypassing the page cache (default file system only)
+        size_t directFileBufferSize = 256 * 1024;  ///< Direct I/O: size of each of the two aligned write buffers
+        bool compressLogFiles = false;             ///< Write each file batch as an independently compressed block (read back with readLogFile)
+        std::string compressionDictionaryPath;     ///< Dictionary trained with tools/log_dict for compressLogFiles (empty = none)
+        size_t blockFilterBitsPerToken = 0;        ///< compressLogFiles: Bloom filter bits per distinct word/component in each block, for tools/log_query (0 = none)
+
+        RotationPolicy rotationPolicy = RotationPolicy::SIZE;         ///< Size, time or combined rotation
+        RotationInterval rotationInterval = RotationInterval::HOURLY; ///< Time rotation period; files are named after its start
+        uint32_t rotationPrepareMs = 1000;                            ///< Time rotation: open the next file this long before the boundary
+
+        /// Level-tiered retention, e.g. {{24, LogLevel::WARNING}, {24 * 7, LogLevel::ERROR}}: rotated files
+        /// older than a day keep WARNING and above, older than a week ERROR and above. A background pass
+        /// rewrites aged files and merges the results into files of up to maxFileSize (not with recycleLogFiles).
+        std::vector<RetentionTier> retentionTiers;
+        uint32_t retentionMaxAgeHours = 0;              ///< Delete rotated and compacted files older than this (0 = keep)
+        uint32_t compactionIntervalMs = 10 * 60 * 1000; ///< Time between compaction passes
 
         bool asyncLogging = true;           ///< Enable async logging
         bool enableColors = true;           ///< Enable console colors
@@ -104,6 +263,50 @@ namespace embedded_logger
         std::string timestampFormat = "%Y-%m-%d %H:%M:%S"; ///< Timestamp format
         std::string logFilePrefix = "embedded_log";        ///< Log file prefix
         std::string logFileExtension = ".txt";             ///< Log file extension
+
+        /// Per-component levels for dotted hierarchical names, e.g. {"BMS", WARNING}, {"BMS.Cell", DEBUG}.
+        /// A component inherits the level of its longest configured prefix; a matching level
+        /// applies to all outputs in place of consoleLogLevel/fileLogLevel.
+        std::map<std::string, LogLevel> componentLevels;
+
+        size_t maxBinaryPayloadSize = 256; ///< Bytes copied per logBinary() call, the rest is counted only
+
+        bool captureBacktraces = false;            ///< Attach raw return addresses to severe entries (Linux, symbolize offline)
+        LogLevel backtraceLevel = LogLevel::ERROR; ///< Lowest level that captures a backtrace
+        size_t backtraceDepth = 16;                ///< Frames kept per entry (at most BacktraceCapture::kMaxDepth)
+
+        bool forkSafe = true;                                       ///< Install fork() handlers (POSIX only)
+        ForkChildMode forkChildMode = ForkChildMode::SEPARATE_FILE; ///< Child process behaviour after fork()
+        uint32_t forkDrainTimeoutMs = 1000;                         ///< Longest wait for the writer before fork(); then fork undrained
+        size_t multiProcessRingSlots = 1024;                        ///< Shared ring capacity (PARENT_RING mode and named rings)
+
+        SharedRingRole sharedRingRole = SharedRingRole::NONE; ///< Cross-process ring role
+        std::string sharedRingName = "/embedded_logger";      ///< shm_open() name of the cross-process ring
+        uint32_t sharedRingStallTimeoutMs = 100;              ///< Collector skips slots left uncommitted this long
+
+        std::string streamSocketPath;                    ///< UNIX socket for live subscribers (empty = off, POSIX)
+        uint16_t streamTcpPort = 0;                      ///< TCP loopback port for live subscribers (0 = off)
+        size_t streamSubscriberBufferSize = 64 * 1024;   ///< Per-subscriber buffer in bytes
+        size_t streamMaxSubscribers = 8;                 ///< Concurrent subscriber limit
+        bool streamDisconnectSlowSubscribers = true;     ///< Disconnect (true) or drop entries for (false) slow subscribers
+
+        bool adaptiveVerbosity = false;          ///< Shed DEBUG/INFO automatically when the writer falls behind
+        size_t adaptiveQueueHighWatermark = 512; ///< Queue depth that counts as overload
+        size_t adaptiveQueueLowWatermark = 64;   ///< Queue depth that counts as recovered
+        uint32_t adaptiveLagHighMs = 500;        ///< Writer lag (entry age when written) that counts as overload
+        uint32_t adaptiveLagLowMs = 50;          ///< Writer lag that counts as recovered
+        uint32_t adaptiveSampleRate = 10;        ///< Keep 1-in-N DEBUG/INFO per component while SAMPLING (<= 1 skips SAMPLING)
+        uint32_t adaptiveHoldMs = 1000;          ///< Minimum time in a state before escalating further or restoring
+
+        uint32_t debugBurstMs = 0;                   ///< After an ERROR/CRITICAL, log the failing component at debugBurstLevel for this long (0 = off)
+        LogLevel debugBurstLevel = LogLevel::DEBUG;  ///< Level during a burst; like a componentLevels entry, it applies to console and file
+        std::vector<std::string> debugBurstTriggers; ///< Components (and their dotted sub-components) whose errors start a burst (empty = any)
+        bool debugBurstGlobal = false;               ///< A burst lowers every component, not only the failing one
+
+        size_t emergencyFlushBlockSize = 4096; ///< emergencyFlush(): bytes per write; the deadline is checked between writes
+
+        uint32_t writerStallTimeoutMs = 0; ///< Degrade when a file write has not returned for this long, e.g. a hung SD card (0 = off)
+        size_t degradedRingEntries = 1024; ///< Degraded mode: newest file entries held in RAM until the writer recovers
     };
 
     /**
@@ -127,8 +330,38 @@ namespace embedded_logger
         virtual uint64_t getUnixTimestampMs() = 0;
     };
 
+    /**
+     * @brief Opaque handle to an open file, owned by the IFileSystem that returned it
+     */
+    using FileHandle = intptr_t;
+
+    /// Returned by IFileSystem::openFile() on failure
+    constexpr FileHandle kInvalidFileHandle = -1;
+
+    /**
+     * @brief How IFileSystem::openFile() treats existing contents
+     */
+    enum class FileOpenMode : uint8_t
+    {
+        APPEND = 0,   ///< Create if missing, write at the end
+        TRUNCATE = 1, ///< Create if missing, discard existing contents
+        OVERWRITE = 2 ///< Create if missing, write from the start over existing contents
+    };
+
+    /**
+     * @brief One piece of a gathered write
+     */
+    struct WriteBuffer
+    {
+        const void *data; ///< Bytes to write
+        size_t size;      ///< Number of bytes
+    };
+
     /**
      * @brief Platform-specific file system interface
+     * @details All log file I/O goes through this interface. The write methods
+     *          have stdio-based defaults, so a backend only needs to override
+     *          them to reach its native API (raw fds, FATFS, LittleFS, flash).
      */
     class IFileSystem
     {
@@ -170,6 +403,90 @@ namespace embedded_logger
          * @return true if successful
          */
         virtual bool renameFile(const std::string &oldPath, const std::string &newPath) = 0;
+
+        /**
+         * @brief Open a file for writing
+         * @param path File path
+         * @param mode Append to or truncate existing contents
+         * @return Handle, or kInvalidFileHandle on failure
+         */
+        virtual FileHandle openFile(const std::string &path, FileOpenMode mode);
+
+        /**
+         * @brief Append bytes to an open file
+         * @param handle Handle from openFile()
+         * @param data Bytes to write
+         * @param size Number of bytes
+         * @return true if every byte was written
+         */
+        virtual bool appendFile(FileHandle handle, const void *data, size_t size);
+
+        /**
+         * @brief Append several buffers in one call (writev semantics)
+         * @param handle Handle from openFile()
+         * @param buffers Buffers, written in order
+         * @param count Number of buffers
+         * @return true if every byte was written
+         * @note The default calls appendFile() per buffer
+         */
+        virtual bool appendFileV(FileHandle handle, const WriteBuffer *buffers, size_t count);
+
+        /**
+         * @brief Write bytes at a fixed offset without moving the append position
+         * @param handle Handle from openFile()
+         * @param offset File offset
+         * @param data Bytes to write
+         * @param size Number of bytes
+         * @return true if every byte was written
+         */
+        virtual bool writeFileAt(FileHandle handle, uint64_t offset, const void *data, size_t size);
+
+        /**
+         * @brief Reserve disk space for a file up front
+         * @param handle Handle from openFile()
+         * @param size File size to allocate
+         * @return true if the space is allocated; false if unsupported (the caller writes zeros)
+         */
+        virtual bool preallocateFile(FileHandle handle, uint64_t size);
+
+        /**
+         * @brief Make written data durable (fsync)
+         * @param handle Handle from openFile()
+         * @return true if successful
+         */
+        virtual bool syncFile(FileHandle handle);
+
+        /**
+         * @brief Close an open file
+         * @param handle Handle from openFile()
+         */
+        virtual void closeFile(FileHandle handle);
+
+        /**
+         * @brief List the entries of a directory
+         * @param path Directory path
+         * @param names Receives entry names without the directory (appended, excludes "." and "..")
+         * @return true if the directory could be read
+         * @note The default returns false (not supported)
+         */
+        virtual bool listDirectory(const std::string &path, std::vector<std::string> &names);
+
+        /**
+         * @brief Get the time a file was last written
+         * @param path File path
+         * @param unixTimeMs Receives the modification time in Unix milliseconds
+         * @return true if known
+         * @note The default returns false (not supported)
+         */
+        virtual bool getFileModifiedTime(const std::string &path, uint64_t &unixTimeMs);
+
+        /**
+         * @brief Check whether paths refer to the local OS file system
+         * @details Logger only bypasses the file system interface for direct
+         *          I/O (LoggerConfig::directFileIo) when this returns true.
+         * @return true for the built-in POSIX file system
+         */
+        virtual bool supportsDirectIo() { return false; }
     };
 
     /**
@@ -184,8 +501,13 @@ namespace embedded_logger
      * - Thread-safe operation
      * - Asynchronous logging to prevent blocking
      * - Configurable formatting
-     * - Component-based filtering
+     * - Component-based filtering with dotted hierarchical levels
+     * - Binary blob logging with deferred hex encoding
+     * - Thread-local diagnostic context (EL_CONTEXT) rendered with each entry
      * - Cross-platform support (ESP32, STM32, Arduino, Linux, Windows)
+     * - Fork-safe on POSIX, with optional parent-drained shared ring for children
+     * - Live streaming to local subscribers (UNIX socket / TCP loopback)
+     * - Adaptive verbosity: sheds DEBUG/INFO under load and restores it afterwards
      *
      * @example Basic usage
      * @code
@@ -254,6 +576,11 @@ namespace embedded_logger
         LoggerConfig getConfig() const;
 
         // Main logging methods
+        //
+        // Calls taking a component name look it up in a per-thread hash map on
+        // every call (one string hash and compare) before the level check. On hot
+        // paths resolve the name once with registerComponent() and pass the
+        // ComponentId instead.
 
         /**
          * @brief Log a debug message
@@ -300,6 +627,167 @@ namespace embedded_logger
         void critical(const std::string &component, const std::string &message,
                       LogDestination destination = LogDestination::BOTH);
 
+        /**
+         * @brief Log a message through a component handle
+         * @param level Log level
+         * @param component Component handle from registerComponent()
+         * @param message Log message
+         * @param destination Output destination override
+         */
+        void log(LogLevel level, ComponentId component, const std::string &message,
+                 LogDestination destination = LogDestination::BOTH);
+
+        /**
+         * @brief Log a message that is built only if the level/component filter passes
+         * @details makeMessage runs on this thread, after filtering and before
+         *          the entry is queued, so it may capture by reference.
+         * @code
+         * logger->logLazy(LogLevel::DEBUG, "NAV", [&] { return "pos=" + pos.toString(); });
+         * @endcode
+         * @param level Log level
+         * @param component Component name
+         * @param makeMessage Callable returning the message (std::string or convertible)
+         * @param destination Output destination override
+         */
+        template <typename MessageFn>
+        void logLazy(LogLevel level, const std::string &component, MessageFn &&makeMessage,
+                     LogDestination destination = LogDestination::BOTH)
+        {
+            uint16_t id;
+            uint32_t gate;
+            if (admit(level, component, id, gate))
+            {
+                LogEntry entry(level, component, makeMessage());
+                enqueueAdmitted(entry, id, gate, destination);
+            }
+        }
+
+        /** @brief Log a lazily built message through a component handle */
+        template <typename MessageFn>
+        void logLazy(LogLevel level, ComponentId component, MessageFn &&makeMessage,
+                     LogDestination destination = LogDestination::BOTH)
+        {
+            uint16_t id;
+            uint32_t gate;
+            if (admit(level, component, id, gate))
+            {
+                LogEntry entry(level, componentNames_[id], makeMessage());
+                enqueueAdmitted(entry, id, gate, destination);
+            }
+        }
+
+        /**
+         * @brief Log a message that the writer thread builds
+         * @details Like logLazy(), but with asyncLogging the callable is queued
+         *          and called by the writer just before formatting, taking the
+         *          formatting cost off the caller. It must therefore capture by
+         *          value (or reference data that outlives the call). In sync
+         *          mode, forked children and degraded mode it runs on this thread.
+         * @warning The callable must not log. On the writer it runs while
+         *          fork() handlers wait for the writer to go idle, so entries
+         *          logged from it are dropped with a console notice.
+         * @param level Log level
+         * @param component Component name
+         * @param makeMessage Callable returning the message (std::string or convertible)
+         * @param destination Output destination override
+         */
+        template <typename MessageFn>
+        void logDeferred(LogLevel level, const std::string &component, MessageFn makeMessage,
+                         LogDestination destination = LogDestination::BOTH)
+        {
+            uint16_t id;
+            uint32_t gate;
+            if (admit(level, component, id, gate))
+            {
+                LogEntry entry(level, component, std::string());
+                entry.deferredMessage = std::move(makeMessage);
+                enqueueAdmitted(entry, id, gate, destination);
+            }
+        }
+
+        /** @brief Log a writer-built message through a component handle */
+        template <typename MessageFn>
+        void logDeferred(LogLevel level, ComponentId component, MessageFn makeMessage,
+                         LogDestination destination = LogDestination::BOTH)
+        {
+            uint16_t id;
+            uint32_t gate;
+            if (admit(level, component, id, gate))
+            {
+                LogEntry entry(level, componentNames_[id], std::string());
+                entry.deferredMessage = std::move(makeMessage);
+                enqueueAdmitted(entry, id, gate, destination);
+            }
+        }
+
+        /** @brief Log a debug message through a component handle */
+        void debug(ComponentId component, const std::string &message,
+                   LogDestination destination = LogDestination::BOTH);
+
+        /** @brief Log an info message through a component handle */
+        void info(ComponentId component, const std::string &message,
+                  LogDestination destination = LogDestination::BOTH);
+
+        /** @brief Log a warning message through a component handle */
+        void warning(ComponentId component, const std::string &message,
+                     LogDestination destination = LogDestination::BOTH);
+
+        /** @brief Log an error message through a component handle */
+        void error(ComponentId component, const std::string &message,
+                   LogDestination destination = LogDestination::BOTH);
+
+        /** @brief Log a critical message through a component handle */
+        void critical(ComponentId component, const std::string &message,
+                      LogDestination destination = LogDestination::BOTH);
+
+        /**
+         * @brief Check whether an entry would pass the level filter
+         * @param level Log level
+         * @param component Component handle
+         * @return true if an entry with this level and component would be logged
+         * @note Single table load; sampling state is not advanced
+         */
+        bool isEnabled(LogLevel level, ComponentId component) const;
+
+        /**
+         * @brief Set the level of a (dotted) component subtree at runtime
+         * @param component Component name or prefix, e.g. "BMS.Cell"
+         * @param level Minimum level for the subtree
+         * @note Rebuilds the component table; not intended for hot paths
+         */
+        void setComponentLevel(const std::string &component, LogLevel level);
+
+        /**
+         * @brief Remove a runtime or configured component level
+         * @param component Component name or prefix
+         */
+        void clearComponentLevel(const std::string &component);
+
+        /**
+         * @brief Log a raw binary blob (CAN frame, SPI transaction, radio packet)
+         * @details The producer only copies the bytes into the entry; hex encoding
+         *          happens on the writer thread. Binary sinks (shared ring, binary
+         *          stream subscribers) carry the bytes verbatim.
+         * @param level Log level
+         * @param component Component name
+         * @param data Bytes to log
+         * @param size Number of bytes (copied up to maxBinaryPayloadSize)
+         * @param message Optional description printed before the dump
+         */
+        void logBinary(LogLevel level, const std::string &component, const void *data, size_t size,
+                       const std::string &message = std::string());
+
+        /**
+         * @brief Log a raw binary blob through a component handle
+         * @param level Log level
+         * @param component Component handle
+         * @param data Bytes to log
+         * @param size Number of bytes (copied up to maxBinaryPayloadSize)
+         * @param message Optional description printed before the dump
+         */
+        void logBinary(LogLevel level, ComponentId component, const void *data, size_t size,
+                       const std::string &message = std::string());
+
         /**
          * @brief Log formatted message with printf-style formatting
          * @param level Log level
@@ -327,6 +815,31 @@ namespace embedded_logger
          */
         void flush();
 
+        /**
+         * @brief Write the most important pending entries before a deadline
+         * @details For a power-fail warning: from now on only ERROR and
+         *          CRITICAL entries are accepted, until endEmergency(). Pending
+         *          entries are written severest first in writes of at most
+         *          emergencyFlushBlockSize bytes, checking the deadline before
+         *          each, and the file is synced if time remains. Console output
+         *          and rotation are skipped.
+         * @param deadline Time by which the last write must have started
+         * @return How far the flush got
+         * @note Call from a thread, not from interrupt or signal context: it takes
+         *       the logger's locks (giving up at the deadline) and formats entries.
+         *       On an MCU, wake a task from the power-fail interrupt.
+         */
+        EmergencyFlushReport emergencyFlush(std::chrono::steady_clock::time_point deadline);
+
+        /**
+         * @brief Accept every level again after emergencyFlush()
+         * @details For when the supply recovers (a brown-out rather than a
+         *          power loss). Logs a LOGGER warning that the emergency ended;
+         *          does nothing if no emergency is in effect. updateConfig()
+         *          does not end an emergency.
+         */
+        void endEmergency();
+
         // Status and statistics
 
         /**
@@ -341,6 +854,29 @@ namespace embedded_logger
          */
         size_t getTotalLogCount() const;
 
+        /**
+         * @brief Get current adaptive verbosity state
+         * @return NORMAL unless LoggerConfig::adaptiveVerbosity is shedding load
+         */
+        AdaptiveVerbosityState getAdaptiveState() const;
+
+        /**
+         * @brief Get number of entries discarded by the adaptive controller
+         * @return Sampled-out and shed entry count
+         */
+        size_t getAdaptiveDroppedCount() const;
+
+        /**
+         * @brief Check if the file writer is stalled
+         * @details Set when a file write has not returned within
+         *          LoggerConfig::writerStallTimeoutMs. Until the write returns,
+         *          entries bypass the queue: console output is written by the
+         *          caller and file entries are held in a RAM ring, then written
+         *          to the file on recovery.
+         * @return true while in degraded mode
+         */
+        bool isWriterDegraded() const;
+
         /**
          * @brief Check if logger is initialized
          * @return true if initialized and ready
@@ -363,6 +899,47 @@ namespace embedded_logger
          */
         static std::shared_ptr<Logger> getGlobalLogger();
 
+        /**
+         * @brief Create the platform's default file system provider
+         * @return File system used when none is passed to a logger or sink
+         */
+        static std::unique_ptr<IFileSystem> createDefaultFileSystem();
+
+        /**
+         * @brief Read a log file written by this library
+         * @details Recycled files (LoggerConfig::recycleLogFiles) are overwritten
+         *          in place and keep stale bytes past their end; only the length
+         *          recorded in their "# Valid-Length:" header line is returned.
+         *          That line is rewritten every validLengthUpdateBytes and on
+         *          flush(), rotation and shutdown, so after a power loss up to
+         *          that many of the newest bytes are not returned.
+         *          Compressed files (LoggerConfig::compressLogFiles) are returned
+         *          decompressed; a block torn by power loss ends the contents.
+         * @param path File path
+         * @param contents Receives the valid contents
+         * @param dictionary Dictionary the file was compressed with, if any
+         * @return true if the file could be read
+         */
+        static bool readLogFile(const std::string &path, std::string &contents,
+                                const LogDictionary *dictionary = nullptr);
+
+        /**
+         * @brief Register a component name and get its handle
+         * @param name Dotted component name, e.g. "BMS.Cell.Balancer"
+         * @return Stable handle, shared by all logger instances
+         * @note Thread-safe. Registering the same name again returns the same handle.
+         *       Logging by name looks the handle up in a per-thread cache, so
+         *       only a thread's first use of a name takes the registry lock.
+         */
+        static ComponentId registerComponent(const std::string &name);
+
+        /**
+         * @brief Get the name of a registered component
+         * @param component Component handle
+         * @return Component name (empty for the default slot)
+         */
+        static std::string getComponentName(ComponentId component);
+
     private:
         // Configuration and platform providers
         LoggerConfig config_;
@@ -372,20 +949,105 @@ namespace embedded_logger
         // State management
         std::atomic<bool> initialized_;
         std::atomic<bool> shutdownRequested_;
+        // Lock order: queueMutex_, fileMutex_, configMutex_ (as prepareForFork() takes them).
+        // The writer releases queueMutex_ before anything that takes configMutex_.
         mutable std::mutex configMutex_;
 
         // File management
         std::string currentLogFile_;
         size_t currentFileSize_;
-        std::unique_ptr<std::ofstream> currentLogStream_;
+        FileHandle currentLogHandle_;
+        std::string fileBuffer_; ///< Formatted lines not yet handed to the file system
+        std::unique_ptr<DirectFileSink> directSink_; ///< Replaces currentLogHandle_ when directFileIo is active
+        bool recycleFiles_;                          ///< recycleLogFiles in effect
+        size_t fileValidLength_;                     ///< Recycled files: bytes written since the header, header included
+        size_t fileValidLengthOnDisk_;               ///< Recycled files: length last recorded in the header
+        std::unique_ptr<LogBlockCodec> blockCodec_;  ///< Compresses each batch when compressLogFiles is set
+        std::string blockBuffer_;                    ///< Compressed form of fileBuffer_
+        std::vector<uint64_t> blockTokens_;          ///< Filter tokens of fileBuffer_ (blockFilterBitsPerToken)
         mutable std::mutex fileMutex_;
 
         // Asynchronous logging
         std::queue<LogEntry> logQueue_;
         std::mutex queueMutex_;
         std::condition_variable queueCondition_;
+        std::condition_variable drainCondition_;
+        bool workerBusy_;
         std::thread loggerThread_;
 
+        // Multi-process support
+        std::unique_ptr<SharedLogRing> sharedRing_;
+        std::atomic<bool> ringProducer_;
+        bool rotationEnabled_;
+        bool forkQuiesced_; ///< prepareForFork() drained the writer and holds fileMutex_
+        std::atomic<bool> forkRestartPending_; ///< Forked child: finishForkChild() runs on the first log call
+        ForkChildMode forkRestartMode_;        ///< What finishForkChild() restarts
+        bool forkDiscardQueue_;                ///< Forked mid-write: the queued entries are the parent's
+        std::mutex forkRestartMutex_;
+
+        // Time-based rotation: one integer comparison per entry against the next step
+        static constexpr uint64_t kNoRotationTick = UINT64_MAX;
+        std::atomic<uint64_t> nextRotationTick_; ///< Unix ms of the next prepare or switch step (kNoRotationTick = size only)
+        uint64_t rotationBoundaryMs_;            ///< Start of the next period
+        FileHandle preparedHandle_;              ///< Next period's file, opened ahead of the boundary
+        std::string preparedFile_;
+        std::string fileNameSuffix_;
+        bool pruneListWarned_; ///< The log directory could not be listed (reported once per logger)
+
+        // Live subscribers
+        std::unique_ptr<LogStreamServer> streamServer_;
+
+        // Tiered retention
+        std::unique_ptr<LogCompactor> compactor_;
+        std::thread compactionThread_;
+        std::mutex compactionMutex_;
+        std::condition_variable compactionCondition_;
+        std::atomic<bool> compactionStopping_;
+
+        // Component gate table, one packed word per registered component:
+        // bits 0-3 effective minimum level, bits 4-7 minimum level before adaptive shedding,
+        // bit 8 explicit component level, bit 9 errors start a debug burst,
+        // bits 16-31 sample rate (<= 1 = off).
+        // Without an explicit level and with no stream subscribers the minimum also covers
+        // the lower of the console and file levels, so one compare rejects what no sink takes.
+        // Rebuilt only when levels, the adaptive state or the presence of subscribers change.
+        static constexpr size_t kMaxComponents = EMBEDDED_LOGGER_MAX_COMPONENTS;
+        static constexpr uint32_t kGateUnresolved = 0xFFFFFFFF;
+        static constexpr uint32_t kGateExplicit = 0x100;
+        static constexpr uint32_t kGateBurstTrigger = 0x200;
+        mutable std::array<std::atomic<uint32_t>, kMaxComponents> componentGates_;
+        std::array<std::atomic<uint32_t>, kMaxComponents> sampleCounters_;
+        uint16_t loggerComponent_; ///< "LOGGER", resolved up front so the writer never takes the registry lock
+
+        // Adaptive verbosity
+        std::atomic<AdaptiveVerbosityState> adaptiveState_;
+        uint64_t adaptiveStateSinceMs_;
+        std::atomic<size_t> adaptiveDroppedCount_;
+
+        // Stalled-writer watchdog, checked by producers so a stuck writer needs no extra thread
+        std::atomic<uint64_t> fileWriteStartedMs_; ///< Start of the file operation in progress (0 = none)
+        std::atomic<bool> writerDegraded_;
+        uint64_t degradedSinceMs_;
+        std::deque<LogEntry> degradedRing_; ///< File entries held while the writer is stalled
+        size_t degradedDroppedCount_;      ///< Oldest entries pushed out of degradedRing_
+        std::mutex degradedMutex_;
+
+        // Power-fail emergency: only ERROR/CRITICAL pass the gates until endEmergency()
+        std::atomic<bool> emergency_;
+
+        // Debug bursts, folded into the gates so the hot path is unchanged
+        struct DebugBurst
+        {
+            uint64_t startMs;
+            size_t window; ///< Index into burstWindows_
+        };
+        static constexpr uint64_t kNoDebugBurst = UINT64_MAX;
+        std::map<std::string, DebugBurst> debugBursts_; ///< Component ("" = all) -> window; guarded by configMutex_
+        std::atomic<uint64_t> nextBurstEndMs_;          ///< Earliest burst end (kNoDebugBurst = none)
+        // End of the open burst per triggering component, the last slot for a global
+        // burst (0 = none). Errors inside a burst extend it here without configMutex_.
+        std::array<std::atomic<uint64_t>, kMaxComponents + 1> burstWindows_;
+
         // Statistics
         std::atomic<size_t> totalLogCount_;
 
@@ -393,14 +1055,78 @@ namespace embedded_logger
         static std::shared_ptr<Logger> globalLogger_;
         static std::mutex globalLoggerMutex_;
 
+        // Process-wide component registry. Names are written once before the
+        // count is published, so handle-to-name lookups need no lock.
+        static std::array<std::string, kMaxComponents> componentNames_;
+        static std::atomic<uint16_t> componentCount_;
+        static std::unordered_map<std::string, uint16_t> componentIndex_;
+        static std::mutex componentRegistryMutex_;
+
+        // Loggers that must be quiesced around fork()
+        static std::vector<Logger *> forkRegistry_;
+        static std::mutex forkRegistryMutex_;
+
         // Internal methods
         void log(const LogEntry &entry, LogDestination destination);
         void processLogEntry(const LogEntry &entry, LogDestination destination);
         void writeToConsole(const LogEntry &entry);
         void writeToFile(const LogEntry &entry);
+        void appendToFileBuffer(const LogEntry &entry);
         void rotateLogFileIfNeeded();
-        bool createNewLogFile();
+        void rotateLogFile(const std::string &fileName);
+        void scheduleTimeRotation(uint64_t nowMs);
+        void rotateOnTime(uint64_t nowMs);
+        void pruneRotatedFiles();
+        void discardPreparedFile();
+        std::string logFileNameAt(const std::string &timestamp) const;
+        bool createNewLogFile(const std::string &fileName = std::string());
+        bool openLogFile(FileOpenMode mode = FileOpenMode::APPEND);
+        void writeFileHeader();
+        bool recycleLogFile();
+        void preallocateLogFile();
+        bool isLogFileOpen() const;
+        void writeFileBuffer();
+        void writeFileData(const std::string &data);
+        void writeValidLength();
+        void closeLogFile();
         void loggerThreadFunction();
+        void notifyWriter();
+        void drainSharedRing();
+        void compactionThreadFunction();
+        void stopCompaction();
+        void enqueueEntry(LogEntry &entry, LogDestination destination);
+        void logPayload(LogLevel level, uint16_t componentId, const std::string &component,
+                        const void *data, size_t size, const std::string &message);
+        bool passesGate(LogLevel level, uint16_t componentId, uint32_t &gate);
+        bool admit(LogLevel level, const std::string &component, uint16_t &componentId, uint32_t &gate);
+        bool admit(LogLevel level, ComponentId component, uint16_t &componentId, uint32_t &gate);
+        bool reachesSink(const LogEntry &entry, LogDestination destination) const;
+        void enqueueAdmitted(LogEntry &entry, uint16_t componentId, uint32_t gate, LogDestination destination);
+        static void resolveDeferredMessage(LogEntry &entry);
+        uint32_t resolveComponentGate(uint16_t componentId) const;
+        uint32_t computeComponentGate(const std::string &name) const;
+        void rebuildComponentGates();
+        static uint16_t lookupComponent(const std::string &name);
+        void updateAdaptiveVerbosity(size_t queueDepth, uint64_t entryTimestampMs);
+        void setAdaptiveState(AdaptiveVerbosityState state, size_t queueDepth, uint64_t lagMs, uint64_t nowMs);
+        bool holdWhileWriterStalled(LogEntry &entry, LogDestination destination);
+        bool inDebugBurst(const std::string &name) const;
+        void startDebugBurst(const LogEntry &entry);
+        void endDebugBursts(uint64_t nowMs);
+        void logInternal(LogLevel level, const std::string &message);
+        void recoverStalledWriter();
+
+        // fork() handling
+        void registerForFork();
+        void unregisterForFork();
+        void prepareForFork();
+        void resumeAfterForkParent();
+        void resumeAfterForkChild();
+        void finishForkChild();
+        void replaceDirectSinkAfterFork();
+        static void atForkPrepare();
+        static void atForkParent();
+        static void atForkChild();
         LogEntry createLogEntry(LogLevel level, const std::string &component,
                                 const std::string &message);
         std::string formatLogEntry(const LogEntry &entry, bool includeColors = false);
@@ -412,7 +1138,6 @@ namespace embedded_logger
 
         // Default platform providers
         std::unique_ptr<ITimeProvider> createDefaultTimeProvider();
-        std::unique_ptr<IFileSystem> createDefaultFileSystem();
     };
 
     /**
@@ -502,6 +1227,31 @@ namespace embedded_logger
         logger->critical(component, message);                     \
     }
 
+/**
+ * @brief Define a function-local component handle, registered once
+ * @param handle Variable name for the handle
+ * @param name Dotted component name
+ * @code
+ * EL_DEFINE_COMPONENT(kBalancer, "BMS.Cell.Balancer");
+ * EL_DEBUG(kBalancer, "Balancing cell 3");
+ * @endcode
+ */
+#define EL_DEFINE_COMPONENT(handle, name) \
+    static const embedded_logger::ComponentId handle = embedded_logger::Logger::registerComponent(name)
+
+/**
+ * @brief Log a binary blob as a hex dump using global logger
+ * @param level Log level
+ * @param component Component name or handle
+ * @param data Pointer to the bytes
+ * @param size Number of bytes
+ */
+#define EL_BINARY(level, component, data, size)                   \
+    if (auto logger = embedded_logger::Logger::getGlobalLogger()) \
+    {                                                             \
+        logger->logBinary(level, component, data, size);          \
+    }
+
 // Formatted logging macros
 
 /**
@@ -540,4 +1290,155 @@ namespace embedded_logger
         logger->logf(embedded_logger::LogLevel::ERROR, component, format, ##__VA_ARGS__); \
     }
 
+// Conditional and periodic logging macros. Each call site keeps its own static
+// counter; iterations that do not log cost one relaxed atomic operation and a
+// branch (EVERY_MS also reads the steady clock) and never touch the global
+// logger or evaluate the message.
+
+/// @cond
+#define EL_LOG_EVERY_N_IMPL(method, n, component, message)                                              \
+    do                                                                                                  \
+    {                                                                                                   \
+        static std::atomic<uint32_t> elSiteCalls(0);                                                    \
+        const uint32_t elSiteEvery = static_cast<uint32_t>(n);                                          \
+        uint32_t elSiteCall = elSiteCalls.fetch_add(1, std::memory_order_relaxed);                      \
+        if (elSiteEvery != 0 && elSiteCall % elSiteEvery == 0)                                          \
+        {                                                                                               \
+            if (auto logger = embedded_logger::Logger::getGlobalLogger())                               \
+            {                                                                                           \
+                logger->method(component, message);                                                     \
+            }                                                                                           \
+        }                                                                                               \
+    } while (0)
+
+#define EL_LOG_EVERY_MS_IMPL(method, intervalMs, component, message)                                    \
+    do                                                                                                  \
+    {                                                                                                   \
+        static std::atomic<int64_t> elSiteNextMs(0);                                                    \
+        int64_t elSiteNowMs = std::chrono::duration_cast<std::chrono::milliseconds>(                    \
+                                  std::chrono::steady_clock::now().time_since_epoch())                  \
+                                  .count();                                                             \
+        int64_t elSiteNext = elSiteNextMs.load(std::memory_order_relaxed);                              \
+        if (elSiteNowMs >= elSiteNext &&                                                                \
+            elSiteNextMs.compare_exchange_strong(elSiteNext, elSiteNowMs + (intervalMs),                \
+                                                 std::memory_order_relaxed))                            \
+        {                                                                                               \
+            if (auto logger = embedded_logger::Logger::getGlobalLogger())                               \
+            {                                                                                           \
+                logger->method(component, message);                                                     \
+            }                                                                                           \
+        }                                                                                               \
+    } while (0)
+
+#define EL_LOG_FIRST_N_IMPL(method, n, component, message)                                              \
+    do                                                                                                  \
+    {                                                                                                   \
+        static std::atomic<uint32_t> elSiteEmitted(0);                                                  \
+        const uint32_t elSiteLimit = static_cast<uint32_t>(n);                                          \
+        if (elSiteEmitted.load(std::memory_order_relaxed) < elSiteLimit &&                              \
+            elSiteEmitted.fetch_add(1, std::memory_order_relaxed) < elSiteLimit)                        \
+        {                                                                                               \
+            if (auto logger = embedded_logger::Logger::getGlobalLogger())                               \
+            {                                                                                           \
+                logger->method(component, message);                                                     \
+            }                                                                                           \
+        }                                                                                               \
+    } while (0)
+
+#define EL_LOG_IF_IMPL(method, condition, component, message)                                           \
+    do                                                                                                  \
+    {                                                                                                   \
+        if (condition)                                                                                  \
+        {                                                                                               \
+            if (auto logger = embedded_logger::Logger::getGlobalLogger())                               \
+            {                                                                                           \
+                logger->method(component, message);                                                     \
+            }                                                                                           \
+        }                                                                                               \
+    } while (0)
+/// @endcond
+
+/**
+ * @brief Log on the 1st, (n+1)th, (2n+1)th... pass through this call site
+ * @details EL_DEBUG_EVERY_N, EL_INFO_EVERY_N, EL_WARNING_EVERY_N, EL_ERROR_EVERY_N.
+ *          Passes are counted with one atomic increment, so threads sharing a
+ *          call site still log exactly one pass in n. n may be a runtime value;
+ *          n == 0 never logs. Unless n is a power of two, the period shifts once
+ *          when the 32-bit pass counter wraps.
+ * @code
+ * EL_INFO_EVERY_N(100, "NAV", "Iteration " + std::to_string(i)); // string built every 100th pass only
+ * @endcode
+ */
+#define EL_INFO_EVERY_N(n, component, message) EL_LOG_EVERY_N_IMPL(info, n, component, message)
+#define EL_DEBUG_EVERY_N(n, component, message) EL_LOG_EVERY_N_IMPL(debug, n, component, message)
+#define EL_WARNING_EVERY_N(n, component, message) EL_LOG_EVERY_N_IMPL(warning, n, component, message)
+#define EL_ERROR_EVERY_N(n, component, message) EL_LOG_EVERY_N_IMPL(error, n, component, message)
+
+/**
+ * @brief Log at most once per interval (steady clock milliseconds) from this call site
+ * @details EL_DEBUG_EVERY_MS, EL_INFO_EVERY_MS, EL_WARNING_EVERY_MS, EL_ERROR_EVERY_MS.
+ *          The first pass logs; with several threads exactly one logs per interval.
+ */
+#define EL_INFO_EVERY_MS(intervalMs, component, message) EL_LOG_EVERY_MS_IMPL(info, intervalMs, component, message)
+#define EL_DEBUG_EVERY_MS(intervalMs, component, message) EL_LOG_EVERY_MS_IMPL(debug, intervalMs, component, message)
+#define EL_WARNING_EVERY_MS(intervalMs, component, message) EL_LOG_EVERY_MS_IMPL(warning, intervalMs, component, message)
+#define EL_ERROR_EVERY_MS(intervalMs, component, message) EL_LOG_EVERY_MS_IMPL(error, intervalMs, component, message)
+
+/**
+ * @brief Log only the first n passes through this call site
+ * @details EL_DEBUG_FIRST_N, EL_INFO_FIRST_N, EL_WARNING_FIRST_N, EL_ERROR_FIRST_N.
+ *          n == 0 never logs.
+ */
+#define EL_INFO_FIRST_N(n, component, message) EL_LOG_FIRST_N_IMPL(info, n, component, message)
+#define EL_DEBUG_FIRST_N(n, component, message) EL_LOG_FIRST_N_IMPL(debug, n, component, message)
+#define EL_WARNING_FIRST_N(n, component, message) EL_LOG_FIRST_N_IMPL(warning, n, component, message)
+#define EL_ERROR_FIRST_N(n, component, message) EL_LOG_FIRST_N_IMPL(error, n, component, message)
+
+/**
+ * @brief Log only if condition holds; the message is not built otherwise
+ * @details EL_DEBUG_IF, EL_INFO_IF, EL_WARNING_IF, EL_ERROR_IF.
+ */
+#define EL_INFO_IF(condition, component, message) EL_LOG_IF_IMPL(info, condition, component, message)
+#define EL_DEBUG_IF(condition, component, message) EL_LOG_IF_IMPL(debug, condition, component, message)
+#define EL_WARNING_IF(condition, component, message) EL_LOG_IF_IMPL(warning, condition, component, message)
+#define EL_ERROR_IF(condition, component, message) EL_LOG_IF_IMPL(error, condition, component, message)
+
+/**
+ * @brief Log a message built by a callable, called only if the level/component filter passes
+ * @details EL_DEBUG_LAZY, EL_INFO_LAZY, EL_WARNING_LAZY, EL_ERROR_LAZY. The
+ *          callable runs on the calling thread and may capture by reference.
+ * @code
+ * EL_DEBUG_LAZY("NAV", [&] { return "pos=" + pos.toString(); });
+ * @endcode
+ */
+#define EL_DEBUG_LAZY(component, ...) EL_LOG_LAZY_IMPL(logLazy, DEBUG, component, __VA_ARGS__)
+#define EL_INFO_LAZY(component, ...) EL_LOG_LAZY_IMPL(logLazy, INFO, component, __VA_ARGS__)
+#define EL_WARNING_LAZY(component, ...) EL_LOG_LAZY_IMPL(logLazy, WARNING, component, __VA_ARGS__)
+#define EL_ERROR_LAZY(component, ...) EL_LOG_LAZY_IMPL(logLazy, ERROR, component, __VA_ARGS__)
+
+/**
+ * @brief As EL_*_LAZY, but the writer thread calls the callable (see Logger::logDeferred)
+ * @details EL_DEBUG_DEFERRED, EL_INFO_DEFERRED, EL_WARNING_DEFERRED, EL_ERROR_DEFERRED.
+ *          Capture by value, and do not log from the callable.
+ * @code
+ * EL_DEBUG_DEFERRED("NAV", [pos] { return "pos=" + pos.toString(); });
+ * @endcode
+ */
+#define EL_DEBUG_DEFERRED(component, ...) EL_LOG_LAZY_IMPL(logDeferred, DEBUG, component, __VA_ARGS__)
+#define EL_INFO_DEFERRED(component, ...) EL_LOG_LAZY_IMPL(logDeferred, INFO, component, __VA_ARGS__)
+#define EL_WARNING_DEFERRED(component, ...) EL_LOG_LAZY_IMPL(logDeferred, WARNING, component, __VA_ARGS__)
+#define EL_ERROR_DEFERRED(component, ...) EL_LOG_LAZY_IMPL(logDeferred, ERROR, component, __VA_ARGS__)
+
+/// @cond
+// The callable is variadic so capture lists with commas need no extra parentheses
+#define EL_LOG_LAZY_IMPL(method, level, component, ...)                                                 \
+    do                                                                                                  \
+    {                                                                                                   \
+        if (auto logger = embedded_logger::Logger::getGlobalLogger())                                   \
+        {                                                                                               \
+            logger->method(embedded_logger::LogLevel::level, component, __VA_ARGS__);                   \
+        }                                                                                               \
+    } while (0)
+/// @endcond
+
 #endif // EMBEDDED_LOGGER_NO_MACROS
\ No newline at end of file
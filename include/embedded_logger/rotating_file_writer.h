@@ -0,0 +1,166 @@
+/**
+ * @file rotating_file_writer.h
+ * @brief Size-rotated append-only file shared by the text logger and binary sinks
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ *
+ * @copyright Copyright (c) 2025 Unmanned Systems UK. All rights reserved.
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+
+#include "embedded_logger/logger.h"
+
+#include <cstdint>
+#include <string>
+
+namespace embedded_logger
+{
+
+    /**
+     * @brief Shift <path>.N backups up by one and move <path> to <path>.1
+     * @details Works with IFileSystem and with compile-time file system
+     *          policies (BasicLogger), which share the fileExists/deleteFile/
+     *          renameFile names.
+     * @param fileSystem File system or file system policy
+     * @param path Active file path
+     * @param maxBackupFiles Number of backups to keep
+     * @return true if the active file was moved
+     */
+    template <typename FileSystem>
+    bool shiftBackupFiles(FileSystem &fileSystem, const std::string &path, int maxBackupFiles)
+    {
+        // Rotate existing backup files
+        for (int i = maxBackupFiles - 1; i > 0; --i)
+        {
+            std::string oldFile = path + "." + std::to_string(i);
+            std::string newFile = path + "." + std::to_string(i + 1);
+
+            if (fileSystem.fileExists(oldFile))
+            {
+                if (i == maxBackupFiles - 1)
+                {
+                    fileSystem.deleteFile(newFile);
+                }
+                fileSystem.renameFile(oldFile, newFile);
+            }
+        }
+
+        // Move current file to .1
+        return fileSystem.renameFile(path, path + ".1");
+    }
+
+    /**
+     * @brief Append-only file with size-based rotation
+     * @details Uses the same backup scheme as Logger: when the file reaches
+     *          maxFileSize it becomes <path>.1, older backups shift up to
+     *          <path>.<maxBackupFiles>, and a fresh file is opened at <path>
+     *          starting with the configured header. Callers hand over whole
+     *          batches; rotation only happens between batches so a record is
+     *          never split across files.
+     * @note Not thread-safe; owned by a single writer thread.
+     */
+    class RotatingFileWriter
+    {
+    public:
+        /**
+         * @brief Constructor
+         * @param fileSystem File system used for renames and deletes (must outlive the writer)
+         * @param maxFileSize Rotate once the file reaches this many bytes
+         * @param maxBackupFiles Number of rotated backups to keep
+         */
+        RotatingFileWriter(IFileSystem &fileSystem, size_t maxFileSize, int maxBackupFiles);
+
+        /**
+         * @brief Destructor - closes the file
+         */
+        ~RotatingFileWriter();
+
+        RotatingFileWriter(const RotatingFileWriter &) = delete;
+        RotatingFileWriter &operator=(const RotatingFileWriter &) = delete;
+
+        /**
+         * @brief Open (or append to) a file
+         * @param path File path
+         * @param header Bytes written at the start of every new file (may be empty)
+         * @return true if the file is open
+         */
+        bool open(const std::string &path, const std::string &header);
+
+        /**
+         * @brief Append a batch, rotating afterwards if the size limit was reached
+         * @param data Bytes to write
+         * @param size Number of bytes
+         * @return true if the batch was written
+         */
+        bool write(const void *data, size_t size);
+
+        /**
+         * @brief Append several buffers as one batch (gathered write)
+         * @param buffers Buffers, written in order
+         * @param count Number of buffers
+         * @return true if the batch was written
+         */
+        bool write(const WriteBuffer *buffers, size_t count);
+
+        /**
+         * @brief Make written data durable (fsync)
+         * @return true if successful
+         */
+        bool sync();
+
+        /**
+         * @brief Close the file
+         */
+        void close();
+
+        /**
+         * @brief Check whether a file is open
+         * @return true if open
+         */
+        bool isOpen() const { return handle_ != kInvalidFileHandle; }
+
+        /**
+         * @brief Get the active file path
+         * @return File path
+         */
+        const std::string &getCurrentFile() const { return path_; }
+
+        /**
+         * @brief Get the size of the active file
+         * @return Size in bytes, header included
+         */
+        size_t getCurrentSize() const { return currentSize_; }
+
+        /**
+         * @brief Get the number of rotations since open()
+         * @return Rotation count; a change means the next write starts a new file
+         */
+        uint32_t getRotationCount() const { return rotationCount_; }
+
+        /**
+         * @brief Shift <path>.N backups up by one and move <path> to <path>.1
+         * @param fileSystem File system
+         * @param path Active file path
+         * @param maxBackupFiles Number of backups to keep
+         * @return true if the active file was moved
+         */
+        static bool shiftBackups(IFileSystem &fileSystem, const std::string &path, int maxBackupFiles);
+
+    private:
+        bool reopen(bool truncate);
+
+        IFileSystem &fileSystem_;
+        size_t maxFileSize_;
+        int maxBackupFiles_;
+
+        std::string path_;
+        std::string header_;
+        FileHandle handle_;
+        size_t currentSize_;
+        uint32_t rotationCount_;
+    };
+
+} // namespace embedded_logger
@@ -0,0 +1,198 @@
+/**
+ * @file shared_log_ring.h
+ * @brief Shared-memory ring for passing log entries between processes
+ * @details Fixed-size slot ring placed in a MAP_SHARED mapping. Any number of
+ *          processes may produce into the ring; a single consumer (the parent
+ *          logger's writer thread, or a dedicated collector process for a named
+ *          ring) drains it, so file appends never interleave.
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ *
+ * @copyright Copyright (c) 2025 Unmanned Systems UK. All rights reserved.
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+
+#include "embedded_logger/logger.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace embedded_logger
+{
+
+    /**
+     * @brief Multi-producer, single-consumer log ring in shared memory
+     * @details Each slot carries a sequence number that acts as its commit flag:
+     *          a producer claims a slot by advancing the shared head, copies the
+     *          entry in and then publishes the slot by swapping in the next sequence.
+     *          The consumer only reads slots whose sequence shows a completed write.
+     *
+     *          Producer crashes are contained: a slot claimed by a process that no
+     *          longer exists, or left uncommitted past the stall timeout, is skipped
+     *          by the consumer. A producer that resumes after its slot was skipped
+     *          sees its commit fail, and per-slot checksums, seeded with the slot's
+     *          position, reject any later entry torn by such a late write.
+     *
+     *          An idle consumer sleeps on a doorbell word in the shared header
+     *          (a futex on Linux) that every committed push() rings, so it needs
+     *          no polling to notice entries from other processes.
+     *
+     *          Component, timestamp and message are truncated to fit a slot.
+     * @note POSIX only. Requires lock-free atomics (address-free across processes).
+     *
+     * @example Collector and producers
+     * @code
+     * // Collector process: owns the files and rotation
+     * LoggerConfig collector;
+     * collector.sharedRingRole = SharedRingRole::COLLECTOR;
+     * collector.sharedRingName = "/vehicle_log";
+     *
+     * // Every other process
+     * LoggerConfig producer;
+     * producer.sharedRingRole = SharedRingRole::PRODUCER;
+     * producer.sharedRingName = "/vehicle_log";
+     * @endcode
+     */
+    class SharedLogRing
+    {
+    public:
+        /// Bytes of text (timestamp + component + message) stored per slot
+        static constexpr size_t kSlotTextSize = 464;
+
+        /// wait() timeout meaning "until notified"
+        static constexpr uint32_t kWaitForever = UINT32_MAX;
+
+        /**
+         * @brief Create an anonymous shared ring inherited by fork()ed children
+         * @param slotCount Number of slots (rounded up to a power of two)
+         * @return Ring instance, or nullptr if the mapping could not be created
+         */
+        static std::unique_ptr<SharedLogRing> createAnonymous(size_t slotCount);
+
+        /**
+         * @brief Create (or reopen) a named ring with shm_open() - collector side
+         * @param name POSIX shared memory name, e.g. "/vehicle_log"
+         * @param slotCount Number of slots (rounded up to a power of two)
+         * @return Ring instance, or nullptr on failure
+         * @note An existing ring of the same geometry is reused, so a restarted
+         *       collector picks up entries committed while it was down.
+         */
+        static std::unique_ptr<SharedLogRing> create(const std::string &name, size_t slotCount);
+
+        /**
+         * @brief Attach to a named ring created by a collector - producer side
+         * @param name POSIX shared memory name
+         * @return Ring instance, or nullptr if no compatible ring exists
+         */
+        static std::unique_ptr<SharedLogRing> attach(const std::string &name);
+
+        /**
+         * @brief Remove a named ring from the system
+         * @param name POSIX shared memory name
+         * @return true if the name was removed
+         * @note Attached processes keep their mapping until they detach.
+         */
+        static bool unlink(const std::string &name);
+
+        /**
+         * @brief Destructor - unmaps this process' view of the ring
+         */
+        ~SharedLogRing();
+
+        SharedLogRing(const SharedLogRing &) = delete;
+        SharedLogRing &operator=(const SharedLogRing &) = delete;
+
+        /**
+         * @brief Copy an entry into the ring (any process, any thread)
+         * @param entry Entry to publish
+         * @return false if the ring was full and the entry was dropped
+         */
+        bool push(const LogEntry &entry);
+
+        /**
+         * @brief Take the oldest committed entry (consumer only)
+         * @param entry Receives the entry
+         * @return false if no committed entry is available
+         */
+        bool pop(LogEntry &entry);
+
+        /**
+         * @brief Ring the consumer's doorbell (any process, any thread)
+         * @details push() does this for every committed entry. Call it directly
+         *          to wake a consumer that waits on the ring for other work too.
+         */
+        void notify();
+
+        /**
+         * @brief Start waiting for a notify() (consumer only)
+         * @return Ticket to pass to wait()
+         * @details Check for work after this call and before wait(): a notify()
+         *          in between makes wait() return at once.
+         */
+        uint32_t prepareWait();
+
+        /**
+         * @brief Sleep until notify() is called after prepareWait() (consumer only)
+         * @param ticket Value returned by prepareWait()
+         * @param timeoutMs Longest sleep, or kWaitForever
+         * @note Returns early while a claimed slot is uncommitted, so pop() can
+         *       skip it once the stall timeout has passed. Without futexes
+         *       (non-Linux) this polls every 10 ms.
+         */
+        void wait(uint32_t ticket, uint32_t timeoutMs);
+
+        /**
+         * @brief Set how long a claimed slot may stay uncommitted (consumer only)
+         * @param timeoutMs Stall timeout in milliseconds (default 100)
+         * @note Slots owned by a dead process are skipped without waiting.
+         */
+        void setStallTimeout(uint32_t timeoutMs);
+
+        /**
+         * @brief Get number of entries dropped because the ring was full
+         * @return Drop count across all producers
+         */
+        uint64_t getDroppedCount() const;
+
+        /**
+         * @brief Get number of slots skipped because their producer crashed or stalled
+         * @return Abandoned slot count
+         */
+        uint64_t getAbandonedCount() const;
+
+        /**
+         * @brief Get number of committed slots rejected by the checksum
+         * @return Corrupted slot count
+         */
+        uint64_t getCorruptedCount() const;
+
+    private:
+        struct RingHeader;
+        struct SlotRecord;
+        struct RingSlot;
+
+        SharedLogRing(void *mapping, size_t mappingSize);
+
+        static void initializeMapping(void *mapping, size_t slotCount);
+        static uint32_t computeChecksum(uint64_t position, const SlotRecord &record);
+        RingSlot *slotAt(uint64_t position) const;
+        void releaseSlot(RingSlot *slot, uint64_t position);
+        bool abandonStalledSlot(RingSlot *slot, uint64_t position);
+
+        void *mapping_;
+        size_t mappingSize_;
+        RingHeader *header_;
+        RingSlot *slots_;
+
+        // Consumer-local stall tracking
+        uint32_t stallTimeoutMs_;
+        uint64_t stallPosition_;
+        uint64_t stallSinceMs_;
+    };
+
+} // namespace embedded_logger
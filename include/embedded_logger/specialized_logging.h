@@ -1,3 +1,6 @@
 #pragma once 
  
 // Specialized logging utilities (BMS, IoT, Safety-Critical, etc.) 
+
+#include "embedded_logger/can_frame_logger.h"
+#include "embedded_logger/mavlink_tlog_recorder.h"
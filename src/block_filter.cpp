@@ -0,0 +1,226 @@
+// Block Bloom filters
+/**
+ * @file block_filter.cpp
+ * @brief Per-block Bloom filter construction and lookup
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/block_filter.h"
+#include "embedded_logger/log_formatter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace embedded_logger
+{
+
+    namespace
+    {
+        // Words and component names hash apart, so "bms" the word never matches BMS the component
+        constexpr uint64_t kWordSeed = 14695981039346656037ull;
+        constexpr uint64_t kComponentSeed = 0x9E3779B97F4A7C15ull;
+        constexpr size_t kMinFilterBits = 64;
+
+        bool isWordByte(unsigned char c)
+        {
+            // Bytes of multi-byte UTF-8 characters stay inside words
+            return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c >= 0x80;
+        }
+
+        unsigned char lower(unsigned char c)
+        {
+            return c >= 'A' && c <= 'Z' ? static_cast<unsigned char>(c + ('a' - 'A')) : c;
+        }
+
+        uint64_t finish(uint64_t hash)
+        {
+            // FNV alone leaves the high bits of short words poorly mixed
+            hash ^= hash >> 33;
+            hash *= 0xFF51AFD7ED558CCDull;
+            hash ^= hash >> 33;
+            hash *= 0xC4CEB9FE1A85EC53ull;
+            return hash ^ (hash >> 33);
+        }
+
+        uint64_t hashLower(const char *data, size_t size, uint64_t seed)
+        {
+            uint64_t hash = seed;
+            for (size_t i = 0; i < size; ++i)
+            {
+                hash = (hash ^ lower(static_cast<unsigned char>(data[i]))) * 1099511628211ull;
+            }
+            return finish(hash);
+        }
+    }
+
+    void BlockFilter::addWords(const std::string &text, std::vector<uint64_t> &tokens)
+    {
+        size_t size = text.size();
+        for (size_t i = 0; i < size;)
+        {
+            if (!isWordByte(static_cast<unsigned char>(text[i])))
+            {
+                ++i;
+                continue;
+            }
+            size_t start = i;
+            while (i < size && isWordByte(static_cast<unsigned char>(text[i])))
+            {
+                ++i;
+            }
+            tokens.push_back(hashLower(text.data() + start, i - start, kWordSeed));
+        }
+    }
+
+    void BlockFilter::addComponent(const std::string &component, std::vector<uint64_t> &tokens)
+    {
+        for (size_t dot = component.find('.'); dot != std::string::npos; dot = component.find('.', dot + 1))
+        {
+            tokens.push_back(hashLower(component.data(), dot, kComponentSeed));
+        }
+        tokens.push_back(hashLower(component.data(), component.size(), kComponentSeed));
+    }
+
+    void BlockFilter::addLine(const std::string &line, std::vector<uint64_t> &tokens)
+    {
+        std::string component;
+        size_t messageOffset;
+        if (parseLine(line, component, messageOffset))
+        {
+            addComponent(component, tokens);
+            addWords(line.substr(messageOffset), tokens);
+        }
+        else
+        {
+            addWords(line, tokens); // Continuation of a multi-line message
+        }
+    }
+
+    uint64_t BlockFilter::wordToken(const std::string &word)
+    {
+        return hashLower(word.data(), word.size(), kWordSeed);
+    }
+
+    uint64_t BlockFilter::componentToken(const std::string &component)
+    {
+        return hashLower(component.data(), component.size(), kComponentSeed);
+    }
+
+    bool BlockFilter::parseLine(const std::string &line, std::string &component, size_t &messageOffset)
+    {
+        if (line.empty() || line[0] != '[')
+        {
+            return false;
+        }
+
+        // "[timestamp] [   LEVEL] [   component] [pid N] message"
+        size_t level = line.find("] [");
+        size_t field = level == std::string::npos ? level : line.find("] [", level + 3);
+        size_t close = field == std::string::npos ? field : line.find(']', field + 3);
+        if (close == std::string::npos)
+        {
+            return false;
+        }
+
+        size_t start = line.find_first_not_of(' ', field + 3);
+        component.assign(line, start, close > start ? close - start : 0);
+        messageOffset = std::min(close + 2, line.size());
+        if (line.compare(messageOffset, 5, "[pid ") == 0)
+        {
+            size_t pidEnd = line.find("] ", messageOffset);
+            messageOffset = pidEnd == std::string::npos ? messageOffset : pidEnd + 2;
+        }
+        return true;
+    }
+
+    void BlockFilter::splitWords(const std::string &text, std::vector<std::string> &words)
+    {
+        std::string word;
+        for (char c : text)
+        {
+            if (isWordByte(static_cast<unsigned char>(c)))
+            {
+                word += static_cast<char>(lower(static_cast<unsigned char>(c)));
+            }
+            else if (!word.empty())
+            {
+                words.push_back(word);
+                word.clear();
+            }
+        }
+        if (!word.empty())
+        {
+            words.push_back(word);
+        }
+    }
+
+    void BlockFilter::appendFrame(std::vector<uint64_t> &tokens, size_t bitsPerToken, std::string &out)
+    {
+        std::sort(tokens.begin(), tokens.end());
+        tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+
+        // k = ln2 * bits per token minimises false positives for the size
+        size_t bitCount = std::max(kMinFilterBits, tokens.size() * bitsPerToken);
+        size_t byteCount = (bitCount + 7) / 8;
+        bitCount = byteCount * 8;
+        int hashCount = std::min(16, std::max(1, static_cast<int>(std::lround(bitsPerToken * 0.693))));
+
+        out += kFrameTag;
+        formatting::appendVarint(out, byteCount + 1);
+        out += static_cast<char>(hashCount);
+        size_t bits = out.size();
+        out.append(byteCount, '\0');
+        for (uint64_t token : tokens)
+        {
+            // Double hashing: k probes from one 64-bit hash
+            uint32_t h1 = static_cast<uint32_t>(token);
+            uint32_t h2 = static_cast<uint32_t>(token >> 32) | 1;
+            for (int i = 0; i < hashCount; ++i)
+            {
+                size_t bit = (h1 + static_cast<uint64_t>(i) * h2) % bitCount;
+                out[bits + bit / 8] = static_cast<char>(out[bits + bit / 8] | (1 << (bit % 8)));
+            }
+        }
+    }
+
+    bool BlockFilter::readFrame(const char *&cursor, const char *end, BlockFilter &filter)
+    {
+        const auto *in = reinterpret_cast<const uint8_t *>(cursor);
+        const auto *limit = reinterpret_cast<const uint8_t *>(end);
+        uint64_t size;
+        if (in >= limit || *in++ != static_cast<uint8_t>(kFrameTag) || !formatting::readVarint(in, limit, size) ||
+            size < 2 || size > static_cast<uint64_t>(limit - in))
+        {
+            return false;
+        }
+
+        filter.hashCount_ = in[0];
+        filter.bits_.assign(reinterpret_cast<const char *>(in) + 1, static_cast<size_t>(size) - 1);
+        cursor = reinterpret_cast<const char *>(in + size);
+        return true;
+    }
+
+    bool BlockFilter::mayContain(uint64_t token) const
+    {
+        if (bits_.empty())
+        {
+            return true; // No filter: cannot rule anything out
+        }
+
+        size_t bitCount = bits_.size() * 8;
+        uint32_t h1 = static_cast<uint32_t>(token);
+        uint32_t h2 = static_cast<uint32_t>(token >> 32) | 1;
+        for (int i = 0; i < hashCount_; ++i)
+        {
+            size_t bit = (h1 + static_cast<uint64_t>(i) * h2) % bitCount;
+            if ((static_cast<unsigned char>(bits_[bit / 8]) & (1 << (bit % 8))) == 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+} // namespace embedded_logger
@@ -0,0 +1,460 @@
+// Tiered retention compaction
+/**
+ * @file log_compactor.cpp
+ * @brief Rewrites aged log files down to their retention tier and merges them
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/log_compactor.h"
+#include "embedded_logger/block_filter.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+namespace embedded_logger
+{
+
+    namespace
+    {
+        constexpr char kLogFileTitle[] = "# Embedded Logger Library Log File\n";
+        constexpr char kCompactedTag[] = "compacted_"; // follows "<prefix>_"
+        constexpr char kTempSuffix[] = ".tmp";
+        constexpr size_t kCompressedBlockSize = 16 * 1024;
+        constexpr size_t kLevelCount = 5;
+        const char *const kLevelNames[kLevelCount] = {"DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL"};
+
+        bool endsWith(const std::string &text, const std::string &suffix)
+        {
+            return text.size() >= suffix.size() &&
+                   text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+        }
+
+        bool levelFromName(const char *name, size_t length, LogLevel &level)
+        {
+            for (size_t i = 0; i < kLevelCount; ++i)
+            {
+                if (std::strlen(kLevelNames[i]) == length && std::strncmp(name, kLevelNames[i], length) == 0)
+                {
+                    level = static_cast<LogLevel>(i);
+                    return true;
+                }
+            }
+            return false;
+        }
+    }
+
+    /// A file that is due for filtering or merging
+    struct LogCompactor::Candidate
+    {
+        std::string name;
+        uint64_t lastWrittenMs = 0;
+        uint64_t size = 0;
+        LogLevel level = LogLevel::DEBUG;  ///< Lowest level the file still contains
+        LogLevel target = LogLevel::DEBUG; ///< Level it is compacted to
+        bool compacted = false;
+        std::string stem; ///< Name without its ".N" backup or "_n" part number
+        long part = 0;    ///< Orders files of one stem: backups count down, parts up
+    };
+
+    /// Compacted file being assembled for one level
+    struct LogCompactor::Output
+    {
+        std::string body;   ///< Kept lines not yet compressed
+        std::string blocks; ///< Compressed blocks (compressLogFiles)
+        std::vector<std::string> sources;
+        uint64_t lastWrittenMs = 0;
+        uint64_t sourceBytes = 0;
+        bool unchanged = true; ///< Every source is already compacted at this level
+    };
+
+    LogCompactor::LogCompactor(IFileSystem &fileSystem, const LoggerConfig &config, const LogDictionary *dictionary)
+        : fileSystem_(fileSystem), directory_(config.logDirectory), prefix_(config.logFilePrefix + "_"),
+          extension_(config.logFileExtension), tiers_(config.retentionTiers),
+          maxAgeMs_(static_cast<uint64_t>(config.retentionMaxAgeHours) * 3600 * 1000),
+          targetSize_(config.maxFileSize), compress_(dictionary != nullptr),
+          filterBits_(config.blockFilterBitsPerToken), codec_(dictionary ? *dictionary : LogDictionary()), warned_(false)
+    {
+    }
+
+    LogCompactor::Report LogCompactor::run(uint64_t nowMs, const std::string &liveFile,
+                                           const std::atomic<bool> *cancel)
+    {
+        Report report;
+        std::vector<std::string> names;
+        if (!fileSystem_.listDirectory(directory_, names))
+        {
+            if (!warned_)
+            {
+                printf("Logger: Cannot list %s, log retention tiers are not applied\n", directory_.c_str());
+                warned_ = true;
+            }
+            return report;
+        }
+
+        size_t slash = liveFile.find_last_of('/');
+        std::string liveName = slash == std::string::npos ? liveFile : liveFile.substr(slash + 1);
+
+        std::vector<Candidate> candidates;
+        for (const std::string &name : names)
+        {
+            if (name.compare(0, prefix_.size(), prefix_) != 0 || name == liveName || endsWith(name, ".spare"))
+            {
+                continue;
+            }
+
+            std::string path = directory_ + "/" + name;
+            if (endsWith(name, kTempSuffix))
+            {
+                // Left behind by an interrupted pass; its sources still exist
+                fileSystem_.deleteFile(path);
+                continue;
+            }
+            ++report.filesScanned;
+
+            // Compacted files carry their level and age in the name:
+            // <prefix>_compacted_<LEVEL>_<last written ms>[_n]<extension>
+            Candidate candidate;
+            candidate.name = name;
+            if (name.compare(prefix_.size(), sizeof(kCompactedTag) - 1, kCompactedTag) == 0)
+            {
+                const char *field = name.c_str() + prefix_.size() + sizeof(kCompactedTag) - 1;
+                const char *separator = std::strchr(field, '_');
+                if (!separator || !levelFromName(field, static_cast<size_t>(separator - field), candidate.level))
+                {
+                    continue;
+                }
+                char *end = nullptr;
+                candidate.lastWrittenMs = std::strtoull(separator + 1, &end, 10);
+                candidate.compacted = true;
+                candidate.stem = name.substr(0, static_cast<size_t>(end - name.c_str()));
+                candidate.part = *end == '_' ? std::strtol(end + 1, nullptr, 10) : 0;
+            }
+            else if (fileSystem_.getFileModifiedTime(path, candidate.lastWrittenMs))
+            {
+                // "<file>.N" backups: a higher N was rotated out earlier
+                size_t extension = name.rfind(extension_ + ".");
+                size_t digits = extension == std::string::npos ? name.size() : extension + extension_.size() + 1;
+                bool backup = digits < name.size() && name.find_first_not_of("0123456789", digits) == std::string::npos;
+                candidate.stem = backup ? name.substr(0, digits - 1) : name;
+                candidate.part = backup ? -std::strtol(name.c_str() + digits, nullptr, 10) : 0;
+            }
+            else
+            {
+                if (!warned_)
+                {
+                    printf("Logger: File times unavailable, log retention tiers are not applied\n");
+                    warned_ = true;
+                }
+                return report;
+            }
+
+            uint64_t ageMs = nowMs > candidate.lastWrittenMs ? nowMs - candidate.lastWrittenMs : 0;
+            if (maxAgeMs_ != 0 && ageMs >= maxAgeMs_)
+            {
+                if (fileSystem_.deleteFile(path))
+                {
+                    ++report.filesExpired;
+                }
+                continue;
+            }
+
+            bool tiered = false;
+            LogLevel target = tierLevel(ageMs, tiered);
+            if (!tiered)
+            {
+                continue;
+            }
+
+            candidate.size = fileSystem_.getFileSize(path);
+            if (candidate.compacted && candidate.level >= target && candidate.size >= targetSize_)
+            {
+                continue; // Already filtered and large enough
+            }
+            candidate.target = std::max(candidate.level, target);
+            candidates.push_back(candidate);
+        }
+
+        // Oldest first, so merged files stay in chronological order. File times
+        // may only have whole seconds, so files of one second go by name.
+        std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b)
+                  {
+                      if (a.lastWrittenMs != b.lastWrittenMs)
+                      {
+                          return a.lastWrittenMs < b.lastWrittenMs;
+                      }
+                      if (a.compacted != b.compacted)
+                      {
+                          return a.compacted;
+                      }
+                      int order = a.stem.compare(b.stem);
+                      return order != 0 ? order < 0 : a.part < b.part;
+                  });
+
+        std::map<LogLevel, Output> outputs;
+        for (const Candidate &candidate : candidates)
+        {
+            if (cancel && cancel->load())
+            {
+                break;
+            }
+
+            Output &output = outputs[candidate.target];
+            if (!appendFiltered(output, candidate, candidate.target))
+            {
+                continue;
+            }
+            packBlocks(output, false);
+            if (output.blocks.size() + output.body.size() >= targetSize_)
+            {
+                // A compacted file that fills an output by itself (its text can
+                // be over the size even where its compressed blocks are not)
+                // would only be rewritten as it is, on every pass
+                if (output.unchanged && output.sources.size() == 1)
+                {
+                    output = Output();
+                    continue;
+                }
+                writeOutput(output, candidate.target, report);
+            }
+        }
+
+        if (cancel && cancel->load())
+        {
+            return report; // Sources of unwritten outputs are still in place
+        }
+
+        for (auto &entry : outputs)
+        {
+            // A lone small compacted file has nothing to merge with yet
+            if (!entry.second.sources.empty() && !(entry.second.unchanged && entry.second.sources.size() == 1))
+            {
+                writeOutput(entry.second, entry.first, report);
+            }
+        }
+        return report;
+    }
+
+    bool LogCompactor::parseLevel(const std::string &line, LogLevel &level)
+    {
+        if (line.empty() || line[0] != '[')
+        {
+            return false;
+        }
+
+        // "[timestamp] [   LEVEL] ..." - the level is right-aligned in the second field
+        size_t open = line.find("] [");
+        if (open == std::string::npos)
+        {
+            return false;
+        }
+        size_t start = line.find_first_not_of(' ', open + 3);
+        size_t end = line.find(']', open + 3);
+        return start != std::string::npos && end != std::string::npos && start < end &&
+               levelFromName(line.c_str() + start, end - start, level);
+    }
+
+    LogLevel LogCompactor::tierLevel(uint64_t ageMs, bool &tiered) const
+    {
+        // Highest level of every tier reached, so a file never regains levels with age
+        LogLevel level = LogLevel::DEBUG;
+        tiered = false;
+        for (const RetentionTier &tier : tiers_)
+        {
+            if (ageMs >= static_cast<uint64_t>(tier.afterHours) * 3600 * 1000)
+            {
+                level = std::max(level, tier.minLevel);
+                tiered = true;
+            }
+        }
+        return level;
+    }
+
+    bool LogCompactor::appendFiltered(Output &output, const Candidate &candidate, LogLevel level)
+    {
+        std::string contents;
+        if (!Logger::readLogFile(directory_ + "/" + candidate.name, contents, &codec_.dictionary()))
+        {
+            return false;
+        }
+
+        // Plain files: header up to the separator line, keep only its module
+        // records. Compacted files: keep each "# Source:" block with its entries.
+        std::string sectionHeader;
+        size_t position = 0;
+        if (contents.compare(0, 2, "# ") == 0)
+        {
+            std::string modules;
+            while (position < contents.size())
+            {
+                size_t end = contents.find('\n', position);
+                end = end == std::string::npos ? contents.size() : end + 1;
+                if (contents[position] == '=')
+                {
+                    position = end;
+                    break;
+                }
+                if (contents.compare(position, 10, "# Module: ") == 0)
+                {
+                    modules.append(contents, position, end - position);
+                }
+                position = end;
+            }
+            if (!candidate.compacted)
+            {
+                sectionHeader = "# Source: " + candidate.name + "\n" + modules;
+            }
+        }
+        else
+        {
+            sectionHeader = "# Source: " + candidate.name + "\n";
+        }
+
+        bool keep = true;
+        bool inSectionHeader = false;
+        std::string line;
+        while (position < contents.size())
+        {
+            size_t end = contents.find('\n', position);
+            end = end == std::string::npos ? contents.size() : end + 1;
+            line.assign(contents, position, end - position);
+            position = end;
+            if (line.back() != '\n')
+            {
+                line += '\n';
+            }
+
+            if (candidate.compacted && line.compare(0, 2, "# ") == 0)
+            {
+                if (!inSectionHeader)
+                {
+                    sectionHeader.clear();
+                    inSectionHeader = true;
+                }
+                sectionHeader += line;
+                continue;
+            }
+            inSectionHeader = false;
+
+            // Continuation lines of multi-line messages follow their entry
+            LogLevel entryLevel;
+            if (parseLevel(line, entryLevel))
+            {
+                keep = entryLevel >= level;
+            }
+            if (keep)
+            {
+                output.body += sectionHeader;
+                sectionHeader.clear();
+                output.body += line;
+            }
+        }
+
+        output.sources.push_back(candidate.name);
+        output.lastWrittenMs = std::max(output.lastWrittenMs, candidate.lastWrittenMs);
+        output.sourceBytes += candidate.size;
+        output.unchanged = output.unchanged && candidate.compacted && candidate.level == level;
+        return true;
+    }
+
+    void LogCompactor::packBlocks(Output &output, bool all)
+    {
+        if (!compress_)
+        {
+            return;
+        }
+
+        // Blocks of whole lines, small enough to keep the dictionary within reach
+        size_t start = 0;
+        while (output.body.size() - start >= (all ? 1 : kCompressedBlockSize))
+        {
+            size_t end = output.body.find('\n', std::min(start + kCompressedBlockSize, output.body.size()) - 1);
+            end = end == std::string::npos ? output.body.size() : end + 1;
+            if (filterBits_ != 0)
+            {
+                // Rebuild the filter for the regrouped lines
+                std::vector<uint64_t> tokens;
+                for (size_t line = start; line < end;)
+                {
+                    size_t lineEnd = output.body.find('\n', line);
+                    lineEnd = lineEnd == std::string::npos || lineEnd > end ? end : lineEnd;
+                    BlockFilter::addLine(output.body.substr(line, lineEnd - line), tokens);
+                    line = lineEnd + 1;
+                }
+                BlockFilter::appendFrame(tokens, filterBits_, output.blocks);
+            }
+            codec_.appendBlock(output.body.data() + start, end - start, output.blocks);
+            start = end;
+        }
+        output.body.erase(0, start);
+    }
+
+    bool LogCompactor::writeOutput(Output &output, LogLevel level, Report &report)
+    {
+        bool written = true;
+        uint64_t bytes = 0;
+        if (!output.body.empty() || !output.blocks.empty())
+        {
+            std::string levelName = kLevelNames[static_cast<size_t>(level)];
+            std::string base = directory_ + "/" + prefix_ + kCompactedTag + levelName + "_" +
+                               std::to_string(output.lastWrittenMs);
+            std::string path = base + extension_;
+            for (int suffix = 1; fileSystem_.fileExists(path); ++suffix)
+            {
+                path = base + "_" + std::to_string(suffix) + extension_;
+            }
+
+            std::string header = kLogFileTitle;
+            if (compress_)
+            {
+                char id[9];
+                snprintf(id, sizeof(id), "%08x", codec_.dictionary().id());
+                header += std::string(LogBlockCodec::kHeaderLabel) + id + "\n";
+            }
+            header += "# Compacted: " + levelName + "\n# Last-Written: " + std::to_string(output.lastWrittenMs) +
+                      "\n# Format: [Timestamp] [Level] [Component] Message\n" + std::string(80, '=') + "\n";
+
+            packBlocks(output, true);
+            bytes = header.size() + output.blocks.size() + output.body.size();
+
+            // Complete and durable under a temporary name before any source goes away
+            std::string temp = path + kTempSuffix;
+            FileHandle handle = fileSystem_.openFile(temp, FileOpenMode::TRUNCATE);
+            WriteBuffer buffers[3] = {{header.data(), header.size()},
+                                      {output.blocks.data(), output.blocks.size()},
+                                      {output.body.data(), output.body.size()}};
+            written = handle != kInvalidFileHandle && fileSystem_.appendFileV(handle, buffers, 3) &&
+                      fileSystem_.syncFile(handle);
+            fileSystem_.closeFile(handle);
+            written = written && fileSystem_.renameFile(temp, path);
+            if (!written)
+            {
+                printf("Logger: Failed to write compacted log file %s\n", path.c_str());
+                fileSystem_.deleteFile(temp);
+            }
+            else
+            {
+                ++report.filesWritten;
+            }
+        }
+
+        if (written)
+        {
+            for (const std::string &source : output.sources)
+            {
+                fileSystem_.deleteFile(directory_ + "/" + source);
+            }
+            report.filesCompacted += output.sources.size();
+            report.bytesBefore += output.sourceBytes;
+            report.bytesAfter += bytes;
+        }
+
+        output = Output();
+        return written;
+    }
+
+} // namespace embedded_logger
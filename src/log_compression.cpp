@@ -0,0 +1,540 @@
+// Log block compression
+/**
+ * @file log_compression.cpp
+ * @brief Dictionary trainer and LZ block codec implementation
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/log_compression.h"
+#include "embedded_logger/block_filter.h"
+#include "embedded_logger/log_formatter.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+namespace embedded_logger
+{
+
+    namespace
+    {
+        constexpr char kDictionaryMagic[8] = {'E', 'L', 'D', 'I', 'C', 'T', '0', '1'};
+        constexpr char kCompressedBlock = 'Z';
+        constexpr char kStoredBlock = 'S';
+        constexpr size_t kMinMatch = 4;
+        constexpr size_t kMaxOffset = 0xFFFF;
+        constexpr unsigned kDictionaryHashBits = 14;
+        constexpr unsigned kMaxBlockHashBits = 12;
+
+        // Trainer: substrings that count as "the same text" and the unit picked per slice
+        constexpr size_t kTrainDmer = 8;
+        constexpr size_t kTrainSegment = 64;
+
+        uint32_t fnv1a(const uint8_t *data, size_t size)
+        {
+            uint32_t hash = 2166136261u;
+            for (size_t i = 0; i < size; ++i)
+            {
+                hash = (hash ^ data[i]) * 16777619u;
+            }
+            return hash;
+        }
+
+        uint32_t read32(const uint8_t *data)
+        {
+            uint32_t value;
+            std::memcpy(&value, data, sizeof(value));
+            return value;
+        }
+
+        uint32_t hashSequence(uint32_t sequence, unsigned bits)
+        {
+            return (sequence * 2654435761u) >> (32 - bits);
+        }
+
+        /// LZ4-style length extension: 255 per byte until a smaller byte
+        void putLength(std::string &out, size_t length)
+        {
+            for (; length >= 255; length -= 255)
+            {
+                out += static_cast<char>(255);
+            }
+            out += static_cast<char>(length);
+        }
+
+        bool getLength(const uint8_t *&cursor, const uint8_t *end, size_t &length)
+        {
+            uint8_t byte;
+            do
+            {
+                if (cursor >= end)
+                {
+                    return false;
+                }
+                byte = *cursor++;
+                length += byte;
+            } while (byte == 255);
+            return true;
+        }
+
+        void putSequence(std::string &out, const uint8_t *literals, size_t literalLength, size_t offset,
+                         size_t matchLength)
+        {
+            size_t matchCode = matchLength != 0 ? matchLength - kMinMatch : 0;
+            out += static_cast<char>((std::min<size_t>(literalLength, 15) << 4) | std::min<size_t>(matchCode, 15));
+            if (literalLength >= 15)
+            {
+                putLength(out, literalLength - 15);
+            }
+            out.append(reinterpret_cast<const char *>(literals), literalLength);
+            if (matchLength == 0)
+            {
+                return; // Final literals
+            }
+            out += static_cast<char>(offset & 0xFF);
+            out += static_cast<char>(offset >> 8);
+            if (matchCode >= 15)
+            {
+                putLength(out, matchCode - 15);
+            }
+        }
+    }
+
+    LogDictionary::LogDictionary()
+        : id_(0)
+    {
+    }
+
+    LogDictionary::LogDictionary(const std::string &contents)
+        : contents_(contents.size() > kMaxSize ? contents.substr(contents.size() - kMaxSize) : contents), id_(0)
+    {
+        if (!contents_.empty())
+        {
+            id_ = fnv1a(reinterpret_cast<const uint8_t *>(contents_.data()), contents_.size());
+            id_ = id_ != 0 ? id_ : 1;
+        }
+    }
+
+    LogDictionary LogDictionary::train(const std::vector<std::string> &samples, size_t size)
+    {
+        size = std::min(size, kMaxSize);
+        std::string corpus;
+        for (const std::string &sample : samples)
+        {
+            corpus += sample;
+        }
+        if (corpus.size() < kTrainSegment || size < kTrainSegment)
+        {
+            return LogDictionary();
+        }
+
+        // Document frequency: in how many samples each 8-byte substring occurs
+        struct Count
+        {
+            uint32_t samples = 0;
+            uint32_t lastSample = UINT32_MAX;
+        };
+        std::unordered_map<uint64_t, Count> frequency;
+        std::vector<uint64_t> dmers(corpus.size() - kTrainDmer + 1);
+        size_t position = 0;
+        for (uint32_t index = 0; index < samples.size(); ++index)
+        {
+            size_t end = position + samples[index].size();
+            for (; position < end; ++position)
+            {
+                if (position < dmers.size())
+                {
+                    std::memcpy(&dmers[position], corpus.data() + position, kTrainDmer);
+                    Count &count = frequency[dmers[position]];
+                    if (count.lastSample != index)
+                    {
+                        count.lastSample = index;
+                        ++count.samples;
+                    }
+                }
+            }
+        }
+
+        // One segment per slice of the corpus keeps the dictionary representative of all of it
+        size_t epochs = std::max<size_t>(1, std::min(size / kTrainSegment, corpus.size() / kTrainSegment));
+        size_t epochLength = corpus.size() / epochs;
+        size_t window = kTrainSegment - kTrainDmer + 1;
+        std::vector<std::pair<uint64_t, size_t>> picked;
+        for (size_t epoch = 0; epoch < epochs; ++epoch)
+        {
+            size_t begin = epoch * epochLength;
+            size_t last = std::min(begin + epochLength, corpus.size() - kTrainSegment + 1);
+            if (begin >= last)
+            {
+                continue;
+            }
+
+            uint64_t score = 0;
+            for (size_t i = begin; i < begin + window; ++i)
+            {
+                score += frequency[dmers[i]].samples;
+            }
+            uint64_t bestScore = score;
+            size_t best = begin;
+            for (size_t start = begin + 1; start < last; ++start)
+            {
+                score += frequency[dmers[start + window - 1]].samples;
+                score -= frequency[dmers[start - 1]].samples;
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    best = start;
+                }
+            }
+            if (bestScore == 0)
+            {
+                continue;
+            }
+
+            // Text already covered earns nothing in later slices
+            for (size_t i = best; i < best + window; ++i)
+            {
+                frequency[dmers[i]].samples = 0;
+            }
+            picked.emplace_back(bestScore, best);
+        }
+
+        std::stable_sort(picked.begin(), picked.end(),
+                         [](const std::pair<uint64_t, size_t> &a, const std::pair<uint64_t, size_t> &b)
+                         { return a.first < b.first; });
+        std::string contents;
+        for (const auto &segment : picked)
+        {
+            contents.append(corpus, segment.second, kTrainSegment);
+        }
+        if (contents.size() > size)
+        {
+            contents.erase(0, contents.size() - size);
+        }
+        return LogDictionary(contents);
+    }
+
+    bool LogDictionary::load(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::ostringstream stream;
+        stream << file.rdbuf();
+        std::string data = stream.str();
+
+        const size_t headerSize = sizeof(kDictionaryMagic) + 8;
+        if (!file || data.size() < headerSize || std::memcmp(data.data(), kDictionaryMagic, sizeof(kDictionaryMagic)) != 0)
+        {
+            printf("Logger: %s is not a log compression dictionary\n", path.c_str());
+            return false;
+        }
+
+        const auto *fields = reinterpret_cast<const uint8_t *>(data.data()) + sizeof(kDictionaryMagic);
+        uint32_t id = fields[0] | fields[1] << 8 | fields[2] << 16 | static_cast<uint32_t>(fields[3]) << 24;
+        uint32_t size = fields[4] | fields[5] << 8 | fields[6] << 16 | static_cast<uint32_t>(fields[7]) << 24;
+        LogDictionary dictionary(data.substr(headerSize));
+        if (size != dictionary.contents().size() || id != dictionary.id())
+        {
+            printf("Logger: Compression dictionary %s is damaged\n", path.c_str());
+            return false;
+        }
+        *this = dictionary;
+        return true;
+    }
+
+    bool LogDictionary::save(const std::string &path) const
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        uint32_t fields[2] = {id_, static_cast<uint32_t>(contents_.size())};
+        char header[8];
+        for (int i = 0; i < 8; ++i)
+        {
+            header[i] = static_cast<char>(fields[i / 4] >> (8 * (i % 4)));
+        }
+        file.write(kDictionaryMagic, sizeof(kDictionaryMagic));
+        file.write(header, sizeof(header));
+        file.write(contents_.data(), static_cast<std::streamsize>(contents_.size()));
+        return static_cast<bool>(file);
+    }
+
+    LogBlockCodec::LogBlockCodec(const LogDictionary &dictionary)
+        : dictionary_(dictionary), blockTable_(size_t(1) << kMaxBlockHashBits)
+    {
+        if (dictionary_.empty())
+        {
+            return;
+        }
+
+        // Later positions overwrite earlier ones: prefer the closest (shortest offset) match
+        dictionaryTable_.assign(size_t(1) << kDictionaryHashBits, 0);
+        const auto *bytes = reinterpret_cast<const uint8_t *>(dictionary_.contents().data());
+        for (size_t i = 0; i + kMinMatch <= dictionary_.contents().size(); ++i)
+        {
+            dictionaryTable_[hashSequence(read32(bytes + i), kDictionaryHashBits)] = static_cast<uint16_t>(i + 1);
+        }
+    }
+
+    void LogBlockCodec::appendBlock(const void *data, size_t size, std::string &out)
+    {
+        size_t start = out.size();
+        out += kCompressedBlock;
+        formatting::appendVarint(out, size);
+
+        std::string payload;
+        compress(data, size, payload);
+        bool stored = payload.size() >= size;
+        if (stored)
+        {
+            out[start] = kStoredBlock;
+        }
+        formatting::appendVarint(out, stored ? size : payload.size());
+
+        uint32_t checksum = fnv1a(static_cast<const uint8_t *>(data), size);
+        for (int i = 0; i < 4; ++i)
+        {
+            out += static_cast<char>(checksum >> (8 * i));
+        }
+        if (stored)
+        {
+            out.append(static_cast<const char *>(data), size);
+        }
+        else
+        {
+            out += payload;
+        }
+    }
+
+    bool LogBlockCodec::readBlock(const char *&cursor, const char *end, std::string &out) const
+    {
+        // Filter frames only matter to searches
+        const char *block = cursor;
+        BlockFilter filter;
+        while (block < end && *block == BlockFilter::kFrameTag && BlockFilter::readFrame(block, end, filter))
+        {
+        }
+
+        const uint8_t *in;
+        uint64_t rawSize;
+        uint64_t payloadSize;
+        uint32_t checksum;
+        bool stored;
+        if (!parseBlockHeader(block, end, in, rawSize, payloadSize, checksum, stored))
+        {
+            return false;
+        }
+
+        size_t start = out.size();
+        if (stored ? payloadSize != rawSize : !decompress(in, payloadSize, rawSize, out))
+        {
+            out.resize(start);
+            return false;
+        }
+        if (stored)
+        {
+            out.append(reinterpret_cast<const char *>(in), payloadSize);
+        }
+        if (fnv1a(reinterpret_cast<const uint8_t *>(out.data()) + start, rawSize) != checksum)
+        {
+            out.resize(start);
+            return false;
+        }
+
+        cursor = reinterpret_cast<const char *>(in + payloadSize);
+        return true;
+    }
+
+    bool LogBlockCodec::skipBlock(const char *&cursor, const char *end)
+    {
+        const uint8_t *in;
+        uint64_t rawSize;
+        uint64_t payloadSize;
+        uint32_t checksum;
+        bool stored;
+        if (!parseBlockHeader(cursor, end, in, rawSize, payloadSize, checksum, stored))
+        {
+            return false;
+        }
+        cursor = reinterpret_cast<const char *>(in + payloadSize);
+        return true;
+    }
+
+    bool LogBlockCodec::parseBlockHeader(const char *cursor, const char *end, const uint8_t *&payload,
+                                         uint64_t &rawSize, uint64_t &payloadSize, uint32_t &checksum, bool &stored)
+    {
+        const auto *in = reinterpret_cast<const uint8_t *>(cursor);
+        const auto *limit = reinterpret_cast<const uint8_t *>(end);
+        if (in >= limit || (*in != kCompressedBlock && *in != kStoredBlock))
+        {
+            return false;
+        }
+        stored = *in++ == kStoredBlock;
+
+        if (!formatting::readVarint(in, limit, rawSize) || !formatting::readVarint(in, limit, payloadSize) ||
+            static_cast<size_t>(limit - in) < 4 || payloadSize > static_cast<size_t>(limit - in) - 4)
+        {
+            return false; // Torn
+        }
+        checksum = in[0] | in[1] << 8 | in[2] << 16 | static_cast<uint32_t>(in[3]) << 24;
+        payload = in + 4;
+        return true;
+    }
+
+    size_t LogBlockCodec::matchLength(uint32_t candidate, const uint8_t *source, size_t position, size_t size) const
+    {
+        // candidate indexes the dictionary followed by the block
+        const auto *dictionary = reinterpret_cast<const uint8_t *>(dictionary_.contents().data());
+        size_t dictionarySize = dictionary_.contents().size();
+        size_t length = 0;
+        while (candidate < dictionarySize && position + length < size &&
+               dictionary[candidate] == source[position + length])
+        {
+            ++candidate;
+            ++length;
+        }
+        if (candidate < dictionarySize)
+        {
+            return length;
+        }
+
+        const uint8_t *match = source + (candidate - dictionarySize);
+        const uint8_t *next = source + position + length;
+        const uint8_t *limit = source + size;
+        while (next < limit && *match == *next)
+        {
+            ++match;
+            ++next;
+        }
+        return static_cast<size_t>(next - source) - position;
+    }
+
+    void LogBlockCodec::compress(const void *data, size_t size, std::string &out)
+    {
+        const auto *source = static_cast<const uint8_t *>(data);
+        const size_t dictionarySize = dictionary_.contents().size();
+
+        // Small blocks only clear a small table
+        unsigned bits = 8;
+        while (bits < kMaxBlockHashBits && (size_t(1) << bits) < size)
+        {
+            ++bits;
+        }
+        std::fill(blockTable_.begin(), blockTable_.begin() + (size_t(1) << bits), 0);
+
+        size_t anchor = 0;
+        size_t position = 0;
+        while (position + kMinMatch <= size)
+        {
+            uint32_t sequence = read32(source + position);
+            size_t bestLength = 0;
+            size_t bestOffset = 0;
+
+            uint32_t &slot = blockTable_[hashSequence(sequence, bits)];
+            if (slot != 0 && position - (slot - 1) <= kMaxOffset && read32(source + slot - 1) == sequence)
+            {
+                bestLength = matchLength(static_cast<uint32_t>(dictionarySize + slot - 1), source, position, size);
+                bestOffset = position - (slot - 1);
+            }
+            slot = static_cast<uint32_t>(position + 1);
+
+            if (!dictionaryTable_.empty())
+            {
+                uint16_t entry = dictionaryTable_[hashSequence(sequence, kDictionaryHashBits)];
+                size_t offset = dictionarySize - (entry - 1) + position;
+                if (entry != 0 && offset <= kMaxOffset)
+                {
+                    size_t length = matchLength(entry - 1, source, position, size);
+                    if (length > bestLength)
+                    {
+                        bestLength = length;
+                        bestOffset = offset;
+                    }
+                }
+            }
+
+            if (bestLength < kMinMatch)
+            {
+                ++position;
+                continue;
+            }
+
+            putSequence(out, source + anchor, position - anchor, bestOffset, bestLength);
+            position += bestLength;
+            anchor = position;
+            if (position - 2 + kMinMatch <= size)
+            {
+                blockTable_[hashSequence(read32(source + position - 2), bits)] = static_cast<uint32_t>(position - 1);
+            }
+        }
+
+        putSequence(out, source + anchor, size - anchor, 0, 0);
+    }
+
+    bool LogBlockCodec::decompress(const void *data, size_t size, size_t rawSize, std::string &out) const
+    {
+        const auto *in = static_cast<const uint8_t *>(data);
+        const auto *end = in + size;
+        const std::string &dictionary = dictionary_.contents();
+        const size_t base = out.size();
+        out.reserve(base + rawSize);
+
+        while (in < end)
+        {
+            uint8_t token = *in++;
+            size_t literalLength = token >> 4;
+            if (literalLength == 15 && !getLength(in, end, literalLength))
+            {
+                return false;
+            }
+            if (literalLength > static_cast<size_t>(end - in) || out.size() - base + literalLength > rawSize)
+            {
+                return false;
+            }
+            out.append(reinterpret_cast<const char *>(in), literalLength);
+            in += literalLength;
+            if (in == end)
+            {
+                break; // Final literals
+            }
+
+            if (end - in < 2)
+            {
+                return false;
+            }
+            size_t offset = in[0] | in[1] << 8;
+            in += 2;
+            size_t matchLength = (token & 0x0F);
+            if (matchLength == 15 && !getLength(in, end, matchLength))
+            {
+                return false;
+            }
+            matchLength += kMinMatch;
+
+            size_t produced = out.size() - base;
+            if (offset == 0 || offset > produced + dictionary.size() || produced + matchLength > rawSize)
+            {
+                return false;
+            }
+
+            // The window is the dictionary followed by this block's output
+            size_t from = base + produced - offset;
+            if (offset > produced)
+            {
+                size_t dictionaryStart = dictionary.size() - (offset - produced);
+                size_t count = std::min(matchLength, offset - produced);
+                out.append(dictionary, dictionaryStart, count);
+                matchLength -= count;
+                from = base;
+            }
+            for (; matchLength != 0; --matchLength)
+            {
+                out += out[from++];
+            }
+        }
+        return out.size() - base == rawSize;
+    }
+
+} // namespace embedded_logger
@@ -0,0 +1,74 @@
+// Diagnostic context
+/**
+ * @file log_context.cpp
+ * @brief Thread-local diagnostic context implementation
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/log_context.h"
+
+namespace embedded_logger
+{
+
+    std::shared_ptr<const LogContextNode> &LogContext::slot()
+    {
+        static thread_local std::shared_ptr<const LogContextNode> context;
+        return context;
+    }
+
+    const std::shared_ptr<const LogContextNode> &LogContext::current()
+    {
+        return slot();
+    }
+
+    void LogContext::render(const LogContextNode *context, std::string &out)
+    {
+        if (!context)
+        {
+            return;
+        }
+
+        // Walk innermost to outermost, then emit in reverse so outer fields come first
+        const LogContextNode *chain[kMaxRenderedFields];
+        size_t depth = 0;
+        const LogContextNode *node = context;
+        for (; node && depth < kMaxRenderedFields; node = node->parent.get())
+        {
+            chain[depth++] = node;
+        }
+
+        out += '[';
+        if (node)
+        {
+            // Outer fields past the limit
+            out += "... ";
+        }
+        for (size_t i = depth; i > 0; --i)
+        {
+            const LogContextNode *node = chain[i - 1];
+            out += node->key;
+            out += '=';
+            out += node->value;
+            out += i > 1 ? ' ' : ']';
+        }
+        out += ' ';
+    }
+
+    LogContextScope::LogContextScope(const char *key, std::string value)
+        : previous_(LogContext::slot())
+    {
+        auto node = std::make_shared<LogContextNode>();
+        node->key = key;
+        node->value = std::move(value);
+        node->parent = previous_;
+        LogContext::slot() = std::move(node);
+    }
+
+    LogContextScope::~LogContextScope()
+    {
+        LogContext::slot() = std::move(previous_);
+    }
+
+} // namespace embedded_logger
@@ -1 +1,117 @@
-// Log formatting utilities 
+// Log formatting utilities
+/**
+ * @file log_formatter.cpp
+ * @brief Formatting utilities implementation
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/log_formatter.h"
+
+namespace embedded_logger
+{
+    namespace formatting
+    {
+
+        namespace
+        {
+            /// "000102...ff": two characters per byte value
+            struct HexTable
+            {
+                char pairs[512];
+
+                constexpr HexTable() : pairs{}
+                {
+                    const char digits[] = "0123456789abcdef";
+                    for (int i = 0; i < 256; ++i)
+                    {
+                        pairs[i * 2] = digits[i >> 4];
+                        pairs[i * 2 + 1] = digits[i & 0xF];
+                    }
+                }
+            };
+
+            constexpr HexTable kHexTable;
+        }
+
+        void appendHex(std::string &out, const void *data, size_t size)
+        {
+            if (size == 0)
+            {
+                return;
+            }
+
+            size_t start = out.size();
+            out.resize(start + size * 3 - 1, ' ');
+
+            const auto *bytes = static_cast<const uint8_t *>(data);
+            char *dst = &out[start];
+            for (size_t i = 0; i < size; ++i)
+            {
+                const char *pair = &kHexTable.pairs[bytes[i] * 2];
+                dst[0] = pair[0];
+                dst[1] = pair[1];
+                dst += 3;
+            }
+        }
+
+        void appendBacktrace(std::string &out, const uintptr_t *frames, size_t count)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+
+            out.reserve(out.size() + 6 + count * (3 + sizeof(uintptr_t) * 2));
+            out += " [bt";
+            for (size_t i = 0; i < count; ++i)
+            {
+                // Big-endian byte order, leading zero bytes dropped
+                uint8_t bytes[sizeof(uintptr_t)];
+                for (size_t b = 0; b < sizeof(uintptr_t); ++b)
+                {
+                    bytes[b] = static_cast<uint8_t>(frames[i] >> (8 * (sizeof(uintptr_t) - 1 - b)));
+                }
+                size_t skip = 0;
+                while (skip + 1 < sizeof(uintptr_t) && bytes[skip] == 0)
+                {
+                    ++skip;
+                }
+
+                out += " 0x";
+                for (size_t b = skip; b < sizeof(uintptr_t); ++b)
+                {
+                    out.append(&kHexTable.pairs[bytes[b] * 2], 2);
+                }
+            }
+            out += ']';
+        }
+
+        void appendVarint(std::string &out, uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                out += static_cast<char>((value & 0x7F) | 0x80);
+                value >>= 7;
+            }
+            out += static_cast<char>(value);
+        }
+
+        bool readVarint(const uint8_t *&cursor, const uint8_t *end, uint64_t &value)
+        {
+            value = 0;
+            for (unsigned shift = 0; cursor < end && shift < 64; shift += 7)
+            {
+                uint8_t byte = *cursor++;
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    } // namespace formatting
+} // namespace embedded_logger
@@ -0,0 +1,856 @@
+// Printf engine
+/**
+ * @file log_printf.cpp
+ * @brief Integer-only printf implementation
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/log_printf.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+namespace embedded_logger
+{
+    namespace formatting
+    {
+
+        namespace
+        {
+            /// "00" "01" ... "99": two digits per division
+            struct DigitPairs
+            {
+                char pairs[200];
+
+                constexpr DigitPairs() : pairs{}
+                {
+                    for (int i = 0; i < 100; ++i)
+                    {
+                        pairs[i * 2] = static_cast<char>('0' + i / 10);
+                        pairs[i * 2 + 1] = static_cast<char>('0' + i % 10);
+                    }
+                }
+            };
+
+            constexpr DigitPairs kDigitPairs;
+
+            /// Write value in decimal ending at end; returns the first digit
+            char *writeDecimal(char *end, uint64_t value)
+            {
+                // 64-bit division is a library call on 32-bit cores: leave it as soon as the value fits
+                while (value > 0xFFFFFFFFull)
+                {
+                    uint32_t pair = static_cast<uint32_t>(value % 100);
+                    value /= 100;
+                    end -= 2;
+                    memcpy(end, kDigitPairs.pairs + pair * 2, 2);
+                }
+                uint32_t low = static_cast<uint32_t>(value);
+                while (low >= 100)
+                {
+                    uint32_t pair = low % 100;
+                    low /= 100;
+                    end -= 2;
+                    memcpy(end, kDigitPairs.pairs + pair * 2, 2);
+                }
+                if (low >= 10)
+                {
+                    end -= 2;
+                    memcpy(end, kDigitPairs.pairs + low * 2, 2);
+                }
+                else
+                {
+                    *--end = static_cast<char>('0' + low);
+                }
+                return end;
+            }
+
+            /// Write value in base 8 (shift 3) or 16 (shift 4) ending at end
+            char *writePowerOfTwo(char *end, uint64_t value, unsigned shift, bool upper)
+            {
+                const char *digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+                unsigned mask = (1u << shift) - 1;
+                do
+                {
+                    *--end = digits[value & mask];
+                    value >>= shift;
+                } while (value != 0);
+                return end;
+            }
+
+            /// Bounded writer that counts what would have been written
+            class Output
+            {
+            public:
+                Output(char *buffer, size_t size) : buffer_(buffer), size_(size), length_(0) {}
+
+                void put(char c)
+                {
+                    if (length_ + 1 < size_)
+                    {
+                        buffer_[length_] = c;
+                    }
+                    ++length_;
+                }
+
+                void put(const char *text, size_t count)
+                {
+                    if (length_ + 1 < size_)
+                    {
+                        size_t room = size_ - 1 - length_;
+                        memcpy(buffer_ + length_, text, count < room ? count : room);
+                    }
+                    length_ += count;
+                }
+
+                void fill(char c, size_t count)
+                {
+                    if (length_ + 1 < size_)
+                    {
+                        size_t room = size_ - 1 - length_;
+                        memset(buffer_ + length_, c, count < room ? count : room);
+                    }
+                    length_ += count;
+                }
+
+                size_t finish()
+                {
+                    if (size_ != 0)
+                    {
+                        buffer_[length_ < size_ ? length_ : size_ - 1] = '\0';
+                    }
+                    return length_;
+                }
+
+            private:
+                char *buffer_;
+                size_t size_;
+                size_t length_;
+            };
+
+            struct Spec
+            {
+                bool left = false;
+                bool plus = false;
+                bool space = false;
+                bool alt = false;
+                bool zero = false;
+                size_t width = 0;
+                int precision = -1; ///< -1 = not given
+                char conversion = 0;
+            };
+
+            enum class Length
+            {
+                NONE,
+                HH,
+                H,
+                L,
+                LL,
+                J,
+                Z,
+                T,
+                LONG_DOUBLE
+            };
+
+            void emitField(Output &out, const Spec &spec, const char *prefix, size_t prefixLength, size_t zeros,
+                           const char *body, size_t bodyLength)
+            {
+                size_t length = prefixLength + zeros + bodyLength;
+                size_t padding = spec.width > length ? spec.width - length : 0;
+                if (!spec.left)
+                {
+                    out.fill(' ', padding);
+                }
+                out.put(prefix, prefixLength);
+                out.fill('0', zeros);
+                out.put(body, bodyLength);
+                if (spec.left)
+                {
+                    out.fill(' ', padding);
+                }
+            }
+
+            void formatInteger(Output &out, const Spec &spec, uint64_t magnitude, bool negative)
+            {
+                char digits[24];
+                char *end = digits + sizeof(digits);
+                char *start;
+                char prefix[2];
+                size_t prefixLength = 0;
+
+                switch (spec.conversion)
+                {
+                case 'o':
+                    start = writePowerOfTwo(end, magnitude, 3, false);
+                    break;
+                case 'x':
+                case 'X':
+                    start = writePowerOfTwo(end, magnitude, 4, spec.conversion == 'X');
+                    if (spec.alt && magnitude != 0)
+                    {
+                        prefix[prefixLength++] = '0';
+                        prefix[prefixLength++] = spec.conversion;
+                    }
+                    break;
+                default:
+                    start = writeDecimal(end, magnitude);
+                    if (negative || spec.plus || spec.space)
+                    {
+                        prefix[prefixLength++] = negative ? '-' : spec.plus ? '+' : ' ';
+                    }
+                    break;
+                }
+
+                size_t count = static_cast<size_t>(end - start);
+                if (spec.precision == 0 && magnitude == 0)
+                {
+                    count = 0; // "%.0d" prints nothing for 0
+                }
+                size_t precision = spec.precision < 0 ? 0 : static_cast<size_t>(spec.precision);
+                size_t zeros = precision > count ? precision - count : 0;
+                if (spec.conversion == 'o' && spec.alt && zeros == 0 && (count == 0 || *(end - count) != '0'))
+                {
+                    zeros = 1; // "%#o" always starts with 0
+                }
+                size_t length = prefixLength + zeros + count;
+                if (spec.zero && !spec.left && spec.precision < 0 && spec.width > length)
+                {
+                    zeros += spec.width - length;
+                }
+                emitField(out, spec, prefix, prefixLength, zeros, end - count, count);
+            }
+
+            constexpr uint32_t kLimbBase = 1000000000;
+            constexpr uint32_t kPow10[10] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+                                             1000000000};
+
+            // 2^1024 has 309 digits (35 limbs); 2^-1074 has 1074 fraction digits (120 limbs)
+            constexpr int kLimbs = 128;
+
+            int limbDigits(uint32_t limb)
+            {
+                int digits = 1;
+                while (digits < 9 && limb >= kPow10[digits])
+                {
+                    ++digits;
+                }
+                return digits;
+            }
+
+            /**
+             * Exact decimal value of a double in base-10^9 limbs, most significant
+             * first. The units limb holds the integer part's last nine digits; the
+             * limbs after it are the fraction.
+             */
+            struct Decimal
+            {
+                uint32_t limbs[kLimbs];
+                uint32_t *first;
+                uint32_t *units;
+                uint32_t *end;
+                bool sticky; ///< Non-zero digits were dropped after end
+
+                uint32_t *firstNonZero()
+                {
+                    uint32_t *limb = first;
+                    while (limb < end && *limb == 0)
+                    {
+                        ++limb;
+                    }
+                    return limb;
+                }
+
+                void setZero()
+                {
+                    limbs[0] = 0;
+                    first = units = limbs;
+                    end = limbs + 1;
+                    sticky = false;
+                }
+
+                /**
+                 * mantissa * 2^exponent. Only digits up to precision (plus guard
+                 * digits) past the units limb (fixed) or the first significant
+                 * digit are kept; sticky records whether the rest were zero.
+                 */
+                void expand(uint64_t mantissa, int exponent, bool fixed, int precision)
+                {
+                    first = exponent < 0 ? limbs + 1 : limbs + kLimbs - 2;
+                    first[0] = static_cast<uint32_t>(mantissa / kLimbBase);
+                    first[1] = static_cast<uint32_t>(mantissa % kLimbBase);
+                    units = first + 1;
+                    end = first + 2;
+                    sticky = false;
+                    if (first[0] == 0)
+                    {
+                        ++first;
+                    }
+
+                    // Multiply 29 bits at a time: a limb shifted by 29 plus the carry fits in 64 bits
+                    while (exponent > 0)
+                    {
+                        int shift = exponent < 29 ? exponent : 29;
+                        uint32_t carry = 0;
+                        for (uint32_t *limb = end; limb != first;)
+                        {
+                            --limb;
+                            uint64_t product = (static_cast<uint64_t>(*limb) << shift) + carry;
+                            *limb = static_cast<uint32_t>(product % kLimbBase);
+                            carry = static_cast<uint32_t>(product / kLimbBase);
+                        }
+                        if (carry != 0)
+                        {
+                            *--first = carry;
+                        }
+                        exponent -= shift;
+                    }
+
+                    // Divide 9 bits at a time: 10^9 is a multiple of 2^9, so remainders move down exactly
+                    long keep = 1 + (static_cast<long>(precision) + 17 + 8) / 9;
+                    while (exponent < 0)
+                    {
+                        int shift = -exponent < 9 ? -exponent : 9;
+                        uint32_t mask = (1u << shift) - 1;
+                        uint32_t carry = 0;
+                        for (uint32_t *limb = first; limb < end; ++limb)
+                        {
+                            uint32_t remainder = *limb & mask;
+                            *limb = (*limb >> shift) + carry;
+                            carry = (kLimbBase >> shift) * remainder;
+                        }
+                        if (*first == 0 && first < units)
+                        {
+                            ++first;
+                        }
+                        if (carry != 0)
+                        {
+                            *end++ = carry;
+                        }
+
+                        uint32_t *base = fixed ? units : firstNonZero();
+                        if (end - base > keep)
+                        {
+                            for (uint32_t *limb = base + keep; limb < end; ++limb)
+                            {
+                                sticky = sticky || *limb != 0;
+                            }
+                            end = base + keep;
+                        }
+                        exponent += shift;
+                    }
+                }
+
+                /// Round half-to-even, keeping `digit` digits counted from the top of limb `from`
+                void roundAt(uint32_t *from, long digit)
+                {
+                    uint32_t *limb = from + digit / 9;
+                    if (limb >= end)
+                    {
+                        return; // Exact to more digits than requested
+                    }
+
+                    uint32_t unit = kPow10[9 - digit % 9];
+                    uint32_t dropped = *limb % unit;
+                    bool more = sticky;
+                    for (uint32_t *rest = limb + 1; rest < end && !more; ++rest)
+                    {
+                        more = *rest != 0;
+                    }
+                    *limb -= dropped;
+                    end = limb + 1;
+                    sticky = false;
+
+                    uint32_t half = unit / 2;
+                    bool up = dropped > half || (dropped == half && more);
+                    if (dropped == half && !more)
+                    {
+                        uint32_t last = unit < kLimbBase ? *limb / unit % 10 : (limb > first ? limb[-1] % 10 : 0);
+                        up = (last & 1) != 0;
+                    }
+                    if (!up)
+                    {
+                        return;
+                    }
+
+                    *limb += unit;
+                    while (*limb >= kLimbBase)
+                    {
+                        *limb = 0;
+                        if (limb == first)
+                        {
+                            *--first = 0;
+                        }
+                        ++*--limb;
+                    }
+                }
+            };
+
+            /// Reads decimal digits left to right; zeros past the end
+            class DigitReader
+            {
+            public:
+                DigitReader(const uint32_t *limb, const uint32_t *end, int digit)
+                    : limb_(limb), end_(end), digit_(digit) {}
+
+                char next()
+                {
+                    char c = limb_ < end_ ? static_cast<char>('0' + *limb_ / kPow10[8 - digit_] % 10) : '0';
+                    if (++digit_ == 9)
+                    {
+                        digit_ = 0;
+                        ++limb_;
+                    }
+                    return c;
+                }
+
+                void copy(Output &out, size_t count)
+                {
+                    for (; count != 0; --count)
+                    {
+                        out.put(next());
+                    }
+                }
+
+            private:
+                const uint32_t *limb_;
+                const uint32_t *end_;
+                int digit_;
+            };
+
+            void formatFloat(Output &out, Spec spec, double value)
+            {
+                uint64_t bits;
+                memcpy(&bits, &value, sizeof(bits));
+                bool negative = (bits >> 63) != 0;
+                int biased = static_cast<int>((bits >> 52) & 0x7FF);
+                uint64_t mantissa = bits & ((1ull << 52) - 1);
+                bool upper = spec.conversion >= 'A' && spec.conversion <= 'Z';
+                char style = static_cast<char>(upper ? spec.conversion - 'A' + 'a' : spec.conversion);
+
+                char sign[1];
+                size_t signLength = 0;
+                if (negative || spec.plus || spec.space)
+                {
+                    sign[signLength++] = negative ? '-' : spec.plus ? '+' : ' ';
+                }
+
+                if (biased == 0x7FF)
+                {
+                    const char *text = mantissa != 0 ? (upper ? "NAN" : "nan") : (upper ? "INF" : "inf");
+                    spec.zero = false;
+                    emitField(out, spec, sign, signLength, 0, text, 3);
+                    return;
+                }
+
+                int exponent = -1074;
+                if (biased != 0)
+                {
+                    mantissa |= 1ull << 52;
+                    exponent = biased - 1075;
+                }
+
+                int precision = spec.precision < 0 ? 6 : spec.precision;
+                int significant = style == 'g' ? (precision == 0 ? 1 : precision) : precision + 1;
+
+                Decimal decimal;
+                bool zero = mantissa == 0;
+                if (zero)
+                {
+                    decimal.setZero();
+                }
+                else if (style == 'f')
+                {
+                    decimal.expand(mantissa, exponent, true, precision);
+                    decimal.roundAt(decimal.units, 9 + static_cast<long>(precision));
+                }
+                else
+                {
+                    decimal.expand(mantissa, exponent, false, significant);
+                    uint32_t *leading = decimal.firstNonZero();
+                    decimal.roundAt(leading, 9 - limbDigits(*leading) + static_cast<long>(significant));
+                }
+
+                uint32_t *leading = decimal.firstNonZero();
+                zero = leading == decimal.end;
+                int leadingOffset = zero ? 0 : 9 - limbDigits(*leading);
+                long decimalExponent = zero ? 0 : 9 * (decimal.units - leading) + (8 - leadingOffset);
+
+                if (style == 'g')
+                {
+                    // Significant digits up to the last non-zero one
+                    long nonZero = 0;
+                    if (!spec.alt && !zero)
+                    {
+                        DigitReader reader(leading, decimal.end, leadingOffset);
+                        for (long i = 1; i <= significant; ++i)
+                        {
+                            nonZero = reader.next() != '0' ? i : nonZero;
+                        }
+                    }
+
+                    if (decimalExponent < significant && decimalExponent >= -4)
+                    {
+                        style = 'f';
+                        long digits = significant - 1 - decimalExponent;
+                        precision = static_cast<int>(spec.alt ? digits : std::max(0L, digits - (significant - nonZero)));
+                    }
+                    else
+                    {
+                        style = 'e';
+                        precision = static_cast<int>(spec.alt ? significant - 1 : std::max(0L, nonZero - 1));
+                    }
+                }
+
+                bool point = precision > 0 || spec.alt;
+                char exponentText[8];
+                size_t exponentLength = 0;
+                size_t integerDigits = 1;
+                if (style == 'e')
+                {
+                    char *exponentEnd = exponentText + sizeof(exponentText);
+                    uint64_t magnitude = static_cast<uint64_t>(decimalExponent < 0 ? -decimalExponent : decimalExponent);
+                    char *start = writeDecimal(exponentEnd, magnitude);
+                    if (magnitude < 10)
+                    {
+                        *--start = '0';
+                    }
+                    *--start = decimalExponent < 0 ? '-' : '+';
+                    *--start = upper ? 'E' : 'e';
+                    exponentLength = static_cast<size_t>(exponentEnd - start);
+                    memmove(exponentText, start, exponentLength);
+                }
+                else if (!zero && leading <= decimal.units)
+                {
+                    integerDigits = static_cast<size_t>(decimalExponent) + 1;
+                }
+
+                size_t length = signLength + integerDigits + (point ? 1 : 0) + static_cast<size_t>(precision) + exponentLength;
+                size_t padding = spec.width > length ? spec.width - length : 0;
+                if (!spec.left && !spec.zero)
+                {
+                    out.fill(' ', padding);
+                }
+                out.put(sign, signLength);
+                if (!spec.left && spec.zero)
+                {
+                    out.fill('0', padding);
+                }
+
+                if (style == 'e')
+                {
+                    DigitReader reader(leading, decimal.end, leadingOffset);
+                    out.put(zero ? '0' : reader.next());
+                    if (point)
+                    {
+                        out.put('.');
+                    }
+                    reader.copy(out, static_cast<size_t>(precision));
+                    out.put(exponentText, exponentLength);
+                }
+                else
+                {
+                    if (integerDigits == 1 && (zero || leading > decimal.units))
+                    {
+                        out.put('0');
+                    }
+                    else
+                    {
+                        DigitReader(leading, decimal.end, leadingOffset).copy(out, integerDigits);
+                    }
+                    if (point)
+                    {
+                        out.put('.');
+                    }
+                    DigitReader(decimal.units + 1, decimal.end, 0).copy(out, static_cast<size_t>(precision));
+                }
+
+                if (spec.left)
+                {
+                    out.fill(' ', padding);
+                }
+            }
+
+            template <typename T>
+            T readDigits(const char *&cursor)
+            {
+                T value = 0;
+                while (*cursor >= '0' && *cursor <= '9')
+                {
+                    value = value * 10 + static_cast<T>(*cursor++ - '0');
+                }
+                return value;
+            }
+        }
+
+        int formatV(char *buffer, size_t size, const char *format, va_list args)
+        {
+#ifdef EMBEDDED_LOGGER_LIBC_PRINTF
+            return vsnprintf(buffer, size, format, args);
+#else
+            Output out(buffer, size);
+            const char *cursor = format;
+            while (*cursor != '\0')
+            {
+                const char *literal = cursor;
+                while (*cursor != '\0' && *cursor != '%')
+                {
+                    ++cursor;
+                }
+                out.put(literal, static_cast<size_t>(cursor - literal));
+                if (*cursor == '\0')
+                {
+                    break;
+                }
+
+                const char *specStart = cursor++;
+                Spec spec;
+                for (bool flags = true; flags;)
+                {
+                    switch (*cursor)
+                    {
+                    case '-':
+                        spec.left = true;
+                        break;
+                    case '+':
+                        spec.plus = true;
+                        break;
+                    case ' ':
+                        spec.space = true;
+                        break;
+                    case '#':
+                        spec.alt = true;
+                        break;
+                    case '0':
+                        spec.zero = true;
+                        break;
+                    default:
+                        flags = false;
+                        continue;
+                    }
+                    ++cursor;
+                }
+
+                if (*cursor == '*')
+                {
+                    int width = va_arg(args, int);
+                    spec.left = spec.left || width < 0;
+                    spec.width = width < 0 ? 0u - static_cast<unsigned>(width) : static_cast<unsigned>(width);
+                    ++cursor;
+                }
+                else
+                {
+                    spec.width = readDigits<size_t>(cursor);
+                }
+
+                if (*cursor == '.')
+                {
+                    ++cursor;
+                    if (*cursor == '*')
+                    {
+                        int precision = va_arg(args, int);
+                        spec.precision = precision < 0 ? -1 : precision;
+                        ++cursor;
+                    }
+                    else
+                    {
+                        spec.precision = readDigits<int>(cursor);
+                    }
+                }
+
+                Length length = Length::NONE;
+                switch (*cursor)
+                {
+                case 'h':
+                    length = cursor[1] == 'h' ? Length::HH : Length::H;
+                    cursor += length == Length::HH ? 2 : 1;
+                    break;
+                case 'l':
+                    length = cursor[1] == 'l' ? Length::LL : Length::L;
+                    cursor += length == Length::LL ? 2 : 1;
+                    break;
+                case 'j':
+                    length = Length::J;
+                    ++cursor;
+                    break;
+                case 'z':
+                    length = Length::Z;
+                    ++cursor;
+                    break;
+                case 't':
+                    length = Length::T;
+                    ++cursor;
+                    break;
+                case 'L':
+                    length = Length::LONG_DOUBLE;
+                    ++cursor;
+                    break;
+                default:
+                    break;
+                }
+
+                spec.conversion = *cursor;
+                if (*cursor != '\0')
+                {
+                    ++cursor;
+                }
+
+                switch (spec.conversion)
+                {
+                case 'd':
+                case 'i':
+                {
+                    int64_t value;
+                    switch (length)
+                    {
+                    case Length::HH:
+                        value = static_cast<signed char>(va_arg(args, int));
+                        break;
+                    case Length::H:
+                        value = static_cast<short>(va_arg(args, int));
+                        break;
+                    case Length::L:
+                        value = va_arg(args, long);
+                        break;
+                    case Length::LL:
+                        value = va_arg(args, long long);
+                        break;
+                    case Length::J:
+                        value = va_arg(args, intmax_t);
+                        break;
+                    case Length::Z:
+                        value = va_arg(args, std::make_signed<size_t>::type);
+                        break;
+                    case Length::T:
+                        value = va_arg(args, ptrdiff_t);
+                        break;
+                    default:
+                        value = va_arg(args, int);
+                        break;
+                    }
+                    uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+                    formatInteger(out, spec, magnitude, value < 0);
+                    break;
+                }
+                case 'u':
+                case 'o':
+                case 'x':
+                case 'X':
+                {
+                    uint64_t value;
+                    switch (length)
+                    {
+                    case Length::HH:
+                        value = static_cast<unsigned char>(va_arg(args, unsigned));
+                        break;
+                    case Length::H:
+                        value = static_cast<unsigned short>(va_arg(args, unsigned));
+                        break;
+                    case Length::L:
+                        value = va_arg(args, unsigned long);
+                        break;
+                    case Length::LL:
+                        value = va_arg(args, unsigned long long);
+                        break;
+                    case Length::J:
+                        value = va_arg(args, uintmax_t);
+                        break;
+                    case Length::Z:
+                        value = va_arg(args, size_t);
+                        break;
+                    case Length::T:
+                        value = static_cast<uint64_t>(va_arg(args, ptrdiff_t));
+                        break;
+                    default:
+                        value = va_arg(args, unsigned);
+                        break;
+                    }
+                    spec.plus = spec.space = false;
+                    formatInteger(out, spec, value, false);
+                    break;
+                }
+                case 'p':
+                {
+                    void *pointer = va_arg(args, void *);
+                    if (pointer == nullptr)
+                    {
+                        emitField(out, spec, nullptr, 0, 0, "(nil)", 5);
+                        break;
+                    }
+                    spec.alt = true;
+                    spec.conversion = 'x';
+                    formatInteger(out, spec, reinterpret_cast<uintptr_t>(pointer), false);
+                    break;
+                }
+                case 'c':
+                {
+                    char c = static_cast<char>(va_arg(args, int));
+                    emitField(out, spec, nullptr, 0, 0, &c, 1);
+                    break;
+                }
+                case 's':
+                {
+                    const char *text = va_arg(args, const char *);
+                    text = text != nullptr ? text : "(null)";
+                    size_t textLength;
+                    if (spec.precision >= 0)
+                    {
+                        const void *nul = memchr(text, '\0', static_cast<size_t>(spec.precision));
+                        textLength = nul != nullptr ? static_cast<size_t>(static_cast<const char *>(nul) - text)
+                                                    : static_cast<size_t>(spec.precision);
+                    }
+                    else
+                    {
+                        textLength = strlen(text);
+                    }
+                    emitField(out, spec, nullptr, 0, 0, text, textLength);
+                    break;
+                }
+                case 'f':
+                case 'F':
+                case 'e':
+                case 'E':
+                case 'g':
+                case 'G':
+                {
+                    double value = length == Length::LONG_DOUBLE ? static_cast<double>(va_arg(args, long double))
+                                                                 : va_arg(args, double);
+                    formatFloat(out, spec, value);
+                    break;
+                }
+                case '%':
+                    out.put('%');
+                    break;
+                default:
+                    // Unsupported: copy as written
+                    out.put(specStart, static_cast<size_t>(cursor - specStart));
+                    break;
+                }
+            }
+            return static_cast<int>(out.finish());
+#endif
+        }
+
+        int format(char *buffer, size_t size, const char *format, ...)
+        {
+            va_list args;
+            va_start(args, format);
+            int length = formatV(buffer, size, format, args);
+            va_end(args);
+            return length;
+        }
+
+        void appendDecimal(std::string &out, uint64_t value)
+        {
+            char digits[20];
+            char *end = digits + sizeof(digits);
+            char *start = writeDecimal(end, value);
+            out.append(start, static_cast<size_t>(end - start));
+        }
+
+    } // namespace formatting
+} // namespace embedded_logger
@@ -9,12 +9,24 @@
  */
 
 #include "embedded_logger/logger.h"
+#include "embedded_logger/block_filter.h"
+#include "embedded_logger/log_compactor.h"
+#include "embedded_logger/log_compression.h"
+#include "embedded_logger/log_formatter.h"
+#include "embedded_logger/log_printf.h"
+#include "embedded_logger/rotating_file_writer.h"
+#include <cctype>
 #include <cstdio>
 #include <cstdarg>
+#include <cstdlib>
+#include <cstring>
 #include <chrono>
+#include <ctime>
+#include <fstream>
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
+#include <new>
 
 #ifdef _WIN32
 #include <direct.h>
@@ -26,6 +38,14 @@
 #include <sys/stat.h>
 #endif
 
+#if defined(__linux__) || defined(__APPLE__)
+#include <cerrno>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/uio.h>
+#define HAS_POSIX_FILE_IO
+#endif
+
 #ifdef __linux__
 #include <filesystem>
 namespace fs = std::filesystem;
@@ -37,12 +57,205 @@ namespace fs = std::filesystem;
 #define NO_FILESYSTEM
 #endif
 
+#if (defined(__linux__) || defined(__APPLE__)) && !defined(ESP_PLATFORM)
+#include <pthread.h>
+#include "embedded_logger/shared_log_ring.h"
+#include "embedded_logger/log_stream_server.h"
+#include "embedded_logger/direct_file_sink.h"
+#include "embedded_logger/backtrace_capture.h"
+#define HAS_FORK_SUPPORT
+#define HAS_STREAM_SERVER
+#define HAS_DIRECT_FILE_IO
+#define HAS_BACKTRACE_CAPTURE
+#endif
+
 namespace embedded_logger
 {
 
     // Static member initialization
     std::shared_ptr<Logger> Logger::globalLogger_ = nullptr;
     std::mutex Logger::globalLoggerMutex_;
+    std::array<std::string, Logger::kMaxComponents> Logger::componentNames_;
+    std::atomic<uint16_t> Logger::componentCount_(1);
+    std::unordered_map<std::string, uint16_t> Logger::componentIndex_;
+    std::mutex Logger::componentRegistryMutex_;
+    std::vector<Logger *> Logger::forkRegistry_;
+    std::mutex Logger::forkRegistryMutex_;
+
+    namespace
+    {
+        constexpr char kLogFileTitle[] = "# Embedded Logger Library Log File\n";
+        constexpr char kValidLengthLabel[] = "# Valid-Length: ";
+        constexpr size_t kValidLengthDigits = 20;
+        constexpr size_t kValidLengthOffset = sizeof(kLogFileTitle) - 1 + sizeof(kValidLengthLabel) - 1;
+
+        /// Local time, without std::localtime()'s shared buffer (writer and producers call this)
+        std::tm localTime(time_t seconds)
+        {
+            std::tm local{};
+#ifdef _WIN32
+            localtime_s(&local, &seconds);
+#else
+            localtime_r(&seconds, &local);
+#endif
+            return local;
+        }
+
+        /// Start of the rotation period containing unixMs, or of the one after it, in local time
+        uint64_t rotationPeriodStart(uint64_t unixMs, RotationInterval interval, bool next)
+        {
+            std::tm local = localTime(static_cast<time_t>(unixMs / 1000));
+            local.tm_sec = 0;
+            local.tm_min = 0;
+            if (interval == RotationInterval::DAILY)
+            {
+                local.tm_hour = 0;
+                local.tm_mday += next ? 1 : 0;
+            }
+            else
+            {
+                local.tm_hour += next ? 1 : 0;
+            }
+            local.tm_isdst = -1; // mktime() normalises the overflow and any DST change
+            return static_cast<uint64_t>(std::mktime(&local)) * 1000;
+        }
+
+        /// Local time as used in log file names
+        std::string fileTimestamp(uint64_t unixMs)
+        {
+            std::tm local = localTime(static_cast<time_t>(unixMs / 1000));
+            char buffer[32];
+            std::strftime(buffer, sizeof(buffer), "%Y-%m-%d_%H_%M_%S", &local);
+            return buffer;
+        }
+
+        /// Lock, giving up at the deadline
+        bool lockBefore(std::unique_lock<std::mutex> &lock, std::chrono::steady_clock::time_point deadline)
+        {
+            while (!lock.try_lock())
+            {
+                if (std::chrono::steady_clock::now() >= deadline)
+                {
+                    return false;
+                }
+                std::this_thread::yield();
+            }
+            return true;
+        }
+
+        /// Marks a file operation in progress for the stalled-writer check
+        class FileWriteStamp
+        {
+        public:
+            FileWriteStamp(std::atomic<uint64_t> &startedMs, uint64_t nowMs) : startedMs_(startedMs)
+            {
+                startedMs_.store(nowMs, std::memory_order_relaxed);
+            }
+            ~FileWriteStamp() { startedMs_.store(0, std::memory_order_relaxed); }
+
+        private:
+            std::atomic<uint64_t> &startedMs_;
+        };
+
+        // Set while a logDeferred() callable runs. On the writer that is inside the
+        // workerBusy_ window, where logging could wait on locks atForkPrepare() holds.
+        thread_local bool buildingDeferredMessage = false;
+
+        /// Refuse entries logged from inside a deferred message callable
+        bool loggedFromDeferredMessage()
+        {
+            if (!buildingDeferredMessage)
+            {
+                return false;
+            }
+            printf("Logger: Entry logged from a deferred message callable dropped\n");
+            return true;
+        }
+    }
+
+    // IFileSystem write defaults: stdio, so every platform with a C library works
+    FileHandle IFileSystem::openFile(const std::string &path, FileOpenMode mode)
+    {
+        FILE *file = nullptr;
+        switch (mode)
+        {
+        case FileOpenMode::TRUNCATE:
+            file = fopen(path.c_str(), "wb");
+            break;
+        case FileOpenMode::OVERWRITE:
+            file = fopen(path.c_str(), "r+b");
+            if (!file)
+            {
+                file = fopen(path.c_str(), "w+b");
+            }
+            break;
+        case FileOpenMode::APPEND:
+        default:
+            file = fopen(path.c_str(), "ab");
+            break;
+        }
+        return file ? reinterpret_cast<FileHandle>(file) : kInvalidFileHandle;
+    }
+
+    bool IFileSystem::appendFile(FileHandle handle, const void *data, size_t size)
+    {
+        // Callers batch, so hand each batch to the OS like a raw write would
+        FILE *file = reinterpret_cast<FILE *>(handle);
+        return handle != kInvalidFileHandle && fwrite(data, 1, size, file) == size && fflush(file) == 0;
+    }
+
+    bool IFileSystem::appendFileV(FileHandle handle, const WriteBuffer *buffers, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!appendFile(handle, buffers[i].data, buffers[i].size))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool IFileSystem::writeFileAt(FileHandle handle, uint64_t offset, const void *data, size_t size)
+    {
+        FILE *file = reinterpret_cast<FILE *>(handle);
+        if (handle == kInvalidFileHandle)
+        {
+            return false;
+        }
+
+        long position = ftell(file);
+        bool written = fseek(file, static_cast<long>(offset), SEEK_SET) == 0 && fwrite(data, 1, size, file) == size;
+        return fseek(file, position, SEEK_SET) == 0 && fflush(file) == 0 && written;
+    }
+
+    bool IFileSystem::preallocateFile(FileHandle, uint64_t)
+    {
+        return false;
+    }
+
+    bool IFileSystem::syncFile(FileHandle handle)
+    {
+        return handle != kInvalidFileHandle && fflush(reinterpret_cast<FILE *>(handle)) == 0;
+    }
+
+    void IFileSystem::closeFile(FileHandle handle)
+    {
+        if (handle != kInvalidFileHandle)
+        {
+            fclose(reinterpret_cast<FILE *>(handle));
+        }
+    }
+
+    bool IFileSystem::listDirectory(const std::string &, std::vector<std::string> &)
+    {
+        return false;
+    }
+
+    bool IFileSystem::getFileModifiedTime(const std::string &, uint64_t &)
+    {
+        return false;
+    }
 
     /**
      * @brief Default time provider using system clock
@@ -53,8 +266,7 @@ namespace embedded_logger
         std::string getCurrentDateTime() override
         {
             auto now = std::chrono::system_clock::now();
-            auto time_t = std::chrono::system_clock::to_time_t(now);
-            auto tm = *std::localtime(&time_t);
+            auto tm = localTime(std::chrono::system_clock::to_time_t(now));
 
             char buffer[32];
             std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm);
@@ -144,17 +356,190 @@ namespace embedded_logger
         {
             return rename(oldPath.c_str(), newPath.c_str()) == 0;
         }
+
+#ifdef HAS_POSIX_FILE_IO
+        // Raw descriptors: no stdio buffering on top of the logger's own batching
+        FileHandle openFile(const std::string &path, FileOpenMode mode) override
+        {
+            int flags = O_WRONLY | O_CREAT | O_CLOEXEC;
+            if (mode == FileOpenMode::TRUNCATE)
+            {
+                flags |= O_TRUNC;
+            }
+            else if (mode == FileOpenMode::APPEND)
+            {
+                flags |= O_APPEND;
+            }
+            int fd = open(path.c_str(), flags, 0644);
+            return fd >= 0 ? static_cast<FileHandle>(fd) : kInvalidFileHandle;
+        }
+
+        bool appendFile(FileHandle handle, const void *data, size_t size) override
+        {
+            WriteBuffer buffer = {data, size};
+            return appendFileV(handle, &buffer, 1);
+        }
+
+        bool appendFileV(FileHandle handle, const WriteBuffer *buffers, size_t count) override
+        {
+            if (handle == kInvalidFileHandle)
+            {
+                return false;
+            }
+
+            iovec vectors[16];
+            while (count != 0)
+            {
+                size_t batch = std::min<size_t>(count, 16);
+                size_t remaining = 0;
+                for (size_t i = 0; i < batch; ++i)
+                {
+                    vectors[i].iov_base = const_cast<void *>(buffers[i].data);
+                    vectors[i].iov_len = buffers[i].size;
+                    remaining += buffers[i].size;
+                }
+
+                // Resume after short writes until the whole batch is out
+                iovec *next = vectors;
+                int left = static_cast<int>(batch);
+                while (remaining != 0)
+                {
+                    ssize_t written = writev(static_cast<int>(handle), next, left);
+                    if (written < 0)
+                    {
+                        if (errno == EINTR)
+                            continue;
+                        return false;
+                    }
+
+                    remaining -= static_cast<size_t>(written);
+                    while (left != 0 && static_cast<size_t>(written) >= next->iov_len)
+                    {
+                        written -= static_cast<ssize_t>(next->iov_len);
+                        ++next;
+                        --left;
+                    }
+                    if (left != 0)
+                    {
+                        next->iov_base = static_cast<char *>(next->iov_base) + written;
+                        next->iov_len -= static_cast<size_t>(written);
+                    }
+                }
+
+                buffers += batch;
+                count -= batch;
+            }
+            return true;
+        }
+
+        bool writeFileAt(FileHandle handle, uint64_t offset, const void *data, size_t size) override
+        {
+            const char *bytes = static_cast<const char *>(data);
+            while (handle != kInvalidFileHandle && size != 0)
+            {
+                ssize_t written = pwrite(static_cast<int>(handle), bytes, size, static_cast<off_t>(offset));
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    return false;
+                }
+                bytes += written;
+                offset += static_cast<uint64_t>(written);
+                size -= static_cast<size_t>(written);
+            }
+            return handle != kInvalidFileHandle;
+        }
+
+        bool preallocateFile(FileHandle handle, uint64_t size) override
+        {
+#ifdef __linux__
+            // Allocates real extents (unlike ftruncate), so later overwrites never allocate
+            return handle != kInvalidFileHandle &&
+                   posix_fallocate(static_cast<int>(handle), 0, static_cast<off_t>(size)) == 0;
+#else
+            (void)handle;
+            (void)size;
+            return false;
+#endif
+        }
+
+        bool syncFile(FileHandle handle) override
+        {
+#ifdef __linux__
+            return handle != kInvalidFileHandle && fdatasync(static_cast<int>(handle)) == 0;
+#else
+            return handle != kInvalidFileHandle && fsync(static_cast<int>(handle)) == 0;
+#endif
+        }
+
+        void closeFile(FileHandle handle) override
+        {
+            if (handle != kInvalidFileHandle)
+            {
+                close(static_cast<int>(handle));
+            }
+        }
+
+        bool listDirectory(const std::string &path, std::vector<std::string> &names) override
+        {
+            DIR *directory = opendir(path.c_str());
+            if (!directory)
+            {
+                return false;
+            }
+
+            while (dirent *entry = readdir(directory))
+            {
+                if (std::strcmp(entry->d_name, ".") != 0 && std::strcmp(entry->d_name, "..") != 0)
+                {
+                    names.push_back(entry->d_name);
+                }
+            }
+            closedir(directory);
+            return true;
+        }
+
+        bool getFileModifiedTime(const std::string &path, uint64_t &unixTimeMs) override
+        {
+            struct stat info;
+            if (stat(path.c_str(), &info) != 0)
+            {
+                return false;
+            }
+            unixTimeMs = static_cast<uint64_t>(info.st_mtime) * 1000;
+            return true;
+        }
+#endif
+
+#ifdef HAS_DIRECT_FILE_IO
+        bool supportsDirectIo() override
+        {
+            return true;
+        }
+#endif
     };
 
     Logger::Logger(const LoggerConfig &config,
                    std::unique_ptr<ITimeProvider> timeProvider,
                    std::unique_ptr<IFileSystem> fileSystem)
-        : config_(config), timeProvider_(timeProvider ? std::move(timeProvider) : createDefaultTimeProvider()), fileSystem_(fileSystem ? std::move(fileSystem) : createDefaultFileSystem()), initialized_(false), shutdownRequested_(false), currentFileSize_(0), totalLogCount_(0)
+        : config_(config), timeProvider_(timeProvider ? std::move(timeProvider) : createDefaultTimeProvider()), fileSystem_(fileSystem ? std::move(fileSystem) : createDefaultFileSystem()), initialized_(false), shutdownRequested_(false), currentFileSize_(0), currentLogHandle_(kInvalidFileHandle), recycleFiles_(false), fileValidLength_(0), fileValidLengthOnDisk_(0), workerBusy_(false), ringProducer_(false), rotationEnabled_(true), forkQuiesced_(false), forkRestartPending_(false), forkRestartMode_(ForkChildMode::SEPARATE_FILE), forkDiscardQueue_(false), nextRotationTick_(kNoRotationTick), rotationBoundaryMs_(0), preparedHandle_(kInvalidFileHandle), pruneListWarned_(false), compactionStopping_(false), adaptiveState_(AdaptiveVerbosityState::NORMAL), adaptiveStateSinceMs_(0), adaptiveDroppedCount_(0), fileWriteStartedMs_(0), writerDegraded_(false), degradedSinceMs_(0), degradedDroppedCount_(0), emergency_(false), nextBurstEndMs_(kNoDebugBurst), totalLogCount_(0)
     {
+        for (size_t i = 0; i < kMaxComponents; ++i)
+        {
+            componentGates_[i].store(kGateUnresolved, std::memory_order_relaxed);
+            sampleCounters_[i].store(0, std::memory_order_relaxed);
+        }
+        for (auto &window : burstWindows_)
+        {
+            window.store(0, std::memory_order_relaxed);
+        }
+        loggerComponent_ = lookupComponent("LOGGER");
     }
 
     Logger::~Logger()
     {
+        unregisterForFork();
         shutdown();
     }
 
@@ -167,6 +552,30 @@ namespace embedded_logger
 
         try
         {
+#ifdef HAS_BACKTRACE_CAPTURE
+            if (config_.captureBacktraces)
+            {
+                BacktraceCapture::warmUp();
+            }
+#endif
+
+#ifdef HAS_FORK_SUPPORT
+            // Producers hand every entry to the collector and own no files
+            if (config_.sharedRingRole == SharedRingRole::PRODUCER)
+            {
+                sharedRing_ = SharedLogRing::attach(config_.sharedRingName);
+                if (sharedRing_)
+                {
+                    ringProducer_.store(true);
+                    initialized_.store(true);
+                    logSystemStartup("Embedded Logger producing into shared ring " + config_.sharedRingName);
+                    printf("Logger: Producing into shared ring %s\n", config_.sharedRingName.c_str());
+                    return true;
+                }
+                printf("Logger: Shared ring %s not available, logging locally\n", config_.sharedRingName.c_str());
+            }
+#endif
+
             // Create log directory if it doesn't exist
             if (!fileSystem_->fileExists(config_.logDirectory))
             {
@@ -177,13 +586,123 @@ namespace embedded_logger
                 }
             }
 
+#ifdef HAS_DIRECT_FILE_IO
+            if (config_.directFileIo)
+            {
+                if (!fileSystem_->supportsDirectIo())
+                {
+                    printf("Logger: Direct file I/O needs the default file system, using buffered writes\n");
+                }
+                else if (config_.forkSafe && config_.forkChildMode == ForkChildMode::SHARED_FILE)
+                {
+                    // Positioned block rewrites would overwrite a child's O_APPEND lines
+                    printf("Logger: Direct file I/O is not available with ForkChildMode::SHARED_FILE\n");
+                }
+                else
+                {
+                    directSink_ = std::make_unique<DirectFileSink>(config_.directFileBufferSize);
+                }
+            }
+#endif
+
+            recycleFiles_ = config_.recycleLogFiles;
+            if (recycleFiles_ && config_.forkSafe && config_.forkChildMode == ForkChildMode::SHARED_FILE)
+            {
+                // A child's O_APPEND writes would land past the preallocated end
+                printf("Logger: Log file recycling is not available with ForkChildMode::SHARED_FILE\n");
+                recycleFiles_ = false;
+            }
+#ifdef HAS_DIRECT_FILE_IO
+            if (recycleFiles_ && directSink_)
+            {
+                printf("Logger: Log file recycling is not used with direct file I/O\n");
+                recycleFiles_ = false;
+            }
+#endif
+
+            if (config_.compressLogFiles)
+            {
+                LogDictionary dictionary;
+                if (!config_.compressionDictionaryPath.empty() && !dictionary.load(config_.compressionDictionaryPath))
+                {
+                    printf("Logger: Compressing log files without a dictionary\n");
+                }
+                blockCodec_ = std::make_unique<LogBlockCodec>(dictionary);
+            }
+            else if (config_.blockFilterBitsPerToken != 0)
+            {
+                printf("Logger: Block filters need compressLogFiles; not writing them\n");
+            }
+
+            if (!config_.retentionTiers.empty() || config_.retentionMaxAgeHours != 0)
+            {
+                if (recycleFiles_)
+                {
+                    // Compaction would delete the files the recycler reuses
+                    printf("Logger: Log retention tiers are not applied to recycled log files\n");
+                }
+                else
+                {
+                    compactor_ = std::make_unique<LogCompactor>(*fileSystem_, config_,
+                                                                blockCodec_ ? &blockCodec_->dictionary() : nullptr);
+                }
+            }
+
             // Create initial log file
-            if (!createNewLogFile())
+            std::unique_lock<std::mutex> fileLock(fileMutex_);
+            bool fileCreated = createNewLogFile();
+            scheduleTimeRotation(timeProvider_->getUnixTimestampMs());
+            fileLock.unlock();
+            if (!fileCreated)
             {
                 printf("Logger: Failed to create initial log file\n");
                 return false;
             }
 
+#ifdef HAS_FORK_SUPPORT
+            // Other processes write into this ring, our writer thread drains it
+            if (config_.sharedRingRole == SharedRingRole::COLLECTOR)
+            {
+                sharedRing_ = SharedLogRing::create(config_.sharedRingName, config_.multiProcessRingSlots);
+                if (!sharedRing_)
+                {
+                    printf("Logger: Failed to create shared ring %s\n", config_.sharedRingName.c_str());
+                }
+            }
+
+            // Children inherit whichever ring exists
+            if (!sharedRing_ && config_.forkSafe && config_.forkChildMode == ForkChildMode::PARENT_RING)
+            {
+                sharedRing_ = SharedLogRing::createAnonymous(config_.multiProcessRingSlots);
+                if (!sharedRing_)
+                {
+                    printf("Logger: Failed to create shared ring, children will use separate files\n");
+                }
+            }
+
+            if (sharedRing_)
+            {
+                sharedRing_->setStallTimeout(config_.sharedRingStallTimeoutMs);
+            }
+#endif
+
+#ifdef HAS_STREAM_SERVER
+            if (!config_.streamSocketPath.empty() || config_.streamTcpPort != 0)
+            {
+                streamServer_ = std::make_unique<LogStreamServer>(
+                    config_.streamSubscriberBufferSize, config_.streamMaxSubscribers,
+                    config_.streamDisconnectSlowSubscribers ? LogStreamServer::SlowSubscriberPolicy::DISCONNECT
+                                                            : LogStreamServer::SlowSubscriberPolicy::DROP_ENTRIES,
+                    [this]
+                    { rebuildComponentGates(); }); // Subscribers take entries below the console/file levels
+                if (!streamServer_->start(config_.streamSocketPath, config_.streamTcpPort))
+                {
+                    printf("Logger: Live streaming unavailable\n");
+                    streamServer_.reset();
+                }
+            }
+#endif
+
             // Start async logging thread if enabled
             if (config_.asyncLogging)
             {
@@ -193,6 +712,17 @@ namespace embedded_logger
 
             initialized_.store(true);
 
+            if (compactor_)
+            {
+                compactionStopping_.store(false);
+                compactionThread_ = std::thread(&Logger::compactionThreadFunction, this);
+            }
+
+            if (config_.forkSafe)
+            {
+                registerForFork();
+            }
+
             // Log system startup
             logSystemStartup("Embedded Logger initialized successfully");
 
@@ -219,24 +749,43 @@ namespace embedded_logger
             return;
         }
 
-        logSystemShutdown();
+        unregisterForFork();
+        stopCompaction();
+
+        // A forked child's banner would land in the parent's file
+        if (!ringProducer_.load() || config_.sharedRingRole == SharedRingRole::PRODUCER)
+        {
+            logSystemShutdown();
+        }
 
         shutdownRequested_.store(true);
 
         // Wake up logger thread and wait for it to finish
         if (config_.asyncLogging && loggerThread_.joinable())
         {
-            queueCondition_.notify_all();
+            notifyWriter();
             loggerThread_.join();
         }
+        drainCondition_.notify_all();
 
-        // Flush and close file
-        std::lock_guard<std::mutex> lock(fileMutex_);
-        if (currentLogStream_ && currentLogStream_->is_open())
+        // Pick up anything children committed after the last pass
+        if (sharedRing_ && !ringProducer_.load())
+        {
+            drainSharedRing();
+        }
+
+#ifdef HAS_STREAM_SERVER
+        // Subscribers get everything written up to here
+        if (streamServer_)
         {
-            currentLogStream_->flush();
-            currentLogStream_->close();
+            streamServer_->stop();
         }
+#endif
+
+        // Flush and close file
+        std::lock_guard<std::mutex> lock(fileMutex_);
+        discardPreparedFile();
+        closeLogFile();
 
         initialized_.store(false);
         printf("Logger: Shutdown completed\n");
@@ -244,8 +793,11 @@ namespace embedded_logger
 
     void Logger::updateConfig(const LoggerConfig &config)
     {
-        std::lock_guard<std::mutex> lock(configMutex_);
-        config_ = config;
+        {
+            std::lock_guard<std::mutex> lock(configMutex_);
+            config_ = config;
+        }
+        rebuildComponentGates();
     }
 
     LoggerConfig Logger::getConfig() const
@@ -289,12 +841,119 @@ namespace embedded_logger
         log(entry, destination);
     }
 
+    void Logger::log(LogLevel level, ComponentId component, const std::string &message,
+                     LogDestination destination)
+    {
+        uint16_t id;
+        uint32_t gate;
+        if (!admit(level, component, id, gate))
+        {
+            return;
+        }
+
+        LogEntry entry(level, componentNames_[id], message);
+        enqueueAdmitted(entry, id, gate, destination);
+    }
+
+    void Logger::debug(ComponentId component, const std::string &message, LogDestination destination)
+    {
+        log(LogLevel::DEBUG, component, message, destination);
+    }
+
+    void Logger::info(ComponentId component, const std::string &message, LogDestination destination)
+    {
+        log(LogLevel::INFO, component, message, destination);
+    }
+
+    void Logger::warning(ComponentId component, const std::string &message, LogDestination destination)
+    {
+        log(LogLevel::WARNING, component, message, destination);
+    }
+
+    void Logger::error(ComponentId component, const std::string &message, LogDestination destination)
+    {
+        log(LogLevel::ERROR, component, message, destination);
+    }
+
+    void Logger::critical(ComponentId component, const std::string &message, LogDestination destination)
+    {
+        log(LogLevel::CRITICAL, component, message, destination);
+    }
+
+    bool Logger::isEnabled(LogLevel level, ComponentId component) const
+    {
+        uint16_t id = component.value < kMaxComponents ? component.value : 0;
+        uint32_t gate = componentGates_[id].load(std::memory_order_relaxed);
+        if (gate == kGateUnresolved)
+        {
+            gate = resolveComponentGate(id);
+        }
+        return static_cast<uint8_t>(level) >= (gate & 0xF);
+    }
+
+    void Logger::setComponentLevel(const std::string &component, LogLevel level)
+    {
+        {
+            std::lock_guard<std::mutex> lock(configMutex_);
+            config_.componentLevels[component] = level;
+        }
+        rebuildComponentGates();
+    }
+
+    void Logger::clearComponentLevel(const std::string &component)
+    {
+        {
+            std::lock_guard<std::mutex> lock(configMutex_);
+            config_.componentLevels.erase(component);
+        }
+        rebuildComponentGates();
+    }
+
+    void Logger::logBinary(LogLevel level, const std::string &component, const void *data, size_t size,
+                           const std::string &message)
+    {
+        if (!initialized_.load() || loggedFromDeferredMessage())
+        {
+            return;
+        }
+        logPayload(level, lookupComponent(component), component, data, size, message);
+    }
+
+    void Logger::logBinary(LogLevel level, ComponentId component, const void *data, size_t size,
+                           const std::string &message)
+    {
+        if (!initialized_.load() || loggedFromDeferredMessage())
+        {
+            return;
+        }
+        uint16_t id = component.value < kMaxComponents ? component.value : 0;
+        logPayload(level, id, componentNames_[id], data, size, message);
+    }
+
+    void Logger::logPayload(LogLevel level, uint16_t componentId, const std::string &component,
+                            const void *data, size_t size, const std::string &message)
+    {
+        uint32_t gate;
+        if (!passesGate(level, componentId, gate))
+        {
+            return;
+        }
+
+        // Producer cost is a copy; hex encoding happens when the entry is formatted
+        LogEntry entry(level, component, message);
+        entry.componentId = componentId;
+        entry.bypassSinkLevels = (gate & kGateExplicit) != 0;
+        entry.payload.assign(static_cast<const char *>(data), std::min(size, config_.maxBinaryPayloadSize));
+        entry.payloadSize = static_cast<uint32_t>(size);
+        enqueueEntry(entry, config_.defaultDestination);
+    }
+
     void Logger::logf(LogLevel level, const std::string &component, const char *format, ...)
     {
         char buffer[1024];
         va_list args;
         va_start(args, format);
-        vsnprintf(buffer, sizeof(buffer), format, args);
+        formatting::formatV(buffer, sizeof(buffer), format, args);
         va_end(args);
 
         LogEntry entry(level, component, std::string(buffer));
@@ -327,20 +986,213 @@ namespace embedded_logger
     {
         if (config_.asyncLogging)
         {
-            // For async logging, wait for queue to empty
+            // The writer signals each time it has emptied the queue and written its batch
             std::unique_lock<std::mutex> lock(queueMutex_);
-            while (!logQueue_.empty() && !shutdownRequested_.load())
+            drainCondition_.wait(lock, [this]
+                                 { return (logQueue_.empty() && !workerBusy_) || shutdownRequested_.load() ||
+                                          !loggerThread_.joinable(); });
+        }
+
+        // Hand pending lines to the file system
+        std::lock_guard<std::mutex> fileLock(fileMutex_);
+        FileWriteStamp stamp(fileWriteStartedMs_, config_.writerStallTimeoutMs != 0 ? timeProvider_->getUnixTimestampMs() : 0);
+        writeFileBuffer();
+        writeValidLength();
+#ifdef HAS_DIRECT_FILE_IO
+        if (directSink_)
+        {
+            directSink_->flush();
+        }
+#endif
+    }
+
+    EmergencyFlushReport Logger::emergencyFlush(std::chrono::steady_clock::time_point deadline)
+    {
+        using Clock = std::chrono::steady_clock;
+        Clock::time_point start = Clock::now();
+        EmergencyFlushReport report;
+        if (!initialized_.load())
+        {
+            return report;
+        }
+
+        // Refuse everything below ERROR from here on
+        if (!emergency_.exchange(true))
+        {
+            rebuildComponentGates();
+        }
+
+        // Take the queue; the writer finishes at most the entry in its hands
+        std::vector<LogEntry> pending;
+        std::unique_lock<std::mutex> queueLock(queueMutex_, std::defer_lock);
+        std::unique_lock<std::mutex> fileLock(fileMutex_, std::defer_lock);
+        if (!lockBefore(queueLock, deadline))
+        {
+            report.lockTimedOut = true;
+            report.elapsedUs = static_cast<uint32_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+            return report;
+        }
+        pending.reserve(logQueue_.size());
+        while (!logQueue_.empty())
+        {
+            pending.push_back(std::move(logQueue_.front()));
+            logQueue_.pop();
+        }
+        queueLock.unlock();
+
+        std::vector<bool> written(pending.size(), false);
+        bool inTime = lockBefore(fileLock, deadline) && isLogFileOpen();
+        report.lockTimedOut = !fileLock.owns_lock();
+        if (inTime)
+        {
+            FileWriteStamp stamp(fileWriteStartedMs_, config_.writerStallTimeoutMs != 0 ? timeProvider_->getUnixTimestampMs() : 0);
+
+            // Lines formatted earlier follow the severe entries, not precede them
+            std::string tail;
+            std::vector<uint64_t> tailTokens;
+            tail.swap(fileBuffer_);
+            tailTokens.swap(blockTokens_);
+
+            LogDestination destination = config_.defaultDestination;
+            auto forFile = [&](const LogEntry &entry)
+            {
+                return hasDestination(destination, LogDestination::FILE_ONLY) &&
+                       (entry.bypassSinkLevels || entry.level >= config_.fileLogLevel);
+            };
+
+            // Bounded writes of whole lines; lines of a write not started are given back
+            std::vector<size_t> inBlock;
+            auto writeBlock = [&](size_t &count)
+            {
+                if (fileBuffer_.empty())
+                {
+                    return true;
+                }
+                if (Clock::now() >= deadline)
+                {
+                    currentFileSize_ -= blockCodec_ ? 0 : fileBuffer_.size();
+                    fileBuffer_.clear();
+                    blockTokens_.clear();
+                    inBlock.clear();
+                    return false;
+                }
+                size_t size = fileBuffer_.size();
+                writeFileBuffer();
+                report.bytesWritten += blockCodec_ ? blockBuffer_.size() : size;
+                for (size_t index : inBlock)
+                {
+                    written[index] = true;
+                }
+                count += inBlock.size();
+                inBlock.clear();
+                return true;
+            };
+            auto writeEntries = [&](bool severe, size_t &count)
+            {
+                for (size_t i = 0; i < pending.size(); ++i)
+                {
+                    LogEntry &entry = pending[i];
+                    if ((entry.level >= LogLevel::ERROR) != severe || !forFile(entry))
+                    {
+                        continue;
+                    }
+                    resolveDeferredMessage(entry);
+                    appendToFileBuffer(entry);
+                    inBlock.push_back(i);
+                    if (fileBuffer_.size() >= config_.emergencyFlushBlockSize && !writeBlock(count))
+                    {
+                        return false;
+                    }
+                }
+                return writeBlock(count);
+            };
+
+            for (const LogEntry &entry : pending)
+            {
+                if (forFile(entry))
+                {
+                    (entry.level >= LogLevel::ERROR ? report.severePending : report.otherPending)++;
+                }
+            }
+
+            inTime = writeEntries(true, report.severeWritten);
+            if (inTime && !tail.empty())
+            {
+                inTime = Clock::now() < deadline;
+                if (inTime)
+                {
+                    fileBuffer_.swap(tail);
+                    blockTokens_.swap(tailTokens);
+                    size_t size = fileBuffer_.size();
+                    writeFileBuffer();
+                    report.bytesWritten += blockCodec_ ? blockBuffer_.size() : size;
+                    report.tailWritten = true;
+                }
+            }
+            if (inTime)
             {
-                queueCondition_.notify_all();
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                inTime = writeEntries(false, report.otherWritten);
             }
+            if (inTime && Clock::now() < deadline)
+            {
+                writeValidLength();
+#ifdef HAS_DIRECT_FILE_IO
+                report.synced = directSink_ ? directSink_->flush() : fileSystem_->syncFile(currentLogHandle_);
+#else
+                report.synced = fileSystem_->syncFile(currentLogHandle_);
+#endif
+            }
+            if (!tail.empty())
+            {
+                // Not reached: leave it for the next batch
+                fileBuffer_.swap(tail);
+                blockTokens_.swap(tailTokens);
+            }
+        }
+        if (fileLock.owns_lock())
+        {
+            fileLock.unlock();
         }
 
-        // Flush file stream
-        std::lock_guard<std::mutex> fileLock(fileMutex_);
-        if (currentLogStream_ && currentLogStream_->is_open())
+        // Anything not written is still logged if power holds
+        report.completed = report.synced;
+        std::vector<LogEntry> unwritten;
+        for (size_t i = 0; i < pending.size(); ++i)
+        {
+            if (!written[i])
+            {
+                unwritten.push_back(std::move(pending[i]));
+            }
+        }
+        if (!unwritten.empty())
+        {
+            queueLock.lock();
+            std::queue<LogEntry> newer;
+            newer.swap(logQueue_);
+            for (LogEntry &entry : unwritten)
+            {
+                logQueue_.push(std::move(entry));
+            }
+            while (!newer.empty())
+            {
+                logQueue_.push(std::move(newer.front()));
+                newer.pop();
+            }
+            notifyWriter();
+        }
+
+        report.elapsedUs = static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+        return report;
+    }
+
+    void Logger::endEmergency()
+    {
+        if (emergency_.exchange(false))
         {
-            currentLogStream_->flush();
+            rebuildComponentGates();
+            logInternal(LogLevel::WARNING, "Emergency ended, all levels accepted again");
         }
     }
 
@@ -356,45 +1208,198 @@ namespace embedded_logger
 
     void Logger::log(const LogEntry &entry, LogDestination destination)
     {
-        if (!initialized_.load())
+        if (!initialized_.load() || loggedFromDeferredMessage())
+        {
+            return;
+        }
+
+        // Level filtering and load shedding, decided before any formatting work
+        uint16_t id = lookupComponent(entry.component);
+        uint32_t gate;
+        if (!passesGate(entry.level, id, gate))
         {
             return;
         }
 
-        // Create complete log entry with timestamp
         LogEntry completeEntry = entry;
-        completeEntry.timestamp = getCurrentTimestamp();
+        completeEntry.componentId = id;
+        completeEntry.bypassSinkLevels = (gate & kGateExplicit) != 0;
+        enqueueEntry(completeEntry, destination);
+    }
+
+    bool Logger::admit(LogLevel level, const std::string &component, uint16_t &componentId, uint32_t &gate)
+    {
+        if (!initialized_.load() || loggedFromDeferredMessage())
+        {
+            return false;
+        }
+        componentId = lookupComponent(component);
+        return passesGate(level, componentId, gate);
+    }
+
+    bool Logger::admit(LogLevel level, ComponentId component, uint16_t &componentId, uint32_t &gate)
+    {
+        if (!initialized_.load() || loggedFromDeferredMessage())
+        {
+            return false;
+        }
+        componentId = component.value < kMaxComponents ? component.value : 0;
+        return passesGate(level, componentId, gate);
+    }
+
+    void Logger::enqueueAdmitted(LogEntry &entry, uint16_t componentId, uint32_t gate, LogDestination destination)
+    {
+        entry.componentId = componentId;
+        entry.bypassSinkLevels = (gate & kGateExplicit) != 0;
+        enqueueEntry(entry, destination);
+    }
+
+    void Logger::resolveDeferredMessage(LogEntry &entry)
+    {
+        if (!entry.deferredMessage)
+        {
+            return;
+        }
+
+        buildingDeferredMessage = true;
+        try
+        {
+            entry.message = entry.deferredMessage();
+        }
+        catch (const std::exception &e)
+        {
+            entry.message = std::string("<message not built: ") + e.what() + ">";
+        }
+        catch (...)
+        {
+            entry.message = "<message not built>";
+        }
+        buildingDeferredMessage = false;
+        entry.deferredMessage = nullptr; // Release the captures
+    }
+
+    bool Logger::reachesSink(const LogEntry &entry, LogDestination destination) const
+    {
+        // The gate covers the lower of the two levels; this is the per-destination answer
+        if (entry.bypassSinkLevels ||
+            (hasDestination(destination, LogDestination::CONSOLE_ONLY) && entry.level >= config_.consoleLogLevel) ||
+            (hasDestination(destination, LogDestination::FILE_ONLY) && entry.level >= config_.fileLogLevel))
+        {
+            return true;
+        }
+#ifdef HAS_STREAM_SERVER
+        return streamServer_ && streamServer_->hasSubscribers();
+#else
+        return false;
+#endif
+    }
+
+    void Logger::enqueueEntry(LogEntry &completeEntry, LogDestination destination)
+    {
+        if (forkRestartPending_.load(std::memory_order_acquire))
+        {
+            finishForkChild();
+            if (!initialized_.load())
+            {
+                return;
+            }
+        }
         completeEntry.timestampMs = timeProvider_->getUnixTimestampMs();
+        if (completeEntry.timestampMs >= nextBurstEndMs_.load(std::memory_order_relaxed))
+        {
+            // Admitted by a burst that is over: ask the restored gate again
+            endDebugBursts(completeEntry.timestampMs);
+            uint32_t gate;
+            if (!passesGate(completeEntry.level, completeEntry.componentId, gate))
+            {
+                return;
+            }
+            completeEntry.bypassSinkLevels = (gate & kGateExplicit) != 0;
+        }
+        if (!reachesSink(completeEntry, destination))
+        {
+            return;
+        }
 
-        if (config_.asyncLogging)
+        // Complete the log entry with timestamp
+        completeEntry.timestamp = getCurrentTimestamp();
+        if (!completeEntry.context)
+        {
+            // Reference, not a copy: the context node is shared with the scope
+            completeEntry.context = LogContext::current();
+        }
+
+#ifdef HAS_BACKTRACE_CAPTURE
+        // Raw addresses only; tools/symbolize resolves them against the file's module records
+        if (config_.captureBacktraces && completeEntry.level >= config_.backtraceLevel &&
+            completeEntry.backtrace.empty())
+        {
+            uintptr_t frames[BacktraceCapture::kMaxDepth];
+            size_t depth = BacktraceCapture::capture(frames, config_.backtraceDepth, 1);
+            completeEntry.backtrace.assign(frames, frames + depth);
+        }
+#endif
+
+        bool handled = false;
+#ifdef HAS_FORK_SUPPORT
+        if (ringProducer_.load(std::memory_order_relaxed))
+        {
+            // Forked child: the parent's writer owns the file
+            resolveDeferredMessage(completeEntry);
+            sharedRing_->push(completeEntry);
+            handled = true;
+        }
+#endif
+
+        if (!handled && config_.writerStallTimeoutMs != 0)
+        {
+            handled = holdWhileWriterStalled(completeEntry, destination);
+        }
+
+        if (!handled && config_.asyncLogging)
         {
             // Add to queue for background processing
             std::lock_guard<std::mutex> lock(queueMutex_);
             logQueue_.push(completeEntry);
-            queueCondition_.notify_one();
+            notifyWriter();
         }
-        else
+        else if (!handled)
         {
             // Process immediately
+            resolveDeferredMessage(completeEntry);
             processLogEntry(completeEntry, destination);
         }
 
         totalLogCount_++;
+
+        // After the entry, so the burst record follows the error that started it
+        if (completeEntry.level >= LogLevel::ERROR && config_.debugBurstMs != 0)
+        {
+            startDebugBurst(completeEntry);
+        }
     }
 
     void Logger::processLogEntry(const LogEntry &entry, LogDestination destination)
     {
-        if ((destination & LogDestination::CONSOLE_ONLY) &&
-            entry.level >= config_.consoleLogLevel)
+        if (hasDestination(destination, LogDestination::CONSOLE_ONLY) &&
+            (entry.bypassSinkLevels || entry.level >= config_.consoleLogLevel))
         {
             writeToConsole(entry);
         }
 
-        if ((destination & LogDestination::FILE_ONLY) &&
-            entry.level >= config_.fileLogLevel)
+        if (hasDestination(destination, LogDestination::FILE_ONLY) &&
+            (entry.bypassSinkLevels || entry.level >= config_.fileLogLevel))
         {
             writeToFile(entry);
         }
+
+#ifdef HAS_STREAM_SERVER
+        // Subscribers filter on their own, independent of console/file levels
+        if (streamServer_ && streamServer_->hasSubscribers())
+        {
+            streamServer_->publish(entry, formatLogEntry(entry, false));
+        }
+#endif
     }
 
     void Logger::writeToConsole(const LogEntry &entry)
@@ -408,153 +1413,1622 @@ namespace embedded_logger
     {
         std::lock_guard<std::mutex> lock(fileMutex_);
 
-        if (!currentLogStream_ || !currentLogStream_->is_open())
+        if (!isLogFileOpen())
         {
             return;
         }
+        FileWriteStamp stamp(fileWriteStartedMs_, config_.writerStallTimeoutMs != 0 ? timeProvider_->getUnixTimestampMs() : 0);
+
+        // Entries of a new period go to its file
+        if (entry.timestampMs >= nextRotationTick_.load(std::memory_order_relaxed))
+        {
+            rotateOnTime(entry.timestampMs);
+        }
 
-        std::string formatted = formatLogEntry(entry, false);
-        *currentLogStream_ << formatted << std::endl;
+        appendToFileBuffer(entry);
 
-        currentFileSize_ += formatted.length() + 1;
+        // Async: batch lines into few large writes. Sync: write through.
+        if (!config_.asyncLogging || fileBuffer_.size() >= config_.fileWriteBatchSize)
+        {
+            writeFileBuffer();
+        }
 
         // Check if rotation is needed
-        if (currentFileSize_ >= config_.maxFileSize)
+        if (rotationEnabled_ && currentFileSize_ >= config_.maxFileSize && config_.rotationPolicy != RotationPolicy::TIME)
         {
             rotateLogFileIfNeeded();
         }
     }
 
+    void Logger::appendToFileBuffer(const LogEntry &entry)
+    {
+        // Caller holds fileMutex_
+        std::string line = formatLogEntry(entry, false);
+        if (blockCodec_ && config_.blockFilterBitsPerToken != 0)
+        {
+            BlockFilter::addLine(line, blockTokens_);
+        }
+        fileBuffer_ += line;
+        fileBuffer_ += '\n';
+        if (!blockCodec_)
+        {
+            currentFileSize_ += line.size() + 1; // Compressed blocks count when written
+        }
+    }
+
     void Logger::rotateLogFileIfNeeded()
     {
-        if (currentFileSize_ < config_.maxFileSize)
+        if (currentFileSize_ < config_.maxFileSize || config_.rotationPolicy == RotationPolicy::TIME)
         {
             return;
         }
 
-        currentLogStream_->close();
+        rotateLogFile(std::string());
+    }
+
+    void Logger::rotateLogFile(const std::string &fileName)
+    {
+        // Caller holds fileMutex_
+        closeLogFile();
 
         try
         {
-            // Rotate existing backup files
-            for (int i = config_.maxBackupFiles - 1; i > 0; --i)
+            if (recycleFiles_)
             {
-                std::string oldFile = currentLogFile_ + "." + std::to_string(i);
-                std::string newFile = currentLogFile_ + "." + std::to_string(i + 1);
-
-                if (fileSystem_->fileExists(oldFile))
-                {
-                    if (i == config_.maxBackupFiles - 1)
-                    {
-                        fileSystem_->deleteFile(newFile);
-                    }
-                    fileSystem_->renameFile(oldFile, newFile);
-                }
+                recycleLogFile();
+                return;
             }
 
-            // Move current log to .1
-            std::string backupFile = currentLogFile_ + ".1";
-            fileSystem_->renameFile(currentLogFile_, backupFile);
+            if (config_.rotationPolicy == RotationPolicy::SIZE)
+            {
+                // Same backup scheme as the binary sinks (CAN, telemetry)
+                RotatingFileWriter::shiftBackups(*fileSystem_, currentLogFile_, config_.maxBackupFiles);
+                createNewLogFile(fileName);
+                return;
+            }
 
-            // Create new log file
-            createNewLogFile();
+            // Time rotation: every file keeps its period's name and the oldest go by count.
+            // Only a size rotation within the same second needs the old file moved aside.
+            std::string nextFile = fileName.empty() ? logFileNameAt(fileTimestamp(timeProvider_->getUnixTimestampMs()))
+                                                    : fileName;
+            if (nextFile == currentLogFile_)
+            {
+                RotatingFileWriter::shiftBackups(*fileSystem_, currentLogFile_, config_.maxBackupFiles);
+            }
+            createNewLogFile(nextFile);
+            pruneRotatedFiles();
         }
         catch (const std::exception &e)
         {
             printf("Logger: Failed to rotate log file: %s\n", e.what());
             // Try to reopen current file
-            currentLogStream_ = std::make_unique<std::ofstream>(currentLogFile_, std::ios::app);
+            openLogFile();
         }
     }
 
-    bool Logger::createNewLogFile()
+    void Logger::scheduleTimeRotation(uint64_t nowMs)
     {
-        std::string timestamp = getCurrentTimestamp();
-        // Replace colons and spaces with underscores for filename
-        std::replace(timestamp.begin(), timestamp.end(), ':', '_');
-        std::replace(timestamp.begin(), timestamp.end(), ' ', '_');
-
-        currentLogFile_ = config_.logDirectory + "/" + config_.logFilePrefix + "_" +
-                          timestamp + config_.logFileExtension;
-        currentFileSize_ = 0;
-
-        std::lock_guard<std::mutex> lock(fileMutex_);
-        currentLogStream_ = std::make_unique<std::ofstream>(currentLogFile_, std::ios::app);
-
-        if (!currentLogStream_->is_open())
+        // Caller holds fileMutex_
+        if (config_.rotationPolicy == RotationPolicy::SIZE || !rotationEnabled_)
         {
-            printf("Logger: Failed to create log file: %s\n", currentLogFile_.c_str());
-            return false;
+            nextRotationTick_.store(kNoRotationTick, std::memory_order_relaxed);
+            return;
         }
 
-        // Write file header
-        *currentLogStream_ << "# Embedded Logger Library Log File" << std::endl;
-        *currentLogStream_ << "# Created: " << getCurrentTimestamp() << std::endl;
-        *currentLogStream_ << "# Format: [Timestamp] [Level] [Component] Message" << std::endl;
-        *currentLogStream_ << std::string(80, '=') << std::endl;
-
-        return true;
+        // The direct sink and recycled files open their file in place, so only the boundary is a step
+        rotationBoundaryMs_ = rotationPeriodStart(nowMs, config_.rotationInterval, true);
+        uint64_t prepareMs = rotationBoundaryMs_ - std::min<uint64_t>(config_.rotationPrepareMs, rotationBoundaryMs_);
+        bool prepare = !recycleFiles_ && !directSink_ && prepareMs > nowMs;
+        nextRotationTick_.store(prepare ? prepareMs : rotationBoundaryMs_, std::memory_order_relaxed);
     }
 
-    void Logger::loggerThreadFunction()
+    void Logger::rotateOnTime(uint64_t nowMs)
     {
-        while (!shutdownRequested_.load())
+        // Caller holds fileMutex_
+        if (nowMs < rotationBoundaryMs_)
         {
-            std::unique_lock<std::mutex> lock(queueMutex_);
-
-            // Wait for log entries or shutdown signal
-            queueCondition_.wait(lock, [this]
-                                 { return !logQueue_.empty() || shutdownRequested_.load(); });
-
+            // Ahead of the boundary: create the file now so the switch is only a handle swap
+            if (preparedHandle_ == kInvalidFileHandle)
+            {
+                preparedFile_ = logFileNameAt(fileTimestamp(rotationBoundaryMs_));
+                preparedHandle_ = fileSystem_->openFile(preparedFile_, FileOpenMode::APPEND);
+            }
+            nextRotationTick_.store(rotationBoundaryMs_, std::memory_order_relaxed);
+            return;
+        }
+
+        // Named after the period the switch falls in, which after a quiet spell is not the prepared one
+        std::string fileName = logFileNameAt(fileTimestamp(rotationPeriodStart(nowMs, config_.rotationInterval, false)));
+        if (preparedFile_ != fileName)
+        {
+            discardPreparedFile();
+        }
+        rotateLogFile(fileName);
+        scheduleTimeRotation(nowMs);
+    }
+
+    void Logger::pruneRotatedFiles()
+    {
+        // Caller holds fileMutex_. Level-tiered retention owns the old files when configured.
+        if (compactor_ || config_.maxBackupFiles < 0)
+        {
+            return;
+        }
+
+        std::vector<std::string> names;
+        if (!fileSystem_->listDirectory(config_.logDirectory, names))
+        {
+            if (!pruneListWarned_)
+            {
+                printf("Logger: Cannot list %s, time-rotated log files are not pruned\n", config_.logDirectory.c_str());
+                pruneListWarned_ = true;
+            }
+            return;
+        }
+
+        // <prefix>_<YYYY-MM-DD_HH_MM_SS><suffix><extension>, plus any ".N" of a same-second rotation;
+        // the timestamp sorts by age. Other processes' files differ in the suffix.
+        const size_t kTimestampLength = 19;
+        std::string head = config_.logFilePrefix + "_";
+        std::string tail = fileNameSuffix_ + config_.logFileExtension;
+        std::string liveName = currentLogFile_.substr(currentLogFile_.find_last_of('/') + 1);
+        size_t tailAt = head.size() + kTimestampLength;
+        size_t nameLength = tailAt + tail.size();
+        std::vector<std::string> rotated;
+        for (const std::string &name : names)
+        {
+            if (name != liveName && name.size() >= nameLength && name.compare(0, head.size(), head) == 0 &&
+                std::isdigit(static_cast<unsigned char>(name[head.size()])) &&
+                name.compare(tailAt, tail.size(), tail) == 0 &&
+                (name.size() == nameLength || name[nameLength] == '.'))
+            {
+                rotated.push_back(name);
+            }
+        }
+        if (rotated.size() <= static_cast<size_t>(config_.maxBackupFiles))
+        {
+            return;
+        }
+
+        // Oldest first: by period, then ".N" backups of a period before the file itself
+        auto backupNumber = [nameLength](const std::string &name)
+        { return name.size() > nameLength ? std::strtoul(name.c_str() + nameLength + 1, nullptr, 10) : 0ul; };
+        std::sort(rotated.begin(), rotated.end(), [&](const std::string &a, const std::string &b)
+                  {
+                      int order = a.compare(0, nameLength, b, 0, nameLength);
+                      return order != 0 ? order < 0 : backupNumber(a) > backupNumber(b);
+                  });
+        for (size_t i = 0; i + config_.maxBackupFiles < rotated.size(); ++i)
+        {
+            fileSystem_->deleteFile(config_.logDirectory + "/" + rotated[i]);
+        }
+    }
+
+    void Logger::discardPreparedFile()
+    {
+        // Caller holds fileMutex_. Nothing has been written to it yet.
+        if (preparedHandle_ != kInvalidFileHandle)
+        {
+            fileSystem_->closeFile(preparedHandle_);
+            fileSystem_->deleteFile(preparedFile_);
+            preparedHandle_ = kInvalidFileHandle;
+        }
+        preparedFile_.clear();
+    }
+
+    std::string Logger::logFileNameAt(const std::string &timestamp) const
+    {
+        return config_.logDirectory + "/" + config_.logFilePrefix + "_" + timestamp + fileNameSuffix_ +
+               config_.logFileExtension;
+    }
+
+    bool Logger::createNewLogFile(const std::string &fileName)
+    {
+        if (fileName.empty() && recycleFiles_)
+        {
+            // One live name across restarts: a boot shifts the previous set instead of starting another
+            currentLogFile_ = logFileNameAt("live");
+            if (fileSystem_->fileExists(currentLogFile_))
+            {
+                return recycleLogFile();
+            }
+        }
+        else if (fileName.empty())
+        {
+            std::string timestamp = getCurrentTimestamp();
+            // Replace colons and spaces with underscores for filename
+            std::replace(timestamp.begin(), timestamp.end(), ':', '_');
+            std::replace(timestamp.begin(), timestamp.end(), ' ', '_');
+            currentLogFile_ = logFileNameAt(timestamp);
+        }
+        else
+        {
+            currentLogFile_ = fileName;
+        }
+        currentFileSize_ = 0;
+
+        // Caller holds fileMutex_ (rotation runs inside writeToFile())
+        if (preparedHandle_ != kInvalidFileHandle && preparedFile_ == currentLogFile_)
+        {
+            currentLogHandle_ = preparedHandle_;
+            preparedHandle_ = kInvalidFileHandle;
+            preparedFile_.clear();
+        }
+        else if (!openLogFile(recycleFiles_ ? FileOpenMode::OVERWRITE : FileOpenMode::APPEND))
+        {
+            printf("Logger: Failed to create log file: %s\n", currentLogFile_.c_str());
+            return false;
+        }
+
+        if (recycleFiles_)
+        {
+            preallocateLogFile();
+        }
+        writeFileHeader();
+
+        return true;
+    }
+
+    bool Logger::recycleLogFile()
+    {
+        // Caller holds fileMutex_. The live file keeps its name, so the
+        // oldest backup can take its place and the set of files stays fixed.
+        bool reuse = true;
+        if (config_.maxBackupFiles > 0)
+        {
+            std::string oldest = currentLogFile_ + "." + std::to_string(config_.maxBackupFiles);
+            std::string spare = currentLogFile_ + ".spare";
+            reuse = fileSystem_->fileExists(oldest) && fileSystem_->renameFile(oldest, spare);
+            RotatingFileWriter::shiftBackups(*fileSystem_, currentLogFile_, config_.maxBackupFiles);
+            reuse = reuse && fileSystem_->renameFile(spare, currentLogFile_);
+        }
+
+        currentFileSize_ = 0;
+        if (!openLogFile(FileOpenMode::OVERWRITE))
+        {
+            printf("Logger: Failed to reopen recycled log file: %s\n", currentLogFile_.c_str());
+            return false;
+        }
+
+        // Until the backup set is full there is nothing to reuse yet
+        if (!reuse)
+        {
+            preallocateLogFile();
+        }
+        writeFileHeader();
+        return true;
+    }
+
+    void Logger::preallocateLogFile()
+    {
+        // Caller holds fileMutex_
+        uint64_t size = config_.maxFileSize;
+        if (fileSystem_->preallocateFile(currentLogHandle_, size))
+        {
+            return;
+        }
+
+        // No fallocate(): write zeros once so later passes only overwrite allocated blocks
+        std::string zeros(static_cast<size_t>(std::min<uint64_t>(size, 64 * 1024)), '\0');
+        for (uint64_t offset = 0; offset < size; offset += zeros.size())
+        {
+            size_t length = static_cast<size_t>(std::min<uint64_t>(zeros.size(), size - offset));
+            if (!fileSystem_->writeFileAt(currentLogHandle_, offset, zeros.data(), length))
+            {
+                break;
+            }
+        }
+    }
+
+    void Logger::writeFileHeader()
+    {
+        // Caller holds fileMutex_
+        fileValidLength_ = 0;
+        fileValidLengthOnDisk_ = 0;
+        std::string header = kLogFileTitle;
+        if (recycleFiles_)
+        {
+            // Fixed width so it can be rewritten in place; filled in with the header's own length below
+            header += kValidLengthLabel;
+            header.append(kValidLengthDigits, '0');
+            header += '\n';
+        }
+        if (blockCodec_)
+        {
+            // Plain text like the rest of the header; readers check they have this dictionary
+            char id[9];
+            snprintf(id, sizeof(id), "%08x", blockCodec_->dictionary().id());
+            header += std::string(LogBlockCodec::kHeaderLabel) + id + "\n";
+        }
+        header += "# Created: " + getCurrentTimestamp() + "\n# Format: [Timestamp] [Level] [Component] Message\n";
+#ifdef HAS_BACKTRACE_CAPTURE
+        if (config_.captureBacktraces)
+        {
+            // Load addresses differ per run (ASLR); record them with every file
+            BacktraceCapture::appendModuleRecords(header);
+        }
+#endif
+        header += std::string(80, '=') + "\n";
+        if (recycleFiles_)
+        {
+            char field[kValidLengthDigits + 1];
+            snprintf(field, sizeof(field), "%020zu", header.size());
+            header.replace(kValidLengthOffset, kValidLengthDigits, field);
+            fileValidLengthOnDisk_ = header.size();
+        }
+        writeFileData(header);
+    }
+
+    bool Logger::readLogFile(const std::string &path, std::string &contents, const LogDictionary *dictionary)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+
+        std::ostringstream stream;
+        stream << file.rdbuf();
+        contents = stream.str();
+
+        if (contents.compare(0, sizeof(kLogFileTitle) - 1, kLogFileTitle) == 0 &&
+            contents.compare(sizeof(kLogFileTitle) - 1, sizeof(kValidLengthLabel) - 1, kValidLengthLabel) == 0)
+        {
+            size_t validLength = static_cast<size_t>(
+                std::strtoull(contents.c_str() + kValidLengthOffset, nullptr, 10));
+            contents.resize(std::min(validLength, contents.size()));
+        }
+
+        // Compressed files: plain header, then one block per write
+        std::string separator = "\n" + std::string(80, '=') + "\n";
+        size_t headerEnd = contents.find(separator);
+        size_t label = contents.find(std::string("\n") + LogBlockCodec::kHeaderLabel);
+        if (headerEnd == std::string::npos || label == std::string::npos || label > headerEnd)
+        {
+            return true;
+        }
+        headerEnd += separator.size();
+
+        uint32_t id = static_cast<uint32_t>(
+            std::strtoul(contents.c_str() + label + sizeof(LogBlockCodec::kHeaderLabel), nullptr, 16));
+        if (id != (dictionary ? dictionary->id() : 0))
+        {
+            printf("Logger: %s needs compression dictionary %08x\n", path.c_str(), id);
+            return false;
+        }
+
+        LogBlockCodec codec(id != 0 ? *dictionary : LogDictionary());
+        std::string decoded = contents.substr(0, headerEnd);
+        const char *cursor = contents.data() + headerEnd;
+        const char *end = contents.data() + contents.size();
+        while (cursor < end && codec.readBlock(cursor, end, decoded))
+        {
+        }
+        contents.swap(decoded);
+        return true;
+    }
+
+    bool Logger::openLogFile(FileOpenMode mode)
+    {
+        // Caller holds fileMutex_
+#ifdef HAS_DIRECT_FILE_IO
+        if (directSink_)
+        {
+            return directSink_->open(currentLogFile_);
+        }
+#endif
+        currentLogHandle_ = fileSystem_->openFile(currentLogFile_, mode);
+        return currentLogHandle_ != kInvalidFileHandle;
+    }
+
+    bool Logger::isLogFileOpen() const
+    {
+#ifdef HAS_DIRECT_FILE_IO
+        if (directSink_)
+        {
+            return directSink_->isOpen();
+        }
+#endif
+        return currentLogHandle_ != kInvalidFileHandle;
+    }
+
+    void Logger::writeFileBuffer()
+    {
+        // Caller holds fileMutex_
+        if (fileBuffer_.empty() || !isLogFileOpen())
+        {
+            return;
+        }
+
+        if (blockCodec_)
+        {
+            // Each batch is one self-contained block, so a torn write loses only that batch
+            blockBuffer_.clear();
+            if (config_.blockFilterBitsPerToken != 0)
+            {
+                // Filter and block go out in one write
+                BlockFilter::appendFrame(blockTokens_, config_.blockFilterBitsPerToken, blockBuffer_);
+                blockTokens_.clear();
+            }
+            blockCodec_->appendBlock(fileBuffer_.data(), fileBuffer_.size(), blockBuffer_);
+            currentFileSize_ += blockBuffer_.size();
+            writeFileData(blockBuffer_);
+        }
+        else
+        {
+            writeFileData(fileBuffer_);
+        }
+        fileBuffer_.clear();
+    }
+
+    void Logger::writeFileData(const std::string &data)
+    {
+        // Caller holds fileMutex_
+        if (data.empty() || !isLogFileOpen())
+        {
+            return;
+        }
+
+        bool written;
+#ifdef HAS_DIRECT_FILE_IO
+        if (directSink_)
+        {
+            written = directSink_->write(data.data(), data.size());
+        }
+        else
+#endif
+        {
+            written = fileSystem_->appendFile(currentLogHandle_, data.data(), data.size());
+        }
+
+        if (!written)
+        {
+            printf("Logger: Failed to write %zu bytes to %s\n", data.size(), currentLogFile_.c_str());
+        }
+        else if (recycleFiles_)
+        {
+            fileValidLength_ += data.size();
+            if (fileValidLength_ - fileValidLengthOnDisk_ >= config_.validLengthUpdateBytes)
+            {
+                writeValidLength();
+            }
+        }
+    }
+
+    void Logger::writeValidLength()
+    {
+        // Caller holds fileMutex_. Older contents follow the new data until
+        // overwritten; readers stop at the recorded length, so at most
+        // validLengthUpdateBytes of the newest data are lost if power fails.
+        if (!recycleFiles_ || fileValidLength_ == fileValidLengthOnDisk_ || !isLogFileOpen())
+        {
+            return;
+        }
+        char field[kValidLengthDigits + 1];
+        snprintf(field, sizeof(field), "%020zu", fileValidLength_);
+        if (fileSystem_->writeFileAt(currentLogHandle_, kValidLengthOffset, field, kValidLengthDigits))
+        {
+            fileValidLengthOnDisk_ = fileValidLength_;
+        }
+    }
+
+    void Logger::closeLogFile()
+    {
+        // Caller holds fileMutex_
+        writeFileBuffer();
+        writeValidLength();
+#ifdef HAS_DIRECT_FILE_IO
+        if (directSink_)
+        {
+            // Writes the partial tail block and trims the padding
+            directSink_->close();
+        }
+#endif
+        if (currentLogHandle_ != kInvalidFileHandle)
+        {
+            fileSystem_->closeFile(currentLogHandle_);
+            currentLogHandle_ = kInvalidFileHandle;
+        }
+    }
+
+    void Logger::loggerThreadFunction()
+    {
+        constexpr uint64_t kWaitForever = UINT64_MAX;
+        while (!shutdownRequested_.load())
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+
+            // Wait for log entries or shutdown signal. While shedding load, wake
+            // periodically so verbosity can be restored.
+            auto ready = [this]
+            { return !logQueue_.empty() || shutdownRequested_.load() || writerDegraded_.load(); };
+            uint64_t waitMs = kWaitForever;
+            if (adaptiveState_.load(std::memory_order_relaxed) != AdaptiveVerbosityState::NORMAL)
+            {
+                waitMs = 100;
+            }
+            else if (nextRotationTick_.load(std::memory_order_relaxed) != kNoRotationTick ||
+                     nextBurstEndMs_.load(std::memory_order_relaxed) != kNoDebugBurst)
+            {
+                // Wake for the next rotation step or burst end even when nothing is logged;
+                // at least once a second, so a wall clock set forward is caught up promptly
+                uint64_t nowMs = timeProvider_->getUnixTimestampMs();
+                uint64_t tick = std::min(nextRotationTick_.load(std::memory_order_relaxed),
+                                         nextBurstEndMs_.load(std::memory_order_relaxed));
+                waitMs = tick > nowMs ? std::min<uint64_t>(tick - nowMs, 1000) : 0;
+            }
+#ifdef HAS_FORK_SUPPORT
+            if (sharedRing_)
+            {
+                // Children cannot signal our condition variable, so with a shared
+                // ring every producer rings the ring's doorbell instead
+                uint32_t ticket = sharedRing_->prepareWait();
+                if (!ready())
+                {
+                    lock.unlock();
+                    sharedRing_->wait(ticket, waitMs == kWaitForever ? SharedLogRing::kWaitForever
+                                                                    : static_cast<uint32_t>(waitMs));
+                    lock.lock();
+                }
+            }
+            else
+#endif
+            if (waitMs == kWaitForever)
+            {
+                queueCondition_.wait(lock, ready);
+            }
+            else
+            {
+                queueCondition_.wait_for(lock, std::chrono::milliseconds(waitMs), ready);
+            }
+            if (adaptiveState_.load(std::memory_order_relaxed) != AdaptiveVerbosityState::NORMAL)
+            {
+                // Whichever wait woke us, an idle queue lets verbosity step back
+                size_t queueDepth = logQueue_.size();
+                workerBusy_ = true;
+                lock.unlock();
+                updateAdaptiveVerbosity(queueDepth, 0);
+                lock.lock();
+            }
+
             // Process all queued entries
+            size_t sinceEvaluation = 0;
             while (!logQueue_.empty())
             {
-                LogEntry entry = logQueue_.front();
+                LogEntry entry = std::move(logQueue_.front());
                 logQueue_.pop();
+                workerBusy_ = true;
                 lock.unlock();
 
                 // Process the log entry
+                resolveDeferredMessage(entry);
                 processLogEntry(entry, config_.defaultDestination);
 
                 lock.lock();
+
+                if (config_.adaptiveVerbosity && (++sinceEvaluation >= 64 || logQueue_.empty()))
+                {
+                    sinceEvaluation = 0;
+                    size_t queueDepth = logQueue_.size();
+                    lock.unlock();
+                    updateAdaptiveVerbosity(queueDepth, entry.timestampMs);
+                    lock.lock();
+                }
+            }
+
+            // Queue is empty: pick up children's entries, then write the batch
+            workerBusy_ = true;
+            lock.unlock();
+            if (sharedRing_)
+            {
+                drainSharedRing();
+            }
+            if (nextBurstEndMs_.load(std::memory_order_relaxed) != kNoDebugBurst)
+            {
+                uint64_t nowMs = timeProvider_->getUnixTimestampMs();
+                if (nowMs >= nextBurstEndMs_.load(std::memory_order_relaxed))
+                {
+                    endDebugBursts(nowMs);
+                }
+            }
+            if (writerDegraded_.load() && fileWriteStartedMs_.load(std::memory_order_relaxed) == 0)
+            {
+                recoverStalledWriter();
+            }
+            {
+                std::lock_guard<std::mutex> fileLock(fileMutex_);
+                FileWriteStamp stamp(fileWriteStartedMs_, config_.writerStallTimeoutMs != 0 ? timeProvider_->getUnixTimestampMs() : 0);
+                writeFileBuffer();
+                if (nextRotationTick_.load(std::memory_order_relaxed) != kNoRotationTick)
+                {
+                    uint64_t nowMs = timeProvider_->getUnixTimestampMs();
+                    if (nowMs >= nextRotationTick_.load(std::memory_order_relaxed) && isLogFileOpen())
+                    {
+                        rotateOnTime(nowMs);
+                    }
+                }
             }
+            lock.lock();
+
+            workerBusy_ = false;
+            drainCondition_.notify_all();
         }
 
         // Process any remaining entries before shutdown
         std::lock_guard<std::mutex> lock(queueMutex_);
         while (!logQueue_.empty())
         {
-            LogEntry entry = logQueue_.front();
+            LogEntry entry = std::move(logQueue_.front());
             logQueue_.pop();
+            resolveDeferredMessage(entry);
             processLogEntry(entry, config_.defaultDestination);
         }
+        recoverStalledWriter();
     }
 
-    std::string Logger::formatLogEntry(const LogEntry &entry, bool includeColors)
+    void Logger::notifyWriter()
     {
-        std::ostringstream oss;
+        // The writer sleeps on the ring's doorbell instead of the condition while a ring is attached
+        queueCondition_.notify_one();
+#ifdef HAS_FORK_SUPPORT
+        if (sharedRing_ && !ringProducer_.load())
+        {
+            sharedRing_->notify();
+        }
+#endif
+    }
 
-        if (includeColors)
+    void Logger::drainSharedRing()
+    {
+#ifdef HAS_FORK_SUPPORT
+        LogEntry entry;
+        while (sharedRing_->pop(entry))
+        {
+            processLogEntry(entry, config_.defaultDestination);
+        }
+#endif
+    }
+
+    void Logger::compactionThreadFunction()
+    {
+        std::unique_lock<std::mutex> lock(compactionMutex_);
+        while (!compactionStopping_.load())
+        {
+            lock.unlock();
+
+            std::string liveFile;
+            {
+                std::lock_guard<std::mutex> fileLock(fileMutex_);
+                liveFile = currentLogFile_;
+            }
+            LogCompactor::Report report =
+                compactor_->run(timeProvider_->getUnixTimestampMs(), liveFile, &compactionStopping_);
+            if (report.filesCompacted != 0 || report.filesExpired != 0)
+            {
+                info("SYSTEM", "Retention: compacted " + std::to_string(report.filesCompacted) + " files (" +
+                                   std::to_string(report.bytesBefore) + " -> " + std::to_string(report.bytesAfter) +
+                                   " bytes) into " + std::to_string(report.filesWritten) + ", expired " +
+                                   std::to_string(report.filesExpired));
+            }
+
+            lock.lock();
+            compactionCondition_.wait_for(lock, std::chrono::milliseconds(config_.compactionIntervalMs),
+                                          [this]
+                                          { return compactionStopping_.load(); });
+        }
+    }
+
+    void Logger::stopCompaction()
+    {
+        if (!compactionThread_.joinable())
         {
-            oss << getColorForLevel(entry.level);
+            return;
         }
 
-        oss << "[" << entry.timestamp << "] "
-            << "[" << std::setw(8) << logLevelToString(entry.level) << "] "
-            << "[" << std::setw(12) << entry.component << "] "
-            << entry.message;
+        {
+            std::lock_guard<std::mutex> lock(compactionMutex_);
+            compactionStopping_.store(true);
+        }
+        compactionCondition_.notify_all();
+        compactionThread_.join();
+    }
+
+    bool Logger::passesGate(LogLevel level, uint16_t componentId, uint32_t &gate)
+    {
+        gate = componentGates_[componentId].load(std::memory_order_relaxed);
+        if (gate == kGateUnresolved)
+        {
+            gate = resolveComponentGate(componentId);
+        }
+
+        uint8_t value = static_cast<uint8_t>(level);
+        if (value < (gate & 0xF))
+        {
+            // Below the level set by configuration, a burst or an emergency is plain filtering;
+            // anything else was shed
+            if (value >= ((gate >> 4) & 0xF))
+            {
+                adaptiveDroppedCount_.fetch_add(1, std::memory_order_relaxed);
+            }
+            return false;
+        }
+
+        uint32_t sampleRate = gate >> 16;
+        if (sampleRate > 1 && level < LogLevel::WARNING &&
+            sampleCounters_[componentId].fetch_add(1, std::memory_order_relaxed) % sampleRate != 0)
+        {
+            adaptiveDroppedCount_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        return true;
+    }
+
+    uint32_t Logger::computeComponentGate(const std::string &name) const
+    {
+        // Caller holds configMutex_. Longest configured dotted prefix wins.
+        uint32_t configured = static_cast<uint32_t>(LogLevel::DEBUG);
+        uint32_t gate = 0;
+
+        if (!config_.componentLevels.empty() && !name.empty())
+        {
+            std::string prefix = name;
+            for (;;)
+            {
+                auto it = config_.componentLevels.find(prefix);
+                if (it != config_.componentLevels.end())
+                {
+                    configured = static_cast<uint32_t>(it->second);
+                    gate |= kGateExplicit;
+                    break;
+                }
+
+                size_t dot = prefix.rfind('.');
+                if (dot == std::string::npos)
+                {
+                    break;
+                }
+                prefix.resize(dot);
+            }
+        }
+
+        if (config_.debugBurstMs != 0)
+        {
+            bool triggers = config_.debugBurstTriggers.empty();
+            for (const std::string &trigger : config_.debugBurstTriggers)
+            {
+                triggers = triggers || name == trigger ||
+                           (name.compare(0, trigger.size(), trigger) == 0 && name.size() > trigger.size() &&
+                            name[trigger.size()] == '.');
+            }
+            gate |= triggers ? kGateBurstTrigger : 0;
+        }
+
+        if (!debugBursts_.empty() && inDebugBurst(name))
+        {
+            // Counts as configured, so sinks follow and adaptive shedding still applies
+            configured = std::min(configured, static_cast<uint32_t>(config_.debugBurstLevel));
+            gate |= kGateExplicit;
+        }
+
+        // Entries no sink takes are rejected at the gate, unless a subscriber may want them
+        bool subscribers = false;
+#ifdef HAS_STREAM_SERVER
+        subscribers = streamServer_ && streamServer_->hasSubscribers();
+#endif
+        if ((gate & kGateExplicit) == 0 && !subscribers)
+        {
+            configured = std::max(configured, static_cast<uint32_t>(std::min(config_.consoleLogLevel,
+                                                                               config_.fileLogLevel)));
+        }
+
+        if (emergency_.load(std::memory_order_relaxed))
+        {
+            // Not shedding: entries an emergency drops stay out of the adaptive count
+            configured = std::max(configured, static_cast<uint32_t>(LogLevel::ERROR));
+        }
+        uint32_t effective = configured;
+        switch (adaptiveState_.load(std::memory_order_relaxed))
+        {
+        case AdaptiveVerbosityState::SHEDDING:
+            effective = std::max(effective, static_cast<uint32_t>(LogLevel::WARNING));
+            break;
+        case AdaptiveVerbosityState::SAMPLING:
+            gate |= std::min<uint32_t>(config_.adaptiveSampleRate, 0xFFFF) << 16;
+            break;
+        case AdaptiveVerbosityState::NORMAL:
+        default:
+            break;
+        }
+
+        return gate | effective | (configured << 4);
+    }
+
+    uint32_t Logger::resolveComponentGate(uint16_t componentId) const
+    {
+        std::lock_guard<std::mutex> lock(configMutex_);
+        uint32_t gate = computeComponentGate(componentNames_[componentId]);
+        componentGates_[componentId].store(gate, std::memory_order_relaxed);
+        return gate;
+    }
+
+    void Logger::rebuildComponentGates()
+    {
+        std::lock_guard<std::mutex> lock(configMutex_);
+        uint16_t count = componentCount_.load(std::memory_order_acquire);
+        for (uint16_t id = 0; id < count; ++id)
+        {
+            componentGates_[id].store(computeComponentGate(componentNames_[id]), std::memory_order_relaxed);
+        }
+    }
+
+    uint16_t Logger::lookupComponent(const std::string &name)
+    {
+        // Ids never change once assigned, so each thread keeps the names it has
+        // used and takes the registry lock only the first time it sees a name
+        thread_local std::unordered_map<std::string, uint16_t> known;
+        auto cached = known.find(name);
+        if (cached != known.end())
+        {
+            return cached->second;
+        }
+
+        uint16_t id;
+        {
+            std::lock_guard<std::mutex> lock(componentRegistryMutex_);
+            auto it = componentIndex_.find(name);
+            if (it != componentIndex_.end())
+            {
+                id = it->second;
+            }
+            else if (componentCount_.load(std::memory_order_relaxed) < kMaxComponents)
+            {
+                id = componentCount_.load(std::memory_order_relaxed);
+                componentNames_[id] = name;
+                componentIndex_.emplace(name, id);
+                componentCount_.store(static_cast<uint16_t>(id + 1), std::memory_order_release);
+            }
+            else
+            {
+                // Table full: the name logs through the default slot, with default levels
+                static bool reported = false;
+                if (!reported)
+                {
+                    reported = true;
+                    printf("Logger: Component table full (%u names), \"%s\" and later new names get default levels\n",
+                           static_cast<unsigned>(kMaxComponents - 1), name.c_str());
+                }
+                id = 0;
+            }
+        }
+        known.emplace(name, id);
+        return id;
+    }
+
+    ComponentId Logger::registerComponent(const std::string &name)
+    {
+        ComponentId component;
+        component.value = lookupComponent(name);
+        return component;
+    }
+
+    std::string Logger::getComponentName(ComponentId component)
+    {
+        if (component.value >= componentCount_.load(std::memory_order_acquire))
+        {
+            return std::string();
+        }
+        return componentNames_[component.value];
+    }
+
+    void Logger::updateAdaptiveVerbosity(size_t queueDepth, uint64_t entryTimestampMs)
+    {
+        // Called on the writer thread, without queueMutex_: a change rebuilds the
+        // gates under configMutex_ and logs through the queue
+        uint64_t now = timeProvider_->getUnixTimestampMs();
+        uint64_t lag = (entryTimestampMs != 0 && now > entryTimestampMs) ? now - entryTimestampMs : 0;
+
+        bool overloaded = queueDepth >= config_.adaptiveQueueHighWatermark || lag >= config_.adaptiveLagHighMs;
+        bool recovered = queueDepth <= config_.adaptiveQueueLowWatermark && lag <= config_.adaptiveLagLowMs;
+        bool held = now - adaptiveStateSinceMs_ >= config_.adaptiveHoldMs;
+        bool sampling = config_.adaptiveSampleRate > 1;
+
+        switch (adaptiveState_.load(std::memory_order_relaxed))
+        {
+        case AdaptiveVerbosityState::NORMAL:
+            if (overloaded)
+            {
+                setAdaptiveState(sampling ? AdaptiveVerbosityState::SAMPLING : AdaptiveVerbosityState::SHEDDING,
+                                 queueDepth, lag, now);
+            }
+            break;
+
+        case AdaptiveVerbosityState::SAMPLING:
+            if (overloaded && held)
+            {
+                setAdaptiveState(AdaptiveVerbosityState::SHEDDING, queueDepth, lag, now);
+            }
+            else if (recovered && held)
+            {
+                setAdaptiveState(AdaptiveVerbosityState::NORMAL, queueDepth, lag, now);
+            }
+            break;
+
+        case AdaptiveVerbosityState::SHEDDING:
+            if (recovered && held)
+            {
+                setAdaptiveState(sampling ? AdaptiveVerbosityState::SAMPLING : AdaptiveVerbosityState::NORMAL,
+                                 queueDepth, lag, now);
+            }
+            break;
+        }
+    }
+
+    void Logger::setAdaptiveState(AdaptiveVerbosityState state, size_t queueDepth, uint64_t lagMs, uint64_t nowMs)
+    {
+        static const char *names[] = {"NORMAL", "SAMPLING", "SHEDDING"};
+
+        std::string action;
+        switch (state)
+        {
+        case AdaptiveVerbosityState::SAMPLING:
+            action = "sampling DEBUG/INFO 1-in-" + std::to_string(config_.adaptiveSampleRate) + " per component";
+            break;
+        case AdaptiveVerbosityState::SHEDDING:
+            action = "dropping DEBUG/INFO";
+            break;
+        case AdaptiveVerbosityState::NORMAL:
+        default:
+            action = "full verbosity restored";
+            break;
+        }
+
+        std::string message = std::string("Adaptive verbosity ") + names[static_cast<uint8_t>(adaptiveState_.load())] +
+                              " -> " + names[static_cast<uint8_t>(state)] + ": " + action +
+                              " (queue " + std::to_string(queueDepth) + ", lag " + std::to_string(lagMs) +
+                              " ms, dropped so far " + std::to_string(adaptiveDroppedCount_.load()) + ")";
+
+        adaptiveState_.store(state);
+        adaptiveStateSinceMs_ = nowMs;
+        rebuildComponentGates();
+
+        // WARNING, so shedding never drops the record of it
+        logInternal(LogLevel::WARNING, message);
+    }
+
+    bool Logger::inDebugBurst(const std::string &name) const
+    {
+        // Caller holds configMutex_. A burst covers its component's dotted sub-components too.
+        if (debugBursts_.count(std::string()) != 0)
+        {
+            return true;
+        }
+        for (size_t length = name.size(); length != std::string::npos; length = name.rfind('.', length - 1))
+        {
+            if (debugBursts_.count(name.substr(0, length)) != 0)
+            {
+                return true;
+            }
+            if (length == 0)
+            {
+                break;
+            }
+        }
+        return false;
+    }
+
+    void Logger::startDebugBurst(const LogEntry &entry)
+    {
+        // Names past a full component table share the default slot and its levels,
+        // which a burst of their own could not lower
+        if (entry.componentId == 0 && !config_.debugBurstGlobal)
+        {
+            return;
+        }
+        uint32_t gate = componentGates_[entry.componentId].load(std::memory_order_relaxed);
+        if (gate == kGateUnresolved)
+        {
+            gate = resolveComponentGate(entry.componentId);
+        }
+        if ((gate & kGateBurstTrigger) == 0)
+        {
+            return;
+        }
+
+        // Errors inside an open burst only push its end out; no lock for those
+        size_t slot = config_.debugBurstGlobal ? kMaxComponents : entry.componentId;
+        uint64_t endMs = entry.timestampMs + config_.debugBurstMs;
+        uint64_t current = burstWindows_[slot].load(std::memory_order_relaxed);
+        while (current > entry.timestampMs)
+        {
+            if (current >= endMs ||
+                burstWindows_[slot].compare_exchange_weak(current, endMs, std::memory_order_relaxed))
+            {
+                return;
+            }
+        }
+
+        std::string key = config_.debugBurstGlobal ? std::string() : entry.component;
+        {
+            std::lock_guard<std::mutex> lock(configMutex_);
+            if (debugBursts_.count(key) != 0)
+            {
+                // Opened by another thread since the check above, or about to end
+                current = burstWindows_[slot].load(std::memory_order_relaxed);
+                while (current < endMs &&
+                       !burstWindows_[slot].compare_exchange_weak(current, endMs, std::memory_order_relaxed))
+                {
+                }
+                return;
+            }
+            debugBursts_.emplace(key, DebugBurst{entry.timestampMs, slot});
+            burstWindows_[slot].store(endMs, std::memory_order_relaxed);
+            if (endMs < nextBurstEndMs_.load(std::memory_order_relaxed))
+            {
+                nextBurstEndMs_.store(endMs, std::memory_order_relaxed);
+            }
+        }
+
+        rebuildComponentGates();
+        logInternal(LogLevel::WARNING, "Debug burst started: " + (key.empty() ? std::string("all components") : key) +
+                                           " at " + logLevelToString(config_.debugBurstLevel) + " for " +
+                                           std::to_string(config_.debugBurstMs) + " ms after " +
+                                           logLevelToString(entry.level) + " from " + entry.component);
+    }
+
+    void Logger::endDebugBursts(uint64_t nowMs)
+    {
+        std::vector<std::pair<std::string, uint64_t>> ended; // Component, length in ms
+        {
+            std::lock_guard<std::mutex> lock(configMutex_);
+            uint64_t next = kNoDebugBurst;
+            for (auto it = debugBursts_.begin(); it != debugBursts_.end();)
+            {
+                // Fails if an error extends the window meanwhile; the burst then stays
+                std::atomic<uint64_t> &window = burstWindows_[it->second.window];
+                uint64_t endMs = window.load(std::memory_order_relaxed);
+                if (endMs <= nowMs && window.compare_exchange_strong(endMs, 0, std::memory_order_relaxed))
+                {
+                    ended.emplace_back(it->first, endMs - it->second.startMs);
+                    it = debugBursts_.erase(it);
+                }
+                else
+                {
+                    next = std::min(next, endMs);
+                    ++it;
+                }
+            }
+            nextBurstEndMs_.store(next, std::memory_order_relaxed);
+        }
+        if (ended.empty())
+        {
+            return;
+        }
+
+        rebuildComponentGates();
+        for (const auto &burst : ended)
+        {
+            // Extensions make the window longer than debugBurstMs
+            logInternal(LogLevel::WARNING, "Debug burst ended: " +
+                                               (burst.first.empty() ? std::string("all components") : burst.first) +
+                                               " back to configured levels after " + std::to_string(burst.second) +
+                                               " ms");
+        }
+    }
+
+    void Logger::logInternal(LogLevel level, const std::string &message)
+    {
+        // Also runs on the writer while workerBusy_ is set, where atForkPrepare() may be
+        // holding the component registry: use the pre-resolved id, never a name lookup
+        uint32_t gate;
+        if (!passesGate(level, loggerComponent_, gate))
+        {
+            return;
+        }
+        LogEntry entry(level, "LOGGER", message);
+        enqueueAdmitted(entry, loggerComponent_, gate, config_.defaultDestination);
+    }
+
+    bool Logger::holdWhileWriterStalled(LogEntry &entry, LogDestination destination)
+    {
+        uint64_t startedMs = fileWriteStartedMs_.load(std::memory_order_relaxed);
+        if (!writerDegraded_.load())
+        {
+            if (startedMs == 0 || entry.timestampMs < startedMs + config_.writerStallTimeoutMs)
+            {
+                return false;
+            }
+
+            std::lock_guard<std::mutex> lock(degradedMutex_);
+            if (!writerDegraded_.load() && fileWriteStartedMs_.load(std::memory_order_relaxed) == startedMs)
+            {
+                degradedSinceMs_ = startedMs;
+                writerDegraded_.store(true);
+                printf("Logger: File writer stalled for %llu ms, holding the newest %zu file entries in RAM\n",
+                       static_cast<unsigned long long>(entry.timestampMs - startedMs), config_.degradedRingEntries);
+            }
+        }
+        else if (startedMs == 0)
+        {
+            // The write returned: the writer writes out the held entries, and sync callers do it here
+            if (!config_.asyncLogging)
+            {
+                recoverStalledWriter();
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            notifyWriter();
+        }
+
+        if (!writerDegraded_.load())
+        {
+            return false;
+        }
+        // Held entries are written and printed from here, not by the writer
+        resolveDeferredMessage(entry);
+        {
+            std::lock_guard<std::mutex> lock(degradedMutex_);
+            if (!writerDegraded_.load())
+            {
+                return false;
+            }
+            if (hasDestination(destination, LogDestination::FILE_ONLY) &&
+                (entry.bypassSinkLevels || entry.level >= config_.fileLogLevel))
+            {
+                degradedRing_.push_back(entry);
+                if (degradedRing_.size() > config_.degradedRingEntries)
+                {
+                    degradedRing_.pop_front();
+                    degradedDroppedCount_++;
+                }
+            }
+        }
+
+        // The writer owns the console too, so print from the caller meanwhile
+        if (hasDestination(destination, LogDestination::CONSOLE_ONLY) &&
+            (entry.bypassSinkLevels || entry.level >= config_.consoleLogLevel))
+        {
+            writeToConsole(entry);
+        }
+        return true;
+    }
+
+    void Logger::recoverStalledWriter()
+    {
+        std::deque<LogEntry> held;
+        size_t dropped;
+        uint64_t sinceMs;
+        {
+            std::lock_guard<std::mutex> lock(degradedMutex_);
+            if (!writerDegraded_.load())
+            {
+                return;
+            }
+            held.swap(degradedRing_);
+            dropped = degradedDroppedCount_;
+            degradedDroppedCount_ = 0;
+            sinceMs = degradedSinceMs_;
+            writerDegraded_.store(false);
+        }
+
+        // Held entries were printed when logged; only the file still needs them
+        uint64_t nowMs = timeProvider_->getUnixTimestampMs();
+        printf("Logger: File writer recovered after %llu ms\n", static_cast<unsigned long long>(nowMs - sinceMs));
+        for (const LogEntry &entry : held)
+        {
+            writeToFile(entry);
+        }
+
+        LogEntry entry(LogLevel::WARNING, "LOGGER",
+                       "File writer stalled for " + std::to_string(nowMs - sinceMs) + " ms: " +
+                           std::to_string(held.size()) + " entries held in RAM, " + std::to_string(dropped) +
+                           " dropped");
+        entry.timestamp = getCurrentTimestamp();
+        entry.timestampMs = nowMs;
+        processLogEntry(entry, config_.defaultDestination);
+        totalLogCount_++;
+    }
+
+    bool Logger::isWriterDegraded() const
+    {
+        return writerDegraded_.load();
+    }
+
+    AdaptiveVerbosityState Logger::getAdaptiveState() const
+    {
+        return adaptiveState_.load();
+    }
+
+    size_t Logger::getAdaptiveDroppedCount() const
+    {
+        return adaptiveDroppedCount_.load();
+    }
+
+    void Logger::registerForFork()
+    {
+#ifdef HAS_FORK_SUPPORT
+        static std::once_flag handlersInstalled;
+        std::call_once(handlersInstalled, []
+                       { pthread_atfork(&Logger::atForkPrepare, &Logger::atForkParent, &Logger::atForkChild); });
+
+        std::lock_guard<std::mutex> lock(forkRegistryMutex_);
+        if (std::find(forkRegistry_.begin(), forkRegistry_.end(), this) == forkRegistry_.end())
+        {
+            forkRegistry_.push_back(this);
+        }
+#endif
+    }
+
+    void Logger::unregisterForFork()
+    {
+#ifdef HAS_FORK_SUPPORT
+        std::lock_guard<std::mutex> lock(forkRegistryMutex_);
+        forkRegistry_.erase(std::remove(forkRegistry_.begin(), forkRegistry_.end(), this),
+                            forkRegistry_.end());
+#endif
+    }
+
+    void Logger::prepareForFork()
+    {
+        // Quiesce: wait until the writer has emptied the queue and is idle,
+        // then hold every lock across fork() so the child sees consistent state.
+        // A writer stuck in a write is not waited for past forkDrainTimeoutMs;
+        // the child then discards the parent's pending work and reopens its sink.
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(config_.forkDrainTimeoutMs);
+        std::unique_lock<std::mutex> lock(queueMutex_);
+        bool drained = drainCondition_.wait_until(lock, deadline, [this]
+                                                  { return (logQueue_.empty() && !workerBusy_) || !loggerThread_.joinable(); });
+        lock.release();
+
+        std::unique_lock<std::mutex> fileLock(fileMutex_, std::defer_lock);
+        forkQuiesced_ = drained && lockBefore(fileLock, deadline);
+        if (forkQuiesced_)
+        {
+            fileLock.release();
+            writeFileBuffer();
+#ifdef HAS_DIRECT_FILE_IO
+            if (directSink_)
+            {
+                directSink_->prepareForFork();
+            }
+#endif
+        }
+        else
+        {
+            printf("Logger: Writer still busy after %lu ms, forking without draining\n",
+                   static_cast<unsigned long>(config_.forkDrainTimeoutMs));
+        }
+        configMutex_.lock();
+        compactionMutex_.lock();
+        degradedMutex_.lock();
+
+#ifdef HAS_STREAM_SERVER
+        if (streamServer_)
+        {
+            streamServer_->prepareForFork();
+        }
+#endif
+    }
+
+    void Logger::resumeAfterForkParent()
+    {
+#ifdef HAS_STREAM_SERVER
+        if (streamServer_)
+        {
+            streamServer_->resumeAfterForkParent();
+        }
+#endif
+
+        degradedMutex_.unlock();
+        compactionMutex_.unlock();
+        configMutex_.unlock();
+        if (forkQuiesced_)
+        {
+#ifdef HAS_DIRECT_FILE_IO
+            if (directSink_)
+            {
+                directSink_->resumeAfterForkParent();
+            }
+#endif
+            fileMutex_.unlock();
+        }
+        queueMutex_.unlock();
+    }
+
+    void Logger::resumeAfterForkChild()
+    {
+#ifdef HAS_FORK_SUPPORT
+        // Runs inside the atfork child handler: release what the parent's
+        // threads held and rebuild their primitives in place, but leave
+        // anything that allocates, opens files, starts threads or logs to
+        // finishForkChild() on the child's first log call.
+        if (streamServer_)
+        {
+            // Subscribers stay connected to the parent only
+            streamServer_->abandonAfterForkChild();
+        }
+
+        degradedMutex_.unlock();
+        compactionMutex_.unlock();
+        configMutex_.unlock();
+        queueMutex_.unlock();
+        if (forkQuiesced_)
+        {
+            fileMutex_.unlock();
+        }
+        else
+        {
+            // Forked mid-write: the lock and buffers belong to the parent's writer,
+            // which writes them and the queued entries itself
+            new (&fileMutex_) std::mutex();
+            new (&fileBuffer_) std::string();
+            new (&blockBuffer_) std::string();
+            new (&blockTokens_) std::vector<uint64_t>();
+            forkDiscardQueue_ = true;
+        }
+        new (&forkRestartMutex_) std::mutex();
+
+        // The writer thread does not exist in the child. Its handle and any
+        // condition variable it was waiting on are rebuilt in place, since
+        // destroying them would terminate or block.
+        new (&queueCondition_) std::condition_variable();
+        new (&drainCondition_) std::condition_variable();
+        if (loggerThread_.joinable())
+        {
+            new (&loggerThread_) std::thread();
+        }
+        workerBusy_ = false;
+        writerDegraded_.store(false);
+        fileWriteStartedMs_.store(0);
+        degradedDroppedCount_ = 0;
+
+        // Retention of the log directory stays with the parent
+        new (&compactionCondition_) std::condition_variable();
+        if (compactionThread_.joinable())
+        {
+            new (&compactionThread_) std::thread();
+        }
+
+        // Children of a named-ring producer keep producing into the same ring
+        bool namedProducer = ringProducer_.load() && config_.sharedRingRole == SharedRingRole::PRODUCER;
+        ForkChildMode mode = namedProducer ? ForkChildMode::PARENT_RING : config_.forkChildMode;
+        if (mode == ForkChildMode::PARENT_RING && !sharedRing_)
+        {
+            mode = ForkChildMode::SEPARATE_FILE;
+        }
+        forkRestartMode_ = mode;
+        if (mode == ForkChildMode::PARENT_RING)
+        {
+            ringProducer_.store(true);
+        }
+        else if (mode == ForkChildMode::DISABLED)
+        {
+            initialized_.store(false);
+        }
+
+        if (!namedProducer)
+        {
+            // Pending lines were written in prepareForFork(); closing only drops our fd copy
+            fileBuffer_.clear();
+            blockTokens_.clear();
+            fileSystem_->closeFile(currentLogHandle_);
+            currentLogHandle_ = kInvalidFileHandle;
+            if (preparedHandle_ != kInvalidFileHandle)
+            {
+                // The parent switches to its prepared file; ours gets our own name
+                fileSystem_->closeFile(preparedHandle_);
+                preparedHandle_ = kInvalidFileHandle;
+                preparedFile_.clear();
+            }
+            if (directSink_ && forkQuiesced_)
+            {
+                directSink_->abandonAfterForkChild();
+            }
+        }
+
+        forkRestartPending_.store(true, std::memory_order_release);
+#endif
+    }
+
+    void Logger::finishForkChild()
+    {
+#ifdef HAS_FORK_SUPPORT
+        {
+            std::lock_guard<std::mutex> restartLock(forkRestartMutex_);
+            if (!forkRestartPending_.load(std::memory_order_acquire))
+            {
+                // Another thread got here first
+                return;
+            }
+
+            // Subscribers are gone, so the stream no longer holds gates down
+            streamServer_.reset();
+            rebuildComponentGates();
+            if (forkDiscardQueue_)
+            {
+                std::queue<LogEntry>().swap(logQueue_);
+                forkDiscardQueue_ = false;
+            }
+            degradedRing_.clear();
+            compactor_.reset();
+
+            bool restartWriter = false;
+            switch (forkRestartMode_)
+            {
+            case ForkChildMode::SEPARATE_FILE:
+            {
+                replaceDirectSinkAfterFork();
+                fileNameSuffix_ = "_pid" + std::to_string(getpid());
+                std::lock_guard<std::mutex> fileLock(fileMutex_);
+                if (!createNewLogFile())
+                {
+                    initialized_.store(false);
+                    break;
+                }
+                restartWriter = true;
+                break;
+            }
+
+            case ForkChildMode::SHARED_FILE:
+            {
+                // Rotation stays with the parent; two processes renaming the same file would race
+                replaceDirectSinkAfterFork();
+                rotationEnabled_ = false;
+                nextRotationTick_.store(kNoRotationTick);
+                std::lock_guard<std::mutex> fileLock(fileMutex_);
+                currentLogHandle_ = fileSystem_->openFile(currentLogFile_, FileOpenMode::APPEND);
+                restartWriter = true;
+                break;
+            }
+
+            case ForkChildMode::PARENT_RING:
+                break;
+
+            case ForkChildMode::DISABLED:
+            default:
+                sharedRing_.reset();
+                break;
+            }
+
+            if (restartWriter)
+            {
+                // Only the parent drains the ring
+                sharedRing_.reset();
+                if (config_.asyncLogging)
+                {
+                    loggerThread_ = std::thread(&Logger::loggerThreadFunction, this);
+                }
+            }
+            forkRestartPending_.store(false, std::memory_order_release);
+            if (!restartWriter)
+            {
+                return;
+            }
+        }
+
+        info("SYSTEM", "Logger restarted in child process " + std::to_string(getpid()) +
+                           " (parent " + std::to_string(getppid()) + ")");
+#endif
+    }
+
+    void Logger::replaceDirectSinkAfterFork()
+    {
+#ifdef HAS_DIRECT_FILE_IO
+        if (directSink_ && !forkQuiesced_)
+        {
+            // Its lock may be held by the parent's I/O thread: leave it behind and start afresh
+            directSink_.release();
+            directSink_ = std::make_unique<DirectFileSink>(config_.directFileBufferSize);
+        }
+#endif
+    }
+
+    void Logger::atForkPrepare()
+    {
+        forkRegistryMutex_.lock();
+        globalLoggerMutex_.lock();
+        componentRegistryMutex_.lock();
+        for (Logger *logger : forkRegistry_)
+        {
+            logger->prepareForFork();
+        }
+    }
+
+    void Logger::atForkParent()
+    {
+        for (auto it = forkRegistry_.rbegin(); it != forkRegistry_.rend(); ++it)
+        {
+            (*it)->resumeAfterForkParent();
+        }
+        componentRegistryMutex_.unlock();
+        globalLoggerMutex_.unlock();
+        forkRegistryMutex_.unlock();
+    }
+
+    void Logger::atForkChild()
+    {
+        componentRegistryMutex_.unlock();
+        globalLoggerMutex_.unlock();
+        for (Logger *logger : forkRegistry_)
+        {
+            logger->resumeAfterForkChild();
+        }
+        forkRegistryMutex_.unlock();
+    }
+
+    std::string Logger::formatLogEntry(const LogEntry &entry, bool includeColors)
+    {
+        // Appends with padding by hand: a stream with setw costs more than the rest of the line
+        std::string line;
+        line.reserve(48 + entry.timestamp.size() + entry.component.size() + entry.message.size());
+
+        if (includeColors)
+        {
+            line += getColorForLevel(entry.level);
+        }
+
+        std::string level = logLevelToString(entry.level);
+        line += '[';
+        line += entry.timestamp;
+        line += "] [";
+        line.append(level.size() < 8 ? 8 - level.size() : 0, ' ');
+        line += level;
+        line += "] [";
+        line.append(entry.component.size() < 12 ? 12 - entry.component.size() : 0, ' ');
+        line += entry.component;
+        line += "] ";
+
+        if (entry.processId != 0)
+        {
+            line += "[pid ";
+            formatting::appendDecimal(line, entry.processId);
+            line += "] ";
+        }
+
+        if (entry.context)
+        {
+            LogContext::render(entry.context.get(), line);
+        }
+
+        line += entry.message;
+
+        if (entry.payloadSize != 0)
+        {
+            line.reserve(line.size() + entry.payload.size() * 3 + 32);
+            if (!entry.message.empty())
+            {
+                line += ' ';
+            }
+            line += '[';
+            formatting::appendDecimal(line, entry.payloadSize);
+            line += " bytes] ";
+            formatting::appendHex(line, entry.payload.data(), entry.payload.size());
+            if (entry.payload.size() < entry.payloadSize)
+            {
+                line += " ...";
+            }
+        }
+
+        if (!entry.backtrace.empty())
+        {
+            formatting::appendBacktrace(line, entry.backtrace.data(), entry.backtrace.size());
+        }
 
         if (config_.includeSourceLocation && !entry.filename.empty() && entry.lineNumber > 0)
         {
-            oss << " (" << entry.filename << ":" << entry.lineNumber << ")";
+            line += " (";
+            line += entry.filename;
+            line += ':';
+            formatting::appendDecimal(line, static_cast<uint64_t>(entry.lineNumber));
+            line += ')';
         }
 
         if (includeColors)
         {
-            oss << "\033[0m"; // Reset color
+            line += "\033[0m"; // Reset color
         }
 
-        return oss.str();
+        return line;
     }
 
     std::string Logger::getCurrentTimestamp()
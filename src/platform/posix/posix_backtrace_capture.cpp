@@ -0,0 +1,149 @@
+// POSIX backtrace capture
+/**
+ * @file posix_backtrace_capture.cpp
+ * @brief Unwinder-based return address capture and ELF module map
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/backtrace_capture.h"
+#include "embedded_logger/log_formatter.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__linux__) && defined(__GLIBC__)
+#include <execinfo.h>
+#include <link.h>
+#include <unistd.h>
+#define HAS_BACKTRACE_CAPTURE
+#endif
+
+namespace embedded_logger
+{
+
+#ifdef HAS_BACKTRACE_CAPTURE
+    namespace
+    {
+        constexpr uint32_t kGnuBuildIdNote = 3; // NT_GNU_BUILD_ID
+
+        std::string toHexAddress(uintptr_t value)
+        {
+            char buffer[2 + sizeof(uintptr_t) * 2 + 1];
+            snprintf(buffer, sizeof(buffer), "0x%llx", static_cast<unsigned long long>(value));
+            return buffer;
+        }
+
+        /// Find the GNU build-id note among a module's PT_NOTE segments
+        std::string findBuildId(const dl_phdr_info *info)
+        {
+            for (int i = 0; i < info->dlpi_phnum; ++i)
+            {
+                const ElfW(Phdr) &header = info->dlpi_phdr[i];
+                if (header.p_type != PT_NOTE)
+                {
+                    continue;
+                }
+
+                const char *note = reinterpret_cast<const char *>(info->dlpi_addr + header.p_vaddr);
+                const char *end = note + header.p_memsz;
+                while (note + sizeof(ElfW(Nhdr)) <= end)
+                {
+                    const auto *nhdr = reinterpret_cast<const ElfW(Nhdr) *>(note);
+                    const char *name = note + sizeof(ElfW(Nhdr));
+                    const char *desc = name + ((nhdr->n_namesz + 3) & ~3U);
+                    if (nhdr->n_type == kGnuBuildIdNote && nhdr->n_namesz == 4 && std::memcmp(name, "GNU", 4) == 0 &&
+                        desc + nhdr->n_descsz <= end)
+                    {
+                        std::string id;
+                        formatting::appendHex(id, desc, nhdr->n_descsz);
+                        id.erase(std::remove(id.begin(), id.end(), ' '), id.end());
+                        return id;
+                    }
+                    note = desc + ((nhdr->n_descsz + 3) & ~3U);
+                }
+            }
+            return std::string();
+        }
+
+        int appendModule(dl_phdr_info *info, size_t, void *data)
+        {
+            uintptr_t start = UINTPTR_MAX;
+            uintptr_t end = 0;
+            for (int i = 0; i < info->dlpi_phnum; ++i)
+            {
+                const ElfW(Phdr) &header = info->dlpi_phdr[i];
+                if (header.p_type == PT_LOAD)
+                {
+                    start = std::min<uintptr_t>(start, info->dlpi_addr + header.p_vaddr);
+                    end = std::max<uintptr_t>(end, info->dlpi_addr + header.p_vaddr + header.p_memsz);
+                }
+            }
+            if (start >= end)
+            {
+                return 0;
+            }
+
+            // The main program is reported without a name
+            std::string path = info->dlpi_name ? info->dlpi_name : "";
+            if (path.empty())
+            {
+                char buffer[4096];
+                ssize_t length = readlink("/proc/self/exe", buffer, sizeof(buffer) - 1);
+                path.assign(buffer, length > 0 ? static_cast<size_t>(length) : 0);
+            }
+
+            std::string &out = *static_cast<std::string *>(data);
+            std::string buildId = findBuildId(info);
+            out += "# Module: start=" + toHexAddress(start) + " end=" + toHexAddress(end) +
+                   " bias=" + toHexAddress(info->dlpi_addr) + " build-id=" + (buildId.empty() ? "-" : buildId) +
+                   " path=" + path + "\n";
+            return 0;
+        }
+    }
+
+    size_t BacktraceCapture::capture(uintptr_t *frames, size_t maxDepth, size_t skipFrames)
+    {
+        constexpr size_t kMaxSkip = 8;
+        maxDepth = std::min(maxDepth, kMaxDepth);
+        skipFrames = std::min(skipFrames, kMaxSkip) + 1; // plus this function
+
+        void *addresses[kMaxDepth + kMaxSkip + 1];
+        int depth = ::backtrace(addresses, static_cast<int>(maxDepth + skipFrames));
+
+        size_t count = 0;
+        for (int i = static_cast<int>(skipFrames); i < depth; ++i)
+        {
+            frames[count++] = reinterpret_cast<uintptr_t>(addresses[i]);
+        }
+        return count;
+    }
+
+    void BacktraceCapture::warmUp()
+    {
+        void *address;
+        ::backtrace(&address, 1);
+    }
+
+    void BacktraceCapture::appendModuleRecords(std::string &out)
+    {
+        dl_iterate_phdr(appendModule, &out);
+    }
+#else
+    size_t BacktraceCapture::capture(uintptr_t *, size_t, size_t)
+    {
+        return 0;
+    }
+
+    void BacktraceCapture::warmUp()
+    {
+    }
+
+    void BacktraceCapture::appendModuleRecords(std::string &)
+    {
+    }
+#endif
+
+} // namespace embedded_logger
@@ -0,0 +1,358 @@
+// POSIX direct I/O file sink
+/**
+ * @file posix_direct_file_sink.cpp
+ * @brief O_DIRECT double-buffered file sink implementation
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/direct_file_sink.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace embedded_logger
+{
+
+    namespace
+    {
+        constexpr size_t alignDown(size_t value)
+        {
+            return value & ~(DirectFileSink::kAlignment - 1);
+        }
+
+        constexpr size_t alignUp(size_t value)
+        {
+            return alignDown(value + DirectFileSink::kAlignment - 1);
+        }
+    }
+
+    DirectFileSink::DirectFileSink(size_t bufferSize)
+        : capacity_(alignUp(std::max(bufferSize, kAlignment))), buffers_{nullptr, nullptr}, fd_(-1),
+          direct_(false), failed_(false), active_(0), activeUsed_(0), activeWritten_(0), activeOffset_(0),
+          pending_(false), pendingIndex_(0), pendingFrom_(0), pendingOffset_(0), stopping_(false)
+    {
+        for (uint8_t *&buffer : buffers_)
+        {
+            void *memory = nullptr;
+            buffer = posix_memalign(&memory, kAlignment, capacity_) == 0 ? static_cast<uint8_t *>(memory) : nullptr;
+        }
+    }
+
+    DirectFileSink::~DirectFileSink()
+    {
+        close();
+        free(buffers_[0]);
+        free(buffers_[1]);
+    }
+
+    bool DirectFileSink::open(const std::string &path, bool useDirect)
+    {
+        close();
+        resetState();
+
+        if (!buffers_[0] || !buffers_[1])
+        {
+            printf("Logger: Failed to allocate direct I/O buffers\n");
+            return false;
+        }
+
+        // No O_APPEND: writes are positioned so whole blocks can be rewritten
+        int flags = O_RDWR | O_CREAT | O_CLOEXEC;
+#ifdef O_DIRECT
+        if (useDirect)
+        {
+            fd_ = ::open(path.c_str(), flags | O_DIRECT, 0644);
+            direct_.store(fd_ >= 0);
+        }
+        if (!useDirect || (fd_ < 0 && errno == EINVAL))
+#else
+        (void)useDirect;
+#endif
+        {
+            fd_ = ::open(path.c_str(), flags, 0644);
+        }
+
+        if (fd_ < 0)
+        {
+            printf("Logger: Failed to open file: %s (%s)\n", path.c_str(), strerror(errno));
+            return false;
+        }
+
+#if defined(__APPLE__) && defined(F_NOCACHE)
+        fcntl(fd_, F_NOCACHE, 1);
+#endif
+
+        struct stat st;
+        size_t size = fstat(fd_, &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+        activeOffset_ = size;
+
+        // Appending with O_DIRECT: start at the last whole block and carry its tail in the buffer
+        if (direct_.load() && size % kAlignment != 0)
+        {
+            activeOffset_ = alignDown(size);
+            ssize_t n = pread(fd_, buffers_[active_], kAlignment, static_cast<off_t>(activeOffset_));
+            if (n != static_cast<ssize_t>(size - activeOffset_))
+            {
+                activeOffset_ = size;
+                fallBackToBuffered();
+            }
+            else
+            {
+                activeUsed_ = static_cast<size_t>(n);
+            }
+        }
+
+        ioThread_ = std::thread(&DirectFileSink::ioThreadFunction, this);
+        return true;
+    }
+
+    bool DirectFileSink::write(const void *data, size_t size)
+    {
+        if (fd_ < 0)
+        {
+            return false;
+        }
+
+        const auto *bytes = static_cast<const uint8_t *>(data);
+        while (size > 0)
+        {
+            size_t n = std::min(size, capacity_ - activeUsed_);
+            std::memcpy(buffers_[active_] + activeUsed_, bytes, n);
+            activeUsed_ += n;
+            bytes += n;
+            size -= n;
+
+            if (activeUsed_ == capacity_)
+            {
+                submitActive();
+            }
+        }
+        return !failed_.load();
+    }
+
+    bool DirectFileSink::flush()
+    {
+        if (fd_ < 0)
+        {
+            return false;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            waitIdle(lock);
+        }
+
+        if (activeUsed_ > activeWritten_)
+        {
+            uint8_t *buffer = buffers_[active_];
+            if (direct_.load())
+            {
+                // Whole blocks only: pad the tail with zeros, then cut the file back to its logical length
+                size_t end = alignUp(activeUsed_);
+                std::memset(buffer + activeUsed_, 0, end - activeUsed_);
+                if (!writeRange(buffer + activeWritten_, end - activeWritten_, activeOffset_ + activeWritten_))
+                {
+                    return false; // Nothing counts as written; the next flush tries the same range
+                }
+                if (ftruncate(fd_, static_cast<off_t>(activeOffset_ + activeUsed_)) != 0)
+                {
+                    printf("Logger: Failed to truncate log file (%s)\n", strerror(errno));
+                    failed_.store(true);
+                }
+                activeWritten_ = alignDown(activeUsed_);
+            }
+            else if (writeRange(buffer + activeWritten_, activeUsed_ - activeWritten_, activeOffset_ + activeWritten_))
+            {
+                activeWritten_ = activeUsed_;
+            }
+        }
+        return !failed_.load();
+    }
+
+    void DirectFileSink::close()
+    {
+        if (fd_ < 0)
+        {
+            return;
+        }
+
+        flush();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        condition_.notify_all();
+        if (ioThread_.joinable())
+        {
+            ioThread_.join();
+        }
+
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    void DirectFileSink::prepareForFork()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        waitIdle(lock);
+        lock.release();
+    }
+
+    void DirectFileSink::resumeAfterForkParent()
+    {
+        mutex_.unlock();
+    }
+
+    void DirectFileSink::abandonAfterForkChild()
+    {
+        mutex_.unlock();
+
+        // The I/O thread only exists in the parent; buffered bytes are the parent's to write
+        new (&condition_) std::condition_variable();
+        if (ioThread_.joinable())
+        {
+            new (&ioThread_) std::thread();
+        }
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+            fd_ = -1;
+        }
+        resetState();
+    }
+
+    void DirectFileSink::ioThreadFunction()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;)
+        {
+            condition_.wait(lock, [this]
+                            { return pending_ || stopping_; });
+            if (!pending_)
+            {
+                break;
+            }
+
+            const uint8_t *buffer = buffers_[pendingIndex_];
+            size_t from = pendingFrom_;
+            uint64_t offset = pendingOffset_;
+            lock.unlock();
+
+            if (writeRange(buffer + from, capacity_ - from, offset + from) && !direct_.load())
+            {
+                dropCachedRange(offset, capacity_);
+            }
+
+            lock.lock();
+            pending_ = false;
+            condition_.notify_all();
+        }
+    }
+
+    void DirectFileSink::submitActive()
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            waitIdle(lock);
+            pending_ = true;
+            pendingIndex_ = active_;
+            pendingFrom_ = activeWritten_;
+            pendingOffset_ = activeOffset_;
+        }
+        condition_.notify_all();
+
+        active_ ^= 1;
+        activeOffset_ += capacity_;
+        activeUsed_ = 0;
+        activeWritten_ = 0;
+    }
+
+    void DirectFileSink::waitIdle(std::unique_lock<std::mutex> &lock)
+    {
+        condition_.wait(lock, [this]
+                        { return !pending_; });
+    }
+
+    bool DirectFileSink::writeRange(const uint8_t *data, size_t size, uint64_t offset)
+    {
+        size_t written = 0;
+        for (;;)
+        {
+            if (written == size)
+            {
+                return true;
+            }
+
+            ssize_t n = pwrite(fd_, data + written, size - written, static_cast<off_t>(offset + written));
+            if (n > 0)
+            {
+                written += static_cast<size_t>(n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+#ifdef O_DIRECT
+            // Some file systems accept O_DIRECT at open() and only refuse it on write
+            if (n < 0 && errno == EINVAL && direct_.load())
+            {
+                fallBackToBuffered();
+                continue;
+            }
+#endif
+            printf("Logger: Failed to write %zu bytes to log file (%s)\n", size - written,
+                   n < 0 ? strerror(errno) : "short write");
+            failed_.store(true);
+            return false;
+        }
+    }
+
+    void DirectFileSink::fallBackToBuffered()
+    {
+#ifdef O_DIRECT
+        fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL) & ~O_DIRECT);
+#endif
+        direct_.store(false);
+        printf("Logger: O_DIRECT not supported for this file, using buffered writes with fadvise\n");
+    }
+
+    void DirectFileSink::dropCachedRange(uint64_t offset, size_t size)
+    {
+#if defined(__linux__)
+        // DONTNEED skips dirty pages, so push this range out first
+        sync_file_range(fd_, static_cast<off_t>(offset), static_cast<off_t>(size),
+                        SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+#endif
+#ifdef POSIX_FADV_DONTNEED
+        posix_fadvise(fd_, static_cast<off_t>(offset), static_cast<off_t>(size), POSIX_FADV_DONTNEED);
+#else
+        (void)offset;
+        (void)size;
+#endif
+    }
+
+    void DirectFileSink::resetState()
+    {
+        direct_.store(false);
+        failed_.store(false);
+        active_ = 0;
+        activeUsed_ = 0;
+        activeWritten_ = 0;
+        activeOffset_ = 0;
+        pending_ = false;
+        stopping_ = false;
+    }
+
+} // namespace embedded_logger
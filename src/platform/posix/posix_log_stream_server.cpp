@@ -0,0 +1,571 @@
+// POSIX live log stream server
+/**
+ * @file posix_log_stream_server.cpp
+ * @brief UNIX socket / TCP loopback subscriber sink implementation
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/log_stream_server.h"
+#include "embedded_logger/log_formatter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <sstream>
+#include <utility>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace embedded_logger
+{
+
+    namespace
+    {
+        constexpr size_t kMaxCommandLength = 256;
+
+        bool setNonBlocking(int fd)
+        {
+            int flags = fcntl(fd, F_GETFL, 0);
+            return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0 &&
+                   fcntl(fd, F_SETFD, FD_CLOEXEC) == 0;
+        }
+
+        bool parseLevel(const std::string &text, LogLevel &level)
+        {
+            static const char *names[] = {"DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL"};
+            for (uint8_t i = 0; i < 5; ++i)
+            {
+                if (text == names[i])
+                {
+                    level = static_cast<LogLevel>(i);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        template <typename T>
+        void appendRaw(std::string &out, T value)
+        {
+            out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+        }
+
+        template <typename T>
+        T readRaw(const char *data)
+        {
+            T value;
+            std::memcpy(&value, data, sizeof(value));
+            return value;
+        }
+    }
+
+    LogStreamServer::LogStreamServer(size_t bufferSize, size_t maxSubscribers, SlowSubscriberPolicy policy,
+                                     std::function<void()> onSubscribersChanged)
+        : bufferSize_(bufferSize), maxSubscribers_(maxSubscribers), policy_(policy),
+          onSubscribersChanged_(std::move(onSubscribersChanged)),
+          unixListenFd_(-1), tcpListenFd_(-1), wakePipe_{-1, -1},
+          subscriberCount_(0), wakePending_(false), running_(false),
+          droppedCount_(0), disconnectCount_(0)
+    {
+    }
+
+    LogStreamServer::~LogStreamServer()
+    {
+        stop();
+    }
+
+    bool LogStreamServer::start(const std::string &socketPath, uint16_t tcpPort)
+    {
+        if (running_.load())
+        {
+            return true;
+        }
+
+        if (!socketPath.empty())
+        {
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            if (socketPath.size() < sizeof(addr.sun_path))
+            {
+                std::memcpy(addr.sun_path, socketPath.c_str(), socketPath.size() + 1);
+                unixListenFd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+                unlink(socketPath.c_str());
+                if (unixListenFd_ >= 0 &&
+                    (bind(unixListenFd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+                     listen(unixListenFd_, 4) != 0 || !setNonBlocking(unixListenFd_)))
+                {
+                    close(unixListenFd_);
+                    unixListenFd_ = -1;
+                }
+            }
+            if (unixListenFd_ >= 0)
+            {
+                socketPath_ = socketPath;
+            }
+            else
+            {
+                printf("LogStreamServer: Failed to listen on %s\n", socketPath.c_str());
+            }
+        }
+
+        if (tcpPort != 0)
+        {
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(tcpPort);
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            int reuse = 1;
+            tcpListenFd_ = socket(AF_INET, SOCK_STREAM, 0);
+            if (tcpListenFd_ >= 0 &&
+                (setsockopt(tcpListenFd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 ||
+                 bind(tcpListenFd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+                 listen(tcpListenFd_, 4) != 0 || !setNonBlocking(tcpListenFd_)))
+            {
+                close(tcpListenFd_);
+                tcpListenFd_ = -1;
+            }
+            if (tcpListenFd_ < 0)
+            {
+                printf("LogStreamServer: Failed to listen on 127.0.0.1:%u\n", tcpPort);
+            }
+        }
+
+        if (unixListenFd_ < 0 && tcpListenFd_ < 0)
+        {
+            return false;
+        }
+
+        if (pipe(wakePipe_) != 0 || !setNonBlocking(wakePipe_[0]) || !setNonBlocking(wakePipe_[1]))
+        {
+            closeAll();
+            return false;
+        }
+
+        running_.store(true);
+        serverThread_ = std::thread(&LogStreamServer::serverThreadFunction, this);
+        return true;
+    }
+
+    void LogStreamServer::stop()
+    {
+        if (!running_.exchange(false))
+        {
+            return;
+        }
+
+        wakeServer();
+        if (serverThread_.joinable())
+        {
+            serverThread_.join();
+        }
+
+        // Best effort: hand remaining buffered data to the kernel
+        std::lock_guard<std::mutex> lock(subscribersMutex_);
+        for (auto &subscriber : subscribers_)
+        {
+            sendPending(*subscriber);
+        }
+        closeAll();
+    }
+
+    void LogStreamServer::closeAll()
+    {
+        for (auto &subscriber : subscribers_)
+        {
+            close(subscriber->fd);
+        }
+        subscribers_.clear();
+        subscriberCount_.store(0);
+
+        for (int *fd : {&unixListenFd_, &tcpListenFd_, &wakePipe_[0], &wakePipe_[1]})
+        {
+            if (*fd >= 0)
+            {
+                close(*fd);
+                *fd = -1;
+            }
+        }
+
+        if (!socketPath_.empty())
+        {
+            unlink(socketPath_.c_str());
+            socketPath_.clear();
+        }
+    }
+
+    void LogStreamServer::publish(const LogEntry &entry, const std::string &formatted)
+    {
+        std::string binaryRecord;
+        bool queued = false;
+
+        {
+            std::lock_guard<std::mutex> lock(subscribersMutex_);
+            for (auto &subscriber : subscribers_)
+            {
+                if (subscriber->closing || entry.level < subscriber->minLevel ||
+                    entry.component.compare(0, subscriber->componentPrefix.size(),
+                                            subscriber->componentPrefix) != 0)
+                {
+                    continue;
+                }
+
+                if (subscriber->binary && binaryRecord.empty())
+                {
+                    encodeBinaryRecord(entry, binaryRecord);
+                }
+                size_t recordSize = subscriber->binary ? binaryRecord.size() : formatted.size() + 1;
+
+                if (subscriber->outbox.size() - subscriber->sentOffset + recordSize > bufferSize_)
+                {
+                    droppedCount_++;
+                    if (policy_ == SlowSubscriberPolicy::DISCONNECT)
+                    {
+                        disconnectCount_++;
+                        subscriber->closing = true;
+                        queued = true;
+                    }
+                    continue;
+                }
+
+                if (subscriber->sentOffset > bufferSize_ / 2)
+                {
+                    subscriber->outbox.erase(0, subscriber->sentOffset);
+                    subscriber->sentOffset = 0;
+                }
+
+                if (subscriber->binary)
+                {
+                    subscriber->outbox += binaryRecord;
+                }
+                else
+                {
+                    subscriber->outbox += formatted;
+                    subscriber->outbox += '\n';
+                }
+                queued = true;
+            }
+        }
+
+        if (queued)
+        {
+            wakeServer();
+        }
+    }
+
+    void LogStreamServer::wakeServer()
+    {
+        if (!wakePending_.exchange(true) && wakePipe_[1] >= 0)
+        {
+            char byte = 1;
+            ssize_t ignored = write(wakePipe_[1], &byte, 1);
+            (void)ignored;
+        }
+    }
+
+    void LogStreamServer::serverThreadFunction()
+    {
+        std::vector<pollfd> fds;
+        bool hadSubscribers = false;
+
+        while (running_.load())
+        {
+            fds.clear();
+            fds.push_back({wakePipe_[0], POLLIN, 0});
+            if (unixListenFd_ >= 0)
+            {
+                fds.push_back({unixListenFd_, POLLIN, 0});
+            }
+            if (tcpListenFd_ >= 0)
+            {
+                fds.push_back({tcpListenFd_, POLLIN, 0});
+            }
+            size_t firstSubscriber = fds.size();
+
+            {
+                std::lock_guard<std::mutex> lock(subscribersMutex_);
+                for (auto &subscriber : subscribers_)
+                {
+                    short events = POLLIN;
+                    if (subscriber->sentOffset < subscriber->outbox.size())
+                    {
+                        events |= POLLOUT;
+                    }
+                    fds.push_back({subscriber->fd, events, 0});
+                }
+            }
+
+            if (poll(fds.data(), fds.size(), 500) < 0 && errno != EINTR)
+            {
+                break;
+            }
+
+            if (fds[0].revents & POLLIN)
+            {
+                // Clear only once drained: a wakeServer() after the clear writes a byte that stays in the pipe
+                char drain[64];
+                while (read(wakePipe_[0], drain, sizeof(drain)) > 0)
+                {
+                }
+                wakePending_.store(false);
+            }
+
+            for (size_t i = 1; i < firstSubscriber; ++i)
+            {
+                if (fds[i].revents & POLLIN)
+                {
+                    acceptSubscriber(fds[i].fd);
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(subscribersMutex_);
+                for (size_t i = firstSubscriber; i < fds.size(); ++i)
+                {
+                    // Subscribers are only added/removed on this thread, order matches fds
+                    Subscriber &subscriber = *subscribers_[i - firstSubscriber];
+                    if (fds[i].revents & POLLIN)
+                    {
+                        readCommands(subscriber);
+                    }
+                    if (fds[i].revents & (POLLERR | POLLHUP))
+                    {
+                        subscriber.closing = true;
+                    }
+                    if (!subscriber.closing)
+                    {
+                        sendPending(subscriber);
+                    }
+                }
+
+                for (auto it = subscribers_.begin(); it != subscribers_.end();)
+                {
+                    if ((*it)->closing)
+                    {
+                        close((*it)->fd);
+                        it = subscribers_.erase(it);
+                    }
+                    else
+                    {
+                        ++it;
+                    }
+                }
+                subscriberCount_.store(subscribers_.size(), std::memory_order_relaxed);
+            }
+
+            bool hasSubscribersNow = hasSubscribers();
+            if (hasSubscribersNow != hadSubscribers && onSubscribersChanged_)
+            {
+                onSubscribersChanged_();
+            }
+            hadSubscribers = hasSubscribersNow;
+        }
+    }
+
+    void LogStreamServer::acceptSubscriber(int listenFd)
+    {
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(subscribersMutex_);
+        if (subscribers_.size() >= maxSubscribers_ || !setNonBlocking(fd))
+        {
+            close(fd);
+            return;
+        }
+
+        auto subscriber = std::make_unique<Subscriber>();
+        subscriber->fd = fd;
+        subscriber->outbox.reserve(bufferSize_);
+        subscribers_.push_back(std::move(subscriber));
+        subscriberCount_.store(subscribers_.size(), std::memory_order_relaxed);
+    }
+
+    void LogStreamServer::readCommands(Subscriber &subscriber)
+    {
+        char buffer[256];
+        ssize_t received = recv(subscriber.fd, buffer, sizeof(buffer), 0);
+        if (received <= 0)
+        {
+            if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+            {
+                subscriber.closing = true;
+            }
+            return;
+        }
+
+        subscriber.inbox.append(buffer, static_cast<size_t>(received));
+        size_t newline;
+        while ((newline = subscriber.inbox.find('\n')) != std::string::npos)
+        {
+            applyFilter(subscriber, subscriber.inbox.substr(0, newline));
+            subscriber.inbox.erase(0, newline + 1);
+        }
+
+        if (subscriber.inbox.size() > kMaxCommandLength)
+        {
+            subscriber.closing = true;
+        }
+    }
+
+    void LogStreamServer::applyFilter(Subscriber &subscriber, const std::string &line)
+    {
+        std::istringstream iss(line);
+        std::string word;
+        if (!(iss >> word) || word != "FILTER")
+        {
+            return;
+        }
+
+        while (iss >> word)
+        {
+            size_t equals = word.find('=');
+            if (equals == std::string::npos)
+            {
+                continue;
+            }
+            std::string key = word.substr(0, equals);
+            std::string value = word.substr(equals + 1);
+
+            if (key == "level")
+            {
+                parseLevel(value, subscriber.minLevel);
+            }
+            else if (key == "component")
+            {
+                subscriber.componentPrefix = value;
+            }
+            else if (key == "format")
+            {
+                subscriber.binary = value == "binary";
+            }
+        }
+    }
+
+    void LogStreamServer::sendPending(Subscriber &subscriber)
+    {
+        while (subscriber.sentOffset < subscriber.outbox.size())
+        {
+            ssize_t sent = send(subscriber.fd, subscriber.outbox.data() + subscriber.sentOffset,
+                                subscriber.outbox.size() - subscriber.sentOffset, MSG_NOSIGNAL);
+            if (sent <= 0)
+            {
+                if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                {
+                    subscriber.closing = true;
+                }
+                return;
+            }
+            subscriber.sentOffset += static_cast<size_t>(sent);
+        }
+
+        subscriber.outbox.clear();
+        subscriber.sentOffset = 0;
+    }
+
+    void LogStreamServer::prepareForFork()
+    {
+        subscribersMutex_.lock();
+    }
+
+    void LogStreamServer::resumeAfterForkParent()
+    {
+        subscribersMutex_.unlock();
+    }
+
+    void LogStreamServer::abandonAfterForkChild()
+    {
+        subscribersMutex_.unlock();
+
+        // The server thread only exists in the parent
+        if (serverThread_.joinable())
+        {
+            new (&serverThread_) std::thread();
+        }
+        running_.store(false);
+
+        // Keep the parent's socket file in place
+        socketPath_.clear();
+        closeAll();
+    }
+
+    void LogStreamServer::encodeBinaryRecord(const LogEntry &entry, std::string &out)
+    {
+        uint16_t componentLength = static_cast<uint16_t>(std::min<size_t>(entry.component.size(), UINT16_MAX));
+        uint16_t payloadLength = static_cast<uint16_t>(std::min<size_t>(entry.payload.size(), UINT16_MAX));
+        std::string context;
+        LogContext::render(entry.context.get(), context);
+        std::string frames;
+        formatting::appendBacktrace(frames, entry.backtrace.data(), entry.backtrace.size());
+        uint32_t length = static_cast<uint32_t>(sizeof(uint64_t) + sizeof(uint32_t) + 2 + 2 * sizeof(uint16_t) +
+                                                componentLength + payloadLength + context.size() +
+                                                entry.message.size() + frames.size());
+
+        appendRaw(out, length);
+        appendRaw(out, static_cast<uint64_t>(entry.timestampMs));
+        appendRaw(out, static_cast<uint32_t>(entry.processId));
+        appendRaw(out, static_cast<uint8_t>(entry.level));
+        appendRaw(out, static_cast<uint8_t>(0));
+        appendRaw(out, componentLength);
+        appendRaw(out, payloadLength);
+        out.append(entry.component, 0, componentLength);
+        out.append(entry.payload, 0, payloadLength);
+        out.append(context);
+        out.append(entry.message);
+        out.append(frames);
+    }
+
+    size_t LogStreamServer::decodeBinaryRecord(const char *data, size_t size, LogEntry &entry)
+    {
+        constexpr size_t kFixedSize = sizeof(uint64_t) + sizeof(uint32_t) + 2 + 2 * sizeof(uint16_t);
+        if (size < sizeof(uint32_t))
+        {
+            return 0;
+        }
+
+        uint32_t length = readRaw<uint32_t>(data);
+        if (length < kFixedSize || size < sizeof(uint32_t) + length)
+        {
+            return 0;
+        }
+
+        const char *p = data + sizeof(uint32_t);
+        entry.timestampMs = readRaw<uint64_t>(p);
+        entry.processId = readRaw<uint32_t>(p + 8);
+        entry.level = static_cast<LogLevel>(static_cast<uint8_t>(p[12]));
+        uint16_t componentLength = readRaw<uint16_t>(p + 14);
+        uint16_t payloadLength = readRaw<uint16_t>(p + 16);
+        if (kFixedSize + componentLength + payloadLength > length)
+        {
+            return 0;
+        }
+
+        const char *variable = p + kFixedSize;
+        entry.component.assign(variable, componentLength);
+        entry.payload.assign(variable + componentLength, payloadLength);
+        entry.payloadSize = payloadLength;
+        variable += componentLength + payloadLength;
+        entry.message.assign(variable, length - kFixedSize - componentLength - payloadLength);
+        entry.timestamp.clear();
+        entry.filename.clear();
+        entry.lineNumber = 0;
+        return sizeof(uint32_t) + length;
+    }
+
+} // namespace embedded_logger
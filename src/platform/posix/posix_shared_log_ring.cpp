@@ -0,0 +1,569 @@
+// POSIX shared-memory log ring
+/**
+ * @file posix_shared_log_ring.cpp
+ * @brief MAP_SHARED multi-producer log ring implementation
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/shared_log_ring.h"
+#include "embedded_logger/log_formatter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+namespace embedded_logger
+{
+
+    namespace
+    {
+        constexpr uint32_t kRingMagic = 0x454C5247; // "ELRG"
+        constexpr uint32_t kRingVersion = 5;
+
+        static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                      "SharedLogRing requires lock-free 64-bit atomics");
+        static_assert(std::atomic<uint32_t>::is_always_lock_free,
+                      "SharedLogRing requires lock-free 32-bit atomics");
+
+        uint32_t fnv1a(uint32_t hash, const void *data, size_t length)
+        {
+            const auto *bytes = static_cast<const uint8_t *>(data);
+            for (size_t i = 0; i < length; ++i)
+            {
+                hash = (hash ^ bytes[i]) * 16777619u;
+            }
+            return hash;
+        }
+
+        uint64_t steadyMs()
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                             std::chrono::steady_clock::now().time_since_epoch())
+                                             .count());
+        }
+
+        bool processAlive(uint32_t pid)
+        {
+            return kill(static_cast<pid_t>(pid), 0) == 0 || errno != ESRCH;
+        }
+
+        static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+                      "The doorbell is waited on as a plain 32-bit word");
+
+#ifdef __linux__
+        // Shared (not FUTEX_PRIVATE) operations: waiter and wakers may be different processes
+        void futexWait(std::atomic<uint32_t> &word, uint32_t expected, uint32_t timeoutMs)
+        {
+            struct timespec timeout;
+            timeout.tv_sec = static_cast<time_t>(timeoutMs / 1000);
+            timeout.tv_nsec = static_cast<long>(timeoutMs % 1000) * 1000000L;
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT, expected,
+                    timeoutMs == SharedLogRing::kWaitForever ? nullptr : &timeout, nullptr, 0);
+        }
+
+        void futexWakeOne(std::atomic<uint32_t> &word)
+        {
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+        }
+#endif
+    }
+
+    /**
+     * @brief Ring control block at the start of the mapping
+     */
+    struct SharedLogRing::RingHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t slotCount;
+        uint64_t slotSize;
+        alignas(64) std::atomic<uint64_t> head; ///< Next position to claim (producers)
+        alignas(64) std::atomic<uint64_t> tail; ///< Next position to read (consumer)
+        alignas(64) std::atomic<uint64_t> dropped;
+        std::atomic<uint64_t> abandoned;
+        std::atomic<uint64_t> corrupted;
+        alignas(64) std::atomic<uint32_t> doorbell; ///< Bumped by every notify()
+        std::atomic<uint32_t> consumerWaiting;      ///< Set while the consumer may sleep on the doorbell
+    };
+
+    /**
+     * @brief Slot contents covered by the checksum
+     */
+    struct SharedLogRing::SlotRecord
+    {
+        uint64_t timestampMs;
+        int32_t lineNumber;
+        uint8_t level;
+        uint8_t reserved;
+        uint16_t timestampLength;
+        uint16_t componentLength;
+        uint16_t messageLength;
+        uint16_t payloadLength;
+        uint32_t payloadSize;
+        char text[kSlotTextSize];
+    };
+
+    /**
+     * @brief One fixed-size entry slot
+     * @details sequence == position: claimable (or claimed, write in progress);
+     *          sequence == position + 1: committed, readable by the consumer.
+     *          ownerPid is set right after the claim and cleared on release so
+     *          the consumer can tell a crashed producer from a slow one. The
+     *          checksum is seeded with the position, so bytes a late producer
+     *          writes into a slot that has since been reused never verify.
+     */
+    struct SharedLogRing::RingSlot
+    {
+        std::atomic<uint64_t> sequence;
+        std::atomic<uint32_t> ownerPid;
+        uint32_t checksum;
+        SlotRecord record;
+    };
+
+    namespace
+    {
+        size_t roundSlotCount(size_t slotCount)
+        {
+            size_t count = 1;
+            while (count < std::max<size_t>(slotCount, 2))
+            {
+                count <<= 1;
+            }
+            return count;
+        }
+    }
+
+    void SharedLogRing::initializeMapping(void *mapping, size_t slotCount)
+    {
+        auto *header = new (mapping) RingHeader();
+        header->magic = 0;
+        header->version = kRingVersion;
+        header->slotCount = slotCount;
+        header->slotSize = sizeof(RingSlot);
+        header->head.store(0);
+        header->tail.store(0);
+        header->dropped.store(0);
+        header->abandoned.store(0);
+        header->corrupted.store(0);
+        header->doorbell.store(0);
+        header->consumerWaiting.store(0);
+
+        auto *slots = reinterpret_cast<RingSlot *>(static_cast<char *>(mapping) + sizeof(RingHeader));
+        for (size_t i = 0; i < slotCount; ++i)
+        {
+            auto *slot = new (&slots[i]) RingSlot();
+            slot->sequence.store(i, std::memory_order_relaxed);
+            slot->ownerPid.store(0, std::memory_order_relaxed);
+        }
+
+        // Attachers check the magic last
+        std::atomic_thread_fence(std::memory_order_release);
+        header->magic = kRingMagic;
+    }
+
+    std::unique_ptr<SharedLogRing> SharedLogRing::createAnonymous(size_t slotCount)
+    {
+        size_t count = roundSlotCount(slotCount);
+        size_t mappingSize = sizeof(RingHeader) + count * sizeof(RingSlot);
+        void *mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED)
+        {
+            return nullptr;
+        }
+
+        initializeMapping(mapping, count);
+        return std::unique_ptr<SharedLogRing>(new SharedLogRing(mapping, mappingSize));
+    }
+
+    std::unique_ptr<SharedLogRing> SharedLogRing::create(const std::string &name, size_t slotCount)
+    {
+        size_t count = roundSlotCount(slotCount);
+        size_t mappingSize = sizeof(RingHeader) + count * sizeof(RingSlot);
+
+        int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0660);
+        if (fd < 0)
+        {
+            return nullptr;
+        }
+
+        struct stat st;
+        bool reuse = fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) == mappingSize;
+        if (!reuse && ftruncate(fd, static_cast<off_t>(mappingSize)) != 0)
+        {
+            close(fd);
+            return nullptr;
+        }
+
+        void *mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED)
+        {
+            return nullptr;
+        }
+
+        // A restarted collector keeps whatever producers committed while it was down
+        auto *header = static_cast<RingHeader *>(mapping);
+        if (!reuse || header->magic != kRingMagic || header->version != kRingVersion ||
+            header->slotCount != count || header->slotSize != sizeof(RingSlot))
+        {
+            initializeMapping(mapping, count);
+        }
+
+        return std::unique_ptr<SharedLogRing>(new SharedLogRing(mapping, mappingSize));
+    }
+
+    std::unique_ptr<SharedLogRing> SharedLogRing::attach(const std::string &name)
+    {
+        int fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0)
+        {
+            return nullptr;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(RingHeader))
+        {
+            close(fd);
+            return nullptr;
+        }
+
+        size_t mappingSize = static_cast<size_t>(st.st_size);
+        void *mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED)
+        {
+            return nullptr;
+        }
+
+        auto *header = static_cast<RingHeader *>(mapping);
+        bool valid = header->magic == kRingMagic && header->version == kRingVersion &&
+                     header->slotSize == sizeof(RingSlot) &&
+                     sizeof(RingHeader) + header->slotCount * sizeof(RingSlot) == mappingSize;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (!valid)
+        {
+            munmap(mapping, mappingSize);
+            return nullptr;
+        }
+
+        return std::unique_ptr<SharedLogRing>(new SharedLogRing(mapping, mappingSize));
+    }
+
+    bool SharedLogRing::unlink(const std::string &name)
+    {
+        return shm_unlink(name.c_str()) == 0;
+    }
+
+    SharedLogRing::SharedLogRing(void *mapping, size_t mappingSize)
+        : mapping_(mapping), mappingSize_(mappingSize),
+          header_(static_cast<RingHeader *>(mapping)),
+          slots_(reinterpret_cast<RingSlot *>(static_cast<char *>(mapping) + sizeof(RingHeader))),
+          stallTimeoutMs_(100), stallPosition_(UINT64_MAX), stallSinceMs_(0)
+    {
+    }
+
+    SharedLogRing::~SharedLogRing()
+    {
+        munmap(mapping_, mappingSize_);
+    }
+
+    SharedLogRing::RingSlot *SharedLogRing::slotAt(uint64_t position) const
+    {
+        return &slots_[position & (header_->slotCount - 1)];
+    }
+
+    uint32_t SharedLogRing::computeChecksum(uint64_t position, const SlotRecord &record)
+    {
+        uint32_t hash = 2166136261u;
+        hash = fnv1a(hash, &position, sizeof(position));
+        hash = fnv1a(hash, &record.timestampMs, sizeof(record.timestampMs));
+        hash = fnv1a(hash, &record.lineNumber, sizeof(record.lineNumber));
+        hash = fnv1a(hash, &record.level, sizeof(record.level));
+        hash = fnv1a(hash, &record.timestampLength, sizeof(record.timestampLength));
+        hash = fnv1a(hash, &record.componentLength, sizeof(record.componentLength));
+        hash = fnv1a(hash, &record.messageLength, sizeof(record.messageLength));
+        hash = fnv1a(hash, &record.payloadLength, sizeof(record.payloadLength));
+        hash = fnv1a(hash, &record.payloadSize, sizeof(record.payloadSize));
+
+        size_t textLength = static_cast<size_t>(record.timestampLength) + record.componentLength +
+                            record.messageLength + record.payloadLength;
+        return fnv1a(hash, record.text, std::min(textLength, kSlotTextSize));
+    }
+
+    bool SharedLogRing::push(const LogEntry &entry)
+    {
+        uint64_t position = header_->head.load(std::memory_order_relaxed);
+        RingSlot *slot = nullptr;
+
+        for (;;)
+        {
+            slot = slotAt(position);
+            uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+            int64_t diff = static_cast<int64_t>(sequence - position);
+
+            if (diff == 0)
+            {
+                if (header_->head.compare_exchange_weak(position, position + 1,
+                                                        std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                header_->dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                position = header_->head.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->ownerPid.store(static_cast<uint32_t>(getpid()), std::memory_order_relaxed);
+
+        // Copy truncated text fields back to back
+        size_t remaining = kSlotTextSize;
+        size_t timestampLength = std::min(entry.timestamp.size(), remaining);
+        remaining -= timestampLength;
+        size_t componentLength = std::min(entry.component.size(), remaining);
+        remaining -= componentLength;
+        // Context does not survive the process boundary as a handle; render it (and any backtrace) into the message
+        std::string contextual;
+        const std::string *message = &entry.message;
+        if (entry.context || !entry.backtrace.empty())
+        {
+            LogContext::render(entry.context.get(), contextual);
+            contextual += entry.message;
+            formatting::appendBacktrace(contextual, entry.backtrace.data(), entry.backtrace.size());
+            message = &contextual;
+        }
+
+        size_t messageLength = std::min(message->size(), remaining);
+        remaining -= messageLength;
+        size_t payloadLength = std::min(entry.payload.size(), remaining);
+
+        SlotRecord &record = slot->record;
+        char *text = record.text;
+        std::memcpy(text, entry.timestamp.data(), timestampLength);
+        std::memcpy(text + timestampLength, entry.component.data(), componentLength);
+        std::memcpy(text + timestampLength + componentLength, message->data(), messageLength);
+        std::memcpy(text + timestampLength + componentLength + messageLength, entry.payload.data(), payloadLength);
+
+        record.timestampMs = entry.timestampMs;
+        record.lineNumber = entry.lineNumber;
+        record.level = static_cast<uint8_t>(entry.level);
+        record.timestampLength = static_cast<uint16_t>(timestampLength);
+        record.componentLength = static_cast<uint16_t>(componentLength);
+        record.messageLength = static_cast<uint16_t>(messageLength);
+        record.payloadLength = static_cast<uint16_t>(payloadLength);
+        record.payloadSize = entry.payloadSize;
+
+        // Skipped while we stalled: the slot may already hold a newer position's
+        // entry, which our bytes have torn; leave its checksum to fail
+        if (slot->sequence.load(std::memory_order_acquire) != position)
+        {
+            return false;
+        }
+        slot->checksum = computeChecksum(position, record);
+
+        // Commit. Fails only if the consumer gave up on this slot while we stalled.
+        uint64_t expected = position;
+        if (!slot->sequence.compare_exchange_strong(expected, position + 1,
+                                                    std::memory_order_release,
+                                                    std::memory_order_relaxed))
+        {
+            return false;
+        }
+        notify();
+        return true;
+    }
+
+    void SharedLogRing::notify()
+    {
+        // Pairs with prepareWait(): either the consumer sees the new doorbell value
+        // or we see it waiting, so a wakeup is never lost
+        header_->doorbell.fetch_add(1, std::memory_order_seq_cst);
+#ifdef __linux__
+        if (header_->consumerWaiting.load(std::memory_order_seq_cst) != 0)
+        {
+            futexWakeOne(header_->doorbell);
+        }
+#endif
+    }
+
+    uint32_t SharedLogRing::prepareWait()
+    {
+        header_->consumerWaiting.store(1, std::memory_order_seq_cst);
+        return header_->doorbell.load(std::memory_order_seq_cst);
+    }
+
+    void SharedLogRing::wait(uint32_t ticket, uint32_t timeoutMs)
+    {
+        if (stallPosition_ != UINT64_MAX)
+        {
+            // A claimed slot is still uncommitted: come back when it can be abandoned
+            uint64_t stalledMs = steadyMs() - stallSinceMs_;
+            uint64_t untilAbandon = stalledMs < stallTimeoutMs_ ? stallTimeoutMs_ - stalledMs : 0;
+            timeoutMs = static_cast<uint32_t>(std::min<uint64_t>(timeoutMs, untilAbandon));
+        }
+        else if (header_->head.load(std::memory_order_relaxed) != header_->tail.load(std::memory_order_relaxed))
+        {
+            // Claimed since the last pop(); let pop() start timing it in case its owner never commits
+            timeoutMs = 0;
+        }
+
+        if (timeoutMs != 0)
+        {
+#ifdef __linux__
+            futexWait(header_->doorbell, ticket, timeoutMs);
+#else
+            // No cross-process wait primitive: poll
+            if (header_->doorbell.load(std::memory_order_seq_cst) == ticket)
+            {
+                usleep(std::min<uint32_t>(timeoutMs, 10) * 1000);
+            }
+#endif
+        }
+        header_->consumerWaiting.store(0, std::memory_order_relaxed);
+    }
+
+    void SharedLogRing::releaseSlot(RingSlot *slot, uint64_t position)
+    {
+        slot->ownerPid.store(0, std::memory_order_relaxed);
+        slot->sequence.store(position + header_->slotCount, std::memory_order_release);
+        header_->tail.store(position + 1, std::memory_order_relaxed);
+        stallPosition_ = UINT64_MAX;
+    }
+
+    bool SharedLogRing::pop(LogEntry &entry)
+    {
+        for (;;)
+        {
+            uint64_t position = header_->tail.load(std::memory_order_relaxed);
+            RingSlot *slot = slotAt(position);
+            uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+
+            if (sequence == position + 1)
+            {
+                // Verify the copy actually used: a producer that resumed after its
+                // slot was skipped may still be writing into it
+                uint32_t checksum = slot->checksum;
+                SlotRecord record;
+                std::memcpy(&record, &slot->record, sizeof(record));
+                size_t textLength = static_cast<size_t>(record.timestampLength) + record.componentLength +
+                                    record.messageLength + record.payloadLength;
+                if (textLength > kSlotTextSize || checksum != computeChecksum(position, record) ||
+                    slot->sequence.load(std::memory_order_acquire) != position + 1)
+                {
+                    header_->corrupted.fetch_add(1, std::memory_order_relaxed);
+                    releaseSlot(slot, position);
+                    continue;
+                }
+
+                const char *text = record.text;
+                entry.level = static_cast<LogLevel>(record.level);
+                entry.timestamp.assign(text, record.timestampLength);
+                entry.component.assign(text + record.timestampLength, record.componentLength);
+                entry.message.assign(text + record.timestampLength + record.componentLength, record.messageLength);
+                entry.payload.assign(text + record.timestampLength + record.componentLength + record.messageLength,
+                                     record.payloadLength);
+                entry.payloadSize = record.payloadSize;
+                entry.filename.clear();
+                entry.lineNumber = record.lineNumber;
+                entry.timestampMs = record.timestampMs;
+                entry.processId = slot->ownerPid.load(std::memory_order_relaxed);
+
+                releaseSlot(slot, position);
+                return true;
+            }
+
+            // Nothing claimed at this position yet
+            if (header_->head.load(std::memory_order_relaxed) == position)
+            {
+                return false;
+            }
+
+            // Claimed but not committed: a producer is mid-write or died mid-write
+            if (!abandonStalledSlot(slot, position))
+            {
+                return false;
+            }
+        }
+    }
+
+    bool SharedLogRing::abandonStalledSlot(RingSlot *slot, uint64_t position)
+    {
+        uint32_t owner = slot->ownerPid.load(std::memory_order_relaxed);
+        bool ownerDead = owner != 0 && !processAlive(owner);
+
+        if (!ownerDead)
+        {
+            uint64_t now = steadyMs();
+            if (stallPosition_ != position)
+            {
+                stallPosition_ = position;
+                stallSinceMs_ = now;
+                return false;
+            }
+            if (now - stallSinceMs_ < stallTimeoutMs_)
+            {
+                return false;
+            }
+        }
+
+        // Skip the slot; a late commit from the owner will fail its CAS
+        uint64_t expected = position;
+        if (!slot->sequence.compare_exchange_strong(expected, position + header_->slotCount,
+                                                    std::memory_order_acq_rel))
+        {
+            // Committed just now, read it on the next pass
+            return true;
+        }
+
+        slot->ownerPid.store(0, std::memory_order_relaxed);
+        header_->tail.store(position + 1, std::memory_order_relaxed);
+        header_->abandoned.fetch_add(1, std::memory_order_relaxed);
+        stallPosition_ = UINT64_MAX;
+        return true;
+    }
+
+    void SharedLogRing::setStallTimeout(uint32_t timeoutMs)
+    {
+        stallTimeoutMs_ = timeoutMs;
+    }
+
+    uint64_t SharedLogRing::getDroppedCount() const
+    {
+        return header_->dropped.load(std::memory_order_relaxed);
+    }
+
+    uint64_t SharedLogRing::getAbandonedCount() const
+    {
+        return header_->abandoned.load(std::memory_order_relaxed);
+    }
+
+    uint64_t SharedLogRing::getCorruptedCount() const
+    {
+        return header_->corrupted.load(std::memory_order_relaxed);
+    }
+
+} // namespace embedded_logger
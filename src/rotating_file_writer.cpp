@@ -0,0 +1,103 @@
+// Rotating file writer
+/**
+ * @file rotating_file_writer.cpp
+ * @brief Size-rotated append-only file implementation
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/rotating_file_writer.h"
+
+#include <cstdio>
+
+namespace embedded_logger
+{
+
+    RotatingFileWriter::RotatingFileWriter(IFileSystem &fileSystem, size_t maxFileSize, int maxBackupFiles)
+        : fileSystem_(fileSystem), maxFileSize_(maxFileSize), maxBackupFiles_(maxBackupFiles),
+          handle_(kInvalidFileHandle), currentSize_(0), rotationCount_(0)
+    {
+    }
+
+    RotatingFileWriter::~RotatingFileWriter()
+    {
+        close();
+    }
+
+    bool RotatingFileWriter::open(const std::string &path, const std::string &header)
+    {
+        close();
+        path_ = path;
+        header_ = header;
+        rotationCount_ = 0;
+        return reopen(false);
+    }
+
+    bool RotatingFileWriter::reopen(bool truncate)
+    {
+        handle_ = fileSystem_.openFile(path_, truncate ? FileOpenMode::TRUNCATE : FileOpenMode::APPEND);
+        if (handle_ == kInvalidFileHandle)
+        {
+            printf("Logger: Failed to open file: %s\n", path_.c_str());
+            return false;
+        }
+
+        currentSize_ = truncate ? 0 : fileSystem_.getFileSize(path_);
+        if (currentSize_ == 0 && !header_.empty())
+        {
+            fileSystem_.appendFile(handle_, header_.data(), header_.size());
+            currentSize_ = header_.size();
+        }
+        return true;
+    }
+
+    bool RotatingFileWriter::write(const void *data, size_t size)
+    {
+        WriteBuffer buffer = {data, size};
+        return write(&buffer, 1);
+    }
+
+    bool RotatingFileWriter::write(const WriteBuffer *buffers, size_t count)
+    {
+        if (!isOpen() || !fileSystem_.appendFileV(handle_, buffers, count))
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            currentSize_ += buffers[i].size;
+        }
+
+        if (maxFileSize_ != 0 && currentSize_ >= maxFileSize_)
+        {
+            fileSystem_.closeFile(handle_);
+            handle_ = kInvalidFileHandle;
+            shiftBackups(fileSystem_, path_, maxBackupFiles_);
+            rotationCount_++;
+            return reopen(true);
+        }
+        return true;
+    }
+
+    bool RotatingFileWriter::sync()
+    {
+        return isOpen() && fileSystem_.syncFile(handle_);
+    }
+
+    void RotatingFileWriter::close()
+    {
+        if (isOpen())
+        {
+            fileSystem_.closeFile(handle_);
+            handle_ = kInvalidFileHandle;
+        }
+    }
+
+    bool RotatingFileWriter::shiftBackups(IFileSystem &fileSystem, const std::string &path, int maxBackupFiles)
+    {
+        return shiftBackupFiles(fileSystem, path, maxBackupFiles);
+    }
+
+} // namespace embedded_logger
@@ -0,0 +1,542 @@
+// MAVLink telemetry recorder
+// Raw packet capture in .tlog framing
+/**
+ * @file mavlink_tlog_recorder.cpp
+ * @brief MAVLink .tlog recorder, reader and synthetic traffic generator
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/mavlink_tlog_recorder.h"
+#include "embedded_logger/rotating_file_writer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+
+namespace embedded_logger
+{
+
+    namespace
+    {
+        constexpr uint8_t kMavlinkV1Magic = 0xFE;
+        constexpr uint8_t kMavlinkV2Magic = 0xFD;
+        constexpr uint8_t kMavlinkSignedFlag = 0x01;
+        constexpr size_t kMavlinkSignatureSize = 13;
+
+        uint64_t nowMs()
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                             std::chrono::steady_clock::now().time_since_epoch())
+                                             .count());
+        }
+
+        uint64_t nowUs()
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                             std::chrono::system_clock::now().time_since_epoch())
+                                             .count());
+        }
+
+        std::string fileTimestamp()
+        {
+            std::time_t now = std::time(nullptr);
+            std::tm tm = *std::localtime(&now);
+            char buffer[32];
+            std::strftime(buffer, sizeof(buffer), "%Y-%m-%d_%H_%M_%S", &tm);
+            return buffer;
+        }
+
+        /**
+         * @brief Full packet length from its first bytes
+         * @return Length, or 0 if the bytes do not start a MAVLink packet
+         */
+        size_t mavlinkPacketLength(const uint8_t *data, size_t available)
+        {
+            if (available >= 2 && data[0] == kMavlinkV1Magic)
+            {
+                return 6 + static_cast<size_t>(data[1]) + 2;
+            }
+            if (available >= 3 && data[0] == kMavlinkV2Magic)
+            {
+                return 10 + static_cast<size_t>(data[1]) + 2 +
+                       ((data[2] & kMavlinkSignedFlag) ? kMavlinkSignatureSize : 0);
+            }
+            return 0;
+        }
+
+        /// CRC-16/MCRF4XX as used by MAVLink
+        void crcAccumulate(uint16_t &crc, uint8_t byte)
+        {
+            uint8_t tmp = static_cast<uint8_t>(byte ^ static_cast<uint8_t>(crc & 0xFF));
+            tmp = static_cast<uint8_t>(tmp ^ (tmp << 4));
+            crc = static_cast<uint16_t>((crc >> 8) ^ (tmp << 8) ^ (tmp << 3) ^ (tmp >> 4));
+        }
+
+        template <typename T>
+        uint8_t *put(uint8_t *out, T value)
+        {
+            std::memcpy(out, &value, sizeof(value));
+            return out + sizeof(value);
+        }
+    }
+
+    MavlinkTlogRecorder::MavlinkTlogRecorder(const TlogRecorderConfig &config, std::unique_ptr<IFileSystem> fileSystem)
+        : config_(config), fileSystem_(fileSystem ? std::move(fileSystem) : Logger::createDefaultFileSystem()),
+          flushRequest_(0), flushDone_(0), running_(false), lastSyncMs_(0), lastDropReportMs_(0),
+          reportedDrops_(0), packetCount_(0), droppedPoolExhausted_(0), droppedOverwritten_(0), droppedOversize_(0)
+    {
+        config_.poolBuffers = std::max<size_t>(1, config_.poolBuffers);
+        config_.maxPacketSize = std::max<size_t>(1, config_.maxPacketSize);
+
+        storage_.reset(new uint8_t[config_.poolBuffers * config_.maxPacketSize]);
+        buffers_.resize(config_.poolBuffers);
+        freeBuffers_.reserve(config_.poolBuffers);
+        readyBuffers_.reserve(config_.poolBuffers);
+        for (size_t i = 0; i < config_.poolBuffers; ++i)
+        {
+            buffers_[i].data = storage_.get() + i * config_.maxPacketSize;
+            buffers_[i].capacity = config_.maxPacketSize;
+            freeBuffers_.push_back(&buffers_[i]);
+        }
+    }
+
+    MavlinkTlogRecorder::~MavlinkTlogRecorder()
+    {
+        stop();
+    }
+
+    bool MavlinkTlogRecorder::start()
+    {
+        if (running_.load())
+        {
+            return true;
+        }
+
+        if (!fileSystem_->fileExists(config_.logDirectory) && !fileSystem_->createDirectory(config_.logDirectory))
+        {
+            printf("Logger: Failed to create telemetry log directory: %s\n", config_.logDirectory.c_str());
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(writerMutex_);
+            writer_ = std::make_unique<RotatingFileWriter>(*fileSystem_, config_.maxFileSize, config_.maxBackupFiles);
+            std::string path = config_.logDirectory + "/" + config_.logFilePrefix + "_" + fileTimestamp() + ".tlog";
+            if (!writer_->open(path, std::string()))
+            {
+                writer_.reset();
+                return false;
+            }
+        }
+
+        staging_.reserve(config_.poolBuffers * (sizeof(uint64_t) + config_.maxPacketSize));
+        lastSyncMs_ = nowMs();
+        lastDropReportMs_ = lastSyncMs_;
+        running_.store(true);
+        writerThread_ = std::thread(&MavlinkTlogRecorder::writerThreadFunction, this);
+        return true;
+    }
+
+    void MavlinkTlogRecorder::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            if (!running_.exchange(false))
+            {
+                return;
+            }
+        }
+        queueCondition_.notify_all();
+        flushCondition_.notify_all();
+
+        if (writerThread_.joinable())
+        {
+            writerThread_.join();
+        }
+
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        if (writer_)
+        {
+            writer_->close();
+        }
+    }
+
+    MavlinkTlogRecorder::Buffer *MavlinkTlogRecorder::acquire()
+    {
+        if (!running_.load(std::memory_order_relaxed))
+        {
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        if (!freeBuffers_.empty())
+        {
+            Buffer *buffer = freeBuffers_.back();
+            freeBuffers_.pop_back();
+            return buffer;
+        }
+
+        if (config_.dropPolicy == TlogDropPolicy::DROP_OLDEST && !readyBuffers_.empty())
+        {
+            Buffer *buffer = readyBuffers_.front();
+            readyBuffers_.erase(readyBuffers_.begin());
+            droppedOverwritten_.fetch_add(1, std::memory_order_relaxed);
+            return buffer;
+        }
+
+        droppedPoolExhausted_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    void MavlinkTlogRecorder::commit(Buffer *buffer, size_t size, uint64_t timestampUs)
+    {
+        if (!buffer)
+        {
+            return;
+        }
+
+        buffer->size = std::min(size, buffer->capacity);
+        buffer->timestampUs = timestampUs ? timestampUs : nowUs();
+        {
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            readyBuffers_.push_back(buffer);
+        }
+        queueCondition_.notify_one();
+    }
+
+    void MavlinkTlogRecorder::release(Buffer *buffer)
+    {
+        if (!buffer)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        freeBuffers_.push_back(buffer);
+    }
+
+    bool MavlinkTlogRecorder::recordPacket(const uint8_t *data, size_t size, uint64_t timestampUs)
+    {
+        if (size > config_.maxPacketSize)
+        {
+            droppedOversize_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        Buffer *buffer = acquire();
+        if (!buffer)
+        {
+            return false;
+        }
+
+        std::memcpy(buffer->data, data, size);
+        commit(buffer, size, timestampUs);
+        return true;
+    }
+
+    void MavlinkTlogRecorder::flush()
+    {
+        std::unique_lock<std::mutex> lock(queueMutex_);
+        if (!running_.load())
+        {
+            return;
+        }
+
+        uint64_t ticket = ++flushRequest_;
+        queueCondition_.notify_all();
+        flushCondition_.wait(lock, [this, ticket]
+                             { return flushDone_ >= ticket || !running_.load(); });
+    }
+
+    TlogDropStats MavlinkTlogRecorder::getDropStats() const
+    {
+        TlogDropStats stats;
+        stats.poolExhausted = droppedPoolExhausted_.load();
+        stats.overwritten = droppedOverwritten_.load();
+        stats.oversize = droppedOversize_.load();
+        return stats;
+    }
+
+    std::string MavlinkTlogRecorder::getCurrentFile() const
+    {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        return writer_ ? writer_->getCurrentFile() : std::string();
+    }
+
+    void MavlinkTlogRecorder::writeBatch(std::vector<Buffer *> &batch)
+    {
+        staging_.clear();
+        for (const Buffer *buffer : batch)
+        {
+            // .tlog framing: big-endian microsecond timestamp, then the raw packet
+            char stamp[sizeof(uint64_t)];
+            for (size_t i = 0; i < sizeof(stamp); ++i)
+            {
+                stamp[i] = static_cast<char>(buffer->timestampUs >> (56 - 8 * i));
+            }
+            staging_.append(stamp, sizeof(stamp));
+            staging_.append(reinterpret_cast<const char *>(buffer->data), buffer->size);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(writerMutex_);
+            if (writer_->write(staging_.data(), staging_.size()))
+            {
+                packetCount_.fetch_add(batch.size(), std::memory_order_relaxed);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        freeBuffers_.insert(freeBuffers_.end(), batch.begin(), batch.end());
+        batch.clear();
+    }
+
+    void MavlinkTlogRecorder::reportDrops()
+    {
+        uint64_t now = nowMs();
+        if (config_.dropReportIntervalMs == 0 || now - lastDropReportMs_ < config_.dropReportIntervalMs)
+        {
+            return;
+        }
+        lastDropReportMs_ = now;
+
+        TlogDropStats stats = getDropStats();
+        uint64_t total = stats.poolExhausted + stats.overwritten + stats.oversize;
+        if (total == reportedDrops_)
+        {
+            return;
+        }
+
+        if (auto logger = Logger::getGlobalLogger())
+        {
+            logger->warning("TLOG", "Telemetry recorder dropped " + std::to_string(total - reportedDrops_) +
+                                        " packets (total: pool exhausted " + std::to_string(stats.poolExhausted) +
+                                        ", overwritten " + std::to_string(stats.overwritten) +
+                                        ", oversize " + std::to_string(stats.oversize) + ")");
+        }
+        reportedDrops_ = total;
+    }
+
+    void MavlinkTlogRecorder::writerThreadFunction()
+    {
+        std::vector<Buffer *> batch;
+        batch.reserve(config_.poolBuffers);
+
+        for (;;)
+        {
+            uint64_t pendingFlush;
+            bool stopping;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex_);
+                queueCondition_.wait_for(lock, std::chrono::milliseconds(250), [this]
+                                         { return !readyBuffers_.empty() || !running_.load() ||
+                                                  flushRequest_ != flushDone_; });
+                batch.swap(readyBuffers_);
+                pendingFlush = flushRequest_;
+                stopping = !running_.load();
+            }
+
+            bool wrote = !batch.empty();
+            if (wrote)
+            {
+                writeBatch(batch);
+            }
+
+            uint64_t now = nowMs();
+            if (wrote && config_.syncIntervalMs != 0 && now - lastSyncMs_ >= config_.syncIntervalMs)
+            {
+                std::lock_guard<std::mutex> lock(writerMutex_);
+                writer_->sync();
+                lastSyncMs_ = now;
+            }
+
+            if (pendingFlush != flushDone_)
+            {
+                std::lock_guard<std::mutex> lock(queueMutex_);
+                flushDone_ = pendingFlush;
+                flushCondition_.notify_all();
+            }
+
+            reportDrops();
+
+            if (stopping)
+            {
+                break;
+            }
+        }
+    }
+
+    TlogRecorderConfig MavlinkTlogRecorder::configFromLogger(const LoggerConfig &config)
+    {
+        TlogRecorderConfig tlogConfig;
+        tlogConfig.logDirectory = config.logDirectory;
+        tlogConfig.logFilePrefix = config.logFilePrefix + "_telemetry";
+        tlogConfig.maxFileSize = config.maxFileSize;
+        tlogConfig.maxBackupFiles = config.maxBackupFiles;
+        return tlogConfig;
+    }
+
+    bool MavlinkTlogRecorder::readFile(const std::string &path, std::vector<TlogPacket> &packets)
+    {
+        std::ifstream input(path, std::ios::binary);
+        if (!input.is_open())
+        {
+            printf("Logger: Failed to open telemetry log: %s\n", path.c_str());
+            return false;
+        }
+
+        std::vector<uint8_t> contents((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+        size_t offset = 0;
+        while (offset + sizeof(uint64_t) < contents.size())
+        {
+            const uint8_t *record = contents.data() + offset;
+            size_t available = contents.size() - offset - sizeof(uint64_t);
+            size_t length = mavlinkPacketLength(record + sizeof(uint64_t), available);
+            if (length == 0)
+            {
+                printf("Logger: Unrecognised packet at offset %zu in %s\n", offset, path.c_str());
+                break;
+            }
+            if (length > available)
+            {
+                break;
+            }
+
+            TlogPacket packet;
+            for (size_t i = 0; i < sizeof(uint64_t); ++i)
+            {
+                packet.timestampUs = (packet.timestampUs << 8) | record[i];
+            }
+            packet.data.assign(record + sizeof(uint64_t), record + sizeof(uint64_t) + length);
+            packets.push_back(std::move(packet));
+            offset += sizeof(uint64_t) + length;
+        }
+        return true;
+    }
+
+    SyntheticMavlinkGenerator::SyntheticMavlinkGenerator(uint32_t seed, uint8_t systemId, uint8_t componentId)
+        : state_(seed ? seed : 1), systemId_(systemId), componentId_(componentId), sequence_(0), counter_(0)
+    {
+    }
+
+    uint32_t SyntheticMavlinkGenerator::nextRandom()
+    {
+        // xorshift32
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 17;
+        state_ ^= state_ << 5;
+        return state_;
+    }
+
+    size_t SyntheticMavlinkGenerator::next(uint8_t *buffer, size_t capacity)
+    {
+        uint8_t payload[255] = {};
+        uint8_t *p = payload;
+        uint32_t messageId;
+        uint8_t crcExtra;
+        uint32_t timeBootMs = counter_ * 20;
+        auto jitter = [this](float scale)
+        { return (static_cast<float>(nextRandom() & 0xFFFF) / 65535.0f - 0.5f) * scale; };
+
+        // 50 Hz attitude and position, heartbeat and status every 50th packet
+        uint32_t slot = counter_ % 50;
+        if (slot == 0)
+        {
+            messageId = 0; // HEARTBEAT
+            crcExtra = 50;
+            p = put<uint32_t>(p, 0);  // custom_mode
+            p = put<uint8_t>(p, 2);   // type: quadrotor
+            p = put<uint8_t>(p, 3);   // autopilot: ArduPilot
+            p = put<uint8_t>(p, 0x81); // base_mode: armed, custom mode
+            p = put<uint8_t>(p, 4);   // system_status: active
+            p = put<uint8_t>(p, 3);   // mavlink_version
+        }
+        else if (slot == 25)
+        {
+            messageId = 1; // SYS_STATUS
+            crcExtra = 124;
+            p = put<uint32_t>(p, 0x0020FC2F); // sensors present
+            p = put<uint32_t>(p, 0x0020FC2F); // sensors enabled
+            p = put<uint32_t>(p, 0x0020FC2F); // sensors healthy
+            p = put<uint16_t>(p, static_cast<uint16_t>(300 + (nextRandom() & 0xFF))); // load
+            p = put<uint16_t>(p, static_cast<uint16_t>(15800 - counter_ % 1000));      // voltage_battery mV
+            p = put<int16_t>(p, static_cast<int16_t>(1200 + (nextRandom() & 0x7F)));   // current_battery cA
+            p = put<uint16_t>(p, 0);                                                 // drop_rate_comm
+            p = put<uint16_t>(p, 0);                                                 // errors_comm
+            p = put<uint16_t>(p, 0);                                                 // errors_count1
+            p = put<uint16_t>(p, 0);                                                 // errors_count2
+            p = put<uint16_t>(p, 0);                                                 // errors_count3
+            p = put<uint16_t>(p, 0);                                                 // errors_count4
+            p = put<int8_t>(p, 87);                                                  // battery_remaining
+        }
+        else if (slot & 1)
+        {
+            messageId = 30; // ATTITUDE
+            crcExtra = 39;
+            p = put<uint32_t>(p, timeBootMs);
+            p = put<float>(p, jitter(0.2f));  // roll
+            p = put<float>(p, jitter(0.2f));  // pitch
+            p = put<float>(p, static_cast<float>(counter_ % 628) / 100.0f); // yaw
+            p = put<float>(p, jitter(0.05f)); // rollspeed
+            p = put<float>(p, jitter(0.05f)); // pitchspeed
+            p = put<float>(p, jitter(0.05f)); // yawspeed
+        }
+        else
+        {
+            messageId = 33; // GLOBAL_POSITION_INT
+            crcExtra = 104;
+            p = put<uint32_t>(p, timeBootMs);
+            p = put<int32_t>(p, 515000000 + static_cast<int32_t>(counter_)); // lat degE7
+            p = put<int32_t>(p, -1200000 + static_cast<int32_t>(counter_));  // lon degE7
+            p = put<int32_t>(p, 120000);                                      // alt mm
+            p = put<int32_t>(p, 50000);                                       // relative_alt mm
+            p = put<int16_t>(p, static_cast<int16_t>(jitter(200.0f)));        // vx cm/s
+            p = put<int16_t>(p, static_cast<int16_t>(jitter(200.0f)));        // vy cm/s
+            p = put<int16_t>(p, 0);                                           // vz cm/s
+            p = put<uint16_t>(p, static_cast<uint16_t>(counter_ % 36000));    // hdg cdeg
+        }
+
+        // MAVLink 2 drops trailing zero bytes from the payload
+        size_t payloadLength = static_cast<size_t>(p - payload);
+        while (payloadLength > 1 && payload[payloadLength - 1] == 0)
+        {
+            payloadLength--;
+        }
+
+        size_t total = 10 + payloadLength + 2;
+        if (total > capacity)
+        {
+            return 0;
+        }
+
+        buffer[0] = kMavlinkV2Magic;
+        buffer[1] = static_cast<uint8_t>(payloadLength);
+        buffer[2] = 0; // incompat_flags
+        buffer[3] = 0; // compat_flags
+        buffer[4] = sequence_++;
+        buffer[5] = systemId_;
+        buffer[6] = componentId_;
+        buffer[7] = static_cast<uint8_t>(messageId);
+        buffer[8] = static_cast<uint8_t>(messageId >> 8);
+        buffer[9] = static_cast<uint8_t>(messageId >> 16);
+        std::memcpy(buffer + 10, payload, payloadLength);
+
+        uint16_t crc = 0xFFFF;
+        for (size_t i = 1; i < 10 + payloadLength; ++i)
+        {
+            crcAccumulate(crc, buffer[i]);
+        }
+        crcAccumulate(crc, crcExtra);
+        buffer[10 + payloadLength] = static_cast<uint8_t>(crc & 0xFF);
+        buffer[11 + payloadLength] = static_cast<uint8_t>(crc >> 8);
+
+        counter_++;
+        return total;
+    }
+
+} // namespace embedded_logger
@@ -0,0 +1,238 @@
+// Unit tests for backtrace capture and offline symbolization
+/**
+ * @file test_backtrace_capture.cpp
+ * @brief Standalone tests for BacktraceCapture and tools/symbolize
+ * @details capture() must return the caller's return addresses, innermost
+ *          first, and the module records must place them in this executable.
+ *          An ERROR logged with captureBacktraces carries a "[bt ...]" list
+ *          and the file header the module records; when the build passes the
+ *          tool's path as SYMBOLIZE_TOOL, symbolize must resolve the frames
+ *          back to the functions that logged. Linux only; elsewhere capture()
+ *          returns nothing and the test only checks that. Build against the
+ *          library and run; exits non-zero if a check fails.
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/backtrace_capture.h"
+#include "embedded_logger/logger.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#if defined(__linux__) && defined(__GLIBC__)
+#include <unistd.h>
+#define TEST_HAS_BACKTRACE
+#endif
+
+#define TEST_NOINLINE __attribute__((noinline))
+
+using namespace embedded_logger;
+
+namespace
+{
+    int failures = 0;
+
+#define EXPECT(condition)                                                     \
+    do                                                                        \
+    {                                                                         \
+        if (!(condition))                                                     \
+        {                                                                     \
+            fprintf(stderr, "%s:%d: FAILED: %s\n", __FILE__, __LINE__, #condition); \
+            ++failures;                                                       \
+        }                                                                     \
+    } while (0)
+
+    std::string readFile(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    size_t countOf(const std::string &text, const std::string &needle)
+    {
+        size_t count = 0;
+        for (size_t at = text.find(needle); at != std::string::npos; at = text.find(needle, at + 1))
+        {
+            ++count;
+        }
+        return count;
+    }
+
+    uintptr_t frames[BacktraceCapture::kMaxDepth];
+    size_t depth = 0;
+
+    // Two frames so the order can be checked; the volatiles keep the calls
+    // from becoming tail calls
+    TEST_NOINLINE void captureInner(size_t skipFrames)
+    {
+        depth = BacktraceCapture::capture(frames, BacktraceCapture::kMaxDepth, skipFrames);
+        volatile int keepFrame = 0;
+        (void)keepFrame;
+    }
+
+    TEST_NOINLINE void captureOuter(size_t skipFrames)
+    {
+        captureInner(skipFrames);
+        volatile int keepFrame = 0;
+        (void)keepFrame;
+    }
+
+    TEST_NOINLINE void reportPumpFault(Logger &logger)
+    {
+        logger.error("PUMP", "pressure lost");
+        volatile int keepFrame = 0;
+        (void)keepFrame;
+    }
+
+#ifdef TEST_HAS_BACKTRACE
+    std::string executablePath()
+    {
+        char path[4096];
+        ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+        return length > 0 ? std::string(path, static_cast<size_t>(length)) : std::string();
+    }
+
+    /// The "# Module:" line of this executable
+    std::string executableRecord(const std::string &records)
+    {
+        std::istringstream lines(records);
+        std::string line;
+        std::string suffix = " path=" + executablePath();
+        while (std::getline(lines, line))
+        {
+            if (line.size() >= suffix.size() && line.compare(line.size() - suffix.size(), suffix.size(), suffix) == 0)
+            {
+                return line;
+            }
+        }
+        return std::string();
+    }
+
+    uint64_t fieldValue(const std::string &line, const std::string &name)
+    {
+        size_t at = line.find(" " + name + "=");
+        return at == std::string::npos ? 0 : std::strtoull(line.c_str() + at + name.size() + 2, nullptr, 16);
+    }
+
+    /// A return address inside one of the small functions above
+    bool returnsInto(uintptr_t address, void (*function)(size_t))
+    {
+        uintptr_t entry = reinterpret_cast<uintptr_t>(function);
+        return address > entry && address - entry < 256;
+    }
+#endif
+
+    void testCapture()
+    {
+        captureOuter(0);
+#ifdef TEST_HAS_BACKTRACE
+        EXPECT(depth >= 3);
+        std::string records;
+        BacktraceCapture::appendModuleRecords(records);
+        EXPECT(records.compare(0, 10, "# Module: ") == 0);
+        std::string record = executableRecord(records);
+        EXPECT(!record.empty());
+        EXPECT(record.find(" build-id=") != std::string::npos);
+
+        // Innermost first, inside this executable
+        uint64_t start = fieldValue(record, "start");
+        uint64_t end = fieldValue(record, "end");
+        EXPECT(start < end);
+        EXPECT(depth >= 2 && frames[0] >= start && frames[0] < end);
+        EXPECT(depth >= 2 && returnsInto(frames[0], captureInner));
+        EXPECT(depth >= 2 && returnsInto(frames[1], captureOuter));
+
+        // Skipped frames drop off the inner end; depth is capped
+        size_t full = depth;
+        captureOuter(1);
+        EXPECT(depth == full - 1 && returnsInto(frames[0], captureOuter));
+        uintptr_t shallow[4];
+        EXPECT(BacktraceCapture::capture(shallow, 2, 0) == 2);
+        EXPECT(BacktraceCapture::capture(shallow, 0, 0) == 0);
+#else
+        EXPECT(depth == 0);
+#endif
+    }
+
+#ifdef SYMBOLIZE_TOOL
+    std::string symbolize(const std::string &path)
+    {
+        std::string output;
+        FILE *pipe = popen((std::string(SYMBOLIZE_TOOL) + " " + path + " 2>/dev/null").c_str(), "r");
+        EXPECT(pipe != nullptr);
+        if (!pipe)
+        {
+            return output;
+        }
+        char buffer[4096];
+        while (fgets(buffer, sizeof(buffer), pipe))
+        {
+            output += buffer;
+        }
+        EXPECT(pclose(pipe) == 0);
+        return output;
+    }
+#endif
+
+    void testLoggedBacktraceSymbolizes()
+    {
+        LoggerConfig config;
+        config.logDirectory = "/tmp/embedded_logger_test_backtrace_" +
+                              std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        config.consoleLogLevel = LogLevel::CRITICAL;
+        config.fileLogLevel = LogLevel::DEBUG;
+        config.defaultDestination = LogDestination::FILE_ONLY;
+        config.asyncLogging = false;
+        config.forkSafe = false;
+        config.captureBacktraces = true;
+
+        Logger logger(config);
+        EXPECT(logger.initialize());
+        logger.warning("PUMP", "below the backtrace level");
+        reportPumpFault(logger);
+        std::string path = logger.getCurrentLogFile();
+        logger.shutdown();
+
+        std::string contents = readFile(path);
+#ifdef TEST_HAS_BACKTRACE
+        EXPECT(!executableRecord(contents).empty());
+        EXPECT(countOf(contents, " [bt 0x") == 1);
+        EXPECT(countOf(contents, "] pressure lost [bt 0x") == 1);
+#else
+        EXPECT(countOf(contents, " [bt ") == 0);
+#endif
+
+#ifdef SYMBOLIZE_TOOL
+        // The entry, then one line per frame; the logging call sits in reportPumpFault()
+        std::string output = symbolize(path);
+        EXPECT(countOf(output, "] pressure lost [bt 0x") == 1);
+        EXPECT(countOf(output, "below the backtrace level") == 0);
+        EXPECT(output.find("\n    #0  ") != std::string::npos);
+        EXPECT(output.find("reportPumpFault") != std::string::npos);
+        EXPECT(output.find("testLoggedBacktraceSymbolizes") != std::string::npos);
+        EXPECT(countOf(output, "(no module)") == 0);
+#endif
+    }
+}
+
+int main()
+{
+    testCapture();
+    testLoggedBacktraceSymbolizes();
+
+    if (failures != 0)
+    {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All backtrace capture tests passed\n");
+    return 0;
+}
@@ -0,0 +1,288 @@
+// Unit tests for the policy-based logger
+/**
+ * @file test_basic_logger.cpp
+ * @brief Standalone tests for BasicLogger output, rotation and reopening
+ * @details BasicLogger and a synchronous Logger given the same configuration,
+ *          clock and entries must leave the same files with the same bytes:
+ *          names, headers, line format and backup rotation. When a rotated
+ *          file cannot be opened the failure is printed once, later entries
+ *          retry the open at most once a second, and file logging resumes
+ *          once it succeeds. Build against the library and run; exits
+ *          non-zero if a check fails.
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/basic_logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <unistd.h>
+
+using namespace embedded_logger;
+
+namespace
+{
+    int failures = 0;
+
+#define EXPECT(condition)                                                     \
+    do                                                                        \
+    {                                                                         \
+        if (!(condition))                                                     \
+        {                                                                     \
+            fprintf(stderr, "%s:%d: FAILED: %s\n", __FILE__, __LINE__, #condition); \
+            ++failures;                                                       \
+        }                                                                     \
+    } while (0)
+
+    std::string readFile(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    size_t countOf(const std::string &text, const std::string &needle)
+    {
+        size_t count = 0;
+        for (size_t at = text.find(needle); at != std::string::npos; at = text.find(needle, at + 1))
+        {
+            ++count;
+        }
+        return count;
+    }
+
+    std::vector<std::string> listFiles(const std::string &directory)
+    {
+        std::vector<std::string> names;
+        if (DIR *listing = opendir(directory.c_str()))
+        {
+            while (dirent *item = readdir(listing))
+            {
+                if (item->d_name[0] != '.')
+                {
+                    names.push_back(item->d_name);
+                }
+            }
+            closedir(listing);
+        }
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
+    LoggerConfig testConfig(const std::string &name)
+    {
+        LoggerConfig config;
+        config.logDirectory = "/tmp/embedded_logger_test_" + name + "_" +
+                              std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        config.consoleLogLevel = LogLevel::CRITICAL;
+        config.fileLogLevel = LogLevel::WARNING; // Leaves out Logger's own startup lines
+        config.defaultDestination = LogDestination::FILE_ONLY;
+        config.asyncLogging = false;
+        config.forkSafe = false;
+        config.maxFileSize = 600;
+        config.maxBackupFiles = 3;
+        return config;
+    }
+
+    /// A clock the test moves by hand; whole seconds, like the default provider
+    class ManualTimeProvider : public ITimeProvider
+    {
+    public:
+        explicit ManualTimeProvider(uint64_t &nowMs) : nowMs_(nowMs) {}
+
+        std::string getCurrentDateTime() override
+        {
+            char text[32];
+            snprintf(text, sizeof(text), "2025-01-31 12:%02d:%02d", static_cast<int>(nowMs_ / 60000 % 60),
+                     static_cast<int>(nowMs_ / 1000 % 60));
+            return text;
+        }
+
+        uint64_t getUnixTimestampMs() override { return nowMs_; }
+
+    private:
+        uint64_t &nowMs_;
+    };
+
+    /// Stdio files whose opens fail while *failOpens is set
+    class FlakyFileSystemPolicy : public StdioFileSystemPolicy
+    {
+    public:
+        FlakyFileSystemPolicy(bool &failOpens, int &opens) : failOpens_(&failOpens), opens_(&opens) {}
+
+        bool openFile(const std::string &path)
+        {
+            ++*opens_;
+            if (*failOpens_)
+            {
+                closeFile();
+                return false;
+            }
+            return StdioFileSystemPolicy::openFile(path);
+        }
+
+    private:
+        bool *failOpens_;
+        int *opens_;
+    };
+
+    void logEntries(uint64_t &nowMs, int count, void (*write)(void *, LogLevel, const std::string &, const std::string &),
+                    void *logger)
+    {
+        const LogLevel levels[] = {LogLevel::INFO, LogLevel::WARNING, LogLevel::ERROR, LogLevel::CRITICAL};
+        const char *const components[] = {"NAV", "BMS.Cell", "PowerDistribution"};
+        for (int i = 0; i < count; ++i)
+        {
+            nowMs += 7;
+            write(logger, levels[i % 4], components[i % 3], "entry " + std::to_string(i) + " of the shared sequence");
+        }
+    }
+
+    void testMatchesLogger()
+    {
+        LoggerConfig config = testConfig("basic_format");
+        LoggerConfig basicConfig = config;
+        basicConfig.logDirectory += "_basic";
+
+        uint64_t nowMs = 1000;
+        Logger logger(config, std::unique_ptr<ITimeProvider>(new ManualTimeProvider(nowMs)),
+                      Logger::createDefaultFileSystem());
+        EXPECT(logger.initialize());
+        logEntries(nowMs, 60, [](void *target, LogLevel level, const std::string &component, const std::string &message)
+                   { static_cast<Logger *>(target)->log(level, Logger::registerComponent(component), message); },
+                   &logger);
+        logger.shutdown();
+
+        nowMs = 1000;
+        ManualTimeProvider time(nowMs);
+        auto fileSystem = Logger::createDefaultFileSystem();
+        {
+            RuntimeBasicLogger basic(basicConfig, RuntimeTimePolicy(time), RuntimeFileSystemPolicy(*fileSystem));
+            EXPECT(basic.initialize());
+            logEntries(nowMs, 60, [](void *target, LogLevel level, const std::string &component, const std::string &message)
+                       { static_cast<RuntimeBasicLogger *>(target)->log(level, component, message); },
+                       &basic);
+        }
+
+        // Rotation happened, and stopped at maxBackupFiles
+        std::vector<std::string> names = listFiles(config.logDirectory);
+        EXPECT(names.size() == 4);
+        EXPECT(listFiles(basicConfig.logDirectory) == names);
+        std::string all;
+        for (const std::string &name : names)
+        {
+            std::string expected = readFile(config.logDirectory + "/" + name);
+            std::string actual = readFile(basicConfig.logDirectory + "/" + name);
+            EXPECT(!expected.empty());
+            EXPECT(actual == expected);
+            all += expected;
+            if (actual != expected)
+            {
+                fprintf(stderr, "%s differs:\n--- Logger\n%s--- BasicLogger\n%s", name.c_str(), expected.c_str(),
+                        actual.c_str());
+            }
+        }
+        EXPECT(countOf(all, "] [ WARNING] [    BMS.Cell] entry ") != 0);
+        EXPECT(countOf(all, "] [CRITICAL] [PowerDistribution] entry 59 ") == 1);
+    }
+
+    using FlakyLogger = BasicLogger<RuntimeTimePolicy, FlakyFileSystemPolicy, NullLockPolicy>;
+
+    void testReopenAfterFailedRotation()
+    {
+        LoggerConfig config = testConfig("basic_reopen");
+        config.maxFileSize = 200;
+        uint64_t nowMs = 5000;
+        ManualTimeProvider time(nowMs);
+        bool failOpens = false;
+        int opens = 0;
+
+        // Capture what the logger prints
+        std::string printedPath = config.logDirectory + ".out";
+        fflush(stdout);
+        int savedStdout = dup(1);
+        FILE *printed = freopen(printedPath.c_str(), "w", stdout);
+        EXPECT(printed != nullptr);
+
+        std::string first;
+        std::string reopened;
+        {
+            FlakyLogger logger(config, RuntimeTimePolicy(time), FlakyFileSystemPolicy(failOpens, opens));
+            EXPECT(logger.initialize());
+            EXPECT(opens == 1);
+            first = logger.getCurrentLogFile();
+
+            // Fill the file; the rotation's open fails
+            failOpens = true;
+            for (int i = 0; opens == 1 && i < 20; ++i)
+            {
+                logger.warning("NAV", ("before " + std::to_string(i)).c_str());
+            }
+            EXPECT(opens == 2);
+
+            // Within the second: no retries, entries go nowhere
+            for (int i = 0; i < 10; ++i)
+            {
+                nowMs += 50;
+                logger.warning("NAV", ("lost " + std::to_string(i)).c_str());
+            }
+            EXPECT(opens == 2);
+
+            // A second later: retried once, still failing, not reported again
+            nowMs += 1000;
+            logger.warning("NAV", "lost again");
+            logger.warning("NAV", "lost again");
+            EXPECT(opens == 3);
+
+            // Entries below the file level do not retry
+            failOpens = false;
+            nowMs += 1000;
+            logger.info("NAV", "below the file level");
+            EXPECT(opens == 3);
+
+            logger.error("NAV", "after reopening");
+            EXPECT(opens == 4);
+            reopened = logger.getCurrentLogFile();
+        }
+
+        fflush(stdout);
+        dup2(savedStdout, 1);
+        close(savedStdout);
+        std::string output = readFile(printedPath);
+        std::remove(printedPath.c_str());
+        EXPECT(countOf(output, "Logger: Failed to create log file: ") == 1);
+        EXPECT(countOf(output, "Logger: Log file reopened: ") == 1);
+
+        std::string contents = readFile(reopened);
+        EXPECT(contents.compare(0, 35, "# Embedded Logger Library Log File\n") == 0);
+        EXPECT(countOf(contents, "] after reopening\n") == 1);
+        EXPECT(countOf(contents, "lost") == 0);
+        EXPECT(reopened != first);
+        EXPECT(countOf(readFile(first + ".1"), "] before 0\n") == 1);
+    }
+}
+
+int main()
+{
+    testMatchesLogger();
+    testReopenAfterFailedRotation();
+
+    if (failures != 0)
+    {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All basic logger tests passed\n");
+    return 0;
+}
@@ -0,0 +1,234 @@
+// Unit tests for the block Bloom filters
+/**
+ * @file test_block_filter.cpp
+ * @brief Standalone tests for BlockFilter tokens, frames and line parsing
+ * @details Every token added to a frame must test positive after the frame
+ *          is read back (no false negatives), absent tokens must mostly test
+ *          negative, lines must split into component and message with and
+ *          without a "[pid N]" field, and dotted component names must match
+ *          their prefixes. Build against the library and run; exits non-zero
+ *          if a check fails.
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/block_filter.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace embedded_logger;
+
+namespace
+{
+    int failures = 0;
+
+#define EXPECT(condition)                                                     \
+    do                                                                        \
+    {                                                                         \
+        if (!(condition))                                                     \
+        {                                                                     \
+            fprintf(stderr, "%s:%d: FAILED: %s\n", __FILE__, __LINE__, #condition); \
+            ++failures;                                                       \
+        }                                                                     \
+    } while (0)
+
+    /// Build a frame over tokens (copied; appendFrame() sorts them) and read it back
+    bool frameRoundTrip(std::vector<uint64_t> tokens, size_t bitsPerToken, BlockFilter &filter)
+    {
+        std::string frame;
+        BlockFilter::appendFrame(tokens, bitsPerToken, frame);
+        const char *cursor = frame.data();
+        bool read = BlockFilter::readFrame(cursor, frame.data() + frame.size(), filter);
+        EXPECT(read);
+        EXPECT(cursor == frame.data() + frame.size());
+        return read;
+    }
+
+    void testNoFalseNegatives()
+    {
+        const size_t bitsPerToken[] = {1, 4, 8, 16};
+        const size_t tokenCounts[] = {0, 1, 7, 100, 5000};
+        for (size_t bits : bitsPerToken)
+        {
+            for (size_t count : tokenCounts)
+            {
+                std::vector<uint64_t> tokens;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    tokens.push_back(BlockFilter::wordToken("word" + std::to_string(i)));
+                    tokens.push_back(tokens.back()); // Duplicates are harmless
+                }
+                BlockFilter filter;
+                if (!frameRoundTrip(tokens, bits, filter))
+                {
+                    continue;
+                }
+                for (uint64_t token : tokens)
+                {
+                    EXPECT(filter.mayContain(token));
+                }
+            }
+        }
+
+        // Absent tokens: about 2% false positives at 8 bits per token
+        std::vector<uint64_t> tokens;
+        for (int i = 0; i < 1000; ++i)
+        {
+            tokens.push_back(BlockFilter::wordToken("present" + std::to_string(i)));
+        }
+        BlockFilter filter;
+        frameRoundTrip(tokens, 8, filter);
+        int falsePositives = 0;
+        for (int i = 0; i < 10000; ++i)
+        {
+            falsePositives += filter.mayContain(BlockFilter::wordToken("absent" + std::to_string(i))) ? 1 : 0;
+        }
+        EXPECT(falsePositives < 500);
+
+        // A default filter (no frame) rules nothing out
+        EXPECT(BlockFilter().mayContain(BlockFilter::wordToken("anything")));
+    }
+
+    void testLineTokens()
+    {
+        std::vector<uint64_t> tokens;
+        BlockFilter::addLine("[2025-01-31 12:00:00.000] [ WARNING] [    BMS.Cell] Cell 47 OverVoltage: 4.31V",
+                             tokens);
+        BlockFilter::addLine("  continuation Line", tokens);
+        BlockFilter filter;
+        frameRoundTrip(tokens, 8, filter);
+
+        const char *const words[] = {"cell", "47", "overvoltage", "OVERVOLTAGE", "4", "31v", "continuation", "line"};
+        for (const char *word : words)
+        {
+            EXPECT(filter.mayContain(BlockFilter::wordToken(word)));
+        }
+        EXPECT(filter.mayContain(BlockFilter::componentToken("BMS.Cell")));
+        EXPECT(filter.mayContain(BlockFilter::componentToken("bms")));
+
+        // Words and components hash apart; timestamps and levels are not indexed
+        EXPECT(BlockFilter::wordToken("bms") != BlockFilter::componentToken("bms"));
+        EXPECT(BlockFilter::wordToken("Cell") == BlockFilter::wordToken("cell"));
+
+        std::vector<std::string> split;
+        BlockFilter::splitWords("Cell 47 OverVoltage: 4.31V", split);
+        EXPECT(split.size() == 5 && split[0] == "cell" && split[2] == "overvoltage" && split[4] == "31v");
+    }
+
+    void testParseLine()
+    {
+        std::string component;
+        size_t offset = 0;
+
+        std::string line = "[2025-01-31 12:00:00.000] [    INFO] [         NAV] Waypoint 3 reached";
+        EXPECT(BlockFilter::parseLine(line, component, offset));
+        EXPECT(component == "NAV");
+        EXPECT(line.substr(offset) == "Waypoint 3 reached");
+
+        line = "[2025-01-31 12:00:00.000] [   ERROR] [    BMS.Cell] [pid 4242] Cell 7 open";
+        EXPECT(BlockFilter::parseLine(line, component, offset));
+        EXPECT(component == "BMS.Cell");
+        EXPECT(line.substr(offset) == "Cell 7 open");
+
+        // A component longer than the padding and an empty message
+        line = "[2025-01-31 12:00:00.000] [CRITICAL] [PowerDistribution] ";
+        EXPECT(BlockFilter::parseLine(line, component, offset));
+        EXPECT(component == "PowerDistribution");
+        EXPECT(offset == line.size());
+
+        // Brackets inside the message are message text
+        line = "[2025-01-31 12:00:00.000] [    INFO] [         NAV] [pid 7] fix [3D] ok";
+        EXPECT(BlockFilter::parseLine(line, component, offset));
+        EXPECT(line.substr(offset) == "fix [3D] ok");
+
+        EXPECT(!BlockFilter::parseLine("", component, offset));
+        EXPECT(!BlockFilter::parseLine("# Log file header", component, offset));
+        EXPECT(!BlockFilter::parseLine("    at frame 3", component, offset));
+        EXPECT(!BlockFilter::parseLine("[2025-01-31 12:00:00.000] truncated", component, offset));
+    }
+
+    void testDottedComponentPrefixes()
+    {
+        std::vector<uint64_t> tokens;
+        BlockFilter::addComponent("Vehicle.BMS.Cell", tokens);
+        EXPECT(tokens.size() == 3);
+
+        BlockFilter filter;
+        frameRoundTrip(tokens, 16, filter);
+        EXPECT(filter.mayContain(BlockFilter::componentToken("Vehicle")));
+        EXPECT(filter.mayContain(BlockFilter::componentToken("vehicle.bms")));
+        EXPECT(filter.mayContain(BlockFilter::componentToken("Vehicle.BMS.Cell")));
+
+        // Only whole leading components are prefixes
+        EXPECT(tokens[0] == BlockFilter::componentToken("Vehicle"));
+        EXPECT(tokens[1] == BlockFilter::componentToken("Vehicle.BMS"));
+        EXPECT(tokens[2] == BlockFilter::componentToken("Vehicle.BMS.Cell"));
+        uint64_t partial[] = {BlockFilter::componentToken("Veh"), BlockFilter::componentToken("BMS"),
+                              BlockFilter::componentToken("Cell"), BlockFilter::componentToken("Vehicle.BM")};
+        for (uint64_t token : partial)
+        {
+            for (uint64_t added : tokens)
+            {
+                EXPECT(token != added);
+            }
+        }
+
+        tokens.clear();
+        BlockFilter::addComponent("NAV", tokens);
+        EXPECT(tokens.size() == 1 && tokens[0] == BlockFilter::componentToken("NAV"));
+    }
+
+    void testFrameReading()
+    {
+        std::vector<uint64_t> tokens = {BlockFilter::wordToken("alpha")};
+        std::string frame;
+        BlockFilter::appendFrame(tokens, 8, frame);
+        EXPECT(frame[0] == BlockFilter::kFrameTag);
+
+        // Torn frames and other blocks are not filters, and leave the cursor alone
+        for (size_t cut = 0; cut < frame.size(); ++cut)
+        {
+            const char *cursor = frame.data();
+            BlockFilter filter;
+            EXPECT(!BlockFilter::readFrame(cursor, frame.data() + cut, filter));
+            EXPECT(cursor == frame.data());
+        }
+        std::string other = "Z" + frame.substr(1);
+        const char *cursor = other.data();
+        BlockFilter filter;
+        EXPECT(!BlockFilter::readFrame(cursor, other.data() + other.size(), filter));
+
+        // Frames read back-to-back from one buffer
+        std::vector<uint64_t> second = {BlockFilter::wordToken("beta")};
+        BlockFilter::appendFrame(second, 8, frame);
+        cursor = frame.data();
+        BlockFilter first;
+        BlockFilter next;
+        EXPECT(BlockFilter::readFrame(cursor, frame.data() + frame.size(), first));
+        EXPECT(BlockFilter::readFrame(cursor, frame.data() + frame.size(), next));
+        EXPECT(cursor == frame.data() + frame.size());
+        EXPECT(first.mayContain(BlockFilter::wordToken("alpha")));
+        EXPECT(next.mayContain(BlockFilter::wordToken("beta")));
+    }
+}
+
+int main()
+{
+    testNoFalseNegatives();
+    testLineTokens();
+    testParseLine();
+    testDottedComponentPrefixes();
+    testFrameReading();
+
+    if (failures != 0)
+    {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All block filter tests passed\n");
+    return 0;
+}
@@ -0,0 +1,189 @@
+// Unit tests for the direct I/O file sink
+/**
+ * @file test_direct_file_sink.cpp
+ * @brief Standalone tests for DirectFileSink file contents and lengths
+ * @details After every flush() and close() the file must hold exactly the
+ *          bytes written so far: the zero-padded tail block is cut back by
+ *          ftruncate(), reopening appends onto a partial last block, and the
+ *          page-cache fallback writes the same bytes. A flush that fails
+ *          (here on RLIMIT_FSIZE) must leave its range to be written again.
+ *          Build against the library and run; exits non-zero if a check
+ *          fails.
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/direct_file_sink.h"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+using namespace embedded_logger;
+
+namespace
+{
+    int failures = 0;
+
+#define EXPECT(condition)                                                     \
+    do                                                                        \
+    {                                                                         \
+        if (!(condition))                                                     \
+        {                                                                     \
+            fprintf(stderr, "%s:%d: FAILED: %s\n", __FILE__, __LINE__, #condition); \
+            ++failures;                                                       \
+        }                                                                     \
+    } while (0)
+
+    std::string readFile(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    std::string testPath(const std::string &name)
+    {
+        return "/tmp/embedded_logger_test_" + name + "_" +
+               std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".txt";
+    }
+
+    /// Bytes that differ from block to block, so a misplaced block shows
+    std::string pattern(size_t size, char seed)
+    {
+        std::string out;
+        for (size_t i = 0; i < size; ++i)
+        {
+            out += static_cast<char>('a' + (seed + i / 7) % 26);
+        }
+        return out;
+    }
+
+    bool writeAll(DirectFileSink &sink, const std::string &data, size_t chunk)
+    {
+        bool ok = true;
+        for (size_t at = 0; at < data.size(); at += chunk)
+        {
+            ok = sink.write(data.data() + at, std::min(chunk, data.size() - at)) && ok;
+        }
+        return ok;
+    }
+
+    // The tail block goes out zero-padded; the file must end at the last byte written
+    void testTailIsPaddedAndTruncated(bool useDirect)
+    {
+        std::string path = testPath(useDirect ? "direct_tail" : "buffered_tail");
+        DirectFileSink sink(4096);
+        EXPECT(sink.open(path, useDirect));
+        if (!useDirect)
+        {
+            EXPECT(!sink.isDirect());
+        }
+
+        std::string expected = pattern(100, 0);
+        EXPECT(writeAll(sink, expected, 100));
+        EXPECT(sink.flush());
+        EXPECT(readFile(path) == expected);
+
+        // The partial block is rewritten in full as it grows
+        std::string more = pattern(5000, 3);
+        EXPECT(writeAll(sink, more, 333));
+        expected += more;
+        EXPECT(sink.flush());
+        EXPECT(readFile(path) == expected);
+        EXPECT(sink.flush()); // Nothing new
+        EXPECT(readFile(path) == expected);
+
+        // Several buffers' worth between flushes, ending on a block boundary
+        more = pattern(3 * 4096 - expected.size() % 4096 + 2 * 4096, 5);
+        EXPECT(writeAll(sink, more, 1000));
+        expected += more;
+        EXPECT(expected.size() % 4096 == 0);
+        EXPECT(sink.flush());
+        EXPECT(readFile(path) == expected);
+
+        sink.close();
+        EXPECT(!sink.isOpen());
+        EXPECT(readFile(path) == expected);
+        std::remove(path.c_str());
+    }
+
+    // Reopening starts from the last whole block and carries the rest in the buffer
+    void testReopenAppendsToPartialBlock(bool useDirect)
+    {
+        std::string path = testPath(useDirect ? "direct_reopen" : "buffered_reopen");
+        std::string expected;
+        const size_t sizes[] = {100, 4096 - 100, 4097, 1, 8192, 300};
+        char seed = 0;
+        for (size_t size : sizes)
+        {
+            DirectFileSink sink(8192);
+            EXPECT(sink.open(path, useDirect));
+            std::string more = pattern(size, seed++);
+            EXPECT(writeAll(sink, more, 77));
+            expected += more;
+            sink.close();
+            EXPECT(readFile(path) == expected);
+        }
+        std::remove(path.c_str());
+    }
+
+    // A flush that fails counts nothing as written; the next one writes the same range
+    void testFailedFlushIsRetried(bool useDirect)
+    {
+        std::string path = testPath(useDirect ? "direct_retry" : "buffered_retry");
+        DirectFileSink sink(16384);
+        EXPECT(sink.open(path, useDirect));
+
+        signal(SIGXFSZ, SIG_IGN);
+        rlimit saved;
+        EXPECT(getrlimit(RLIMIT_FSIZE, &saved) == 0);
+        rlimit limited = saved;
+        limited.rlim_cur = 0;
+        EXPECT(setrlimit(RLIMIT_FSIZE, &limited) == 0);
+
+        std::string expected = pattern(5000, 1);
+        sink.write(expected.data(), expected.size());
+        EXPECT(!sink.flush());
+
+        EXPECT(setrlimit(RLIMIT_FSIZE, &saved) == 0);
+        signal(SIGXFSZ, SIG_DFL);
+
+        std::string more = pattern(200, 2);
+        sink.write(more.data(), more.size());
+        expected += more;
+        sink.flush(); // Still reports the earlier failure
+        EXPECT(readFile(path) == expected);
+        sink.close();
+        EXPECT(readFile(path) == expected);
+        std::remove(path.c_str());
+    }
+}
+
+int main()
+{
+    const bool modes[] = {true, false};
+    for (bool useDirect : modes)
+    {
+        testTailIsPaddedAndTruncated(useDirect);
+        testReopenAppendsToPartialBlock(useDirect);
+        testFailedFlushIsRetried(useDirect);
+    }
+
+    if (failures != 0)
+    {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All direct file sink tests passed\n");
+    return 0;
+}
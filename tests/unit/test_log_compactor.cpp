@@ -0,0 +1,306 @@
+// Unit tests for level-tiered log compaction
+/**
+ * @file test_log_compactor.cpp
+ * @brief Standalone tests for LogCompactor on files written by Logger
+ * @details A logger writes a mix of levels into several rotated files. One
+ *          compaction pass with a WARNING tier, run as if the files had aged
+ *          past it, must leave only WARNING and above, every one of them
+ *          exactly once and in order, and must not touch the live file. The
+ *          merged files must read back with Logger::readLogFile(), plain and
+ *          compressed, and with tools/log_query when the build passes its
+ *          path as LOG_QUERY_TOOL. Build against the library and run; exits
+ *          non-zero if a check fails.
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/log_compactor.h"
+#include "embedded_logger/log_compression.h"
+#include "embedded_logger/logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+
+using namespace embedded_logger;
+
+namespace
+{
+    int failures = 0;
+
+#define EXPECT(condition)                                                     \
+    do                                                                        \
+    {                                                                         \
+        if (!(condition))                                                     \
+        {                                                                     \
+            fprintf(stderr, "%s:%d: FAILED: %s\n", __FILE__, __LINE__, #condition); \
+            ++failures;                                                       \
+        }                                                                     \
+    } while (0)
+
+    const uint64_t kHourMs = 3600 * 1000;
+
+    std::vector<std::string> listFiles(const std::string &directory)
+    {
+        std::vector<std::string> names;
+        if (DIR *listing = opendir(directory.c_str()))
+        {
+            while (dirent *item = readdir(listing))
+            {
+                if (item->d_name[0] != '.')
+                {
+                    names.push_back(item->d_name);
+                }
+            }
+            closedir(listing);
+        }
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
+    /// Entry lines of a file (headers and separators left out)
+    std::vector<std::string> entryLines(const std::string &path, const LogDictionary *dictionary)
+    {
+        std::string contents;
+        EXPECT(Logger::readLogFile(path, contents, dictionary));
+        std::vector<std::string> lines;
+        for (size_t start = 0; start < contents.size();)
+        {
+            size_t end = contents.find('\n', start);
+            end = end == std::string::npos ? contents.size() : end;
+            if (contents[start] == '[')
+            {
+                lines.push_back(contents.substr(start, end - start));
+            }
+            start = end + 1;
+        }
+        return lines;
+    }
+
+    /// The i that writeLogs() put in a line, which orders lines as written
+    long entryNumber(const std::string &line)
+    {
+        size_t at = line.find("] entry ");
+        return at == std::string::npos ? -1 : std::strtol(line.c_str() + at + 8, nullptr, 10);
+    }
+
+    bool isCompacted(const std::string &name)
+    {
+        return name.find("_compacted_") != std::string::npos;
+    }
+
+    LoggerConfig compactorConfig(const std::string &name)
+    {
+        LoggerConfig config;
+        config.logDirectory = "/tmp/embedded_logger_test_" + name + "_" +
+                              std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        config.consoleLogLevel = LogLevel::CRITICAL;
+        config.fileLogLevel = LogLevel::DEBUG;
+        config.defaultDestination = LogDestination::FILE_ONLY;
+        config.asyncLogging = false;
+        config.forkSafe = false;
+        config.maxFileSize = 4096;
+        config.maxBackupFiles = 100;
+        config.retentionTiers = {{1, LogLevel::WARNING}};
+        config.compactionIntervalMs = 24 * kHourMs; // Only the pass run below
+        return config;
+    }
+
+    /// Log a level mix, then return the live file
+    std::string writeLogs(const LoggerConfig &config)
+    {
+        Logger logger(config);
+        EXPECT(logger.initialize());
+        const char *const names[] = {"DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL"};
+        for (int i = 0; i < 400; ++i)
+        {
+            std::string component = i % 2 ? "BMS.Cell" : "NAV";
+            std::string message = "entry " + std::to_string(i) + " at " + names[i % 5] + " with padding text";
+            switch (i % 5)
+            {
+            case 0:
+                logger.debug(component, message);
+                break;
+            case 1:
+                logger.info(component, message);
+                break;
+            case 2:
+                logger.warning(component, message);
+                break;
+            case 3:
+                logger.error(component, message);
+                break;
+            default:
+                logger.critical(component, message);
+                break;
+            }
+        }
+        std::string live = logger.getCurrentLogFile();
+        logger.shutdown();
+        return live;
+    }
+
+#ifdef LOG_QUERY_TOOL
+    /// Entry lines tools/log_query prints for every entry of the given files
+    std::vector<std::string> queryLines(const std::vector<std::string> &paths, const std::string &dictionaryPath)
+    {
+        std::string command = std::string(LOG_QUERY_TOOL) +
+                              (dictionaryPath.empty() ? std::string() : " --dict " + dictionaryPath) + " ''";
+        for (const std::string &path : paths)
+        {
+            command += " " + path;
+        }
+        std::vector<std::string> lines;
+        FILE *output = popen(command.c_str(), "r");
+        EXPECT(output != nullptr);
+        if (!output)
+        {
+            return lines;
+        }
+        char buffer[4096];
+        while (fgets(buffer, sizeof(buffer), output))
+        {
+            std::string line = buffer;
+            line.erase(line.find_last_not_of('\n') + 1);
+            size_t separator = line.find(":[");
+            lines.push_back(separator == std::string::npos ? line : line.substr(separator + 1));
+        }
+        EXPECT(pclose(output) == 0);
+        return lines;
+    }
+#endif
+
+    void checkCompaction(LoggerConfig config, const LogDictionary *dictionary, const std::string &dictionaryPath)
+    {
+        std::string live = writeLogs(config);
+        std::string liveName = live.substr(live.find_last_of('/') + 1);
+
+        // Everything a WARNING tier keeps, in file order
+        std::vector<std::string> sources;
+        std::vector<std::string> expected;
+        size_t below = 0;
+        for (const std::string &name : listFiles(config.logDirectory))
+        {
+            if (name == liveName)
+            {
+                continue;
+            }
+            sources.push_back(name);
+            for (const std::string &line : entryLines(config.logDirectory + "/" + name, dictionary))
+            {
+                LogLevel level;
+                EXPECT(LogCompactor::parseLevel(line, level));
+                if (level >= LogLevel::WARNING)
+                {
+                    expected.push_back(line);
+                }
+                else
+                {
+                    ++below;
+                }
+            }
+        }
+        // Rotated names do not sort by age; the entries carry their order
+        std::stable_sort(expected.begin(), expected.end(), [](const std::string &a, const std::string &b)
+                         { return entryNumber(a) < entryNumber(b); });
+        EXPECT(sources.size() >= 3);
+        EXPECT(!expected.empty() && below != 0);
+        std::vector<std::string> liveLines = entryLines(live, dictionary);
+
+        auto fileSystem = Logger::createDefaultFileSystem();
+        LogCompactor compactor(*fileSystem, config, dictionary);
+        uint64_t nowMs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                   std::chrono::system_clock::now().time_since_epoch())
+                                                   .count());
+
+        // Younger than the tier: nothing happens
+        LogCompactor::Report report = compactor.run(nowMs, live);
+        EXPECT(report.filesCompacted == 0 && report.filesWritten == 0);
+
+        report = compactor.run(nowMs + 2 * kHourMs, live);
+        EXPECT(report.filesCompacted == sources.size());
+        EXPECT(report.filesWritten >= 1);
+        EXPECT(report.bytesAfter < report.bytesBefore);
+
+        // Parts of one output are numbered "", "_1", "_2", ... in the order written
+        std::vector<std::string> compacted;
+        for (const std::string &name : listFiles(config.logDirectory))
+        {
+            if (name != liveName)
+            {
+                EXPECT(isCompacted(name));
+                EXPECT(name.find("_WARNING_") != std::string::npos);
+                compacted.push_back(config.logDirectory + "/" + name);
+            }
+        }
+        std::stable_sort(compacted.begin(), compacted.end(), [](const std::string &a, const std::string &b)
+                         { return a.size() < b.size(); });
+        std::vector<std::string> kept;
+        for (const std::string &path : compacted)
+        {
+            for (const std::string &line : entryLines(path, dictionary))
+            {
+                kept.push_back(line);
+            }
+        }
+        EXPECT(compacted.size() == report.filesWritten);
+        EXPECT(kept == expected);
+        EXPECT(entryLines(live, dictionary) == liveLines);
+
+#ifdef LOG_QUERY_TOOL
+        EXPECT(queryLines(compacted, dictionaryPath) == expected);
+#else
+        (void)dictionaryPath;
+#endif
+
+        // A second pass finds nothing more to do
+        report = compactor.run(nowMs + 2 * kHourMs, live);
+        EXPECT(report.filesCompacted == 0 && report.filesWritten == 0);
+        EXPECT(listFiles(config.logDirectory).size() == compacted.size() + 1);
+    }
+
+    void testPlainFiles()
+    {
+        checkCompaction(compactorConfig("compact_plain"), nullptr, std::string());
+    }
+
+    void testCompressedFiles()
+    {
+        LoggerConfig config = compactorConfig("compact_compressed");
+        std::vector<std::string> samples;
+        for (int i = 0; i < 50; ++i)
+        {
+            samples.push_back("[2025-01-31 12:00:00.000] [ WARNING] [    BMS.Cell] entry " + std::to_string(i) +
+                              " at WARNING with padding text\n");
+        }
+        LogDictionary dictionary = LogDictionary::train(samples, 1024);
+        std::string dictionaryPath = config.logDirectory + ".dict";
+        EXPECT(dictionary.save(dictionaryPath));
+
+        config.compressLogFiles = true;
+        config.compressionDictionaryPath = dictionaryPath;
+        config.blockFilterBitsPerToken = 8;
+        checkCompaction(config, &dictionary, dictionaryPath);
+        std::remove(dictionaryPath.c_str());
+    }
+}
+
+int main()
+{
+    testPlainFiles();
+    testCompressedFiles();
+
+    if (failures != 0)
+    {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All log compactor tests passed\n");
+    return 0;
+}
@@ -0,0 +1,291 @@
+// Unit tests for log block compression
+/**
+ * @file test_log_compression.cpp
+ * @brief Standalone tests for LogBlockCodec and LogDictionary
+ * @details Round-trips blocks through appendBlock()/readBlock(): empty,
+ *          incompressible (stored), matches that start in the dictionary and
+ *          run on into the block, and literal and match lengths that need
+ *          extension bytes. Torn and corrupted blocks must be rejected and
+ *          dictionaries must survive save()/load() with their ID. Build
+ *          against the library and run; exits non-zero if a check fails.
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/log_compression.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace embedded_logger;
+
+namespace
+{
+    int failures = 0;
+
+#define EXPECT(condition)                                                     \
+    do                                                                        \
+    {                                                                         \
+        if (!(condition))                                                     \
+        {                                                                     \
+            fprintf(stderr, "%s:%d: FAILED: %s\n", __FILE__, __LINE__, #condition); \
+            ++failures;                                                       \
+        }                                                                     \
+    } while (0)
+
+    /// Deterministic bytes with no repeats worth a match
+    std::string noise(size_t size, uint32_t seed)
+    {
+        std::string out;
+        for (size_t i = 0; i < size; ++i)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            out += static_cast<char>(seed >> 24);
+        }
+        return out;
+    }
+
+    std::string logLines(int count)
+    {
+        std::string out;
+        for (int i = 0; i < count; ++i)
+        {
+            out += "2025-01-31 12:00:0" + std::to_string(i % 10) + ".000 [    INFO] [BMS     ] Cell " +
+                   std::to_string(i % 16) + " voltage 3." + std::to_string(700 + i) + " V\n";
+        }
+        return out;
+    }
+
+    /// Frame data, read it back, and return the block type ('Z' or 'S'); 0 on failure
+    char roundTrip(LogBlockCodec &codec, const std::string &data)
+    {
+        std::string block;
+        codec.appendBlock(data.data(), data.size(), block);
+
+        const char *cursor = block.data();
+        std::string out = "prefix";
+        bool read = codec.readBlock(cursor, block.data() + block.size(), out);
+        EXPECT(read);
+        EXPECT(out == "prefix" + data);
+        EXPECT(cursor == block.data() + block.size());
+        return read && out == "prefix" + data ? block[0] : 0;
+    }
+
+    void testEmptyBlock()
+    {
+        LogBlockCodec codec;
+        EXPECT(roundTrip(codec, std::string()) == 'S');
+
+        LogBlockCodec withDictionary(LogDictionary(logLines(20)));
+        EXPECT(roundTrip(withDictionary, std::string()) == 'S');
+    }
+
+    void testIncompressibleIsStored()
+    {
+        LogBlockCodec codec;
+        std::string data = noise(300, 7);
+        EXPECT(roundTrip(codec, data) == 'S');
+
+        std::string block;
+        codec.appendBlock(data.data(), data.size(), block);
+        EXPECT(block.size() < data.size() + 12); // Type, two varints and the checksum
+    }
+
+    void testCompressedRoundTrips()
+    {
+        LogBlockCodec codec;
+        EXPECT(roundTrip(codec, logLines(40)) == 'Z');
+        EXPECT(roundTrip(codec, "abcd") == 'S');
+        EXPECT(roundTrip(codec, std::string(5, 'a')) == 'S');
+        EXPECT(roundTrip(codec, std::string(64, 'a')) == 'Z');
+
+        // The codec is reused block after block; its match table must not leak between them
+        for (int i = 1; i < 30; ++i)
+        {
+            EXPECT(roundTrip(codec, logLines(i)) != 0);
+        }
+    }
+
+    // A match found in the dictionary that runs past its end continues into
+    // the block: the decoder copies the dictionary tail, then its own output
+    void testMatchRunsPastDictionaryEnd()
+    {
+        LogDictionary dictionary(logLines(5) + "0123456789");
+        LogBlockCodec codec(dictionary);
+        std::string repeated;
+        for (int i = 0; i < 6; ++i)
+        {
+            repeated += "0123456789";
+        }
+        std::string data = repeated + " end of block";
+        EXPECT(roundTrip(codec, data) == 'Z');
+
+        std::string block;
+        codec.appendBlock(data.data(), data.size(), block);
+        EXPECT(block.size() < 40);
+
+        // Starting at the dictionary's last byte
+        std::string fromLastByte = "9" + repeated;
+        EXPECT(roundTrip(codec, fromLastByte) == 'Z');
+    }
+
+    // Lengths of 15 and more spill into 255-per-byte extension bytes
+    void testLongLiteralAndMatchLengths()
+    {
+        LogBlockCodec codec;
+        const size_t lengths[] = {14, 15, 16, 15 + 254, 15 + 255, 15 + 256, 15 + 255 + 255, 1000};
+        for (size_t literal : lengths)
+        {
+            for (size_t match : lengths)
+            {
+                std::string data = noise(literal, static_cast<uint32_t>(literal)) + std::string(match + 4, 'm');
+                EXPECT(roundTrip(codec, data) != 0);
+            }
+        }
+
+        std::string data = noise(15 + 255 + 3, 11) + std::string(4 + 15 + 255 + 255 + 2, 'q') + noise(20, 12);
+        EXPECT(roundTrip(codec, data) == 'Z');
+    }
+
+    void testTornBlocksAreRejected()
+    {
+        LogBlockCodec codec;
+        const std::string samples[] = {logLines(10), noise(200, 3)};
+        for (const std::string &data : samples)
+        {
+            std::string block;
+            codec.appendBlock(data.data(), data.size(), block);
+            for (size_t cut = 0; cut < block.size(); ++cut)
+            {
+                const char *cursor = block.data();
+                std::string out = "kept";
+                EXPECT(!codec.readBlock(cursor, block.data() + cut, out));
+                EXPECT(out == "kept");
+                EXPECT(cursor == block.data());
+            }
+        }
+    }
+
+    void testChecksumMismatchIsRejected()
+    {
+        LogBlockCodec codec;
+        const std::string samples[] = {logLines(10), noise(200, 5)};
+        for (const std::string &data : samples)
+        {
+            std::string block;
+            codec.appendBlock(data.data(), data.size(), block);
+
+            // Flip one bit in the checksum, which sits just before the payload, then in the payload
+            std::string payload;
+            codec.compress(data.data(), data.size(), payload);
+            size_t checksumAt = block.size() - (block[0] == 'S' ? data.size() : payload.size()) - 4;
+            const size_t positions[] = {checksumAt, block.size() - 1};
+            for (size_t position : positions)
+            {
+                std::string damaged = block;
+                damaged[position] = static_cast<char>(damaged[position] ^ 0x01);
+                const char *cursor = damaged.data();
+                std::string out;
+                EXPECT(!codec.readBlock(cursor, damaged.data() + damaged.size(), out));
+                EXPECT(out.empty());
+            }
+        }
+
+        // Blocks compressed against one dictionary do not decode with another
+        LogBlockCodec first(LogDictionary(logLines(30)));
+        LogBlockCodec second(LogDictionary(noise(2000, 9)));
+        std::string data = logLines(8);
+        std::string block;
+        first.appendBlock(data.data(), data.size(), block);
+        EXPECT(block[0] == 'Z');
+        const char *cursor = block.data();
+        std::string out;
+        EXPECT(!second.readBlock(cursor, block.data() + block.size(), out));
+    }
+
+    void testDictionarySaveAndLoad()
+    {
+        std::string path = "/tmp/embedded_logger_test_dictionary_" +
+                           std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        std::vector<std::string> samples;
+        for (int i = 0; i < 40; ++i)
+        {
+            samples.push_back(logLines(6 + i % 4));
+        }
+        LogDictionary trained = LogDictionary::train(samples, 2048);
+        EXPECT(!trained.empty());
+        EXPECT(trained.contents().size() <= 2048);
+        EXPECT(trained.id() != 0);
+        EXPECT(LogDictionary().id() == 0);
+        EXPECT(LogDictionary(trained.contents()).id() == trained.id());
+        EXPECT(LogDictionary(trained.contents() + "x").id() != trained.id());
+
+        EXPECT(trained.save(path));
+        LogDictionary loaded;
+        EXPECT(loaded.load(path));
+        EXPECT(loaded.id() == trained.id());
+        EXPECT(loaded.contents() == trained.contents());
+
+        // A file written with one dictionary reads back with the loaded copy
+        LogBlockCodec writer(trained);
+        LogBlockCodec reader(loaded);
+        std::string data = logLines(12);
+        std::string block;
+        writer.appendBlock(data.data(), data.size(), block);
+        const char *cursor = block.data();
+        std::string out;
+        EXPECT(reader.readBlock(cursor, block.data() + block.size(), out));
+        EXPECT(out == data);
+
+        // Damaged contents no longer match the stored ID
+        std::string file;
+        {
+            std::ifstream in(path, std::ios::binary);
+            std::stringstream contents;
+            contents << in.rdbuf();
+            file = contents.str();
+        }
+        file[file.size() - 1] = static_cast<char>(file[file.size() - 1] ^ 0x20);
+        {
+            std::ofstream outFile(path, std::ios::binary | std::ios::trunc);
+            outFile << file;
+        }
+        LogDictionary damaged;
+        EXPECT(!damaged.load(path));
+        EXPECT(damaged.empty());
+
+        {
+            std::ofstream outFile(path, std::ios::binary | std::ios::trunc);
+            outFile << "not a dictionary";
+        }
+        EXPECT(!damaged.load(path));
+        EXPECT(!damaged.load(path + ".missing"));
+        std::remove(path.c_str());
+    }
+}
+
+int main()
+{
+    testEmptyBlock();
+    testIncompressibleIsStored();
+    testCompressedRoundTrips();
+    testMatchRunsPastDictionaryEnd();
+    testLongLiteralAndMatchLengths();
+    testTornBlocksAreRejected();
+    testChecksumMismatchIsRejected();
+    testDictionarySaveAndLoad();
+
+    if (failures != 0)
+    {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All log compression tests passed\n");
+    return 0;
+}
@@ -0,0 +1,185 @@
+// Unit tests for the diagnostic context
+/**
+ * @file test_log_context.cpp
+ * @brief Standalone tests for EL_CONTEXT scopes and their rendering
+ * @details Covers nesting, scope exit, isolation between threads, the
+ *          rendering limit and the context carried by queued entries. Build
+ *          against the library and run; exits non-zero if a check fails.
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/log_context.h"
+#include "embedded_logger/logger.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace embedded_logger;
+
+namespace
+{
+    int failures = 0;
+
+#define EXPECT(condition)                                                     \
+    do                                                                        \
+    {                                                                         \
+        if (!(condition))                                                     \
+        {                                                                     \
+            fprintf(stderr, "%s:%d: FAILED: %s\n", __FILE__, __LINE__, #condition); \
+            ++failures;                                                       \
+        }                                                                     \
+    } while (0)
+
+    std::string rendered()
+    {
+        std::string out;
+        LogContext::render(LogContext::current().get(), out);
+        return out;
+    }
+
+    std::string readFile(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    void testNestingAndScopeExit()
+    {
+        EXPECT(!LogContext::current());
+        EXPECT(rendered().empty());
+        {
+            EL_CONTEXT("flight", 42);
+            EXPECT(rendered() == "[flight=42] ");
+            {
+                EL_CONTEXT("string", "B");
+                EL_CONTEXT("cell", 7);
+                EXPECT(rendered() == "[flight=42 string=B cell=7] ");
+            }
+            EXPECT(rendered() == "[flight=42] ");
+        }
+        EXPECT(!LogContext::current());
+        EXPECT(rendered().empty());
+    }
+
+    void testHandleOutlivesScope()
+    {
+        std::shared_ptr<const LogContextNode> kept;
+        {
+            EL_CONTEXT("flight", 7);
+            EL_CONTEXT("phase", "landing");
+            kept = LogContext::current();
+        }
+        EXPECT(!LogContext::current());
+        std::string out;
+        LogContext::render(kept.get(), out);
+        EXPECT(out == "[flight=7 phase=landing] ");
+    }
+
+    void testThreadIsolation()
+    {
+        EL_CONTEXT("flight", 1);
+        std::string seenByOther;
+        std::string nestedInOther;
+        std::thread other([&]
+                          {
+                              seenByOther = rendered();
+                              EL_CONTEXT("worker", 2);
+                              nestedInOther = rendered();
+                          });
+        other.join();
+        EXPECT(seenByOther.empty());
+        EXPECT(nestedInOther == "[worker=2] ");
+        EXPECT(rendered() == "[flight=1] ");
+    }
+
+    void testRenderLimit()
+    {
+        std::shared_ptr<const LogContextNode> context;
+        for (int i = 1; i <= 20; ++i)
+        {
+            auto node = std::make_shared<LogContextNode>();
+            node->key = "k" + std::to_string(i);
+            node->value = "v" + std::to_string(i);
+            node->parent = context;
+            context = node;
+        }
+        std::string out;
+        LogContext::render(context.get(), out);
+        EXPECT(out.compare(0, 11, "[... k5=v5 ") == 0);
+        EXPECT(out.find("k4=") == std::string::npos);
+        EXPECT(out.size() > 9 && out.compare(out.size() - 9, 9, "k20=v20] ") == 0);
+
+        // Exactly at the limit: no marker
+        for (int i = 0; i < 4; ++i)
+        {
+            context = context->parent;
+        }
+        out.clear();
+        LogContext::render(context.get(), out);
+        EXPECT(out.compare(0, 7, "[k1=v1 ") == 0);
+        EXPECT(out.find("...") == std::string::npos);
+    }
+
+    // Queued entries keep the context they were logged with, per thread
+    void testEntriesCarryContext()
+    {
+        LoggerConfig config;
+        config.logDirectory = "/tmp/embedded_logger_test_context_" +
+                              std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        config.consoleLogLevel = LogLevel::CRITICAL;
+        config.fileLogLevel = LogLevel::INFO;
+        config.defaultDestination = LogDestination::FILE_ONLY;
+        config.forkSafe = false;
+        auto logger = std::make_shared<Logger>(config);
+        EXPECT(logger->initialize());
+
+        {
+            EL_CONTEXT("flight", 42);
+            logger->info("NAV", "takeoff");
+            std::thread other([&]
+                              { logger->info("BMS", "no context here"); });
+            other.join();
+            {
+                EL_CONTEXT("phase", "cruise");
+                logger->info("NAV", "cruising");
+                logger->debug("NAV", "below file level");
+            }
+        }
+        logger->info("NAV", "after flight");
+
+        std::string file = logger->getCurrentLogFile();
+        logger->shutdown();
+        std::string contents = readFile(file);
+        EXPECT(contents.find("[flight=42] takeoff") != std::string::npos);
+        EXPECT(contents.find("[flight=42 phase=cruise] cruising") != std::string::npos);
+        EXPECT(contents.find("] no context here") != std::string::npos);
+        EXPECT(contents.find("] after flight") != std::string::npos);
+        EXPECT(contents.find("flight=42] after") == std::string::npos);
+        EXPECT(contents.find("below file level") == std::string::npos);
+    }
+}
+
+int main()
+{
+    testNestingAndScopeExit();
+    testHandleOutlivesScope();
+    testThreadIsolation();
+    testRenderLimit();
+    testEntriesCarryContext();
+
+    if (failures != 0)
+    {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All log context tests passed\n");
+    return 0;
+}
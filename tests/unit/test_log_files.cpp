@@ -0,0 +1,387 @@
+// Unit tests for log file management
+/**
+ * @file test_log_files.cpp
+ * @brief Standalone tests for recycled and time-rotated log files
+ * @details Runs Logger against a file system that counts its header
+ *          rewrites and a manually advanced clock, so rotation boundaries are
+ *          crossed without waiting. Build against the library and run; exits
+ *          non-zero if a check fails.
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/logger.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+
+using namespace embedded_logger;
+
+namespace
+{
+    int failures = 0;
+
+#define EXPECT(condition)                                                     \
+    do                                                                        \
+    {                                                                         \
+        if (!(condition))                                                     \
+        {                                                                     \
+            fprintf(stderr, "%s:%d: FAILED: %s\n", __FILE__, __LINE__, #condition); \
+            ++failures;                                                       \
+        }                                                                     \
+    } while (0)
+
+    std::string readFile(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    size_t countOf(const std::string &text, const std::string &needle)
+    {
+        size_t count = 0;
+        for (size_t at = text.find(needle); at != std::string::npos; at = text.find(needle, at + 1))
+        {
+            ++count;
+        }
+        return count;
+    }
+
+    std::string testDirectory(const std::string &name)
+    {
+        return "/tmp/embedded_logger_test_" + name + "_" +
+               std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+
+    /// Local files, counting the in-place header rewrites
+    class CountingFileSystem : public IFileSystem
+    {
+    public:
+        std::atomic<int> validLengthWrites{0};
+
+        bool fileExists(const std::string &path) override { return inner_->fileExists(path); }
+        bool createDirectory(const std::string &path) override { return inner_->createDirectory(path); }
+        size_t getFileSize(const std::string &path) override { return inner_->getFileSize(path); }
+        bool deleteFile(const std::string &path) override { return inner_->deleteFile(path); }
+        bool renameFile(const std::string &oldPath, const std::string &newPath) override
+        {
+            return inner_->renameFile(oldPath, newPath);
+        }
+        bool writeFileAt(FileHandle handle, uint64_t offset, const void *data, size_t size) override
+        {
+            if (offset < 128 && size == 20)
+            {
+                validLengthWrites.fetch_add(1); // The "# Valid-Length:" field; preallocation writes start at 0
+            }
+            return IFileSystem::writeFileAt(handle, offset, data, size);
+        }
+
+    private:
+        std::unique_ptr<IFileSystem> inner_ = Logger::createDefaultFileSystem();
+    };
+
+    /// Wall clock the test moves by hand
+    class ManualClock : public ITimeProvider
+    {
+    public:
+        explicit ManualClock(uint64_t startMs) : nowMs(startMs) {}
+
+        std::atomic<uint64_t> nowMs;
+
+        std::string getCurrentDateTime() override
+        {
+            time_t seconds = static_cast<time_t>(nowMs.load() / 1000);
+            std::tm local{};
+            localtime_r(&seconds, &local);
+            char buffer[32];
+            strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local);
+            return buffer;
+        }
+        uint64_t getUnixTimestampMs() override { return nowMs.load(); }
+    };
+
+    /// Local midnight of a fixed day, so tests do not depend on today's date
+    uint64_t localMidnightMs()
+    {
+        std::tm local{};
+        local.tm_year = 2025 - 1900;
+        local.tm_mon = 2;
+        local.tm_mday = 14;
+        local.tm_isdst = -1;
+        return static_cast<uint64_t>(mktime(&local)) * 1000;
+    }
+
+    /// Name a time-rotated file gets for a period starting at unixMs
+    std::string periodFile(const std::string &directory, uint64_t unixMs)
+    {
+        time_t seconds = static_cast<time_t>(unixMs / 1000);
+        std::tm local{};
+        localtime_r(&seconds, &local);
+        char buffer[32];
+        strftime(buffer, sizeof(buffer), "%Y-%m-%d_%H_%M_%S", &local);
+        return directory + "/embedded_log_" + buffer + ".txt";
+    }
+
+    bool exists(const std::string &path)
+    {
+        return std::ifstream(path).good();
+    }
+
+    std::vector<std::string> listFiles(const std::string &directory)
+    {
+        std::vector<std::string> names;
+        if (DIR *listing = opendir(directory.c_str()))
+        {
+            while (dirent *item = readdir(listing))
+            {
+                if (item->d_name[0] != '.')
+                {
+                    names.push_back(item->d_name);
+                }
+            }
+            closedir(listing);
+        }
+        return names;
+    }
+
+    const uint64_t kMinuteMs = 60 * 1000;
+    const uint64_t kHourMs = 60 * kMinuteMs;
+
+    LoggerConfig timeConfig(const std::string &directory, RotationInterval interval)
+    {
+        LoggerConfig config;
+        config.logDirectory = directory;
+        config.consoleLogLevel = LogLevel::CRITICAL;
+        config.fileLogLevel = LogLevel::INFO;
+        config.defaultDestination = LogDestination::FILE_ONLY;
+        config.forkSafe = false;
+        config.asyncLogging = false; // Rotation runs on the logging call, at the entry's timestamp
+        config.rotationPolicy = RotationPolicy::TIME;
+        config.rotationInterval = interval;
+        config.rotationPrepareMs = 1000;
+        return config;
+    }
+
+    // The next hour's file is opened within rotationPrepareMs of the boundary
+    // and taken over at the boundary; after a quiet spell the file is named
+    // after the period of the switch.
+    void testHourlyRotation()
+    {
+        std::string directory = testDirectory("hourly");
+        uint64_t midnight = localMidnightMs();
+        auto time = std::make_unique<ManualClock>(midnight + 30 * kMinuteMs);
+        ManualClock *clock = time.get();
+        Logger logger(timeConfig(directory, RotationInterval::HOURLY), std::move(time));
+        EXPECT(logger.initialize());
+        std::string first = logger.getCurrentLogFile();
+        EXPECT(first == periodFile(directory, midnight + 30 * kMinuteMs)); // Named at start, not at the period start
+
+        logger.info("APP", "hour zero early");
+        clock->nowMs = midnight + kHourMs - 2000;
+        logger.info("APP", "hour zero outside the prepare window");
+        EXPECT(!exists(periodFile(directory, midnight + kHourMs)));
+
+        clock->nowMs = midnight + kHourMs - 500;
+        logger.info("APP", "hour zero late");
+        EXPECT(exists(periodFile(directory, midnight + kHourMs))); // Pre-opened, still empty
+        EXPECT(readFile(periodFile(directory, midnight + kHourMs)).empty());
+        EXPECT(logger.getCurrentLogFile() == first);
+
+        clock->nowMs = midnight + kHourMs + 100;
+        logger.info("APP", "hour one");
+        EXPECT(logger.getCurrentLogFile() == periodFile(directory, midnight + kHourMs));
+
+        // Nothing logged through the prepare window of 02:00: the 02:00 file never exists
+        clock->nowMs = midnight + 3 * kHourMs + 20 * kMinuteMs;
+        logger.info("APP", "hour three");
+        EXPECT(logger.getCurrentLogFile() == periodFile(directory, midnight + 3 * kHourMs));
+        EXPECT(!exists(periodFile(directory, midnight + 2 * kHourMs)));
+        logger.shutdown();
+
+        std::string hourZero = readFile(first);
+        EXPECT(countOf(hourZero, "] hour zero") == 3);
+        EXPECT(countOf(hourZero, "] hour one") == 0);
+        std::string hourOne = readFile(periodFile(directory, midnight + kHourMs));
+        EXPECT(countOf(hourOne, "] hour one") == 1);
+        EXPECT(countOf(hourOne, "] hour zero") == 0);
+        EXPECT(countOf(readFile(periodFile(directory, midnight + 3 * kHourMs)), "] hour three") == 1);
+    }
+
+    // Daily files switch at local midnight
+    void testDailyRotation()
+    {
+        std::string directory = testDirectory("daily");
+        uint64_t midnight = localMidnightMs();
+        auto time = std::make_unique<ManualClock>(midnight + 12 * kHourMs);
+        ManualClock *clock = time.get();
+        Logger logger(timeConfig(directory, RotationInterval::DAILY), std::move(time));
+        EXPECT(logger.initialize());
+        std::string first = logger.getCurrentLogFile();
+
+        clock->nowMs = midnight + 23 * kHourMs;
+        logger.info("APP", "same day");
+        EXPECT(logger.getCurrentLogFile() == first);
+
+        std::tm local{};
+        local.tm_year = 2025 - 1900;
+        local.tm_mon = 2;
+        local.tm_mday = 15;
+        local.tm_isdst = -1;
+        uint64_t nextMidnight = static_cast<uint64_t>(mktime(&local)) * 1000;
+        clock->nowMs = nextMidnight - 200;
+        logger.info("APP", "just before midnight");
+        EXPECT(exists(periodFile(directory, nextMidnight)));
+        EXPECT(logger.getCurrentLogFile() == first);
+
+        clock->nowMs = nextMidnight + 1;
+        logger.info("APP", "next day");
+        EXPECT(logger.getCurrentLogFile() == periodFile(directory, nextMidnight));
+        logger.shutdown();
+
+        EXPECT(countOf(readFile(first), "] just before midnight") == 1);
+        EXPECT(countOf(readFile(first), "] next day") == 0);
+        EXPECT(countOf(readFile(periodFile(directory, nextMidnight)), "] next day") == 1);
+    }
+
+    // Time-rotated files are pruned to maxBackupFiles, oldest first; files of
+    // other prefixes and other processes are left alone.
+    void testRotatedFilePruning()
+    {
+        std::string directory = testDirectory("prune");
+        uint64_t midnight = localMidnightMs();
+        LoggerConfig config = timeConfig(directory, RotationInterval::HOURLY);
+        config.maxBackupFiles = 2;
+        auto time = std::make_unique<ManualClock>(midnight + kMinuteMs);
+        ManualClock *clock = time.get();
+        Logger logger(config, std::move(time));
+        EXPECT(logger.initialize());
+
+        std::string otherProcess = directory + "/embedded_log_2000-01-01_00_00_00_pid77.txt";
+        std::string otherPrefix = directory + "/telemetry_2000-01-01_00_00_00.txt";
+        std::ofstream(otherProcess) << "other process\n";
+        std::ofstream(otherPrefix) << "other prefix\n";
+
+        for (uint64_t hour = 0; hour < 6; ++hour)
+        {
+            clock->nowMs = midnight + hour * kHourMs + kMinuteMs;
+            logger.info("APP", "hour " + std::to_string(hour));
+        }
+        std::string live = logger.getCurrentLogFile();
+        logger.shutdown();
+
+        EXPECT(live == periodFile(directory, midnight + 5 * kHourMs));
+        EXPECT(exists(periodFile(directory, midnight + 4 * kHourMs)));
+        EXPECT(exists(periodFile(directory, midnight + 3 * kHourMs)));
+        EXPECT(!exists(periodFile(directory, midnight + 2 * kHourMs)));
+        EXPECT(!exists(periodFile(directory, midnight + kMinuteMs)));
+        EXPECT(exists(otherProcess));
+        EXPECT(exists(otherPrefix));
+        EXPECT(listFiles(directory).size() == 5);
+    }
+
+    LoggerConfig recycleConfig(const std::string &directory)
+    {
+        LoggerConfig config;
+        config.logDirectory = directory;
+        config.consoleLogLevel = LogLevel::CRITICAL;
+        config.fileLogLevel = LogLevel::INFO;
+        config.defaultDestination = LogDestination::FILE_ONLY;
+        config.forkSafe = false;
+        config.asyncLogging = false; // Every entry is its own write
+        config.recycleLogFiles = true;
+        config.maxFileSize = 64 * 1024;
+        config.maxBackupFiles = 1;
+        return config;
+    }
+
+    /// One logger run: count entries, shut down, return the header rewrites
+    int recycleRun(const LoggerConfig &config, ManualClock &clock, const std::string &text, int entries,
+                   std::string &liveFile)
+    {
+        auto fileSystem = std::make_unique<CountingFileSystem>();
+        CountingFileSystem *counting = fileSystem.get();
+        auto time = std::make_unique<ManualClock>(clock.nowMs.load());
+        ManualClock *runClock = time.get();
+        Logger logger(config, std::move(time), std::move(fileSystem));
+        EXPECT(logger.initialize());
+        for (int i = 0; i < entries; ++i)
+        {
+            logger.info("APP", text + " " + std::to_string(i));
+            runClock->nowMs += 10;
+        }
+        liveFile = logger.getCurrentLogFile();
+        logger.shutdown();
+        clock.nowMs.store(runClock->nowMs.load() + 60000);
+        return counting->validLengthWrites.load();
+    }
+
+    // The header is rewritten on close and at the byte threshold, not per
+    // write; a restart reuses the oldest file and readers see only the
+    // bytes written since.
+    void testRecycledValidLength()
+    {
+        std::string directory = testDirectory("recycle");
+        LoggerConfig config = recycleConfig(directory);
+        ManualClock clock(localMidnightMs());
+        std::string live;
+
+        int headerWrites = recycleRun(config, clock, "first run", 200, live);
+        EXPECT(headerWrites <= 2); // 200 writes, only close records the length
+        std::string contents;
+        EXPECT(Logger::readLogFile(live, contents));
+        EXPECT(countOf(contents, "] first run ") == 200);
+        EXPECT(contents.find('\0') == std::string::npos); // Preallocated zeros are past the end
+
+        // Second boot: the first run's file becomes the backup
+        recycleRun(config, clock, "second run", 50, live);
+        EXPECT(Logger::readLogFile(live + ".1", contents));
+        EXPECT(countOf(contents, "] first run ") == 200);
+
+        // Third boot: the backup set is full, so the first run's file is overwritten in place
+        recycleRun(config, clock, "third run", 20, live);
+        std::string raw = readFile(live);
+        EXPECT(countOf(raw, "] first run ") > 0); // Stale bytes are still in the file
+        EXPECT(Logger::readLogFile(live, contents));
+        EXPECT(countOf(contents, "] third run ") == 20);
+        EXPECT(countOf(contents, "] first run ") == 0);
+        EXPECT(contents.size() < raw.size());
+        EXPECT(Logger::readLogFile(live + ".1", contents));
+        EXPECT(countOf(contents, "] second run ") == 50);
+
+        // A small threshold rewrites the header as the file grows
+        config.validLengthUpdateBytes = 1024;
+        headerWrites = recycleRun(config, clock, "threshold run", 200, live);
+        EXPECT(Logger::readLogFile(live, contents));
+        EXPECT(countOf(contents, "] threshold run ") == 200);
+        EXPECT(headerWrites >= static_cast<int>(contents.size() / 1024) - 1);
+        EXPECT(headerWrites <= static_cast<int>(contents.size() / 1024) + 2);
+    }
+}
+
+int main()
+{
+    testRecycledValidLength();
+    testHourlyRotation();
+    testDailyRotation();
+    testRotatedFilePruning();
+
+    if (failures != 0)
+    {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All log file tests passed\n");
+    return 0;
+}
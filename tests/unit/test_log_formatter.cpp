@@ -0,0 +1,148 @@
+// Unit tests for hex formatting of binary payloads
+/**
+ * @file test_log_formatter.cpp
+ * @brief Standalone tests for formatting::appendHex and Logger::logBinary
+ * @details appendHex() must encode every byte value as a lowercase pair,
+ *          separate pairs with single spaces, append after existing text and
+ *          add nothing for an empty input. logBinary() lines must carry the
+ *          full size and the first maxBinaryPayloadSize bytes, mark a cut
+ *          dump with " ...", and print no dump for an empty blob. Build
+ *          against the library and run; exits non-zero if a check fails.
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/log_formatter.h"
+#include "embedded_logger/logger.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace embedded_logger;
+
+namespace
+{
+    int failures = 0;
+
+#define EXPECT(condition)                                                     \
+    do                                                                        \
+    {                                                                         \
+        if (!(condition))                                                     \
+        {                                                                     \
+            fprintf(stderr, "%s:%d: FAILED: %s\n", __FILE__, __LINE__, #condition); \
+            ++failures;                                                       \
+        }                                                                     \
+    } while (0)
+
+    std::string readFile(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    /// The line of a log file that contains needle, without its newline
+    std::string lineWith(const std::string &contents, const std::string &needle)
+    {
+        size_t at = contents.find(needle);
+        if (at == std::string::npos)
+        {
+            return std::string();
+        }
+        size_t start = contents.rfind('\n', at);
+        start = start == std::string::npos ? 0 : start + 1;
+        size_t end = contents.find('\n', at);
+        return contents.substr(start, end == std::string::npos ? std::string::npos : end - start);
+    }
+
+    bool endsWith(const std::string &text, const std::string &suffix)
+    {
+        return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    void testAppendHex()
+    {
+        std::string out;
+        formatting::appendHex(out, nullptr, 0);
+        EXPECT(out.empty());
+
+        const uint8_t frame[] = {0x12, 0x34, 0xab, 0xcd};
+        formatting::appendHex(out, frame, 1);
+        EXPECT(out == "12");
+
+        // Appends after existing text, nothing added for an empty input
+        out = "id 0x123:";
+        formatting::appendHex(out, frame, 0);
+        EXPECT(out == "id 0x123:");
+        formatting::appendHex(out, frame, sizeof(frame));
+        EXPECT(out == "id 0x123:12 34 ab cd");
+
+        // Every byte value against snprintf
+        std::vector<uint8_t> all;
+        std::string expected;
+        for (int value = 0; value < 256; ++value)
+        {
+            char pair[4];
+            snprintf(pair, sizeof(pair), "%02x", value);
+            expected += (value == 0 ? "" : " ") + std::string(pair);
+            all.push_back(static_cast<uint8_t>(value));
+        }
+        out.clear();
+        formatting::appendHex(out, all.data(), all.size());
+        EXPECT(out == expected);
+    }
+
+    void testLogBinary()
+    {
+        LoggerConfig config;
+        config.logDirectory = "/tmp/embedded_logger_test_binary_" +
+                              std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        config.consoleLogLevel = LogLevel::CRITICAL;
+        config.fileLogLevel = LogLevel::DEBUG;
+        config.defaultDestination = LogDestination::FILE_ONLY;
+        config.asyncLogging = false;
+        config.forkSafe = false;
+        config.maxBinaryPayloadSize = 4;
+
+        Logger logger(config);
+        EXPECT(logger.initialize());
+        const uint8_t bytes[] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0xff};
+        logger.logBinary(LogLevel::INFO, "CAN", bytes, 4, "exact");
+        logger.logBinary(LogLevel::INFO, "CAN", bytes, sizeof(bytes), "truncated");
+        logger.logBinary(LogLevel::INFO, "CAN", bytes, 0, "empty");
+        logger.logBinary(LogLevel::INFO, "CAN", bytes + 8, 2);
+        logger.logBinary(LogLevel::DEBUG, logger.registerComponent("SPI"), bytes + 6, 3, "handle");
+        std::string path = logger.getCurrentLogFile();
+        logger.shutdown();
+
+        std::string contents = readFile(path);
+        EXPECT(endsWith(lineWith(contents, " exact"), "] exact [4 bytes] 00 01 02 03"));
+        EXPECT(endsWith(lineWith(contents, " truncated"), "] truncated [10 bytes] 00 01 02 03 ..."));
+        EXPECT(endsWith(lineWith(contents, " empty"), "] empty"));
+        EXPECT(lineWith(contents, " empty").find("bytes]") == std::string::npos);
+        EXPECT(endsWith(lineWith(contents, "[2 bytes]"), "] [2 bytes] 08 ff"));
+        EXPECT(endsWith(lineWith(contents, " handle"), "] handle [3 bytes] 06 07 08"));
+        EXPECT(lineWith(contents, " handle").find("SPI") != std::string::npos);
+    }
+}
+
+int main()
+{
+    testAppendHex();
+    testLogBinary();
+
+    if (failures != 0)
+    {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All log formatter tests passed\n");
+    return 0;
+}
@@ -1 +1,836 @@
-// Unit tests for core logger functionality 
+// Unit tests for core logger functionality
+/**
+ * @file test_logger.cpp
+ * @brief Standalone tests for Logger behaviour that needs a real writer thread
+ * @details Build against the library and run; exits non-zero on the first
+ *          failed check. A watchdog turns a hang into a failure.
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/logger.h"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <dirent.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define TEST_HAS_FORK
+#endif
+
+using namespace embedded_logger;
+
+namespace
+{
+    int failures = 0;
+
+#define EXPECT(condition)                                                     \
+    do                                                                        \
+    {                                                                         \
+        if (!(condition))                                                     \
+        {                                                                     \
+            fprintf(stderr, "%s:%d: FAILED: %s\n", __FILE__, __LINE__, #condition); \
+            ++failures;                                                       \
+        }                                                                     \
+    } while (0)
+
+    std::string readFile(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    size_t countOf(const std::string &text, const std::string &needle)
+    {
+        size_t count = 0;
+        for (size_t at = text.find(needle); at != std::string::npos; at = text.find(needle, at + 1))
+        {
+            ++count;
+        }
+        return count;
+    }
+
+    LoggerConfig testConfig(const std::string &name)
+    {
+        LoggerConfig config;
+        config.logDirectory = "/tmp/embedded_logger_test_" + name + "_" +
+                              std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        config.consoleLogLevel = LogLevel::CRITICAL;
+        config.fileLogLevel = LogLevel::DEBUG;
+        config.defaultDestination = LogDestination::FILE_ONLY;
+        return config;
+    }
+
+#ifdef TEST_HAS_FORK
+    std::vector<std::string> listFiles(const std::string &directory)
+    {
+        std::vector<std::string> names;
+        if (DIR *listing = opendir(directory.c_str()))
+        {
+            while (dirent *item = readdir(listing))
+            {
+                if (item->d_name[0] != '.')
+                {
+                    names.push_back(item->d_name);
+                }
+            }
+            closedir(listing);
+        }
+        return names;
+    }
+
+    void onWatchdog(int)
+    {
+        const char message[] = "FAILED: timed out (deadlock)\n";
+        ssize_t written = write(2, message, sizeof(message) - 1);
+        (void)written;
+        _exit(1);
+    }
+
+    // fork() while debug bursts end on the writer: the "ended" record must not
+    // need the component registry that atForkPrepare() holds.
+    void testForkDuringDebugBurst()
+    {
+        LoggerConfig config = testConfig("fork_burst");
+        config.debugBurstMs = 1;
+        config.forkChildMode = ForkChildMode::DISABLED;
+        auto logger = std::make_shared<Logger>(config);
+        EXPECT(logger->initialize());
+
+        alarm(60);
+        std::atomic<bool> stop(false);
+        std::thread faults([&]
+                           {
+                               for (int i = 0; !stop.load(); ++i)
+                               {
+                                   logger->error("BMS", "fault " + std::to_string(i));
+                                   logger->debug("BMS", "burst detail " + std::to_string(i));
+                                   std::this_thread::sleep_for(std::chrono::microseconds(500 + (i % 10) * 100));
+                               }
+                           });
+        for (int i = 0; i < 2000; ++i)
+        {
+            pid_t child = fork();
+            if (child == 0)
+            {
+                _exit(0);
+            }
+            EXPECT(child > 0);
+            int status = 0;
+            waitpid(child, &status, 0);
+            EXPECT(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        }
+        stop.store(true);
+        faults.join();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        alarm(0);
+
+        std::string file = logger->getCurrentLogFile();
+        logger->shutdown();
+        std::string contents = readFile(file);
+        EXPECT(countOf(contents, "Debug burst started") > 0);
+        EXPECT(countOf(contents, "Debug burst started") == countOf(contents, "Debug burst ended"));
+    }
+
+    // A deferred callable that logs runs inside the writer's busy window: its
+    // entry is dropped, so fork() cannot wait on it.
+    void testLoggingFromDeferredMessage()
+    {
+        LoggerConfig config = testConfig("deferred_reentry");
+        config.forkChildMode = ForkChildMode::DISABLED;
+        auto logger = std::make_shared<Logger>(config);
+        EXPECT(logger->initialize());
+
+        alarm(60);
+        std::thread producer([&]
+                             {
+                                 for (int i = 0; i < 500; ++i)
+                                 {
+                                     logger->logDeferred(LogLevel::INFO, "NAV" + std::to_string(i % 300), [logger, i]
+                                                         {
+                                                             logger->info("NAV.Inner" + std::to_string(i), "inner");
+                                                             return std::string("outer");
+                                                         });
+                                 }
+                             });
+        for (int i = 0; i < 200; ++i)
+        {
+            pid_t child = fork();
+            if (child == 0)
+            {
+                _exit(0);
+            }
+            int status = 0;
+            waitpid(child, &status, 0);
+        }
+        producer.join();
+        alarm(0);
+
+        std::string file = logger->getCurrentLogFile();
+        logger->shutdown();
+        std::string contents = readFile(file);
+        EXPECT(countOf(contents, "] outer") == 500);
+        EXPECT(countOf(contents, "] inner") == 0);
+    }
+
+    // Local files whose writes can be held up, standing in for a stalled SD card.
+    // Only the stalled process's writes wait, so a forked child can still log.
+    class StallingFileSystem : public IFileSystem
+    {
+    public:
+        std::atomic<pid_t> stalledProcess{0};
+
+        bool fileExists(const std::string &path) override
+        {
+            struct stat info;
+            return stat(path.c_str(), &info) == 0;
+        }
+        bool createDirectory(const std::string &path) override { return mkdir(path.c_str(), 0755) == 0; }
+        size_t getFileSize(const std::string &path) override
+        {
+            struct stat info;
+            return stat(path.c_str(), &info) == 0 ? static_cast<size_t>(info.st_size) : 0;
+        }
+        bool deleteFile(const std::string &path) override { return unlink(path.c_str()) == 0; }
+        bool renameFile(const std::string &oldPath, const std::string &newPath) override
+        {
+            return rename(oldPath.c_str(), newPath.c_str()) == 0;
+        }
+        bool appendFile(FileHandle handle, const void *data, size_t size) override
+        {
+            while (stalledProcess.load() == getpid())
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return IFileSystem::appendFile(handle, data, size);
+        }
+    };
+
+    // A writer stuck in a write delays fork() by forkDrainTimeoutMs at most; the
+    // child starts its own file and the parent keeps everything it had queued.
+    void testForkWithStalledWriter()
+    {
+        LoggerConfig config = testConfig("fork_stalled");
+        config.forkDrainTimeoutMs = 200;
+        auto fileSystem = std::make_unique<StallingFileSystem>();
+        StallingFileSystem *stalling = fileSystem.get();
+        auto logger = std::make_shared<Logger>(config, nullptr, std::move(fileSystem));
+        EXPECT(logger->initialize());
+
+        alarm(30);
+        stalling->stalledProcess.store(getpid());
+        for (int i = 0; i < 50; ++i)
+        {
+            logger->info("APP", "parent " + std::to_string(i));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        auto started = std::chrono::steady_clock::now();
+        pid_t child = fork();
+        if (child == 0)
+        {
+            logger->info("APP", "child entry");
+            std::string file = logger->getCurrentLogFile();
+            logger->shutdown();
+            std::string contents = readFile(file);
+            _exit(countOf(contents, "child entry") == 1 && countOf(contents, "] parent") == 0 ? 0 : 1);
+        }
+        auto forkMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count();
+        EXPECT(forkMs >= 150 && forkMs < 5000);
+        int status = 0;
+        waitpid(child, &status, 0);
+        EXPECT(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+        stalling->stalledProcess.store(0);
+        std::string file = logger->getCurrentLogFile();
+        logger->shutdown();
+        alarm(0);
+        std::string contents = readFile(file);
+        EXPECT(countOf(contents, "] parent") == 50);
+        EXPECT(countOf(contents, "child entry") == 0);
+    }
+
+    // The fork handler leaves the child's file and writer to its first log
+    // call: a child that never logs creates no file of its own.
+    void testChildRestartsOnFirstLog()
+    {
+        LoggerConfig config = testConfig("fork_lazy");
+        auto logger = std::make_shared<Logger>(config);
+        EXPECT(logger->initialize());
+        logger->info("MAIN", "parent");
+        logger->flush();
+
+        alarm(60);
+        for (int logs = 0; logs < 2; ++logs)
+        {
+            pid_t child = fork();
+            if (child == 0)
+            {
+                if (logs == 0)
+                {
+                    _exit(0);
+                }
+                logger->info("CHILD", "from child");
+                std::string file = logger->getCurrentLogFile();
+                logger->shutdown();
+                std::string contents = readFile(file);
+                bool own = file.find("_pid" + std::to_string(getpid())) != std::string::npos;
+                _exit(own && countOf(contents, "Logger restarted in child process") == 1 &&
+                              countOf(contents, "from child") == 1 && countOf(contents, "] parent") == 0
+                          ? 0
+                          : 1);
+            }
+            EXPECT(child > 0);
+            int status = 0;
+            waitpid(child, &status, 0);
+            EXPECT(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+            std::vector<std::string> files = listFiles(config.logDirectory);
+            size_t childFiles = 0;
+            for (const std::string &name : files)
+            {
+                childFiles += name.find("_pid" + std::to_string(child)) != std::string::npos ? 1 : 0;
+            }
+            EXPECT(childFiles == static_cast<size_t>(logs));
+        }
+        alarm(0);
+
+        std::string file = logger->getCurrentLogFile();
+        logger->info("MAIN", "parent again");
+        logger->shutdown();
+        std::string contents = readFile(file);
+        EXPECT(countOf(contents, "] parent") == 2);
+        EXPECT(contents.find("from child") == std::string::npos);
+    }
+
+    // A child's entry wakes the parent's writer through the ring's doorbell;
+    // nothing else would, as the writer has no timed wakeup pending here.
+    void testChildEntryWakesWriter()
+    {
+        LoggerConfig config = testConfig("ring_wake");
+        config.forkChildMode = ForkChildMode::PARENT_RING;
+        auto logger = std::make_shared<Logger>(config);
+        EXPECT(logger->initialize());
+        logger->info("MAIN", "parent");
+        logger->flush();
+        std::string file = logger->getCurrentLogFile();
+
+        alarm(60);
+        pid_t child = fork();
+        if (child == 0)
+        {
+            logger->info("CHILD", "from child");
+            _exit(0);
+        }
+        EXPECT(child > 0);
+        int status = 0;
+        waitpid(child, &status, 0);
+        EXPECT(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+        auto started = std::chrono::steady_clock::now();
+        while (readFile(file).find("from child") == std::string::npos &&
+               std::chrono::steady_clock::now() - started < std::chrono::seconds(2))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        EXPECT(readFile(file).find("from child") != std::string::npos);
+        logger->shutdown();
+        alarm(0);
+    }
+
+    // With a shared ring the writer sleeps on the ring's doorbell; its timed
+    // wakeups must still let adaptive verbosity step back to NORMAL once the
+    // flood is over.
+    void testAdaptiveRecoveryWithSharedRing()
+    {
+        LoggerConfig config = testConfig("adaptive_ring");
+        config.forkChildMode = ForkChildMode::PARENT_RING;
+        config.adaptiveVerbosity = true;
+        config.adaptiveHoldMs = 100;
+        auto logger = std::make_shared<Logger>(config);
+        EXPECT(logger->initialize());
+
+        std::vector<std::thread> producers;
+        for (int t = 0; t < 4; ++t)
+        {
+            producers.emplace_back([&logger, t]
+                                   {
+                                       for (int i = 0; i < 200000; ++i)
+                                       {
+                                           logger->debug("FLOOD" + std::to_string(t), "entry " + std::to_string(i));
+                                       }
+                                   });
+        }
+        for (std::thread &producer : producers)
+        {
+            producer.join();
+        }
+        EXPECT(logger->getAdaptiveDroppedCount() > 0);
+
+        for (int waitedMs = 0; waitedMs < 3000 && logger->getAdaptiveState() != AdaptiveVerbosityState::NORMAL;
+             waitedMs += 10)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        EXPECT(logger->getAdaptiveState() == AdaptiveVerbosityState::NORMAL);
+
+        // Entries an emergency filters out are not load shedding
+        size_t dropped = logger->getAdaptiveDroppedCount();
+        logger->emergencyFlush(std::chrono::steady_clock::now() + std::chrono::milliseconds(500));
+        for (int i = 0; i < 100; ++i)
+        {
+            logger->debug("FLOOD0", "during emergency");
+        }
+        EXPECT(logger->getAdaptiveDroppedCount() == dropped);
+
+        // The writer logs each transition through the queue like any other entry
+        logger->shutdown();
+        std::string contents;
+        for (const std::string &name : listFiles(config.logDirectory))
+        {
+            contents += readFile(config.logDirectory + "/" + name);
+        }
+        EXPECT(countOf(contents, "Adaptive verbosity NORMAL -> ") >= 1);
+        EXPECT(countOf(contents, " -> NORMAL: full verbosity restored") >= 1);
+    }
+
+    /// Read from a subscriber socket until needle arrives or timeoutMs passes
+    bool receiveUntil(int fd, std::string &received, const std::string &needle, int timeoutMs)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        while (received.find(needle) == std::string::npos)
+        {
+            int remainingMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                   deadline - std::chrono::steady_clock::now())
+                                                   .count());
+            pollfd descriptor = {fd, POLLIN, 0};
+            if (remainingMs <= 0 || poll(&descriptor, 1, remainingMs) <= 0)
+            {
+                return false;
+            }
+            char buffer[4096];
+            ssize_t got = recv(fd, buffer, sizeof(buffer), 0);
+            if (got <= 0)
+            {
+                return false;
+            }
+            received.append(buffer, static_cast<size_t>(got));
+        }
+        return true;
+    }
+
+    // A subscriber connects, gets the entries its filter matches and leaves;
+    // the logger keeps writing its file throughout.
+    void testStreamSubscriber()
+    {
+        LoggerConfig config = testConfig("stream");
+        config.forkSafe = false;
+        config.fileLogLevel = LogLevel::INFO;
+        config.streamSocketPath = config.logDirectory + ".sock";
+        auto logger = std::make_shared<Logger>(config);
+        EXPECT(logger->initialize());
+        ComponentId nav = logger->registerComponent("NAV");
+        EXPECT(!logger->isEnabled(LogLevel::DEBUG, nav)); // No sink takes DEBUG
+
+        alarm(30);
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", config.streamSocketPath.c_str());
+        EXPECT(connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0);
+        const char filter[] = "FILTER level=INFO component=NAV\n";
+        EXPECT(send(fd, filter, sizeof(filter) - 1, 0) == static_cast<ssize_t>(sizeof(filter) - 1));
+
+        // Entries logged before the server accepted the connection never reach it
+        std::string received;
+        bool subscribed = false;
+        for (int i = 0; i < 200 && !subscribed; ++i)
+        {
+            logger->info("NAV", "probe " + std::to_string(i));
+            subscribed = receiveUntil(fd, received, "probe", 10);
+        }
+        EXPECT(subscribed);
+        EXPECT(logger->isEnabled(LogLevel::DEBUG, nav)); // A subscriber might
+
+        for (int i = 0; i < 100; ++i)
+        {
+            logger->info("NAV.GPS", "fix " + std::to_string(i));
+            logger->info("BMS", "not streamed " + std::to_string(i));
+            logger->debug("NAV", "below filter " + std::to_string(i));
+        }
+        EXPECT(receiveUntil(fd, received, "fix 99\n", 5000));
+        EXPECT(countOf(received, "] fix ") == 100);
+        EXPECT(countOf(received, "not streamed") == 0);
+        EXPECT(countOf(received, "below filter") == 0);
+
+        close(fd);
+        for (int waitedMs = 0; waitedMs < 2000 && logger->isEnabled(LogLevel::DEBUG, nav); waitedMs += 10)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        EXPECT(!logger->isEnabled(LogLevel::DEBUG, nav));
+        for (int i = 0; i < 100; ++i)
+        {
+            logger->info("NAV", "after disconnect " + std::to_string(i));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        alarm(0);
+
+        std::string file = logger->getCurrentLogFile();
+        logger->shutdown();
+        std::string contents = readFile(file);
+        EXPECT(countOf(contents, "] fix ") == 100);
+        EXPECT(countOf(contents, "after disconnect") == 100);
+        struct stat info;
+        EXPECT(stat(config.streamSocketPath.c_str(), &info) != 0); // Removed by shutdown()
+    }
+#endif
+
+    // A component takes the level of its longest configured dotted prefix;
+    // an explicit level overrides the console/file levels.
+    void testHierarchicalComponentLevels()
+    {
+        LoggerConfig config = testConfig("component_levels");
+        config.forkSafe = false;
+        config.fileLogLevel = LogLevel::INFO;
+        config.componentLevels["nav"] = LogLevel::WARNING;
+        config.componentLevels["nav.gps"] = LogLevel::DEBUG;
+        auto logger = std::make_shared<Logger>(config);
+        EXPECT(logger->initialize());
+
+        ComponentId nav = logger->registerComponent("nav");
+        ComponentId gps = logger->registerComponent("nav.gps");
+        ComponentId rtk = logger->registerComponent("nav.gps.rtk");
+        ComponentId imu = logger->registerComponent("nav.imu");
+        ComponentId gpsLookalike = logger->registerComponent("nav.gpsx");
+        ComponentId navLookalike = logger->registerComponent("navx");
+
+        EXPECT(!logger->isEnabled(LogLevel::INFO, nav));
+        EXPECT(logger->isEnabled(LogLevel::WARNING, nav));
+        EXPECT(logger->isEnabled(LogLevel::DEBUG, gps));
+        EXPECT(logger->isEnabled(LogLevel::DEBUG, rtk));
+        EXPECT(!logger->isEnabled(LogLevel::INFO, imu));
+        EXPECT(!logger->isEnabled(LogLevel::INFO, gpsLookalike)); // "nav", not "nav.gps"
+        EXPECT(logger->isEnabled(LogLevel::INFO, navLookalike));  // Not under "nav": file level
+        EXPECT(!logger->isEnabled(LogLevel::DEBUG, navLookalike));
+
+        logger->debug("nav.gps.rtk", "rtk detail");
+        logger->debug("navx", "navx detail");
+
+        logger->setComponentLevel("nav.gps.rtk", LogLevel::ERROR);
+        EXPECT(!logger->isEnabled(LogLevel::WARNING, rtk));
+        EXPECT(logger->isEnabled(LogLevel::DEBUG, gps));
+
+        logger->clearComponentLevel("nav.gps");
+        EXPECT(!logger->isEnabled(LogLevel::INFO, gps));
+        EXPECT(logger->isEnabled(LogLevel::WARNING, gps));
+        EXPECT(logger->isEnabled(LogLevel::ERROR, rtk));
+        EXPECT(!logger->isEnabled(LogLevel::WARNING, rtk));
+
+        std::string file = logger->getCurrentLogFile();
+        logger->shutdown();
+        std::string contents = readFile(file);
+        EXPECT(countOf(contents, "rtk detail") == 1);
+        EXPECT(countOf(contents, "navx detail") == 0);
+    }
+
+    /// Clock the test moves by hand
+    class ManualTimeProvider : public ITimeProvider
+    {
+    public:
+        explicit ManualTimeProvider(std::atomic<uint64_t> &nowMs) : nowMs_(nowMs) {}
+        std::string getCurrentDateTime() override { return "2025-01-31 12:00:00"; }
+        uint64_t getUnixTimestampMs() override { return nowMs_.load(); }
+
+    private:
+        std::atomic<uint64_t> &nowMs_;
+    };
+
+    // An error from a trigger component opens a burst for it and its
+    // sub-components, further errors push the end out, and the first entry
+    // past the end closes it
+    void testDebugBurstWindow()
+    {
+        LoggerConfig config = testConfig("debug_burst");
+        config.forkSafe = false;
+        config.asyncLogging = false;
+        config.fileLogLevel = LogLevel::INFO;
+        config.debugBurstMs = 1000;
+        config.debugBurstTriggers = {"BMS"};
+        std::atomic<uint64_t> nowMs(1738324800000ULL);
+        const uint64_t startMs = nowMs.load();
+        auto logger = std::make_shared<Logger>(config, std::unique_ptr<ITimeProvider>(new ManualTimeProvider(nowMs)));
+        EXPECT(logger->initialize());
+
+        logger->debug("BMS.Cell", "before burst");
+        logger->error("NAV", "nav fault"); // Not a trigger
+        logger->debug("NAV", "nav detail");
+
+        logger->error("BMS", "fault 1");
+        logger->debug("BMS.Cell", "detail 1");
+        logger->debug("NAV", "other component detail");
+
+        nowMs = startMs + 800;
+        logger->error("BMS", "fault 2"); // Extends to startMs + 1800
+        nowMs = startMs + 1500;
+        logger->debug("BMS", "detail 2");
+
+        nowMs = startMs + 1800;
+        logger->debug("BMS", "after burst");
+        logger->debug("BMS.Cell", "after burst too");
+
+        nowMs = startMs + 3000;
+        logger->critical("BMS.Cell", "fault 3"); // Sub-components trigger and get their own burst
+        logger->debug("BMS.Cell", "detail 3");
+        logger->debug("BMS", "parent detail");
+
+        std::string file = logger->getCurrentLogFile();
+        logger->shutdown();
+        std::string contents = readFile(file);
+        EXPECT(countOf(contents, "before burst") == 0);
+        EXPECT(countOf(contents, "nav detail") == 0);
+        EXPECT(countOf(contents, "other component detail") == 0);
+        EXPECT(countOf(contents, "detail 1") == 1);
+        EXPECT(countOf(contents, "detail 2") == 1);
+        EXPECT(countOf(contents, "after burst") == 0);
+        EXPECT(countOf(contents, "detail 3") == 1);
+        EXPECT(countOf(contents, "parent detail") == 0);
+        EXPECT(countOf(contents, "Debug burst started") == 2);
+        EXPECT(countOf(contents, "Debug burst started: BMS at DEBUG for 1000 ms after ERROR from BMS") == 1);
+        EXPECT(countOf(contents, "Debug burst started: BMS.Cell at DEBUG") == 1);
+        EXPECT(countOf(contents, "Debug burst ended: BMS back to configured levels after 1800 ms") == 1);
+        EXPECT(contents.find("fault 1") < contents.find("Debug burst started: BMS "));
+        EXPECT(contents.find("Debug burst ended: BMS ") < contents.find("fault 3"));
+    }
+
+    int messagesBuilt = 0;
+
+    std::string built(const std::string &text)
+    {
+        ++messagesBuilt;
+        return text;
+    }
+
+    // Periodic and conditional macros log the passes they promise and build
+    // no message on the others
+    void testPeriodicMacros()
+    {
+        LoggerConfig config = testConfig("periodic_macros");
+        config.forkSafe = false;
+        config.asyncLogging = false;
+        auto logger = std::make_shared<Logger>(config);
+        EXPECT(logger->initialize());
+        Logger::setGlobalLogger(logger);
+
+        messagesBuilt = 0;
+        uint32_t never = 0; // Runtime n
+        for (int i = 0; i < 100; ++i)
+        {
+            EL_INFO_EVERY_N(10, "MACRO", built("every ten " + std::to_string(i)));
+            EL_INFO_EVERY_N(never, "MACRO", built("every zero"));
+            EL_INFO_EVERY_N(0, "MACRO", built("every literal zero"));
+            EL_INFO_FIRST_N(3, "MACRO", built("first three " + std::to_string(i)));
+            EL_INFO_FIRST_N(0, "MACRO", built("first zero"));
+            EL_INFO_IF(i % 25 == 0, "MACRO", built("if " + std::to_string(i)));
+        }
+        EXPECT(messagesBuilt == 10 + 3 + 4);
+
+        // Threads sharing one call site: exactly one pass in n logs
+        auto shared = []
+        { EL_INFO_EVERY_N(7, "MACRO", "shared site"); };
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&shared]
+                                 {
+                                     for (int i = 0; i < 700; ++i)
+                                     {
+                                         shared();
+                                     }
+                                 });
+        }
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+
+        auto started = std::chrono::steady_clock::now();
+        int passes = 0;
+        while (std::chrono::steady_clock::now() - started < std::chrono::milliseconds(230))
+        {
+            EL_INFO_EVERY_MS(100, "MACRO", "every 100 ms");
+            ++passes;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        Logger::setGlobalLogger(nullptr);
+
+        std::string file = logger->getCurrentLogFile();
+        logger->shutdown();
+        std::string contents = readFile(file);
+        EXPECT(countOf(contents, "] every ten ") == 10);
+        EXPECT(countOf(contents, "] every ten 0\n") == 1);
+        EXPECT(countOf(contents, "] every ten 90\n") == 1);
+        EXPECT(countOf(contents, "every zero") == 0);
+        EXPECT(countOf(contents, "every literal zero") == 0);
+        EXPECT(countOf(contents, "] first three ") == 3);
+        EXPECT(countOf(contents, "] first three 2\n") == 1);
+        EXPECT(countOf(contents, "first zero") == 0);
+        EXPECT(countOf(contents, "] if ") == 4);
+        EXPECT(countOf(contents, "] shared site") == 400);
+        EXPECT(passes > 3);
+        size_t periodic = countOf(contents, "] every 100 ms"); // At 0, ~100 and ~200 ms; a late pass may miss the last
+        EXPECT(periodic >= 2 && periodic <= 3);
+    }
+
+    // emergencyFlush() restricts logging to ERROR and above until endEmergency()
+    void testEndEmergency()
+    {
+        LoggerConfig config = testConfig("end_emergency");
+        config.forkSafe = false;
+        auto logger = std::make_shared<Logger>(config);
+        EXPECT(logger->initialize());
+
+        logger->debug("PSU", "before emergency");
+        logger->emergencyFlush(std::chrono::steady_clock::now() + std::chrono::milliseconds(500));
+        logger->debug("PSU", "during emergency");
+        logger->error("PSU", "error during emergency");
+
+        logger->endEmergency();
+        logger->endEmergency(); // Nothing left to end
+        logger->debug("PSU", "after emergency");
+
+        // A configuration change alone does not end an emergency
+        logger->emergencyFlush(std::chrono::steady_clock::now() + std::chrono::milliseconds(500));
+        logger->updateConfig(logger->getConfig());
+        logger->debug("PSU", "during second emergency");
+        logger->endEmergency();
+
+        std::string file = logger->getCurrentLogFile();
+        logger->shutdown();
+        std::string contents = readFile(file);
+        EXPECT(countOf(contents, "before emergency") == 1);
+        EXPECT(countOf(contents, "] during emergency") == 0);
+        EXPECT(countOf(contents, "error during emergency") == 1);
+        EXPECT(countOf(contents, "after emergency") == 1);
+        EXPECT(countOf(contents, "during second emergency") == 0);
+        EXPECT(countOf(contents, "Emergency ended") == 2);
+        EXPECT(contents.find("Emergency ended") < contents.find("after emergency"));
+    }
+
+    // Lazy and deferred callables run once when the entry passes the filter and
+    // never below it; anything a deferred callable logs is dropped
+    void testLazyAndDeferredMessages(bool async)
+    {
+        LoggerConfig config = testConfig(async ? "lazy_async" : "lazy_sync");
+        config.forkSafe = false;
+        config.asyncLogging = async;
+        config.fileLogLevel = LogLevel::INFO;
+        auto logger = std::make_shared<Logger>(config);
+        EXPECT(logger->initialize());
+        ComponentId nav = Logger::registerComponent("NAV");
+
+        std::atomic<int> calls(0);
+        auto counted = [&calls](const char *message)
+        {
+            return [&calls, message]
+            {
+                ++calls;
+                return std::string(message);
+            };
+        };
+        logger->logLazy(LogLevel::DEBUG, "NAV", counted("lazy below"));
+        logger->logLazy(LogLevel::DEBUG, nav, counted("lazy handle below"));
+        logger->logDeferred(LogLevel::DEBUG, "NAV", counted("deferred below"));
+        logger->logDeferred(LogLevel::DEBUG, nav, counted("deferred handle below"));
+        logger->flush();
+        EXPECT(calls.load() == 0);
+
+        logger->logLazy(LogLevel::INFO, "NAV", counted("lazy passed"));
+        logger->logLazy(LogLevel::WARNING, nav, counted("lazy handle passed"));
+        logger->logDeferred(LogLevel::INFO, "NAV", counted("deferred passed"));
+        logger->logDeferred(LogLevel::ERROR, nav, counted("deferred handle passed"));
+        logger->flush();
+        EXPECT(calls.load() == 4);
+
+        // Every entry point refuses an entry logged from inside the callable
+        std::atomic<int> innerCalls(0);
+        Logger *raw = logger.get();
+        logger->logDeferred(LogLevel::INFO, "NAV", [raw, nav, &innerCalls]
+                            {
+                                const uint8_t bytes[] = {0xde, 0xad};
+                                raw->info("NAV", "nested info");
+                                raw->error(nav, "nested handle");
+                                raw->logf(LogLevel::ERROR, "NAV", "nested %s", "printf");
+                                raw->logBinary(LogLevel::ERROR, "NAV", bytes, sizeof(bytes), "nested binary");
+                                raw->logLazy(LogLevel::ERROR, "NAV", [&innerCalls]
+                                             {
+                                                 ++innerCalls;
+                                                 return std::string("nested lazy");
+                                             });
+                                raw->logDeferred(LogLevel::ERROR, "NAV", [&innerCalls]
+                                                 {
+                                                     ++innerCalls;
+                                                     return std::string("nested deferred");
+                                                 });
+                                return std::string("outer");
+                            });
+        logger->flush();
+        logger->info("NAV", "after the callable");
+
+        std::string file = logger->getCurrentLogFile();
+        logger->shutdown();
+        std::string contents = readFile(file);
+        EXPECT(countOf(contents, "below") == 0);
+        EXPECT(countOf(contents, " passed\n") == 4);
+        EXPECT(countOf(contents, "] outer\n") == 1);
+        EXPECT(countOf(contents, "nested") == 0);
+        EXPECT(innerCalls.load() == 0);
+        EXPECT(countOf(contents, "] after the callable\n") == 1);
+    }
+}
+
+int main()
+{
+    // First: component names are registered process-wide and later tests fill the table
+    testHierarchicalComponentLevels();
+    testDebugBurstWindow();
+#ifdef TEST_HAS_FORK
+    signal(SIGALRM, onWatchdog);
+    testForkDuringDebugBurst();
+    testLoggingFromDeferredMessage();
+    testForkWithStalledWriter();
+    testChildRestartsOnFirstLog();
+    testChildEntryWakesWriter();
+    testAdaptiveRecoveryWithSharedRing();
+    testStreamSubscriber();
+#endif
+    testPeriodicMacros();
+    testEndEmergency();
+    testLazyAndDeferredMessages(false);
+    testLazyAndDeferredMessages(true);
+
+    if (failures != 0)
+    {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All logger tests passed\n");
+    return 0;
+}
@@ -1 +1,314 @@
-// Unit tests for platform interfaces 
+// Unit tests for platform interfaces
+/**
+ * @file test_platform_interfaces.cpp
+ * @brief Standalone tests for the IFileSystem handle API
+ * @details Runs the same checks on the built-in POSIX file system and on the
+ *          stdio defaults a backend inherits when it only implements the
+ *          path operations: open modes, appends and gathered appends,
+ *          positioned writes, preallocation, sync, directory listing and
+ *          modification times. A gathered write into a slow FIFO under a
+ *          stream of signals must resume after every short write and EINTR.
+ *          Build against the library and run; exits non-zero if a check
+ *          fails.
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+using namespace embedded_logger;
+
+namespace
+{
+    int failures = 0;
+
+#define EXPECT(condition)                                                     \
+    do                                                                        \
+    {                                                                         \
+        if (!(condition))                                                     \
+        {                                                                     \
+            fprintf(stderr, "%s:%d: FAILED: %s\n", __FILE__, __LINE__, #condition); \
+            ++failures;                                                       \
+        }                                                                     \
+    } while (0)
+
+    std::string readFile(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    std::string testDirectory(const std::string &name)
+    {
+        return "/tmp/embedded_logger_test_" + name + "_" +
+               std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+
+    /// A backend with only the path operations: every handle call is an IFileSystem default
+    class StdioFileSystem : public IFileSystem
+    {
+    public:
+        bool fileExists(const std::string &path) override { return access(path.c_str(), F_OK) == 0; }
+        bool createDirectory(const std::string &path) override
+        {
+            for (size_t slash = path.find('/', 1);; slash = path.find('/', slash + 1))
+            {
+                std::string prefix = path.substr(0, slash);
+                if (mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST)
+                {
+                    return false;
+                }
+                if (slash == std::string::npos)
+                {
+                    return true;
+                }
+            }
+        }
+        size_t getFileSize(const std::string &path) override
+        {
+            struct stat info;
+            return stat(path.c_str(), &info) == 0 ? static_cast<size_t>(info.st_size) : 0;
+        }
+        bool deleteFile(const std::string &path) override { return std::remove(path.c_str()) == 0; }
+        bool renameFile(const std::string &oldPath, const std::string &newPath) override
+        {
+            return std::rename(oldPath.c_str(), newPath.c_str()) == 0;
+        }
+    };
+
+    bool append(IFileSystem &fileSystem, FileHandle handle, const std::string &text)
+    {
+        return fileSystem.appendFile(handle, text.data(), text.size());
+    }
+
+    void checkHandleApi(IFileSystem &fileSystem, bool native)
+    {
+        std::string directory = testDirectory(native ? "posix_fs" : "stdio_fs");
+        EXPECT(fileSystem.createDirectory(directory + "/nested/deeper"));
+        std::string path = directory + "/file.txt";
+        EXPECT(!fileSystem.fileExists(path));
+        EXPECT(fileSystem.openFile(directory + "/missing/file.txt", FileOpenMode::APPEND) == kInvalidFileHandle);
+        EXPECT(!fileSystem.appendFile(kInvalidFileHandle, "x", 1));
+
+        // APPEND creates, then every write lands at the end
+        FileHandle handle = fileSystem.openFile(path, FileOpenMode::APPEND);
+        EXPECT(handle != kInvalidFileHandle);
+        EXPECT(append(fileSystem, handle, "one\n"));
+        std::string expected = "one\n";
+        std::vector<std::string> pieces;
+        std::vector<WriteBuffer> buffers;
+        for (int i = 0; i < 40; ++i)
+        {
+            pieces.push_back(i % 5 == 0 ? std::string() : "piece " + std::to_string(i) + "\n");
+        }
+        for (const std::string &piece : pieces)
+        {
+            buffers.push_back({piece.data(), piece.size()});
+            expected += piece;
+        }
+        EXPECT(fileSystem.appendFileV(handle, buffers.data(), buffers.size()));
+        EXPECT(fileSystem.appendFileV(handle, buffers.data(), 0));
+        EXPECT(fileSystem.syncFile(handle));
+        fileSystem.closeFile(handle);
+        EXPECT(readFile(path) == expected);
+        EXPECT(fileSystem.getFileSize(path) == expected.size());
+
+        handle = fileSystem.openFile(path, FileOpenMode::APPEND);
+        EXPECT(append(fileSystem, handle, "two\n"));
+        fileSystem.closeFile(handle);
+        expected += "two\n";
+        EXPECT(readFile(path) == expected);
+
+        // OVERWRITE keeps the contents and writes from the start; writeFileAt() leaves the position alone
+        handle = fileSystem.openFile(path, FileOpenMode::OVERWRITE);
+        EXPECT(handle != kInvalidFileHandle);
+        EXPECT(append(fileSystem, handle, "ONE"));
+        EXPECT(fileSystem.writeFileAt(handle, expected.size() - 4, "TWO", 3));
+        EXPECT(append(fileSystem, handle, "!"));
+        fileSystem.closeFile(handle);
+        expected.replace(0, 4, "ONE!");
+        expected.replace(expected.size() - 4, 3, "TWO");
+        EXPECT(readFile(path) == expected);
+
+        // OVERWRITE creates a missing file too
+        std::string created = directory + "/created.txt";
+        handle = fileSystem.openFile(created, FileOpenMode::OVERWRITE);
+        EXPECT(append(fileSystem, handle, "new"));
+        fileSystem.closeFile(handle);
+        EXPECT(readFile(created) == "new");
+
+        // TRUNCATE discards; preallocation is native only and sets the size
+        handle = fileSystem.openFile(path, FileOpenMode::TRUNCATE);
+        EXPECT(fileSystem.getFileSize(path) == 0);
+        EXPECT(append(fileSystem, handle, "fresh"));
+        bool preallocated = fileSystem.preallocateFile(handle, 8192);
+        fileSystem.closeFile(handle);
+        if (native)
+        {
+            EXPECT(preallocated);
+            EXPECT(fileSystem.getFileSize(path) == 8192);
+            EXPECT(readFile(path).compare(0, 5, "fresh") == 0);
+        }
+        else
+        {
+            EXPECT(!preallocated);
+            EXPECT(readFile(path) == "fresh");
+        }
+
+        // Directory listing and file times are native only
+        std::vector<std::string> names = {"kept"};
+        bool listed = fileSystem.listDirectory(directory, names);
+        uint64_t modifiedMs = 0;
+        bool timed = fileSystem.getFileModifiedTime(path, modifiedMs);
+        if (native)
+        {
+            EXPECT(listed);
+            std::sort(names.begin(), names.end());
+            EXPECT((names == std::vector<std::string>{"created.txt", "file.txt", "kept", "nested"}));
+            EXPECT(!fileSystem.listDirectory(directory + "/missing", names));
+
+            EXPECT(timed);
+            uint64_t nowMs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                       std::chrono::system_clock::now().time_since_epoch())
+                                                       .count());
+            EXPECT(modifiedMs <= nowMs && modifiedMs + 5000 > nowMs);
+            EXPECT(!fileSystem.getFileModifiedTime(directory + "/missing.txt", modifiedMs));
+            EXPECT(fileSystem.supportsDirectIo());
+        }
+        else
+        {
+            EXPECT(!listed && names.size() == 1);
+            EXPECT(!timed);
+            EXPECT(!fileSystem.supportsDirectIo());
+        }
+
+        EXPECT(fileSystem.renameFile(path, directory + "/renamed.txt"));
+        EXPECT(!fileSystem.fileExists(path));
+        EXPECT(fileSystem.deleteFile(directory + "/renamed.txt"));
+        EXPECT(fileSystem.deleteFile(created));
+        rmdir((directory + "/nested/deeper").c_str());
+        rmdir((directory + "/nested").c_str());
+        rmdir(directory.c_str());
+    }
+
+    void testPosixFileSystem()
+    {
+        auto fileSystem = Logger::createDefaultFileSystem();
+        checkHandleApi(*fileSystem, true);
+    }
+
+    void testStdioDefaults()
+    {
+        StdioFileSystem fileSystem;
+        checkHandleApi(fileSystem, false);
+    }
+
+    std::atomic<int> interruptions(0);
+
+    void onTimer(int)
+    {
+        interruptions.fetch_add(1);
+    }
+
+    // A FIFO drained slowly while a timer fires without SA_RESTART: writev()
+    // returns short counts and EINTR, and appendFileV() must carry on
+    void testInterruptedWrites()
+    {
+        std::string path = testDirectory("posix_fifo");
+        EXPECT(mkfifo(path.c_str(), 0600) == 0);
+
+        std::string received;
+        std::thread reader([&]
+                           {
+                               int fd = open(path.c_str(), O_RDONLY);
+                               char buffer[4096];
+                               for (;;)
+                               {
+                                   ssize_t n = read(fd, buffer, sizeof(buffer));
+                                   if (n < 0 && errno == EINTR)
+                                   {
+                                       continue;
+                                   }
+                                   if (n <= 0)
+                                   {
+                                       break;
+                                   }
+                                   received.append(buffer, static_cast<size_t>(n));
+                                   std::this_thread::sleep_for(std::chrono::microseconds(200));
+                               }
+                               close(fd);
+                           });
+
+        struct sigaction action = {};
+        action.sa_handler = onTimer; // No SA_RESTART
+        sigaction(SIGALRM, &action, nullptr);
+        itimerval timer = {{0, 500}, {0, 500}};
+        setitimer(ITIMER_REAL, &timer, nullptr);
+
+        auto fileSystem = Logger::createDefaultFileSystem();
+        FileHandle handle = fileSystem->openFile(path, FileOpenMode::APPEND);
+        EXPECT(handle != kInvalidFileHandle);
+        std::vector<std::string> pieces;
+        std::vector<WriteBuffer> buffers;
+        std::string expected;
+        for (int i = 0; i < 50; ++i)
+        {
+            pieces.push_back(std::string(1000 + i * 997, static_cast<char>('a' + i % 26)));
+        }
+        for (const std::string &piece : pieces)
+        {
+            buffers.push_back({piece.data(), piece.size()});
+            expected += piece;
+        }
+        for (int round = 0; round < 4; ++round)
+        {
+            EXPECT(fileSystem->appendFileV(handle, buffers.data(), buffers.size()));
+        }
+        EXPECT(fileSystem->appendFile(handle, expected.data(), expected.size()));
+
+        itimerval off = {};
+        setitimer(ITIMER_REAL, &off, nullptr);
+        fileSystem->closeFile(handle);
+        reader.join();
+        signal(SIGALRM, SIG_DFL);
+
+        EXPECT(interruptions.load() > 0);
+        EXPECT(received == expected + expected + expected + expected + expected);
+        std::remove(path.c_str());
+    }
+}
+
+int main()
+{
+    testPosixFileSystem();
+    testStdioDefaults();
+    testInterruptedWrites();
+
+    if (failures != 0)
+    {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All platform interface tests passed\n");
+    return 0;
+}
@@ -0,0 +1,269 @@
+// Unit tests for the shared-memory log ring
+/**
+ * @file test_shared_log_ring.cpp
+ * @brief Standalone tests for SharedLogRing ordering and crash containment
+ * @details Covers wraparound, a full ring, a producer that dies mid-write and
+ *          a producer that resumes after its slot was skipped and reused. The
+ *          producers that crash or stall are forked children whose message
+ *          sits on a page they cannot read, so push() faults part way through
+ *          its copy. Build against the library and run; exits non-zero if a
+ *          check fails.
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/shared_log_ring.h"
+
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace embedded_logger;
+
+namespace
+{
+    int failures = 0;
+
+#define EXPECT(condition)                                                     \
+    do                                                                        \
+    {                                                                         \
+        if (!(condition))                                                     \
+        {                                                                     \
+            fprintf(stderr, "%s:%d: FAILED: %s\n", __FILE__, __LINE__, #condition); \
+            ++failures;                                                       \
+        }                                                                     \
+    } while (0)
+
+    LogEntry makeEntry(const std::string &message)
+    {
+        LogEntry entry(LogLevel::INFO, "RING", message);
+        entry.timestamp = "2025-01-31 12:00:00.000";
+        entry.timestampMs = 1738324800000ULL;
+        entry.lineNumber = 42;
+        return entry;
+    }
+
+    bool popMessage(SharedLogRing &ring, std::string &message)
+    {
+        LogEntry entry;
+        if (!ring.pop(entry))
+        {
+            return false;
+        }
+        message = entry.message;
+        return true;
+    }
+
+    void testWraparound()
+    {
+        auto ring = SharedLogRing::createAnonymous(4);
+        EXPECT(ring != nullptr);
+        if (!ring)
+        {
+            return;
+        }
+
+        // Batches of three walk every slot through many positions
+        int next = 0;
+        int expected = 0;
+        for (int batch = 0; batch < 20; ++batch)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                EXPECT(ring->push(makeEntry("entry " + std::to_string(next++))));
+            }
+            for (int i = 0; i < 3; ++i)
+            {
+                std::string message;
+                EXPECT(popMessage(*ring, message));
+                EXPECT(message == "entry " + std::to_string(expected++));
+            }
+            std::string message;
+            EXPECT(!popMessage(*ring, message));
+        }
+
+        LogEntry entry;
+        EXPECT(ring->push(makeEntry("fields")));
+        EXPECT(ring->pop(entry));
+        EXPECT(entry.level == LogLevel::INFO && entry.component == "RING" && entry.lineNumber == 42);
+        EXPECT(entry.timestamp == "2025-01-31 12:00:00.000" && entry.timestampMs == 1738324800000ULL);
+        EXPECT(entry.processId == static_cast<uint32_t>(getpid()));
+
+        // Full: the fifth entry is dropped and counted, the first four survive
+        for (int i = 0; i < 4; ++i)
+        {
+            EXPECT(ring->push(makeEntry("full " + std::to_string(i))));
+        }
+        EXPECT(!ring->push(makeEntry("dropped")));
+        EXPECT(ring->getDroppedCount() == 1);
+        for (int i = 0; i < 4; ++i)
+        {
+            std::string message;
+            EXPECT(popMessage(*ring, message));
+            EXPECT(message == "full " + std::to_string(i));
+        }
+        EXPECT(ring->getAbandonedCount() == 0 && ring->getCorruptedCount() == 0);
+    }
+
+    // Child side: the page holding the message is unreadable, so push() faults
+    // after it has claimed a slot and copied the timestamp and component
+    char *unreadablePage = nullptr;
+    int resumeFd = -1;
+
+    void onFault(int)
+    {
+        // Stall until the parent says so, then let the copy carry on
+        char go;
+        if (read(resumeFd, &go, 1) != 1)
+        {
+            _exit(3);
+        }
+        mprotect(unreadablePage, static_cast<size_t>(sysconf(_SC_PAGESIZE)), PROT_READ | PROT_WRITE);
+    }
+
+    pid_t forkFaultingProducer(SharedLogRing &ring, int resumeReadFd)
+    {
+        pid_t child = fork();
+        if (child != 0)
+        {
+            return child;
+        }
+
+        // Large enough to get a mapping of its own from malloc
+        LogEntry entry = makeEntry(std::string(1 << 20, 'x'));
+        uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+        unreadablePage = reinterpret_cast<char *>(reinterpret_cast<uintptr_t>(entry.message.data()) & ~(pageSize - 1));
+        resumeFd = resumeReadFd;
+        if (resumeFd >= 0)
+        {
+            signal(SIGSEGV, onFault);
+        }
+        mprotect(unreadablePage, pageSize, PROT_NONE);
+        bool pushed = ring.push(entry);
+        _exit(pushed ? 1 : 0);
+    }
+
+    /// pop() until it returns an entry or timeoutMs passes
+    bool popWithin(SharedLogRing &ring, std::string &message, int timeoutMs)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        while (!popMessage(ring, message))
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    void testDeadProducerSlotIsAbandoned()
+    {
+        auto ring = SharedLogRing::createAnonymous(4);
+        EXPECT(ring != nullptr);
+        if (!ring)
+        {
+            return;
+        }
+        ring->setStallTimeout(60000); // A dead owner must not need the timeout
+
+        pid_t child = forkFaultingProducer(*ring, -1);
+        EXPECT(child > 0);
+        int status = 0;
+        waitpid(child, &status, 0);
+        EXPECT(WIFSIGNALED(status) && WTERMSIG(status) == SIGSEGV);
+
+        EXPECT(ring->push(makeEntry("after the crash")));
+        std::string message;
+        EXPECT(popWithin(*ring, message, 1000));
+        EXPECT(message == "after the crash");
+        EXPECT(ring->getAbandonedCount() == 1);
+        EXPECT(!popMessage(*ring, message));
+
+        // The skipped slot is usable again once the ring wraps
+        for (int i = 0; i < 8; ++i)
+        {
+            EXPECT(ring->push(makeEntry("reuse " + std::to_string(i))));
+            EXPECT(popMessage(*ring, message));
+            EXPECT(message == "reuse " + std::to_string(i));
+        }
+        EXPECT(ring->getCorruptedCount() == 0);
+    }
+
+    // A producer stalls mid-write, its slot is skipped, and the slot's next
+    // position is claimed and committed before the producer resumes. Its late
+    // bytes must never be read back as an entry.
+    void testLateProducerCannotPublish()
+    {
+        auto ring = SharedLogRing::createAnonymous(4);
+        EXPECT(ring != nullptr);
+        if (!ring)
+        {
+            return;
+        }
+        ring->setStallTimeout(10);
+
+        int resume[2];
+        EXPECT(pipe(resume) == 0);
+        pid_t child = forkFaultingProducer(*ring, resume[0]);
+        EXPECT(child > 0);
+
+        // Wait for the claim and for the stall timeout to skip it
+        std::string message;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (ring->getAbandonedCount() == 0 && std::chrono::steady_clock::now() < deadline)
+        {
+            EXPECT(!popMessage(*ring, message));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        EXPECT(ring->getAbandonedCount() == 1);
+
+        // Four entries: the last lands in the stalled producer's slot
+        for (int i = 0; i < 4; ++i)
+        {
+            EXPECT(ring->push(makeEntry("entry " + std::to_string(i))));
+        }
+
+        char go = 1;
+        EXPECT(write(resume[1], &go, 1) == 1);
+        int status = 0;
+        waitpid(child, &status, 0);
+        EXPECT(WIFEXITED(status) && WEXITSTATUS(status) == 0); // Its push() reported failure
+        close(resume[0]);
+        close(resume[1]);
+
+        int popped = 0;
+        while (popMessage(*ring, message))
+        {
+            EXPECT(message.find("xxxx") == std::string::npos);
+            EXPECT(message == "entry " + std::to_string(popped));
+            ++popped;
+        }
+        EXPECT(popped == 3);
+        EXPECT(ring->getCorruptedCount() == 1);
+    }
+}
+
+int main()
+{
+    testWraparound();
+    testDeadProducerSlotIsAbandoned();
+    testLateProducerCannotPublish();
+
+    if (failures != 0)
+    {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All shared log ring tests passed\n");
+    return 0;
+}
@@ -1 +1,424 @@
-// Unit tests for specialized logging 
+// Unit tests for specialized logging
+/**
+ * @file test_specialized_logging.cpp
+ * @brief Standalone tests for the CAN and MAVLink recorders and their readers
+ * @details Build against the library and run; exits non-zero if any check
+ *          failed. Files go to /tmp and are left for inspection on failure.
+ * @version 1.0.0
+ * @date 2025-01-31
+ * @author Embedded Logger Library
+ */
+
+#include "embedded_logger/can_frame_logger.h"
+#include "embedded_logger/mavlink_tlog_recorder.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace embedded_logger;
+
+namespace
+{
+    int failures = 0;
+
+#define EXPECT(condition)                                                     \
+    do                                                                        \
+    {                                                                         \
+        if (!(condition))                                                     \
+        {                                                                     \
+            fprintf(stderr, "%s:%d: FAILED: %s\n", __FILE__, __LINE__, #condition); \
+            ++failures;                                                       \
+        }                                                                     \
+    } while (0)
+
+    std::string readFile(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    std::string testDirectory(const std::string &name)
+    {
+        return "/tmp/embedded_logger_test_" + name + "_" +
+               std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+
+    CanFrame makeFrame(uint64_t timestampUs, uint8_t channel, uint32_t canId, const char *hex)
+    {
+        CanFrame frame;
+        frame.timestampUs = timestampUs;
+        frame.channel = channel;
+        frame.canId = canId;
+        for (size_t i = 0; hex[2 * i] != '\0' && i < 8; ++i)
+        {
+            unsigned value = 0;
+            sscanf(hex + 2 * i, "%2x", &value);
+            frame.data[i] = static_cast<uint8_t>(value);
+            frame.dlc = static_cast<uint8_t>(i + 1);
+        }
+        return frame;
+    }
+
+    bool sameFrame(const CanFrame &a, const CanFrame &b)
+    {
+        return a.timestampUs == b.timestampUs && a.channel == b.channel && a.canId == b.canId && a.dlc == b.dlc &&
+               std::memcmp(a.data, b.data, sizeof(a.data)) == 0;
+    }
+
+    // Identifier, RTR, error and DLC rules follow can-utils' candump -l output
+    void testCandumpFormat()
+    {
+        const uint64_t at = 1436509052249713ULL;
+        EXPECT(CanFrameLogger::formatCandump(makeFrame(at, 0, 0x18FEF100 | kCanEffFlag, "0102030405060708"), "can0") ==
+               "(1436509052.249713) can0 18FEF100#0102030405060708");
+        EXPECT(CanFrameLogger::formatCandump(makeFrame(at, 1, 0x123, "deadbeef"), "vcan1") ==
+               "(1436509052.249713) vcan1 123#DEADBEEF");
+        EXPECT(CanFrameLogger::formatCandump(makeFrame(at, 0, 0x7FF, ""), "can0") == "(1436509052.249713) can0 7FF#");
+        EXPECT(CanFrameLogger::formatCandump(makeFrame(at, 0, 0x123 | kCanRtrFlag, ""), "can0") ==
+               "(1436509052.249713) can0 123#R");
+        EXPECT(CanFrameLogger::formatCandump(makeFrame(at, 0, 0x1ABCDE | kCanEffFlag | kCanRtrFlag, ""), "can0") ==
+               "(1436509052.249713) can0 001ABCDE#R");
+        EXPECT(CanFrameLogger::formatCandump(makeFrame(at, 0, 0x004 | kCanErrFlag, "0000000000000000"), "can0") ==
+               "(1436509052.249713) can0 20000004#0000000000000000");
+        EXPECT(CanFrameLogger::formatCandump(makeFrame(5, 0, 0x1, "00"), "can0") == "(0000000000.000005) can0 001#00");
+    }
+
+    // Every kind of frame comes back as logged, including across the 24-bit
+    // timestamp wrap that sync records cover
+    void testRoundTrip()
+    {
+        CanFrameLoggerConfig config;
+        config.logDirectory = testDirectory("can_round_trip");
+        CanFrameLogger logger(config);
+        EXPECT(logger.start());
+
+        std::vector<CanFrame> sent;
+        const uint64_t start = 1436509052249713ULL; // 2015, as in the candump example
+        const uint32_t ids[] = {0x123, 0x7FF, 0x18FEF100 | kCanEffFlag, 0x321 | kCanRtrFlag, 0x004 | kCanErrFlag};
+        for (int i = 0; i < 300; ++i)
+        {
+            CanFrame frame;
+            frame.timestampUs = start + static_cast<uint64_t>(i) * 250000; // 75 s, several sync epochs
+            frame.channel = static_cast<uint8_t>(i % 15);
+            frame.canId = ids[i % 5];
+            frame.dlc = static_cast<uint8_t>(i % 9);
+            for (uint8_t b = 0; b < frame.dlc; ++b)
+            {
+                frame.data[b] = static_cast<uint8_t>(i * 7 + b);
+            }
+            EXPECT(logger.logFrame(frame.channel, frame.canId, frame.data, frame.dlc, frame.timestampUs));
+            sent.push_back(frame);
+        }
+
+        // DLC above 8 is clamped, no data with DLC 0 is fine
+        uint8_t longData[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+        EXPECT(logger.logFrame(2, 0x555, longData, 12, start + 80000000));
+        sent.push_back(makeFrame(start + 80000000, 2, 0x555, "0102030405060708"));
+        EXPECT(logger.logFrame(3, 0x556, nullptr, 0, start + 80000001));
+        sent.push_back(makeFrame(start + 80000001, 3, 0x556, ""));
+
+        std::string path = logger.getCurrentFile();
+        logger.stop();
+        EXPECT(logger.getDroppedCount() == 0);
+        EXPECT(logger.getFrameCount() == sent.size());
+
+        std::vector<CanFrame> read;
+        EXPECT(CanFrameLogger::readFile(path, read));
+        EXPECT(read.size() == sent.size());
+        for (size_t i = 0; i < read.size() && i < sent.size(); ++i)
+        {
+            if (!sameFrame(read[i], sent[i]))
+            {
+                fprintf(stderr, "frame %zu differs: %s\n", i, CanFrameLogger::formatCandump(read[i], "can").c_str());
+                ++failures;
+                break;
+            }
+        }
+
+        // Export names the channels given and defaults the rest
+        std::string candump = config.logDirectory + "/out.log";
+        EXPECT(CanFrameLogger::exportCandump(path, candump, {"vcan0", "vcan1"}) == static_cast<long>(sent.size()));
+        std::string text = readFile(candump);
+        std::string expected;
+        for (const CanFrame &frame : sent)
+        {
+            std::string name = frame.channel < 2 ? "vcan" + std::to_string(frame.channel)
+                                                 : "can" + std::to_string(frame.channel);
+            expected += CanFrameLogger::formatCandump(frame, name) + "\n";
+        }
+        EXPECT(text == expected);
+        EXPECT(text.find("(1436509052.249713) vcan0 123#\n") == 0);
+    }
+
+    // Rotation happens between batches, and each file starts with its own sync
+    // record, so every file decodes on its own
+    void testRotatedFilesDecodeAlone()
+    {
+        CanFrameLoggerConfig config;
+        config.logDirectory = testDirectory("can_rotation");
+        config.maxFileSize = 64 * sizeof(CanFrameRecord);
+        config.maxBackupFiles = 100;
+        config.batchFrames = 16;
+        CanFrameLogger logger(config);
+        EXPECT(logger.start());
+
+        const uint64_t start = 1700000000000000ULL;
+        const int count = 1000;
+        for (int i = 0; i < count; ++i)
+        {
+            uint8_t data[4];
+            std::memcpy(data, &i, sizeof(data));
+            EXPECT(logger.logFrame(0, 0x100, data, 4, start + static_cast<uint64_t>(i) * 100000));
+            if (i % 16 == 15)
+            {
+                logger.flush();
+            }
+        }
+        std::string path = logger.getCurrentFile();
+        logger.stop();
+
+        std::vector<CanFrame> all;
+        int files = 0;
+        for (int backup = config.maxBackupFiles; backup >= 0; --backup)
+        {
+            std::string file = backup == 0 ? path : path + "." + std::to_string(backup);
+            if (!std::ifstream(file).good())
+            {
+                continue;
+            }
+            ++files;
+            EXPECT(CanFrameLogger::readFile(file, all));
+        }
+        EXPECT(files > 2);
+        EXPECT(all.size() == static_cast<size_t>(count));
+        for (size_t i = 0; i < all.size(); ++i)
+        {
+            int index;
+            std::memcpy(&index, all[i].data, sizeof(index));
+            if (index != static_cast<int>(i) || all[i].timestampUs != start + i * 100000)
+            {
+                fprintf(stderr, "rotated frame %zu decoded as %d at %llu\n", i, index,
+                        static_cast<unsigned long long>(all[i].timestampUs));
+                ++failures;
+                break;
+            }
+        }
+    }
+
+    void testRejectsOtherFiles()
+    {
+        std::string directory = testDirectory("can_reject");
+        CanFrameLoggerConfig config;
+        config.logDirectory = directory;
+        CanFrameLogger logger(config);
+        EXPECT(logger.start()); // Creates the directory
+        logger.stop();
+
+        std::string text = directory + "/not_can.can";
+        std::ofstream(text) << "# Embedded Logger Library Log File\n";
+        std::vector<CanFrame> frames;
+        EXPECT(!CanFrameLogger::readFile(text, frames));
+        EXPECT(frames.empty());
+        EXPECT(!CanFrameLogger::readFile(directory + "/missing.can", frames));
+        EXPECT(CanFrameLogger::exportCandump(text, directory + "/out.log") == -1);
+    }
+
+    // The default file system, with writes that can be held up so the
+    // recorder's queue fills behind a busy writer
+    class StallingFileSystem : public IFileSystem
+    {
+    public:
+        std::atomic<bool> stalled{false};
+        std::atomic<int> writesStarted{0};
+
+        bool fileExists(const std::string &path) override { return inner_->fileExists(path); }
+        bool createDirectory(const std::string &path) override { return inner_->createDirectory(path); }
+        size_t getFileSize(const std::string &path) override { return inner_->getFileSize(path); }
+        bool deleteFile(const std::string &path) override { return inner_->deleteFile(path); }
+        bool renameFile(const std::string &oldPath, const std::string &newPath) override
+        {
+            return inner_->renameFile(oldPath, newPath);
+        }
+        bool appendFileV(FileHandle handle, const WriteBuffer *buffers, size_t count) override
+        {
+            writesStarted.fetch_add(1);
+            while (stalled.load())
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return IFileSystem::appendFileV(handle, buffers, count);
+        }
+
+    private:
+        std::unique_ptr<IFileSystem> inner_ = Logger::createDefaultFileSystem();
+    };
+
+    /// MAVLink v1 HEARTBEAT: magic, length 9, seq, sysid, compid, msgid 0, payload, CRC
+    std::vector<uint8_t> heartbeatV1(uint8_t sequence)
+    {
+        std::vector<uint8_t> packet = {0xFE, 9, sequence, 1, 1, 0};
+        packet.resize(6 + 9 + 2, sequence);
+        return packet;
+    }
+
+    std::vector<uint8_t> syntheticPacket(SyntheticMavlinkGenerator &generator)
+    {
+        uint8_t buffer[kMavlinkMaxPacketSize];
+        size_t length = generator.next(buffer, sizeof(buffer));
+        return std::vector<uint8_t>(buffer, buffer + length);
+    }
+
+    // Packets and timestamps come back byte for byte, v1 and v2 alike, and a
+    // packet cut off at the end of the file is skipped
+    void testTlogRoundTrip()
+    {
+        TlogRecorderConfig config;
+        config.logDirectory = testDirectory("tlog_round_trip");
+        config.dropReportIntervalMs = 0;
+        MavlinkTlogRecorder recorder(config);
+        EXPECT(recorder.start());
+
+        SyntheticMavlinkGenerator generator(7);
+        std::vector<TlogPacket> sent;
+        for (int i = 0; i < 1000; ++i)
+        {
+            TlogPacket packet;
+            packet.timestampUs = 1700000000000000ULL + static_cast<uint64_t>(i) * 20000;
+            packet.data = i % 100 == 0 ? heartbeatV1(static_cast<uint8_t>(i)) : syntheticPacket(generator);
+            EXPECT(recorder.recordPacket(packet.data.data(), packet.data.size(), packet.timestampUs));
+            sent.push_back(packet);
+            if (i % 200 == 199)
+            {
+                recorder.flush(); // Keeps the default pool from filling
+            }
+        }
+        std::string path = recorder.getCurrentFile();
+        recorder.stop();
+        TlogDropStats drops = recorder.getDropStats();
+        EXPECT(drops.poolExhausted == 0 && drops.overwritten == 0 && drops.oversize == 0);
+        EXPECT(recorder.getPacketCount() == sent.size());
+
+        std::vector<TlogPacket> read;
+        EXPECT(MavlinkTlogRecorder::readFile(path, read));
+        EXPECT(read.size() == sent.size());
+        size_t matching = 0;
+        for (size_t i = 0; i < read.size() && i < sent.size(); ++i)
+        {
+            matching += read[i].timestampUs == sent[i].timestampUs && read[i].data == sent[i].data ? 1 : 0;
+        }
+        EXPECT(matching == sent.size());
+
+        // Big-endian receive time ahead of each packet, as ground stations expect
+        std::string bytes = readFile(path);
+        EXPECT(bytes.size() > 8 && static_cast<uint8_t>(bytes[0]) == 0x00 &&
+               static_cast<uint8_t>(bytes[7]) == (1700000000000000ULL & 0xFF) &&
+               static_cast<uint8_t>(bytes[8]) == 0xFE);
+
+        std::ofstream(path, std::ios::binary | std::ios::app).write(bytes.data(), 8 + 5);
+        read.clear();
+        EXPECT(MavlinkTlogRecorder::readFile(path, read));
+        EXPECT(read.size() == sent.size());
+    }
+
+    // With every buffer queued behind a stalled write, DROP_OLDEST gives up
+    // the oldest queued packets and counts each one; DROP_NEWEST refuses the
+    // new ones instead
+    void testTlogDropPolicies()
+    {
+        const TlogDropPolicy policies[] = {TlogDropPolicy::DROP_OLDEST, TlogDropPolicy::DROP_NEWEST};
+        for (TlogDropPolicy policy : policies)
+        {
+            bool oldest = policy == TlogDropPolicy::DROP_OLDEST;
+            TlogRecorderConfig config;
+            config.logDirectory = testDirectory(oldest ? "tlog_drop_oldest" : "tlog_drop_newest");
+            config.poolBuffers = 4;
+            config.dropPolicy = policy;
+            config.dropReportIntervalMs = 0;
+            auto fileSystem = std::make_unique<StallingFileSystem>();
+            StallingFileSystem *stalling = fileSystem.get();
+            MavlinkTlogRecorder recorder(config, std::move(fileSystem));
+            EXPECT(recorder.start());
+
+            SyntheticMavlinkGenerator generator(3);
+            std::vector<std::vector<uint8_t>> packets;
+            for (int i = 0; i < 10; ++i)
+            {
+                packets.push_back(syntheticPacket(generator));
+            }
+
+            // Packet 0 is taken by the writer and held there; 1-3 fill the pool
+            stalling->stalled.store(true);
+            EXPECT(recorder.recordPacket(packets[0].data(), packets[0].size(), 1000));
+            for (int waitedMs = 0; waitedMs < 5000 && stalling->writesStarted.load() == 0; ++waitedMs)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            EXPECT(stalling->writesStarted.load() == 1);
+            size_t accepted = 0;
+            for (int i = 1; i < 10; ++i)
+            {
+                accepted += recorder.recordPacket(packets[i].data(), packets[i].size(), 1000 + i) ? 1 : 0;
+            }
+
+            std::vector<uint8_t> oversize(config.maxPacketSize + 1, 0xFD);
+            EXPECT(!recorder.recordPacket(oversize.data(), oversize.size()));
+
+            stalling->stalled.store(false);
+            std::string path = recorder.getCurrentFile();
+            recorder.stop();
+
+            TlogDropStats drops = recorder.getDropStats();
+            EXPECT(drops.oversize == 1);
+            std::vector<TlogPacket> read;
+            EXPECT(MavlinkTlogRecorder::readFile(path, read));
+            EXPECT(read.size() == 4);
+            EXPECT(recorder.getPacketCount() == 4);
+
+            // Written: the stalled packet, then the three newest (oldest) or the three first (newest)
+            std::vector<int> expected = oldest ? std::vector<int>{0, 7, 8, 9} : std::vector<int>{0, 1, 2, 3};
+            if (oldest)
+            {
+                EXPECT(accepted == 9);
+                EXPECT(drops.overwritten == 6 && drops.poolExhausted == 0);
+            }
+            else
+            {
+                EXPECT(accepted == 3);
+                EXPECT(drops.poolExhausted == 6 && drops.overwritten == 0);
+            }
+            for (size_t i = 0; i < read.size() && i < expected.size(); ++i)
+            {
+                EXPECT(read[i].data == packets[expected[i]]);
+                EXPECT(read[i].timestampUs == static_cast<uint64_t>(1000 + expected[i]));
+            }
+        }
+    }
+}
+
+int main()
+{
+    testCandumpFormat();
+    testRoundTrip();
+    testRotatedFilesDecodeAlone();
+    testRejectsOtherFiles();
+    testTlogRoundTrip();
+    testTlogDropPolicies();
+
+    if (failures != 0)
+    {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All specialized logging tests passed\n");
+    return 0;
+}
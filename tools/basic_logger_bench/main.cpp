@@ -0,0 +1,178 @@
+/**
+ * @file main.cpp
+ * @brief Compares BasicLogger with Logger on the same entries
+ * @details Logs N entries to a file through Logger (asynchronous and
+ *          synchronous) and through the two BasicLogger instantiations, and
+ *          prints the time per call, the time per entry until it is in the
+ *          file, and the time per call for an entry below the level.
+ *
+ *          For code size, build this file twice more with
+ *          -DBASIC_LOGGER_BENCH_ONLY_BASIC and -DBASIC_LOGGER_BENCH_ONLY_LOGGER
+ *          (plus -ffunction-sections -fdata-sections -Wl,--gc-sections), link
+ *          both against the library and compare them with size(1); each build
+ *          then references a single logger.
+ *
+ * Usage:
+ * @code
+ * basic_logger_bench [--entries N] [--dir DIR]
+ * @endcode
+ *
+ * DIR (default /tmp/basic_logger_bench) is created if its parent exists.
+ */
+
+#include "embedded_logger/basic_logger.h"
+#include "embedded_logger/logger.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace embedded_logger;
+
+namespace
+{
+    struct Timing
+    {
+        double callNs;     ///< Per logged entry, returning from the call
+        double onDiskNs;   ///< Per logged entry, including the flush/shutdown that wrote it
+        double filteredNs; ///< Per call below the level
+    };
+
+    LoggerConfig benchConfig(const std::string &directory, const char *name)
+    {
+        LoggerConfig config;
+        config.logDirectory = directory;
+        config.logFilePrefix = name;
+        config.defaultDestination = LogDestination::FILE_ONLY;
+        config.consoleLogLevel = LogLevel::CRITICAL; // Logger's info()/debug() default to BOTH
+        config.fileLogLevel = LogLevel::INFO;
+        config.maxFileSize = 8 * 1024 * 1024;
+        config.maxBackupFiles = 2;
+        config.forkSafe = false;
+        return config;
+    }
+
+    /// Same clock and format as Logger's default time provider
+    class SystemTimeProvider : public ITimeProvider
+    {
+    public:
+        std::string getCurrentDateTime() override
+        {
+            char buffer[32];
+            policy_.formatDateTime(policy_.nowMs(), buffer, sizeof(buffer));
+            return buffer;
+        }
+        uint64_t getUnixTimestampMs() override { return policy_.nowMs(); }
+
+    private:
+        SystemTimePolicy policy_;
+    };
+
+    double nanosecondsSince(std::chrono::steady_clock::time_point start, int count)
+    {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+    }
+
+    /// The same three measurements for any logger with info/debug(component, message)
+    template <typename LoggerType, typename Finish>
+    Timing measure(LoggerType &logger, int entries, Finish finish)
+    {
+        Timing timing;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < entries; ++i)
+        {
+            logger.info("BMS", "Pack balanced, cell delta within limits");
+        }
+        timing.callNs = nanosecondsSince(start, entries);
+        finish();
+        timing.onDiskNs = nanosecondsSince(start, entries);
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < entries; ++i)
+        {
+            logger.debug("BMS", "Cell voltages sampled");
+        }
+        timing.filteredNs = nanosecondsSince(start, entries);
+        return timing;
+    }
+
+    void printTiming(const char *name, const Timing &timing)
+    {
+        printf("%-22s %10.1f %10.1f %12.1f\n", name, timing.callNs, timing.onDiskNs, timing.filteredNs);
+    }
+
+#ifndef BASIC_LOGGER_BENCH_ONLY_BASIC
+    void benchLogger(const std::string &directory, int entries, bool async)
+    {
+        LoggerConfig config = benchConfig(directory, async ? "logger_async" : "logger_sync");
+        config.asyncLogging = async;
+        Logger logger(config);
+        if (!logger.initialize())
+        {
+            fprintf(stderr, "Cannot log to %s\n", directory.c_str());
+            return;
+        }
+        printTiming(async ? "Logger (async)" : "Logger (sync)", measure(logger, entries, [&logger]
+                                                                         { logger.flush(); }));
+        logger.shutdown();
+    }
+#endif
+
+#ifndef BASIC_LOGGER_BENCH_ONLY_LOGGER
+    template <typename LoggerType, typename... Policies>
+    void benchBasicLogger(const char *name, const std::string &directory, int entries, Policies &&...policies)
+    {
+        LoggerType logger(benchConfig(directory, name), std::forward<Policies>(policies)...);
+        if (!logger.initialize())
+        {
+            fprintf(stderr, "Cannot log to %s\n", directory.c_str());
+            return;
+        }
+        printTiming(name, measure(logger, entries, [&logger]
+                                  { logger.flush(); }));
+        logger.shutdown();
+    }
+#endif
+}
+
+int main(int argc, char **argv)
+{
+    int entries = 200000;
+    std::string directory = "/tmp/basic_logger_bench";
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--entries") == 0 && i + 1 < argc)
+        {
+            entries = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--dir") == 0 && i + 1 < argc)
+        {
+            directory = argv[++i];
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [--entries N] [--dir DIR]\n", argv[0]);
+            return 2;
+        }
+    }
+    entries = entries > 0 ? entries : 1;
+
+    printf("%-22s %10s %10s %12s\n", "logger", "call ns", "on disk ns", "filtered ns");
+#ifndef BASIC_LOGGER_BENCH_ONLY_BASIC
+    benchLogger(directory, entries, true);
+    benchLogger(directory, entries, false);
+#endif
+#ifndef BASIC_LOGGER_BENCH_ONLY_LOGGER
+    benchBasicLogger<StaticBasicLogger>("StaticBasicLogger", directory, entries);
+#ifndef BASIC_LOGGER_BENCH_ONLY_BASIC
+    // Through the ITimeProvider/IFileSystem interfaces Logger uses
+    SystemTimeProvider time;
+    auto fileSystem = Logger::createDefaultFileSystem();
+    benchBasicLogger<RuntimeBasicLogger>("RuntimeBasicLogger", directory, entries, RuntimeTimePolicy(time),
+                                         RuntimeFileSystemPolicy(*fileSystem));
+#endif
+#endif
+    return 0;
+}
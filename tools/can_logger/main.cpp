@@ -0,0 +1,255 @@
+/**
+ * @file main.cpp
+ * @brief CAN recorder and .can to candump converter
+ * @details Records SocketCAN interfaces (including vcan) or synthetic traffic
+ *          into .can files, and converts .can files to candump log format.
+ *
+ * Usage:
+ * @code
+ * can_logger record --dir DIR (--iface NAME ... | --synthetic COUNT [--rate FPS] [--channels N])
+ * can_logger export INPUT.can OUTPUT.log [--names can0,can1,...]
+ * @endcode
+ *
+ * Recording from interfaces runs until SIGINT/SIGTERM. A synthetic run
+ * reports achieved rate and drops, which makes it a quick throughput check
+ * without hardware.
+ */
+
+#include "embedded_logger/can_frame_logger.h"
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace embedded_logger;
+
+namespace
+{
+    volatile std::sig_atomic_t stopRequested = 0;
+
+    void onSignal(int)
+    {
+        stopRequested = 1;
+    }
+
+    void printUsage(const char *program)
+    {
+        fprintf(stderr,
+                "Usage: %s record --dir DIR (--iface NAME ... | --synthetic COUNT [--rate FPS] [--channels N])\n"
+                "       %s export INPUT.can OUTPUT.log [--names can0,can1,...]\n",
+                program, program);
+    }
+
+    std::vector<std::string> splitNames(const std::string &list)
+    {
+        std::vector<std::string> names;
+        size_t start = 0;
+        while (start <= list.size())
+        {
+            size_t comma = list.find(',', start);
+            if (comma == std::string::npos)
+            {
+                comma = list.size();
+            }
+            names.push_back(list.substr(start, comma - start));
+            start = comma + 1;
+        }
+        return names;
+    }
+
+    int runSynthetic(CanFrameLogger &logger, unsigned long count, unsigned long rate, uint8_t channels)
+    {
+        SyntheticCanFrameGenerator generator(1, channels);
+        CanFrame frame;
+        auto begin = std::chrono::steady_clock::now();
+
+        for (unsigned long i = 0; i < count && !stopRequested; ++i)
+        {
+            generator.next(frame);
+            logger.logFrame(frame.channel, frame.canId, frame.data, frame.dlc);
+
+            if (rate != 0)
+            {
+                auto due = begin + std::chrono::microseconds(i * 1000000ULL / rate);
+                std::this_thread::sleep_until(due);
+            }
+        }
+
+        logger.flush();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        printf("can_logger: %llu frames written, %llu dropped, %.0f frames/s\n",
+               static_cast<unsigned long long>(logger.getFrameCount()),
+               static_cast<unsigned long long>(logger.getDroppedCount()),
+               seconds > 0 ? static_cast<double>(logger.getFrameCount()) / seconds : 0.0);
+        return 0;
+    }
+
+    int runInterfaces(CanFrameLogger &logger, const std::vector<std::string> &interfaces)
+    {
+#ifdef __linux__
+        std::vector<pollfd> fds;
+        for (const std::string &name : interfaces)
+        {
+            int fd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+            sockaddr_can addr{};
+            addr.can_family = AF_CAN;
+            addr.can_ifindex = static_cast<int>(if_nametoindex(name.c_str()));
+            if (fd < 0 || addr.can_ifindex == 0 ||
+                bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+            {
+                fprintf(stderr, "can_logger: cannot open %s: %s\n", name.c_str(), strerror(errno));
+                if (fd >= 0)
+                {
+                    close(fd);
+                }
+                return 1;
+            }
+
+            // Record error frames too
+            can_err_mask_t errorMask = CAN_ERR_MASK;
+            setsockopt(fd, SOL_CAN_RAW, CAN_RAW_ERR_FILTER, &errorMask, sizeof(errorMask));
+            fds.push_back({fd, POLLIN, 0});
+        }
+
+        while (!stopRequested)
+        {
+            if (poll(fds.data(), fds.size(), 200) <= 0)
+            {
+                continue;
+            }
+
+            for (size_t channel = 0; channel < fds.size(); ++channel)
+            {
+                if (!(fds[channel].revents & POLLIN))
+                {
+                    continue;
+                }
+
+                can_frame frame;
+                if (read(fds[channel].fd, &frame, sizeof(frame)) == static_cast<ssize_t>(sizeof(frame)))
+                {
+                    logger.logFrame(static_cast<uint8_t>(channel), frame.can_id, frame.data, frame.can_dlc);
+                }
+            }
+        }
+
+        for (const pollfd &entry : fds)
+        {
+            close(entry.fd);
+        }
+        logger.flush();
+        printf("can_logger: %llu frames written, %llu dropped\n",
+               static_cast<unsigned long long>(logger.getFrameCount()),
+               static_cast<unsigned long long>(logger.getDroppedCount()));
+        return 0;
+#else
+        (void)logger;
+        (void)interfaces;
+        fprintf(stderr, "can_logger: SocketCAN capture requires Linux\n");
+        return 1;
+#endif
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    std::string command = argv[1];
+    if (command == "export")
+    {
+        if (argc != 4 && !(argc == 6 && std::string(argv[4]) == "--names"))
+        {
+            printUsage(argv[0]);
+            return 2;
+        }
+
+        std::vector<std::string> names;
+        if (argc == 6)
+        {
+            names = splitNames(argv[5]);
+        }
+
+        long exported = CanFrameLogger::exportCandump(argv[2], argv[3], names);
+        if (exported < 0)
+        {
+            return 1;
+        }
+        printf("can_logger: exported %ld frames to %s\n", exported, argv[3]);
+        return 0;
+    }
+
+    if (command != "record")
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    CanFrameLoggerConfig config;
+    std::vector<std::string> interfaces;
+    unsigned long synthetic = 0;
+    unsigned long rate = 0;
+    int channels = 1;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--dir" && hasValue)
+            config.logDirectory = argv[++i];
+        else if (arg == "--iface" && hasValue)
+            interfaces.push_back(argv[++i]);
+        else if (arg == "--synthetic" && hasValue)
+            synthetic = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--rate" && hasValue)
+            rate = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--channels" && hasValue)
+            channels = std::atoi(argv[++i]);
+        else
+        {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (interfaces.empty() == (synthetic == 0))
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    CanFrameLogger logger(config);
+    if (!logger.start())
+    {
+        return 1;
+    }
+    printf("can_logger: recording to %s\n", logger.getCurrentFile().c_str());
+
+    int result = interfaces.empty()
+                     ? runSynthetic(logger, synthetic, rate, static_cast<uint8_t>(channels))
+                     : runInterfaces(logger, interfaces);
+    logger.stop();
+    return result;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file main.cpp
+ * @brief Compares the table-driven hex encoder with a snprintf loop
+ * @details Encodes payloads of typical logBinary() sizes (a CAN frame, a
+ *          MAVLink message, the default maxBinaryPayloadSize and a large
+ *          dump) with formatting::appendHex() and with one snprintf("%02x ")
+ *          per byte, checks that both produce the same text and prints the
+ *          time per call and per byte. The snprintf loop is what the encoder
+ *          replaced; run it on the target to see the difference there.
+ *
+ * Usage:
+ * @code
+ * hex_bench [--iterations N]
+ * @endcode
+ *
+ * Exits non-zero if any output differs.
+ */
+
+#include "embedded_logger/log_formatter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace embedded_logger;
+
+namespace
+{
+    void snprintfHex(std::string &out, const void *data, size_t size)
+    {
+        const auto *bytes = static_cast<const uint8_t *>(data);
+        char pair[4];
+        for (size_t i = 0; i < size; ++i)
+        {
+            snprintf(pair, sizeof(pair), i + 1 < size ? "%02x " : "%02x", bytes[i]);
+            out += pair;
+        }
+    }
+
+    double nanosecondsPerCall(void (*encode)(std::string &, const void *, size_t), const std::vector<uint8_t> &payload,
+                              int iterations)
+    {
+        // One string reused across calls, as the writer reuses its line buffer
+        std::string out;
+        volatile size_t sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            out.clear();
+            encode(out, payload.data(), payload.size());
+            sink = sink + out.size();
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 200000;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+        {
+            iterations = atoi(argv[++i]);
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [--iterations N]\n", argv[0]);
+            return 2;
+        }
+    }
+    iterations = iterations > 0 ? iterations : 1;
+
+    const size_t sizes[] = {8, 64, 256, 4096};
+    int mismatches = 0;
+    printf("%-8s %12s %12s %10s %10s\n", "bytes", "table ns", "snprintf ns", "table/B", "snprintf/B");
+    for (size_t size : sizes)
+    {
+        std::vector<uint8_t> payload(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            payload[i] = static_cast<uint8_t>(i * 131 + 7);
+        }
+
+        std::string table;
+        std::string libc;
+        formatting::appendHex(table, payload.data(), payload.size());
+        snprintfHex(libc, payload.data(), payload.size());
+        if (table != libc)
+        {
+            fprintf(stderr, "%zu bytes: \"%.32s...\" != \"%.32s...\"\n", size, table.c_str(), libc.c_str());
+            ++mismatches;
+            continue;
+        }
+
+        // Same total bytes for every size
+        int calls = static_cast<int>(std::max<size_t>(1, static_cast<size_t>(iterations) * 64 / size));
+        double tableNs = nanosecondsPerCall(formatting::appendHex, payload, calls);
+        double libcNs = nanosecondsPerCall(snprintfHex, payload, calls);
+        printf("%-8zu %12.1f %12.1f %10.2f %10.2f\n", size, tableNs, libcNs, tableNs / size, libcNs / size);
+    }
+    return mismatches != 0 ? 1 : 0;
+}
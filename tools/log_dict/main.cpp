@@ -0,0 +1,285 @@
+/**
+ * @file main.cpp
+ * @brief Trains log compression dictionaries and benchmarks block compression
+ * @details "train" builds a dictionary from existing log files for
+ *          LoggerConfig::compressionDictionaryPath. "bench" cuts log files
+ *          into blocks of the given sizes (at line boundaries, like the
+ *          logger's write batches) and reports compression ratio and speed
+ *          with and without the dictionary. "cat" prints a compressed log
+ *          file as plain text for the other tools.
+ *
+ * Usage:
+ * @code
+ * log_dict train -o DICT [--size BYTES] [--block BYTES] LOGFILE...
+ * log_dict bench [--dict DICT] [--block BYTES[,BYTES...]] LOGFILE...
+ * log_dict cat [--dict DICT] LOGFILE
+ * @endcode
+ *
+ * Train on older logs and bench on newer ones: benchmarking on the training
+ * files overstates the gain.
+ */
+
+#include "embedded_logger/log_compression.h"
+#include "embedded_logger/logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace embedded_logger;
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    void printUsage(const char *program)
+    {
+        fprintf(stderr,
+                "Usage: %s train -o DICT [--size BYTES] [--block BYTES] LOGFILE...\n"
+                "       %s bench [--dict DICT] [--block BYTES[,BYTES...]] LOGFILE...\n"
+                "       %s cat [--dict DICT] LOGFILE\n",
+                program, program, program);
+    }
+
+    /// Log entries of a file without its header
+    bool readBody(const std::string &path, const LogDictionary *dictionary, std::string &body)
+    {
+        std::string contents;
+        if (!Logger::readLogFile(path, contents, dictionary))
+        {
+            fprintf(stderr, "log_dict: cannot read %s\n", path.c_str());
+            return false;
+        }
+
+        std::string separator = "\n" + std::string(80, '=') + "\n";
+        size_t headerEnd = contents.find(separator);
+        body.append(contents, headerEnd == std::string::npos ? 0 : headerEnd + separator.size(), std::string::npos);
+        return true;
+    }
+
+    /// Cut text into blocks of about blockSize bytes at line ends
+    std::vector<std::string> cutBlocks(const std::string &text, size_t blockSize)
+    {
+        std::vector<std::string> blocks;
+        for (size_t start = 0; start < text.size();)
+        {
+            size_t end = text.find('\n', std::min(start + blockSize, text.size()) - 1);
+            end = end == std::string::npos ? text.size() : end + 1;
+            blocks.push_back(text.substr(start, end - start));
+            start = end;
+        }
+        return blocks;
+    }
+
+    struct BenchResult
+    {
+        size_t rawBytes = 0;
+        size_t storedBytes = 0;
+        double compressSeconds = 0;
+        double decompressSeconds = 0;
+        bool roundTrip = true;
+    };
+
+    BenchResult bench(const std::vector<std::string> &blocks, const LogDictionary &dictionary)
+    {
+        BenchResult result;
+        LogBlockCodec codec(dictionary);
+        std::string framed;
+        std::string decoded;
+
+        // Repeat small inputs so timings are not dominated by clock resolution
+        size_t total = 0;
+        for (const std::string &block : blocks)
+        {
+            total += block.size();
+        }
+        int rounds = static_cast<int>(std::max<size_t>(1, (32u << 20) / std::max<size_t>(total, 1)));
+
+        for (int round = 0; round < rounds; ++round)
+        {
+            framed.clear();
+            auto start = Clock::now();
+            for (const std::string &block : blocks)
+            {
+                codec.appendBlock(block.data(), block.size(), framed);
+            }
+            result.compressSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+
+            decoded.clear();
+            start = Clock::now();
+            const char *cursor = framed.data();
+            const char *end = framed.data() + framed.size();
+            while (cursor < end && codec.readBlock(cursor, end, decoded))
+            {
+            }
+            result.decompressSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+            result.roundTrip = result.roundTrip && cursor == end && decoded.size() == total;
+        }
+
+        result.rawBytes = total * rounds;
+        result.storedBytes = framed.size() * rounds;
+        size_t offset = 0;
+        for (const std::string &block : blocks)
+        {
+            result.roundTrip = result.roundTrip && decoded.compare(offset, block.size(), block) == 0;
+            offset += block.size();
+        }
+        return result;
+    }
+
+    int runTrain(const std::string &output, size_t size, size_t blockSize, const std::vector<std::string> &files)
+    {
+        std::vector<std::string> samples;
+        size_t total = 0;
+        for (const std::string &file : files)
+        {
+            std::string body;
+            if (!readBody(file, nullptr, body))
+            {
+                return 1;
+            }
+            for (std::string &block : cutBlocks(body, blockSize))
+            {
+                total += block.size();
+                samples.push_back(std::move(block));
+            }
+        }
+
+        auto start = Clock::now();
+        LogDictionary dictionary = LogDictionary::train(samples, size);
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (dictionary.empty())
+        {
+            fprintf(stderr, "log_dict: not enough sample data (%zu bytes)\n", total);
+            return 1;
+        }
+        if (!dictionary.save(output))
+        {
+            fprintf(stderr, "log_dict: cannot write %s\n", output.c_str());
+            return 1;
+        }
+
+        printf("Dictionary %08x: %zu bytes from %zu samples (%zu bytes) in %.2f s -> %s\n", dictionary.id(),
+               dictionary.contents().size(), samples.size(), total, seconds, output.c_str());
+        return 0;
+    }
+
+    int runBench(const LogDictionary &dictionary, const std::vector<size_t> &blockSizes,
+                 const std::vector<std::string> &files)
+    {
+        std::string text;
+        for (const std::string &file : files)
+        {
+            if (!readBody(file, dictionary.empty() ? nullptr : &dictionary, text))
+            {
+                return 1;
+            }
+        }
+        printf("%zu bytes of log text\n", text.size());
+        printf("%8s  %-10s  %7s  %12s  %12s\n", "block", "dictionary", "ratio", "compress", "decompress");
+
+        bool ok = true;
+        for (size_t blockSize : blockSizes)
+        {
+            std::vector<std::string> blocks = cutBlocks(text, blockSize);
+            for (int withDictionary = 0; withDictionary < (dictionary.empty() ? 1 : 2); ++withDictionary)
+            {
+                BenchResult result = bench(blocks, withDictionary ? dictionary : LogDictionary());
+                char name[16];
+                snprintf(name, sizeof(name), "%08x", withDictionary ? dictionary.id() : 0);
+                printf("%8zu  %-10s  %6.2fx  %7.1f MB/s  %7.1f MB/s%s\n", blockSize, withDictionary ? name : "none",
+                       static_cast<double>(result.rawBytes) / static_cast<double>(result.storedBytes),
+                       result.rawBytes / 1e6 / result.compressSeconds, result.rawBytes / 1e6 / result.decompressSeconds,
+                       result.roundTrip ? "" : "  ROUND TRIP FAILED");
+                ok = ok && result.roundTrip;
+            }
+        }
+        return ok ? 0 : 1;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    std::string command = argv[1];
+    std::string output;
+    std::string dictionaryPath;
+    size_t size = 16 * 1024;
+    size_t trainBlock = 4096;
+    std::vector<size_t> blockSizes = {256, 1024, 4096, 16384};
+    std::vector<std::string> files;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (arg == "--dict" && i + 1 < argc)
+        {
+            dictionaryPath = argv[++i];
+        }
+        else if (arg == "--size" && i + 1 < argc)
+        {
+            size = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--block" && i + 1 < argc)
+        {
+            std::stringstream list(argv[++i]);
+            std::string item;
+            blockSizes.clear();
+            while (std::getline(list, item, ','))
+            {
+                blockSizes.push_back(std::max<size_t>(1, std::strtoul(item.c_str(), nullptr, 10)));
+            }
+            trainBlock = blockSizes.empty() ? trainBlock : blockSizes.front();
+        }
+        else if (arg.compare(0, 1, "-") == 0)
+        {
+            printUsage(argv[0]);
+            return 2;
+        }
+        else
+        {
+            files.push_back(arg);
+        }
+    }
+
+    LogDictionary dictionary;
+    if (!dictionaryPath.empty() && !dictionary.load(dictionaryPath))
+    {
+        return 1;
+    }
+
+    if (command == "train" && !output.empty() && !files.empty())
+    {
+        return runTrain(output, size, trainBlock, files);
+    }
+    if (command == "bench" && !files.empty() && !blockSizes.empty())
+    {
+        return runBench(dictionary, blockSizes, files);
+    }
+    if (command == "cat" && files.size() == 1)
+    {
+        std::string contents;
+        if (!Logger::readLogFile(files[0], contents, dictionaryPath.empty() ? nullptr : &dictionary))
+        {
+            return 1;
+        }
+        fwrite(contents.data(), 1, contents.size(), stdout);
+        return 0;
+    }
+
+    printUsage(argv[0]);
+    return 2;
+}
@@ -0,0 +1,345 @@
+/**
+ * @file main.cpp
+ * @brief Searches log files by keyword, component and level
+ * @details Prints every entry whose message contains all of WORDS (whole
+ *          words, any order, case-insensitive). In compressed files written
+ *          with LoggerConfig::blockFilterBitsPerToken, each block's Bloom
+ *          filter is tested first and blocks that cannot match are stepped
+ *          over without decompressing, so rare terms are found across weeks
+ *          of logs in seconds. Plain files and unfiltered blocks are scanned
+ *          in full. Directories are searched for files with the log
+ *          extension, rotated backups included.
+ *
+ * Usage:
+ * @code
+ * log_query [--dict DICT] [--component NAME] [--level LEVEL] [--ext EXT] [--stats] WORDS PATH...
+ * @endcode
+ *
+ * --component also matches dotted sub-components ("BMS" finds "BMS.Cell").
+ * WORDS may be empty ("") to list a component or level on its own.
+ */
+
+#include "embedded_logger/block_filter.h"
+#include "embedded_logger/log_compactor.h"
+#include "embedded_logger/log_compression.h"
+#include "embedded_logger/logger.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace embedded_logger;
+
+namespace
+{
+    const char kValidLengthLine[] = "\n# Valid-Length: ";
+
+    void printUsage(const char *program)
+    {
+        fprintf(stderr,
+                "Usage: %s [--dict DICT] [--component NAME] [--level LEVEL] [--ext EXT] [--stats] WORDS PATH...\n",
+                program);
+    }
+
+    struct Query
+    {
+        std::vector<std::string> words;
+        std::vector<uint64_t> tokens; ///< Filter tokens of words and component
+        std::string component;        ///< Lowercase (empty = any)
+        bool hasLevel = false;
+        LogLevel minLevel = LogLevel::DEBUG;
+    };
+
+    struct Stats
+    {
+        size_t files = 0;
+        size_t bytes = 0;
+        size_t blocks = 0;
+        size_t skippedBlocks = 0;
+        size_t matches = 0;
+    };
+
+    std::string lowercase(std::string text)
+    {
+        std::transform(text.begin(), text.end(), text.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return text;
+    }
+
+    bool lineMatches(const std::string &line, const Query &query)
+    {
+        std::string component;
+        size_t messageOffset;
+        if (!BlockFilter::parseLine(line, component, messageOffset))
+        {
+            return false;
+        }
+
+        if (!query.component.empty())
+        {
+            component = lowercase(component);
+            if (component.compare(0, query.component.size(), query.component) != 0 ||
+                (component.size() > query.component.size() && component[query.component.size()] != '.'))
+            {
+                return false;
+            }
+        }
+
+        LogLevel level;
+        if (query.hasLevel && (!LogCompactor::parseLevel(line, level) || level < query.minLevel))
+        {
+            return false;
+        }
+
+        std::vector<std::string> words;
+        BlockFilter::splitWords(line.substr(messageOffset), words);
+        for (const std::string &word : query.words)
+        {
+            if (std::find(words.begin(), words.end(), word) == words.end())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Print matching entries of decoded text; continuation lines follow their entry
+    void scanText(const std::string &path, const std::string &text, const Query &query, Stats &stats)
+    {
+        bool printing = false;
+        for (size_t start = 0; start < text.size();)
+        {
+            size_t end = text.find('\n', start);
+            end = end == std::string::npos ? text.size() : end;
+            std::string line = text.substr(start, end - start);
+            if (!line.empty() && line[0] == '[')
+            {
+                printing = lineMatches(line, query);
+                stats.matches += printing ? 1 : 0;
+            }
+            else if (!line.empty() && line[0] == '#')
+            {
+                printing = false;
+            }
+            if (printing)
+            {
+                printf("%s:%s\n", path.c_str(), line.c_str());
+            }
+            start = end + 1;
+        }
+    }
+
+    bool searchFile(const std::string &path, const LogDictionary &dictionary, const Query &query, Stats &stats)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            fprintf(stderr, "log_query: cannot read %s\n", path.c_str());
+            return false;
+        }
+        std::ostringstream stream;
+        stream << file.rdbuf();
+        std::string contents = stream.str();
+        ++stats.files;
+        stats.bytes += contents.size();
+
+        // Recycled files: only the valid length holds this file's entries
+        size_t titleEnd = contents.find('\n');
+        if (titleEnd != std::string::npos && contents.compare(titleEnd, sizeof(kValidLengthLine) - 1, kValidLengthLine) == 0)
+        {
+            size_t validLength = static_cast<size_t>(
+                std::strtoull(contents.c_str() + titleEnd + sizeof(kValidLengthLine) - 1, nullptr, 10));
+            contents.resize(std::min(validLength, contents.size()));
+        }
+
+        std::string separator = "\n" + std::string(80, '=') + "\n";
+        size_t headerEnd = contents.find(separator);
+        size_t label = contents.find(std::string("\n") + LogBlockCodec::kHeaderLabel);
+        if (headerEnd == std::string::npos || label == std::string::npos || label > headerEnd)
+        {
+            scanText(path, contents, query, stats);
+            return true;
+        }
+        headerEnd += separator.size();
+
+        uint32_t id = static_cast<uint32_t>(
+            std::strtoul(contents.c_str() + label + sizeof(LogBlockCodec::kHeaderLabel), nullptr, 16));
+        if (id != dictionary.id())
+        {
+            fprintf(stderr, "log_query: %s needs compression dictionary %08x\n", path.c_str(), id);
+            return false;
+        }
+
+        LogBlockCodec codec(dictionary);
+        std::string text;
+        const char *cursor = contents.data() + headerEnd;
+        const char *end = contents.data() + contents.size();
+        while (cursor < end)
+        {
+            BlockFilter filter;
+            bool filtered = false;
+            while (cursor < end && *cursor == BlockFilter::kFrameTag && BlockFilter::readFrame(cursor, end, filter))
+            {
+                filtered = true;
+            }
+            if (cursor >= end)
+            {
+                break;
+            }
+            ++stats.blocks;
+
+            bool mayMatch = true;
+            for (size_t i = 0; filtered && mayMatch && i < query.tokens.size(); ++i)
+            {
+                mayMatch = filter.mayContain(query.tokens[i]);
+            }
+            if (!mayMatch)
+            {
+                ++stats.skippedBlocks;
+                if (!LogBlockCodec::skipBlock(cursor, end))
+                {
+                    break; // Torn tail
+                }
+                continue;
+            }
+
+            text.clear();
+            if (!codec.readBlock(cursor, end, text))
+            {
+                break;
+            }
+            scanText(path, text, query, stats);
+        }
+        return true;
+    }
+
+    /// Files to search: plain paths as given, directories expanded
+    void collectFiles(IFileSystem &fileSystem, const std::string &path, const std::string &extension,
+                      std::vector<std::string> &files)
+    {
+        std::vector<std::string> names;
+        if (!fileSystem.listDirectory(path, names))
+        {
+            files.push_back(path);
+            return;
+        }
+
+        std::sort(names.begin(), names.end());
+        for (const std::string &name : names)
+        {
+            bool temporary = name.size() >= 4 && name.compare(name.size() - 4, 4, ".tmp") == 0;
+            if (name.find(extension) != std::string::npos && !temporary)
+            {
+                files.push_back(path + "/" + name);
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::string dictionaryPath;
+    std::string extension = ".txt";
+    bool showStats = false;
+    bool haveWords = false;
+    Query query;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--dict" && i + 1 < argc)
+        {
+            dictionaryPath = argv[++i];
+        }
+        else if (arg == "--component" && i + 1 < argc)
+        {
+            query.component = lowercase(argv[++i]);
+        }
+        else if (arg == "--level" && i + 1 < argc)
+        {
+            // parseLevel reads the level field of a log line
+            std::string name = argv[++i];
+            std::transform(name.begin(), name.end(), name.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+            if (!LogCompactor::parseLevel("[] [" + name + "]", query.minLevel))
+            {
+                fprintf(stderr, "log_query: unknown level %s\n", name.c_str());
+                return 2;
+            }
+            query.hasLevel = true;
+        }
+        else if (arg == "--ext" && i + 1 < argc)
+        {
+            extension = argv[++i];
+        }
+        else if (arg == "--stats")
+        {
+            showStats = true;
+        }
+        else if (arg.compare(0, 1, "-") == 0)
+        {
+            printUsage(argv[0]);
+            return 2;
+        }
+        else if (!haveWords)
+        {
+            BlockFilter::splitWords(arg, query.words);
+            haveWords = true;
+        }
+        else
+        {
+            paths.push_back(arg);
+        }
+    }
+
+    if (!haveWords || paths.empty())
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    for (const std::string &word : query.words)
+    {
+        query.tokens.push_back(BlockFilter::wordToken(word));
+    }
+    if (!query.component.empty())
+    {
+        query.tokens.push_back(BlockFilter::componentToken(query.component));
+    }
+
+    LogDictionary dictionary;
+    if (!dictionaryPath.empty() && !dictionary.load(dictionaryPath))
+    {
+        return 1;
+    }
+
+    auto fileSystem = Logger::createDefaultFileSystem();
+    std::vector<std::string> files;
+    for (const std::string &path : paths)
+    {
+        collectFiles(*fileSystem, path, extension, files);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Stats stats;
+    bool ok = true;
+    for (const std::string &file : files)
+    {
+        ok = searchFile(file, dictionary, query, stats) && ok;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (showStats)
+    {
+        fprintf(stderr, "%zu matches in %zu files (%.1f MB), %zu of %zu blocks skipped by filters, %.2f s\n",
+                stats.matches, stats.files, stats.bytes / 1e6, stats.skippedBlocks, stats.blocks, seconds);
+    }
+    return !ok ? 1 : stats.matches != 0 ? 0 : 1;
+}
@@ -0,0 +1,442 @@
+/**
+ * @file main.cpp
+ * @brief Replays recorded log traffic into a Logger and reports latency
+ * @details Reads a text log file written by the logger, or a binary stream
+ *          capture saved with "log_viewer --save", and reproduces the calls
+ *          into a fresh Logger: same levels, components, message sizes and
+ *          payloads, with the original inter-arrival timing, a speed-up
+ *          factor, or as fast as possible. Results let configuration changes
+ *          be compared against field recordings instead of synthetic load.
+ *
+ * Usage:
+ * @code
+ * log_replay INPUT [--speed realtime|max|FACTOR] [--threads N] [--format text|binary]
+ *            [--dir DIR] [--sync] [--direct-io] [--recycle] [--batch BYTES] [--max-file-size BYTES]
+ * @endcode
+ *
+ * Text logs carry one-second timestamps, so entries within a second are
+ * spread evenly across it, and no thread information, so entries are shared
+ * over --threads replay threads by component (keeping each component's
+ * order). Binary captures carry millisecond timestamps and the producing
+ * process; without --threads, each process gets its own replay thread.
+ */
+
+#include "embedded_logger/log_stream_server.h"
+#include "embedded_logger/logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace embedded_logger;
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct ReplayEntry
+    {
+        uint64_t timeUs = 0;   ///< Recorded time
+        LogLevel level = LogLevel::INFO;
+        std::string component;
+        std::string message;
+        std::string payload;   ///< logBinary() bytes (binary captures only)
+        uint32_t source = 0;   ///< Producing process, 0 if unknown
+    };
+
+    struct ThreadResult
+    {
+        std::vector<uint32_t> latencyNs; ///< Duration of each logging call
+        std::vector<uint32_t> lagUs;     ///< How late each call started against its schedule
+        size_t bytes = 0;
+    };
+
+    void printUsage(const char *program)
+    {
+        fprintf(stderr,
+                "Usage: %s INPUT [--speed realtime|max|FACTOR] [--threads N] [--format text|binary]\n"
+                "          [--dir DIR] [--sync] [--direct-io] [--recycle] [--batch BYTES] [--max-file-size BYTES]\n",
+                program);
+    }
+
+    bool parseLevel(const std::string &text, LogLevel &level)
+    {
+        static const std::pair<const char *, LogLevel> kLevels[] = {
+            {"DEBUG", LogLevel::DEBUG}, {"INFO", LogLevel::INFO}, {"WARNING", LogLevel::WARNING},
+            {"ERROR", LogLevel::ERROR}, {"CRITICAL", LogLevel::CRITICAL}};
+        for (const auto &candidate : kLevels)
+        {
+            if (text == candidate.first)
+            {
+                level = candidate.second;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Next "[field]" at pos, trimmed of the formatter's column padding
+    bool takeField(const std::string &line, size_t &pos, std::string &field)
+    {
+        if (pos >= line.size() || line[pos] != '[')
+        {
+            return false;
+        }
+        size_t close = line.find(']', pos);
+        if (close == std::string::npos)
+        {
+            return false;
+        }
+
+        size_t first = line.find_first_not_of(' ', pos + 1);
+        size_t last = line.find_last_not_of(' ', close - 1);
+        field = first <= last && first < close ? line.substr(first, last - first + 1) : std::string();
+        pos = close + 1;
+        if (pos < line.size() && line[pos] == ' ')
+        {
+            ++pos;
+        }
+        return true;
+    }
+
+    bool loadTextLog(const std::string &path, std::vector<ReplayEntry> &entries)
+    {
+        std::string contents;
+        if (!Logger::readLogFile(path, contents))
+        {
+            return false;
+        }
+
+        std::istringstream lines(contents);
+        std::string line;
+        std::vector<size_t> second; // Entries sharing the current timestamp
+        uint64_t secondStart = 0;
+
+        auto spreadSecond = [&entries, &second, &secondStart]()
+        {
+            for (size_t i = 0; i < second.size(); ++i)
+            {
+                entries[second[i]].timeUs = secondStart + i * 1000000ULL / second.size();
+            }
+            second.clear();
+        };
+
+        while (std::getline(lines, line))
+        {
+            ReplayEntry entry;
+            std::string timestamp;
+            std::string level;
+            size_t pos = 0;
+            if (!takeField(line, pos, timestamp) || !takeField(line, pos, level) || !parseLevel(level, entry.level) ||
+                !takeField(line, pos, entry.component))
+            {
+                // Continuation of a multi-line message; headers and separators are skipped
+                if (!entries.empty() && !line.empty() && line[0] != '#' && line[0] != '=')
+                {
+                    entries.back().message += '\n' + line;
+                }
+                continue;
+            }
+            entry.message = line.substr(pos);
+
+            std::tm tm = {};
+            tm.tm_isdst = -1;
+            uint64_t seconds = secondStart;
+            if (strptime(timestamp.c_str(), "%Y-%m-%d %H:%M:%S", &tm))
+            {
+                seconds = static_cast<uint64_t>(std::mktime(&tm)) * 1000000ULL;
+            }
+            if (seconds != secondStart)
+            {
+                spreadSecond();
+                secondStart = seconds;
+            }
+
+            second.push_back(entries.size());
+            entries.push_back(std::move(entry));
+        }
+        spreadSecond();
+        return true;
+    }
+
+    bool loadBinaryCapture(const std::string &path, std::vector<ReplayEntry> &entries)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+        std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        size_t offset = 0;
+        LogEntry record;
+        while (size_t used = LogStreamServer::decodeBinaryRecord(data.data() + offset, data.size() - offset, record))
+        {
+            ReplayEntry entry;
+            entry.timeUs = record.timestampMs * 1000ULL;
+            entry.level = record.level;
+            entry.component = record.component;
+            entry.message = record.message;
+            entry.payload = record.payload;
+            entry.source = record.processId;
+            entries.push_back(std::move(entry));
+            offset += used;
+        }
+
+        // Captures are in delivery order; replay in recorded order
+        std::stable_sort(entries.begin(), entries.end(), [](const ReplayEntry &a, const ReplayEntry &b)
+                         { return a.timeUs < b.timeUs; });
+        return offset != 0 || data.empty();
+    }
+
+    void replayEntry(Logger &logger, const ReplayEntry &entry)
+    {
+        if (!entry.payload.empty())
+        {
+            logger.logBinary(entry.level, entry.component, entry.payload.data(), entry.payload.size(), entry.message);
+            return;
+        }
+
+        switch (entry.level)
+        {
+        case LogLevel::DEBUG:
+            logger.debug(entry.component, entry.message);
+            break;
+        case LogLevel::INFO:
+            logger.info(entry.component, entry.message);
+            break;
+        case LogLevel::WARNING:
+            logger.warning(entry.component, entry.message);
+            break;
+        case LogLevel::ERROR:
+            logger.error(entry.component, entry.message);
+            break;
+        case LogLevel::CRITICAL:
+        default:
+            logger.critical(entry.component, entry.message);
+            break;
+        }
+    }
+
+    template <typename T>
+    T percentile(const std::vector<T> &sorted, double fraction)
+    {
+        if (sorted.empty())
+        {
+            return 0;
+        }
+        size_t index = static_cast<size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    std::string input = argv[1];
+    std::string format;
+    double speed = 1.0; // 0 = as fast as possible
+    size_t threads = 0;
+    LoggerConfig config;
+    config.logDirectory = "/tmp/log_replay";
+    config.defaultDestination = LogDestination::FILE_ONLY;
+    config.fileLogLevel = LogLevel::DEBUG;
+    config.forkSafe = false;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--speed" && hasValue)
+        {
+            std::string value = argv[++i];
+            speed = value == "max" ? 0.0 : value == "realtime" ? 1.0 : std::atof(value.c_str());
+        }
+        else if (arg == "--threads" && hasValue)
+        {
+            threads = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        }
+        else if (arg == "--format" && hasValue)
+        {
+            format = argv[++i];
+        }
+        else if (arg == "--dir" && hasValue)
+        {
+            config.logDirectory = argv[++i];
+        }
+        else if (arg == "--batch" && hasValue)
+        {
+            config.fileWriteBatchSize = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--max-file-size" && hasValue)
+        {
+            config.maxFileSize = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--sync")
+        {
+            config.asyncLogging = false;
+        }
+        else if (arg == "--direct-io")
+        {
+            config.directFileIo = true;
+        }
+        else if (arg == "--recycle")
+        {
+            config.recycleLogFiles = true;
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    // Text logs start with the file header or a bracketed timestamp
+    if (format.empty())
+    {
+        std::ifstream probe(input, std::ios::binary);
+        int first = probe.get();
+        format = first == '#' || first == '[' ? "text" : "binary";
+    }
+
+    std::vector<ReplayEntry> entries;
+    bool loaded = format == "text" ? loadTextLog(input, entries) : loadBinaryCapture(input, entries);
+    if (!loaded || entries.empty())
+    {
+        fprintf(stderr, "log_replay: no entries read from %s\n", input.c_str());
+        return 1;
+    }
+
+    // Assign entries to replay threads: recorded processes, else by component
+    std::map<uint32_t, size_t> sources;
+    for (const ReplayEntry &entry : entries)
+    {
+        sources.emplace(entry.source, sources.size());
+    }
+    bool bySource = threads == 0 && sources.size() > 1;
+    if (threads == 0)
+    {
+        threads = bySource ? sources.size() : 1;
+    }
+
+    std::vector<std::vector<const ReplayEntry *>> work(threads);
+    for (const ReplayEntry &entry : entries)
+    {
+        size_t index = bySource ? sources[entry.source] : std::hash<std::string>()(entry.component) % threads;
+        work[index].push_back(&entry);
+    }
+
+    auto logger = std::make_shared<Logger>(config);
+    if (!logger->initialize())
+    {
+        fprintf(stderr, "log_replay: logger initialization failed\n");
+        return 1;
+    }
+
+    uint64_t firstUs = entries.front().timeUs;
+    std::vector<ThreadResult> results(threads);
+    std::vector<std::thread> workers;
+    std::atomic<size_t> ready(0);
+    Clock::time_point start;
+    std::atomic<bool> go(false);
+
+    for (size_t t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t]()
+                             {
+            ThreadResult &result = results[t];
+            result.latencyNs.reserve(work[t].size());
+            result.lagUs.reserve(speed > 0 ? work[t].size() : 0);
+            ++ready;
+            while (!go.load())
+            {
+                std::this_thread::yield();
+            }
+
+            for (const ReplayEntry *entry : work[t])
+            {
+                if (speed > 0)
+                {
+                    auto due = start + std::chrono::microseconds(
+                                           static_cast<int64_t>(static_cast<double>(entry->timeUs - firstUs) / speed));
+                    std::this_thread::sleep_until(due);
+                    result.lagUs.push_back(static_cast<uint32_t>(
+                        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - due).count()));
+                }
+
+                auto before = Clock::now();
+                replayEntry(*logger, *entry);
+                result.latencyNs.push_back(static_cast<uint32_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - before).count()));
+                result.bytes += entry->message.size() + entry->payload.size();
+            } });
+    }
+
+    while (ready.load() != threads)
+    {
+        std::this_thread::yield();
+    }
+    start = Clock::now();
+    go.store(true);
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    auto replayed = Clock::now();
+
+    // Shutdown writes everything still queued
+    logger->shutdown();
+    auto drained = Clock::now();
+
+    std::vector<uint32_t> latency;
+    std::vector<uint32_t> lag;
+    size_t bytes = 0;
+    for (const ThreadResult &result : results)
+    {
+        latency.insert(latency.end(), result.latencyNs.begin(), result.latencyNs.end());
+        lag.insert(lag.end(), result.lagUs.begin(), result.lagUs.end());
+        bytes += result.bytes;
+    }
+    std::sort(latency.begin(), latency.end());
+    std::sort(lag.begin(), lag.end());
+
+    double replaySeconds = std::chrono::duration<double>(replayed - start).count();
+    double drainMs = std::chrono::duration<double, std::milli>(drained - replayed).count();
+    double recordedSeconds = static_cast<double>(entries.back().timeUs - firstUs) / 1e6;
+
+    char speedText[32] = "max";
+    if (speed > 0)
+    {
+        snprintf(speedText, sizeof(speedText), "%gx", speed);
+    }
+    printf("log_replay: %zu entries from %s (%s, %.1f s recorded), %zu thread(s), speed %s\n", entries.size(),
+           input.c_str(), format.c_str(), recordedSeconds, threads, speedText);
+    printf("  call latency ns   p50 %u  p90 %u  p99 %u  p99.9 %u  max %u\n", percentile(latency, 0.5),
+           percentile(latency, 0.9), percentile(latency, 0.99), percentile(latency, 0.999),
+           latency.empty() ? 0 : latency.back());
+    if (!lag.empty())
+    {
+        printf("  schedule lag us   p50 %u  p99 %u  max %u\n", percentile(lag, 0.5), percentile(lag, 0.99),
+               lag.back());
+    }
+    printf("  replay %.3f s  %.0f entries/s  %.2f MB/s of message text\n", replaySeconds,
+           static_cast<double>(entries.size()) / replaySeconds, static_cast<double>(bytes) / replaySeconds / 1e6);
+    printf("  drain at shutdown %.1f ms, output in %s\n", drainMs, config.logDirectory.c_str());
+    return 0;
+}
@@ -0,0 +1,220 @@
+/**
+ * @file main.cpp
+ * @brief Minimal live log viewer for LogStreamServer
+ * @details Connects to a logger's UNIX socket or TCP loopback port, installs a
+ *          server-side filter and prints entries as they arrive.
+ *
+ * Usage:
+ * @code
+ * log_viewer (--unix PATH | --tcp PORT) [--level LEVEL] [--component PREFIX]
+ *            [--grep TEXT] [--binary] [--save FILE]
+ * @endcode
+ *
+ * --level and --component are evaluated by the logger so filtered entries
+ * never cross the socket; --grep is applied locally. --save writes the raw
+ * binary stream (implies --binary) for later replay.
+ */
+
+#include "embedded_logger/log_formatter.h"
+#include "embedded_logger/log_stream_server.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace embedded_logger;
+
+namespace
+{
+    void printUsage(const char *program)
+    {
+        fprintf(stderr,
+                "Usage: %s (--unix PATH | --tcp PORT) [--level LEVEL] [--component PREFIX]\n"
+                "          [--grep TEXT] [--binary] [--save FILE]\n",
+                program);
+    }
+
+    int connectUnix(const std::string &path)
+    {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(addr.sun_path))
+        {
+            return -1;
+        }
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+        return fd;
+    }
+
+    int connectTcp(uint16_t port)
+    {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+        return fd;
+    }
+
+    const char *levelName(LogLevel level)
+    {
+        static const char *names[] = {"DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL"};
+        uint8_t index = static_cast<uint8_t>(level);
+        return index < 5 ? names[index] : "UNKNOWN";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::string unixPath;
+    int tcpPort = 0;
+    std::string level;
+    std::string component;
+    std::string grep;
+    std::string savePath;
+    bool binary = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--unix" && hasValue)
+            unixPath = argv[++i];
+        else if (arg == "--tcp" && hasValue)
+            tcpPort = std::atoi(argv[++i]);
+        else if (arg == "--level" && hasValue)
+            level = argv[++i];
+        else if (arg == "--component" && hasValue)
+            component = argv[++i];
+        else if (arg == "--grep" && hasValue)
+            grep = argv[++i];
+        else if (arg == "--save" && hasValue)
+            savePath = argv[++i];
+        else if (arg == "--binary")
+            binary = true;
+        else
+        {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (unixPath.empty() == (tcpPort == 0))
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    FILE *saveFile = nullptr;
+    if (!savePath.empty())
+    {
+        saveFile = fopen(savePath.c_str(), "wb");
+        if (!saveFile)
+        {
+            fprintf(stderr, "log_viewer: cannot open %s\n", savePath.c_str());
+            return 1;
+        }
+        binary = true;
+    }
+
+    int fd = unixPath.empty() ? connectTcp(static_cast<uint16_t>(tcpPort)) : connectUnix(unixPath);
+    if (fd < 0)
+    {
+        fprintf(stderr, "log_viewer: cannot connect: %s\n", strerror(errno));
+        return 1;
+    }
+
+    std::string filter = "FILTER";
+    if (!level.empty())
+        filter += " level=" + level;
+    if (!component.empty())
+        filter += " component=" + component;
+    filter += binary ? " format=binary\n" : " format=text\n";
+    if (send(fd, filter.data(), filter.size(), 0) < 0)
+    {
+        fprintf(stderr, "log_viewer: send failed: %s\n", strerror(errno));
+        close(fd);
+        return 1;
+    }
+
+    std::string pending;
+    char buffer[4096];
+    ssize_t received;
+    while ((received = recv(fd, buffer, sizeof(buffer), 0)) > 0)
+    {
+        if (saveFile)
+        {
+            fwrite(buffer, 1, static_cast<size_t>(received), saveFile);
+        }
+        pending.append(buffer, static_cast<size_t>(received));
+
+        size_t consumed = 0;
+        if (binary)
+        {
+            LogEntry entry;
+            size_t used;
+            while ((used = LogStreamServer::decodeBinaryRecord(pending.data() + consumed,
+                                                               pending.size() - consumed, entry)) != 0)
+            {
+                consumed += used;
+                if (grep.empty() || entry.message.find(grep) != std::string::npos)
+                {
+                    std::string dump;
+                    if (!entry.payload.empty())
+                    {
+                        dump = " [";
+                        formatting::appendHex(dump, entry.payload.data(), entry.payload.size());
+                        dump += ']';
+                    }
+                    printf("%llu [%8s] [%12s] %s%s\n", static_cast<unsigned long long>(entry.timestampMs),
+                           levelName(entry.level), entry.component.c_str(), entry.message.c_str(), dump.c_str());
+                }
+            }
+        }
+        else
+        {
+            size_t newline;
+            while ((newline = pending.find('\n', consumed)) != std::string::npos)
+            {
+                std::string line = pending.substr(consumed, newline - consumed);
+                consumed = newline + 1;
+                if (grep.empty() || line.find(grep) != std::string::npos)
+                {
+                    printf("%s\n", line.c_str());
+                }
+            }
+        }
+
+        pending.erase(0, consumed);
+        fflush(stdout);
+    }
+
+    if (saveFile)
+    {
+        fclose(saveFile);
+    }
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file main.cpp
+ * @brief Compares the in-tree printf engine with the C library's snprintf
+ * @details Formats typical log messages with formatting::format() and with
+ *          snprintf, checks that both produce the same text and prints the
+ *          time per call. Run it on the target to see the speed difference
+ *          there; for flash, compare the size of a firmware image linked
+ *          with and without EMBEDDED_LOGGER_LIBC_PRINTF (newlib's float
+ *          printf support is only linked in when something calls it).
+ *
+ * Usage:
+ * @code
+ * printf_bench [--iterations N]
+ * @endcode
+ *
+ * Exits non-zero if any output differs.
+ */
+
+#include "embedded_logger/log_printf.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace embedded_logger;
+
+namespace
+{
+    struct Case
+    {
+        const char *name;
+        int (*engine)(char *, size_t, int);
+        int (*libc)(char *, size_t, int);
+    };
+
+    // Each case formats the same message through both implementations
+#define PRINTF_BENCH_CASE(name, ...)                                                           \
+    {                                                                                          \
+        name,                                                                                  \
+            [](char *buffer, size_t size, int i) { return formatting::format(buffer, size, __VA_ARGS__); }, \
+            [](char *buffer, size_t size, int i) { return snprintf(buffer, size, __VA_ARGS__); }            \
+    }
+
+    const Case kCases[] = {
+        PRINTF_BENCH_CASE("integers", "cell %d voltage %u mV state %s", i % 96, 3300u + i % 500, "OK"),
+        PRINTF_BENCH_CASE("hex", "CAN id=%#05x dlc=%u data=%08lx", i & 0x7FF, i % 9u, 0xDEADBEEFul ^ i),
+        PRINTF_BENCH_CASE("fixed", "pos=%.6f,%.6f alt=%.1f", 51.5 + i * 1e-7, -0.12 + i * 1e-8, 120.25 + i % 100),
+        PRINTF_BENCH_CASE("general", "gain %g error %e", 1.0 / (i + 1), 6.02e23 * i),
+        PRINTF_BENCH_CASE("padded", "[%8s] [%-12s] %5.1f%% %+d", "WARNING", "BMS.Cell", (i % 1000) / 10.0, i - 5000),
+    };
+
+#undef PRINTF_BENCH_CASE
+
+    double nanosecondsPerCall(int (*format)(char *, size_t, int), int iterations)
+    {
+        char buffer[256];
+        volatile int sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            sink = sink + format(buffer, sizeof(buffer), i);
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 200000;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+        {
+            iterations = atoi(argv[++i]);
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [--iterations N]\n", argv[0]);
+            return 2;
+        }
+    }
+    iterations = iterations > 0 ? iterations : 1;
+
+    int mismatches = 0;
+    printf("%-10s %12s %12s\n", "case", "engine ns", "snprintf ns");
+    for (const Case &test : kCases)
+    {
+        for (int i = 0; i < iterations; i += 997)
+        {
+            char engine[256];
+            char libc[256];
+            int engineLength = test.engine(engine, sizeof(engine), i);
+            int libcLength = test.libc(libc, sizeof(libc), i);
+            if (engineLength != libcLength || strcmp(engine, libc) != 0)
+            {
+                fprintf(stderr, "%s: \"%s\" != \"%s\"\n", test.name, engine, libc);
+                ++mismatches;
+                break;
+            }
+        }
+
+        printf("%-10s %12.1f %12.1f\n", test.name, nanosecondsPerCall(test.engine, iterations),
+               nanosecondsPerCall(test.libc, iterations));
+    }
+    return mismatches != 0 ? 1 : 0;
+}
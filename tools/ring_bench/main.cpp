@@ -0,0 +1,322 @@
+/**
+ * @file main.cpp
+ * @brief Compares a shared log ring with per-process log files
+ * @details Forks N producer processes that each log M entries as fast as
+ *          they can, first into a named shared ring drained by this process
+ *          (SharedRingRole::PRODUCER / COLLECTOR), then into a log file of
+ *          their own (SharedRingRole::NONE). For each setup it prints the
+ *          throughput until every entry is on disk and the per-call latency
+ *          the producers saw. Entries missing from the ring run were dropped
+ *          because the ring was full; raise --slots to compare without drops.
+ *
+ * Usage:
+ * @code
+ * ring_bench [--producers N] [--entries M] [--slots S] [--dir DIR]
+ * @endcode
+ *
+ * Each run writes into its own ring_<pid> / files_<pid> directory under DIR
+ * (default /tmp/ring_bench). POSIX only (named rings use shm_open()).
+ * Exits non-zero if a producer fails.
+ */
+
+#include "embedded_logger/logger.h"
+#include "embedded_logger/shared_log_ring.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace embedded_logger;
+
+namespace
+{
+    struct Options
+    {
+        int producers = 4;
+        int entries = 100000;
+        size_t slots = 4096;
+        std::string directory = "/tmp/ring_bench";
+    };
+
+    /// What each producer reports back through its pipe
+    struct ProducerResult
+    {
+        uint32_t p50Ns;
+        uint32_t p99Ns;
+        uint32_t p999Ns;
+        uint32_t maxNs;
+    };
+
+    struct RunResult
+    {
+        double seconds = 0;
+        size_t written = 0;
+        double p50Ns = 0;  ///< Mean of the producers' medians
+        uint32_t p99Ns = 0; ///< Worst producer
+        uint32_t p999Ns = 0;
+        uint32_t maxNs = 0;
+    };
+
+    double secondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    LoggerConfig benchConfig(const std::string &directory)
+    {
+        LoggerConfig config;
+        config.logDirectory = directory;
+        config.defaultDestination = LogDestination::FILE_ONLY;
+        config.maxFileSize = static_cast<size_t>(1) << 40; // One file per run, so counting is a single read
+        config.forkChildMode = ForkChildMode::DISABLED;
+        return config;
+    }
+
+    size_t countEntries(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        const std::string text = contents.str();
+        size_t count = 0;
+        for (size_t at = text.find("] bench "); at != std::string::npos; at = text.find("] bench ", at + 1))
+        {
+            ++count;
+        }
+        return count;
+    }
+
+    /// Child side: wait for the start signal, log, report latencies
+    void runProducer(int index, const Options &options, const LoggerConfig &config, int startFd, int resultFd)
+    {
+        Logger logger(config);
+        if (!logger.initialize())
+        {
+            _exit(1);
+        }
+
+        char go;
+        ssize_t started = read(startFd, &go, 1); // EOF when the parent releases everyone
+        (void)started;
+
+        std::vector<uint32_t> latencies(static_cast<size_t>(options.entries));
+        std::string component = "P" + std::to_string(index);
+        for (int i = 0; i < options.entries; ++i)
+        {
+            auto before = std::chrono::steady_clock::now();
+            logger.logf(LogLevel::INFO, component, "bench entry %d from producer %d value %u", i, index,
+                        static_cast<unsigned>(i * 2654435761u));
+            auto elapsed = std::chrono::steady_clock::now() - before;
+            latencies[static_cast<size_t>(i)] = static_cast<uint32_t>(
+                std::min<long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), UINT32_MAX));
+        }
+        logger.shutdown();
+
+        std::sort(latencies.begin(), latencies.end());
+        auto at = [&latencies](double fraction)
+        { return latencies[std::min(latencies.size() - 1, static_cast<size_t>(fraction * latencies.size()))]; };
+        ProducerResult result = {at(0.50), at(0.99), at(0.999), latencies.back()};
+        ssize_t sent = write(resultFd, &result, sizeof(result));
+        _exit(sent == static_cast<ssize_t>(sizeof(result)) ? 0 : 1);
+    }
+
+    /// Fork the producers, release them together and collect their reports
+    bool runProducers(const Options &options, const LoggerConfig &config, bool numberPrefixes,
+                      RunResult &run, std::chrono::steady_clock::time_point &start)
+    {
+        int startPipe[2];
+        int resultPipe[2];
+        if (pipe(startPipe) != 0 || pipe(resultPipe) != 0)
+        {
+            perror("pipe");
+            return false;
+        }
+
+        std::vector<pid_t> children;
+        for (int i = 0; i < options.producers; ++i)
+        {
+            LoggerConfig producerConfig = config;
+            if (numberPrefixes)
+            {
+                producerConfig.logFilePrefix = config.logFilePrefix + "_p" + std::to_string(i);
+            }
+            pid_t child = fork();
+            if (child == 0)
+            {
+                close(startPipe[1]);
+                close(resultPipe[0]);
+                runProducer(i, options, producerConfig, startPipe[0], resultPipe[1]);
+            }
+            if (child < 0)
+            {
+                perror("fork");
+                return false;
+            }
+            children.push_back(child);
+        }
+        close(startPipe[0]);
+        close(resultPipe[1]);
+
+        // Let every child finish initialize() before the clock starts
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        start = std::chrono::steady_clock::now();
+        close(startPipe[1]);
+
+        bool ok = true;
+        for (size_t received = 0; received < children.size(); ++received)
+        {
+            ProducerResult result;
+            if (read(resultPipe[0], &result, sizeof(result)) != static_cast<ssize_t>(sizeof(result)))
+            {
+                ok = false;
+                break;
+            }
+            run.p50Ns += static_cast<double>(result.p50Ns) / children.size();
+            run.p99Ns = std::max(run.p99Ns, result.p99Ns);
+            run.p999Ns = std::max(run.p999Ns, result.p999Ns);
+            run.maxNs = std::max(run.maxNs, result.maxNs);
+        }
+        for (pid_t child : children)
+        {
+            int status = 0;
+            waitpid(child, &status, 0);
+            ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        }
+        close(resultPipe[0]);
+        return ok;
+    }
+
+    bool runRing(const Options &options, RunResult &run)
+    {
+        std::string directory = options.directory + "/ring_" + std::to_string(getpid());
+        LoggerConfig config = benchConfig(directory);
+        config.sharedRingName = "/ring_bench_" + std::to_string(getpid());
+        config.multiProcessRingSlots = options.slots;
+
+        LoggerConfig collectorConfig = config;
+        collectorConfig.sharedRingRole = SharedRingRole::COLLECTOR;
+        Logger collector(collectorConfig);
+        if (!collector.initialize())
+        {
+            fprintf(stderr, "Cannot start the collector in %s\n", directory.c_str());
+            return false;
+        }
+
+        config.sharedRingRole = SharedRingRole::PRODUCER;
+        std::chrono::steady_clock::time_point start;
+        bool ok = runProducers(options, config, false, run, start);
+
+        // On disk means drained by the collector's writer and flushed; stop when the count stops growing
+        size_t expected = static_cast<size_t>(options.producers) * options.entries;
+        std::chrono::steady_clock::time_point lastGrowth = std::chrono::steady_clock::now();
+        while (ok)
+        {
+            collector.flush();
+            size_t written = countEntries(collector.getCurrentLogFile());
+            if (written != run.written)
+            {
+                run.written = written;
+                run.seconds = secondsSince(start);
+                lastGrowth = std::chrono::steady_clock::now();
+            }
+            if (written >= expected || secondsSince(lastGrowth) > 0.5)
+            {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        collector.shutdown();
+        SharedLogRing::unlink(config.sharedRingName);
+        return ok;
+    }
+
+    bool runFiles(const Options &options, RunResult &run)
+    {
+        std::string directory = options.directory + "/files_" + std::to_string(getpid());
+        LoggerConfig config = benchConfig(directory);
+        config.logFilePrefix = "bench";
+
+        std::chrono::steady_clock::time_point start;
+        bool ok = runProducers(options, config, true, run, start);
+        run.seconds = secondsSince(start); // Each producer's shutdown() wrote its file
+
+        // Producer files are named bench_p<i>_<timestamp>.log
+        DIR *listing = opendir(directory.c_str());
+        while (listing)
+        {
+            dirent *item = readdir(listing);
+            if (!item)
+            {
+                closedir(listing);
+                break;
+            }
+            if (strncmp(item->d_name, "bench_p", 7) == 0)
+            {
+                run.written += countEntries(directory + "/" + item->d_name);
+            }
+        }
+        return ok;
+    }
+
+    void printRun(const char *name, const Options &options, const RunResult &run)
+    {
+        size_t expected = static_cast<size_t>(options.producers) * options.entries;
+        printf("%-6s %10zu %10zu %9.3f %12.0f %9.0f %9u %9u %10u\n", name, expected, run.written, run.seconds,
+               run.seconds > 0 ? run.written / run.seconds : 0.0, run.p50Ns, run.p99Ns, run.p999Ns, run.maxNs);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--producers") == 0 && i + 1 < argc)
+        {
+            options.producers = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--entries") == 0 && i + 1 < argc)
+        {
+            options.entries = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--slots") == 0 && i + 1 < argc)
+        {
+            options.slots = static_cast<size_t>(strtoul(argv[++i], nullptr, 10));
+        }
+        else if (strcmp(argv[i], "--dir") == 0 && i + 1 < argc)
+        {
+            options.directory = argv[++i];
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [--producers N] [--entries M] [--slots S] [--dir DIR]\n", argv[0]);
+            return 2;
+        }
+    }
+    options.producers = std::max(options.producers, 1);
+    options.entries = std::max(options.entries, 1);
+    mkdir(options.directory.c_str(), 0755);
+
+    RunResult ring;
+    RunResult files;
+    bool ok = runRing(options, ring) && runFiles(options, files);
+
+    printf("\n%d producers x %d entries, ring of %zu slots\n", options.producers, options.entries, options.slots);
+    printf("%-6s %10s %10s %9s %12s %9s %9s %9s %10s\n", "setup", "entries", "on disk", "seconds", "entries/s",
+           "p50 ns", "p99 ns", "p99.9 ns", "max ns");
+    printRun("ring", options, ring);
+    printRun("files", options, files);
+    return ok ? 0 : 1;
+}
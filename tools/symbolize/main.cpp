@@ -0,0 +1,314 @@
+/**
+ * @file main.cpp
+ * @brief Offline symbolizer for backtraces in log files
+ * @details Reads a log file written with LoggerConfig::captureBacktraces,
+ *          maps every "[bt 0x...]" address to its module using the file's
+ *          "# Module:" records, and resolves it with addr2line. Each entry
+ *          with a backtrace is printed followed by one line per frame.
+ *
+ * Usage:
+ * @code
+ * symbolize LOGFILE [--sysroot DIR] [--addr2line PROGRAM]
+ * @endcode
+ *
+ * --sysroot is prepended to recorded module paths, e.g. the unstripped
+ * target root filesystem on the host. Modules whose build-id differs from
+ * the one recorded on the target are still used, with a warning.
+ */
+
+#include "embedded_logger/logger.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <elf.h>
+
+using namespace embedded_logger;
+
+namespace
+{
+    struct Module
+    {
+        uint64_t start = 0;
+        uint64_t end = 0;
+        uint64_t bias = 0;
+        std::string buildId;
+        std::string path;
+        bool checked = false;
+    };
+
+    void printUsage(const char *program)
+    {
+        fprintf(stderr, "Usage: %s LOGFILE [--sysroot DIR] [--addr2line PROGRAM]\n", program);
+    }
+
+    std::string fieldValue(const std::string &line, const std::string &name)
+    {
+        size_t pos = line.find(" " + name + "=");
+        if (pos == std::string::npos)
+        {
+            return std::string();
+        }
+        pos += name.size() + 2;
+        // path= is last and may contain spaces
+        size_t end = name == "path" ? line.size() : line.find(' ', pos);
+        return line.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+    }
+
+    template <typename Ehdr, typename Phdr, typename Nhdr>
+    std::string readBuildId(std::ifstream &file)
+    {
+        Ehdr header;
+        file.seekg(0);
+        if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+        {
+            return std::string();
+        }
+
+        for (unsigned i = 0; i < header.e_phnum; ++i)
+        {
+            Phdr program;
+            file.seekg(static_cast<std::streamoff>(header.e_phoff + i * header.e_phentsize));
+            if (!file.read(reinterpret_cast<char *>(&program), sizeof(program)) || program.p_type != PT_NOTE)
+            {
+                continue;
+            }
+
+            std::vector<char> notes(program.p_filesz);
+            file.seekg(static_cast<std::streamoff>(program.p_offset));
+            if (!file.read(notes.data(), static_cast<std::streamsize>(notes.size())))
+            {
+                continue;
+            }
+
+            size_t offset = 0;
+            while (offset + sizeof(Nhdr) <= notes.size())
+            {
+                const auto *note = reinterpret_cast<const Nhdr *>(notes.data() + offset);
+                size_t name = offset + sizeof(Nhdr);
+                size_t desc = name + ((note->n_namesz + 3) & ~3U);
+                if (note->n_type == NT_GNU_BUILD_ID && note->n_namesz == 4 &&
+                    std::memcmp(notes.data() + name, "GNU", 4) == 0 && desc + note->n_descsz <= notes.size())
+                {
+                    std::string id;
+                    char pair[3];
+                    for (size_t b = 0; b < note->n_descsz; ++b)
+                    {
+                        snprintf(pair, sizeof(pair), "%02x", static_cast<uint8_t>(notes[desc + b]));
+                        id += pair;
+                    }
+                    return id;
+                }
+                offset = desc + ((note->n_descsz + 3) & ~3U);
+            }
+        }
+        return std::string();
+    }
+
+    /// GNU build-id of an ELF file on the host, empty if none
+    std::string fileBuildId(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        unsigned char ident[EI_NIDENT];
+        if (!file.read(reinterpret_cast<char *>(ident), sizeof(ident)) || std::memcmp(ident, ELFMAG, SELFMAG) != 0)
+        {
+            return std::string();
+        }
+        return ident[EI_CLASS] == ELFCLASS64 ? readBuildId<Elf64_Ehdr, Elf64_Phdr, Elf64_Nhdr>(file)
+                                             : readBuildId<Elf32_Ehdr, Elf32_Phdr, Elf32_Nhdr>(file);
+    }
+
+    class Symbolizer
+    {
+    public:
+        Symbolizer(const std::string &sysroot, const std::string &addr2line)
+            : sysroot_(sysroot), addr2line_(addr2line) {}
+
+        void addModule(const std::string &line)
+        {
+            Module module;
+            module.start = std::strtoull(fieldValue(line, "start").c_str(), nullptr, 16);
+            module.end = std::strtoull(fieldValue(line, "end").c_str(), nullptr, 16);
+            module.bias = std::strtoull(fieldValue(line, "bias").c_str(), nullptr, 16);
+            module.buildId = fieldValue(line, "build-id");
+            module.path = fieldValue(line, "path");
+            modules_.push_back(module);
+        }
+
+        void clearModules()
+        {
+            modules_.clear();
+        }
+
+        /// Resolve a return address to "function at file:line (module+0xoffset)"
+        std::string describe(uint64_t address)
+        {
+            Module *module = findModule(address);
+            char where[64];
+            if (!module)
+            {
+                snprintf(where, sizeof(where), "0x%llx (no module)", static_cast<unsigned long long>(address));
+                return where;
+            }
+
+            // Return addresses point after the call; look up the call itself
+            uint64_t fileAddress = address - module->bias - 1;
+            std::string hostPath = sysroot_ + module->path;
+            checkBuildId(*module, hostPath);
+
+            snprintf(where, sizeof(where), "+0x%llx)", static_cast<unsigned long long>(fileAddress));
+            return resolve(hostPath, fileAddress) + " (" + module->path + where;
+        }
+
+    private:
+        Module *findModule(uint64_t address)
+        {
+            for (Module &module : modules_)
+            {
+                if (address >= module.start && address < module.end)
+                {
+                    return &module;
+                }
+            }
+            return nullptr;
+        }
+
+        void checkBuildId(Module &module, const std::string &hostPath)
+        {
+            if (module.checked || module.buildId == "-")
+            {
+                return;
+            }
+            module.checked = true;
+
+            std::string local = fileBuildId(hostPath);
+            if (local != module.buildId)
+            {
+                fprintf(stderr, "symbolize: build-id mismatch for %s (log %s, host %s), results may be wrong\n",
+                        hostPath.c_str(), module.buildId.c_str(), local.empty() ? "none" : local.c_str());
+            }
+        }
+
+        std::string resolve(const std::string &path, uint64_t fileAddress)
+        {
+            char key[32];
+            snprintf(key, sizeof(key), "@0x%llx", static_cast<unsigned long long>(fileAddress));
+            auto cached = cache_.find(path + key);
+            if (cached != cache_.end())
+            {
+                return cached->second;
+            }
+
+            std::string command = addr2line_ + " -f -C -e '" + path + "' " + (key + 1) + " 2>/dev/null";
+            std::string function = "??";
+            std::string location = "??:0";
+            if (FILE *pipe = popen(command.c_str(), "r"))
+            {
+                char line[1024];
+                if (fgets(line, sizeof(line), pipe))
+                {
+                    function.assign(line, strcspn(line, "\n"));
+                }
+                if (fgets(line, sizeof(line), pipe))
+                {
+                    location.assign(line, strcspn(line, "\n"));
+                }
+                pclose(pipe);
+            }
+
+            std::string result = function + " at " + location;
+            cache_[path + key] = result;
+            return result;
+        }
+
+        std::string sysroot_;
+        std::string addr2line_;
+        std::vector<Module> modules_;
+        std::map<std::string, std::string> cache_;
+    };
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    std::string sysroot;
+    std::string addr2line = "addr2line";
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--sysroot" && i + 1 < argc)
+        {
+            sysroot = argv[++i];
+        }
+        else if (arg == "--addr2line" && i + 1 < argc)
+        {
+            addr2line = argv[++i];
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    std::string contents;
+    if (!Logger::readLogFile(argv[1], contents))
+    {
+        fprintf(stderr, "symbolize: cannot read %s\n", argv[1]);
+        return 1;
+    }
+
+    Symbolizer symbolizer(sysroot, addr2line);
+    std::istringstream lines(contents);
+    std::string line;
+    bool inHeader = false;
+    size_t resolved = 0;
+    while (std::getline(lines, line))
+    {
+        // Each file header lists the modules of the process that wrote it
+        if (line.compare(0, 2, "# ") == 0)
+        {
+            if (!inHeader)
+            {
+                symbolizer.clearModules();
+                inHeader = true;
+            }
+            if (line.compare(0, 10, "# Module: ") == 0)
+            {
+                symbolizer.addModule(line);
+            }
+            continue;
+        }
+        inHeader = false;
+
+        size_t bt = line.rfind(" [bt ");
+        if (bt == std::string::npos)
+        {
+            continue;
+        }
+
+        printf("%s\n", line.c_str());
+        std::istringstream frames(line.substr(bt + 5, line.find(']', bt) - bt - 5));
+        std::string frame;
+        for (int index = 0; frames >> frame; ++index)
+        {
+            uint64_t address = std::strtoull(frame.c_str(), nullptr, 16);
+            printf("    #%-2d %s\n", index, symbolizer.describe(address).c_str());
+            ++resolved;
+        }
+    }
+
+    fprintf(stderr, "symbolize: %zu frames\n", resolved);
+    return 0;
+}